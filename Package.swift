@@ -23,6 +23,12 @@ let package = Package(
 			linkerSettings: [
 				.linkedFramework("CoreAudio"),
 				.linkedFramework("AudioToolbox"),
+				.linkedFramework("Accelerate"),
+			]),
+		.executableTarget(
+			name: "CXXAudioUtilitiesBenchmarks",
+			dependencies: [
+				"CXXAudioUtilities",
 			]),
 		.testTarget(
 			name: "CXXAudioUtilitiesTests",
@@ -0,0 +1,107 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <limits>
+
+#import <mach/mach_time.h>
+
+#import "SFBAdaptiveUnfairLock.hpp"
+
+namespace {
+
+/// The maximum number of spins between attempts to acquire the lock
+constexpr uint32_t kMaximumBackoff = 16;
+
+/// Returns the number of host ticks per nanosecond
+double HostTicksPerNanosecond() noexcept
+{
+	static const auto ticksPerNanosecond = [] {
+		mach_timebase_info_data_t timebaseInfo;
+		mach_timebase_info(&timebaseInfo);
+		return static_cast<double>(timebaseInfo.denom) / timebaseInfo.numer;
+	}();
+	return ticksPerNanosecond;
+}
+
+/// Spins for @c count iterations, hinting to the processor that the thread is waiting
+void Spin(uint32_t count) noexcept
+{
+	for(uint32_t i = 0; i < count; ++i) {
+#if defined(__arm64__) || defined(__aarch64__)
+		__asm__ __volatile__("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#endif
+	}
+}
+
+/// Returns @c average moved one eighth of the way toward @c sample
+uint32_t UpdateAverage(uint32_t average, uint32_t sample) noexcept
+{
+	return static_cast<uint32_t>(static_cast<int64_t>(average) + (static_cast<int64_t>(sample) - average) / 8);
+}
+
+} /* namespace */
+
+uint64_t SFB::AdaptiveUnfairLock::ConvertNanosecondsToHostTicks(double nanoseconds) noexcept
+{
+	const auto hostTicks = nanoseconds * HostTicksPerNanosecond();
+	if(!(hostTicks > 0))
+		return 0;
+	if(hostTicks >= static_cast<double>(std::numeric_limits<uint64_t>::max()))
+		return std::numeric_limits<uint64_t>::max();
+	return static_cast<uint64_t>(hostTicks);
+}
+
+void SFB::AdaptiveUnfairLock::LockContended() noexcept
+{
+	mContentions.fetch_add(1, std::memory_order_relaxed);
+
+	// Spin for up to twice as long as recent contended acquisitions needed, plus some slack
+	const auto estimate = mSpinEstimate.load(std::memory_order_relaxed);
+	const auto limit = std::min(mMaximumSpinCount, 2 * estimate + 10);
+
+	// Backing off exponentially between attempts limits cache line contention with the owner
+	uint32_t spins = 0;
+	uint32_t backoff = 1;
+	while(spins < limit) {
+		Spin(backoff);
+		spins += backoff;
+		if(os_unfair_lock_trylock(&mLock)) {
+			mSpinEstimate.store(UpdateAverage(estimate, spins), std::memory_order_relaxed);
+			mSpinAcquisitions.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		backoff = std::min(2 * backoff, kMaximumBackoff);
+	}
+
+	mSpinEstimate.store(UpdateAverage(estimate, limit), std::memory_order_relaxed);
+	mParks.fetch_add(1, std::memory_order_relaxed);
+
+	os_unfair_lock_lock(&mLock);
+}
+
+bool SFB::AdaptiveUnfairLock::TryLockContended(uint64_t hostTicks) noexcept
+{
+	mContentions.fetch_add(1, std::memory_order_relaxed);
+
+	const auto now = mach_absolute_time();
+	const auto deadline = hostTicks > std::numeric_limits<uint64_t>::max() - now ? std::numeric_limits<uint64_t>::max() : now + hostTicks;
+
+	uint32_t backoff = 1;
+	for(;;) {
+		Spin(backoff);
+		if(os_unfair_lock_trylock(&mLock))
+			return true;
+		if(mach_absolute_time() >= deadline)
+			break;
+		backoff = std::min(2 * backoff, kMaximumBackoff);
+	}
+
+	mTryLockFailures.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
@@ -0,0 +1,221 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cmath>
+
+#import <mach/mach_time.h>
+
+#import "SFBAudioClockBridge.hpp"
+
+namespace {
+
+/// Returns the number of host ticks per second
+Float64 HostTicksPerSecond() noexcept
+{
+	static const auto ticksPerSecond = [] {
+		mach_timebase_info_data_t timebaseInfo;
+		mach_timebase_info(&timebaseInfo);
+		return 1e9 * timebaseInfo.denom / timebaseInfo.numer;
+	}();
+	return ticksPerSecond;
+}
+
+/// The maximum fractional deviation of the estimated sample period from the nominal sample period
+constexpr Float64 kMaximumPeriodDeviation = 0.01;
+/// The maximum loop coefficient, limiting the correction applied after a long interval between updates
+constexpr Float64 kMaximumOmega = 0.5;
+/// The time in seconds over which a latency error is corrected
+constexpr Float64 kLatencyCorrectionSeconds = 2;
+/// The maximum fractional playback rate adjustment for latency correction
+constexpr Float64 kMaximumRateAdjustment = 0.001;
+
+} /* namespace */
+
+#pragma mark - AudioClockEstimator
+
+SFB::AudioClockEstimator::AudioClockEstimator(Float64 nominalSampleRate, Float64 bandwidth) noexcept
+: mNominalSampleRate{nominalSampleRate}, mBandwidth{bandwidth}, mNominalPeriod{HostTicksPerSecond() / nominalSampleRate}
+{}
+
+#pragma mark Updating
+
+bool SFB::AudioClockEstimator::Update(const AudioTimeStamp& timeStamp) noexcept
+{
+	if((timeStamp.mFlags & (kAudioTimeStampSampleTimeValid | kAudioTimeStampHostTimeValid)) != (kAudioTimeStampSampleTimeValid | kAudioTimeStampHostTimeValid))
+		return false;
+
+	const auto sampleTime = timeStamp.mSampleTime;
+	const auto hostTime = static_cast<Float64>(timeStamp.mHostTime);
+
+	if(!mValid.load(std::memory_order_relaxed)) {
+		Initialize(sampleTime, hostTime);
+		return true;
+	}
+
+	const auto frames = sampleTime - mState.mSampleTime;
+	if(frames <= 0) {
+		// Sample time moving backward indicates a discontinuity
+		if(frames < 0)
+			Initialize(sampleTime, hostTime);
+		return frames < 0;
+	}
+
+	// The error between the measured and predicted host times drives the loop
+	const auto predictedHostTime = mState.mHostTime + frames * mState.mPeriod;
+	const auto error = hostTime - predictedHostTime;
+
+	// An error larger than half the elapsed interval indicates a discontinuity
+	if(std::abs(error) > 0.5 * frames * mState.mPeriod) {
+		Initialize(sampleTime, hostTime);
+		return true;
+	}
+
+	// The loop coefficients scale with the elapsed time so irregular update intervals are handled correctly
+	const auto omega = std::min(2 * M_PI * mBandwidth * frames * mState.mPeriod / HostTicksPerSecond(), kMaximumOmega);
+	const auto b = M_SQRT2 * omega;
+	const auto c = omega * omega;
+
+	State state{ sampleTime, predictedHostTime + b * error, mState.mPeriod + c * error / frames };
+	if(std::abs(state.mPeriod - mNominalPeriod) > kMaximumPeriodDeviation * mNominalPeriod) {
+		Initialize(sampleTime, hostTime);
+		return true;
+	}
+
+	mState = state;
+	StoreState(state);
+	mUpdateCount.fetch_add(1, std::memory_order_relaxed);
+
+	return true;
+}
+
+void SFB::AudioClockEstimator::Reset() noexcept
+{
+	mValid.store(false, std::memory_order_release);
+	mUpdateCount.store(0, std::memory_order_relaxed);
+}
+
+#pragma mark Estimate
+
+std::optional<Float64> SFB::AudioClockEstimator::SampleRate() const noexcept
+{
+	auto state = LoadState();
+	if(!state)
+		return std::nullopt;
+	return HostTicksPerSecond() / state->mPeriod;
+}
+
+std::optional<Float64> SFB::AudioClockEstimator::RateScalar() const noexcept
+{
+	auto state = LoadState();
+	if(!state)
+		return std::nullopt;
+	return state->mPeriod / mNominalPeriod;
+}
+
+std::optional<Float64> SFB::AudioClockEstimator::SampleTimeAtHostTime(UInt64 hostTime) const noexcept
+{
+	auto state = LoadState();
+	if(!state)
+		return std::nullopt;
+	return state->mSampleTime + (static_cast<Float64>(hostTime) - state->mHostTime) / state->mPeriod;
+}
+
+std::optional<UInt64> SFB::AudioClockEstimator::HostTimeAtSampleTime(Float64 sampleTime) const noexcept
+{
+	auto state = LoadState();
+	if(!state)
+		return std::nullopt;
+	const auto hostTime = state->mHostTime + (sampleTime - state->mSampleTime) * state->mPeriod;
+	if(hostTime < 0)
+		return std::nullopt;
+	return static_cast<UInt64>(std::llround(hostTime));
+}
+
+#pragma mark Internals
+
+std::optional<SFB::AudioClockEstimator::State> SFB::AudioClockEstimator::LoadState() const noexcept
+{
+	for(;;) {
+		const auto sequence = mSequence.load(std::memory_order_acquire);
+		if(sequence & 1)
+			continue;
+
+		const auto valid = mValid.load(std::memory_order_relaxed);
+		State state{ mPublishedSampleTime.load(std::memory_order_relaxed), mPublishedHostTime.load(std::memory_order_relaxed), mPublishedPeriod.load(std::memory_order_relaxed) };
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(mSequence.load(std::memory_order_relaxed) != sequence)
+			continue;
+
+		if(!valid)
+			return std::nullopt;
+		return state;
+	}
+}
+
+void SFB::AudioClockEstimator::StoreState(const State& state) noexcept
+{
+	mSequence.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	mPublishedSampleTime.store(state.mSampleTime, std::memory_order_relaxed);
+	mPublishedHostTime.store(state.mHostTime, std::memory_order_relaxed);
+	mPublishedPeriod.store(state.mPeriod, std::memory_order_relaxed);
+	mValid.store(true, std::memory_order_relaxed);
+	mSequence.fetch_add(1, std::memory_order_release);
+}
+
+void SFB::AudioClockEstimator::Initialize(Float64 sampleTime, Float64 hostTime) noexcept
+{
+	mState = { sampleTime, hostTime, mNominalPeriod };
+	StoreState(mState);
+	mUpdateCount.store(0, std::memory_order_relaxed);
+}
+
+#pragma mark - AudioClockBridge
+
+#pragma mark Rate
+
+std::optional<Float64> SFB::AudioClockBridge::RateRatio() const noexcept
+{
+	auto inputSampleRate = mInputClock.SampleRate();
+	auto outputSampleRate = mOutputClock.SampleRate();
+	if(!inputSampleRate || !outputSampleRate)
+		return std::nullopt;
+	return *inputSampleRate / *outputSampleRate;
+}
+
+std::optional<Float64> SFB::AudioClockBridge::PlaybackRate() const noexcept
+{
+	auto rateRatio = RateRatio();
+	if(!rateRatio)
+		return std::nullopt;
+	return *rateRatio * mOutputClock.NominalSampleRate() / mInputClock.NominalSampleRate();
+}
+
+std::optional<Float64> SFB::AudioClockBridge::CorrectedPlaybackRate(Float64 readSampleTime, UInt64 hostTime) const noexcept
+{
+	auto playbackRate = PlaybackRate();
+	auto writeSampleTime = mInputClock.SampleTimeAtHostTime(hostTime);
+	if(!playbackRate || !writeSampleTime)
+		return std::nullopt;
+
+	// Excess latency is corrected by consuming input slightly faster, and insufficient latency by consuming it slower
+	const auto latencyError = (*writeSampleTime - readSampleTime) - mTargetLatencyFrames;
+	const auto adjustment = std::clamp(latencyError / (kLatencyCorrectionSeconds * mInputClock.NominalSampleRate()), -kMaximumRateAdjustment, kMaximumRateAdjustment);
+
+	return *playbackRate * (1 + adjustment);
+}
+
+#pragma mark Reading
+
+bool SFB::AudioClockBridge::Read(CARingBuffer& ringBuffer, AudioBufferList * const bufferList, uint32_t frameCount, UInt64 hostTime) const noexcept
+{
+	auto sampleTime = ReadSampleTimeAtHostTime(hostTime);
+	if(!sampleTime)
+		return false;
+	return ringBuffer.Read(bufferList, frameCount, static_cast<int64_t>(std::llround(*sampleTime)));
+}
@@ -0,0 +1,310 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <array>
+#import <cmath>
+#import <limits>
+#import <stdexcept>
+
+#import <Accelerate/Accelerate.h>
+
+#import "SFBAudioMeter.hpp"
+
+namespace {
+
+/// The true peak oversampling factor
+constexpr UInt32 kTruePeakPhases = 4;
+/// The number of true peak filter taps per phase
+constexpr UInt32 kTruePeakTaps = 12;
+/// The number of samples of history required by the true peak filter
+constexpr UInt32 kTruePeakHistoryLength = kTruePeakTaps - 1;
+
+/// The number of samples examined between checks when detecting silence
+constexpr size_t kSilenceChunkSamples = 256;
+
+/// The true peak interpolation filter stored by phase
+using TruePeakFilter = std::array<std::array<Float32, kTruePeakTaps>, kTruePeakPhases>;
+
+/// Returns a Blackman-windowed sinc interpolation filter for 4x oversampling
+///
+/// Phase @c p computes the sample at @c p/4 of the way between input samples. Each phase is normalized to unity gain
+/// at DC.
+const TruePeakFilter& TruePeakCoefficients() noexcept
+{
+	static const auto filter = [] {
+		constexpr auto length = kTruePeakPhases * kTruePeakTaps;
+		constexpr auto center = length / 2;
+
+		TruePeakFilter filter;
+		for(UInt32 phase = 0; phase < kTruePeakPhases; ++phase) {
+			Float64 sum = 0;
+			for(UInt32 tap = 0; tap < kTruePeakTaps; ++tap) {
+				const auto n = phase + tap * kTruePeakPhases;
+				const auto x = M_PI * (static_cast<Float64>(n) - center) / kTruePeakPhases;
+				const auto sinc = x == 0 ? 1 : std::sin(x) / x;
+				const auto window = 0.42 - 0.5 * std::cos(2 * M_PI * n / length) + 0.08 * std::cos(4 * M_PI * n / length);
+				filter[phase][tap] = static_cast<Float32>(sinc * window);
+				sum += filter[phase][tap];
+			}
+			for(auto& coefficient : filter[phase])
+				coefficient = static_cast<Float32>(coefficient / sum);
+		}
+		return filter;
+	}();
+	return filter;
+}
+
+/// Returns @c true if @c bufferList has the layout described by @c format and at least @c frameCount frames in each buffer
+bool ValidateBufferList(const AudioBufferList& bufferList, const SFB::CAStreamBasicDescription& format, UInt32 frameCount) noexcept
+{
+	if(bufferList.mNumberBuffers != format.ChannelStreamCount())
+		return false;
+
+	const auto bytesPerBuffer = static_cast<size_t>(frameCount) * format.mBytesPerFrame;
+	for(UInt32 i = 0; i < bufferList.mNumberBuffers; ++i) {
+		if(!bufferList.mBuffers[i].mData || bufferList.mBuffers[i].mDataByteSize < bytesPerBuffer)
+			return false;
+	}
+
+	return true;
+}
+
+/// A pointer to the samples of one channel and the distance between them
+struct ChannelSamples {
+	/// The first sample
+	const void *mData;
+	/// The distance between samples
+	vDSP_Stride mStride;
+};
+
+/// Returns the samples for @c channel in @c bufferList
+ChannelSamples Samples(const AudioBufferList& bufferList, const SFB::CAStreamBasicDescription& format, UInt32 channel) noexcept
+{
+	if(format.IsInterleaved())
+		return { static_cast<const uint8_t *>(bufferList.mBuffers[0].mData) + channel * format.SampleWordSize(), static_cast<vDSP_Stride>(format.mChannelsPerFrame) };
+	return { bufferList.mBuffers[channel].mData, 1 };
+}
+
+/// Converts @c count samples starting at sample @c offset to @c Float32
+/// @return The factor scaling the converted samples to full scale
+Float32 ConvertSamples(const ChannelSamples& samples, SFB::CommonPCMFormat format, UInt32 offset, Float32 *destination, vDSP_Length count) noexcept
+{
+	const auto start = static_cast<vDSP_Stride>(offset) * samples.mStride;
+	switch(format) {
+		case SFB::CommonPCMFormat::float32: {
+			const Float32 one = 1;
+			vDSP_vsmul(static_cast<const Float32 *>(samples.mData) + start, samples.mStride, &one, destination, 1, count);
+			return 1;
+		}
+		case SFB::CommonPCMFormat::float64:
+			vDSP_vdpsp(static_cast<const Float64 *>(samples.mData) + start, samples.mStride, destination, 1, count);
+			return 1;
+		case SFB::CommonPCMFormat::int16:
+			vDSP_vflt16(static_cast<const int16_t *>(samples.mData) + start, samples.mStride, destination, 1, count);
+			return 1.f / (1 << 15);
+		case SFB::CommonPCMFormat::int32:
+			vDSP_vflt32(static_cast<const int32_t *>(samples.mData) + start, samples.mStride, destination, 1, count);
+			return 1.f / (1u << 31);
+	}
+	return 1;
+}
+
+/// Returns @c true if no sample in @c samples has a magnitude exceeding @c threshold
+bool SamplesAreSilent(const Float32 *samples, size_t count, Float32 threshold) noexcept
+{
+	for(size_t i = 0; i < count; i += kSilenceChunkSamples) {
+		Float32 peak;
+		vDSP_maxmgv(samples + i, 1, &peak, std::min(kSilenceChunkSamples, count - i));
+		if(peak > threshold)
+			return false;
+	}
+	return true;
+}
+
+/// Returns @c true if no sample in @c samples has a magnitude exceeding @c threshold
+bool SamplesAreSilent(const Float64 *samples, size_t count, Float32 threshold) noexcept
+{
+	for(size_t i = 0; i < count; i += kSilenceChunkSamples) {
+		Float64 peak;
+		vDSP_maxmgvD(samples + i, 1, &peak, std::min(kSilenceChunkSamples, count - i));
+		if(peak > threshold)
+			return false;
+	}
+	return true;
+}
+
+/// Returns @c true if no sample in @c samples has a magnitude exceeding @c threshold
+template <typename T>
+bool SamplesAreSilent(const T *samples, size_t count, Float32 threshold) noexcept
+{
+	constexpr auto fullScale = -static_cast<Float64>(std::numeric_limits<T>::min());
+	const auto limit = static_cast<T>(std::min(std::floor(std::clamp(threshold, 0.f, 1.f) * fullScale), static_cast<Float64>(std::numeric_limits<T>::max())));
+
+	// The inner loop is free of branches so it may be vectorized
+	for(size_t i = 0; i < count; i += kSilenceChunkSamples) {
+		const auto end = std::min(i + kSilenceChunkSamples, count);
+		bool exceeded = false;
+		for(auto j = i; j < end; ++j)
+			exceeded |= (samples[j] > limit) | (samples[j] < -limit);
+		if(exceeded)
+			return false;
+	}
+	return true;
+}
+
+} /* namespace */
+
+#pragma mark Creation and Destruction
+
+SFB::AudioMeter::AudioMeter(const CAStreamBasicDescription& format, bool measureTruePeak)
+: mFormat{format}
+{
+	if(!format.CommonFormat())
+		throw std::invalid_argument("Format is not a common PCM format");
+
+	const auto channelCount = format.ChannelCount();
+	mChannels = std::make_unique<ChannelLevels[]>(channelCount);
+	mScratch = std::make_unique<Float32[]>(kTruePeakHistoryLength + sMaximumChunkFrames);
+	if(measureTruePeak) {
+		// Compute the filter now rather than on the first call to Process()
+		TruePeakCoefficients();
+		mTruePeakHistory = std::make_unique<Float32[]>(channelCount * kTruePeakHistoryLength);
+		mInterpolated = std::make_unique<Float32[]>(sMaximumChunkFrames);
+	}
+}
+
+#pragma mark Metering
+
+bool SFB::AudioMeter::Process(const AudioBufferList& bufferList, UInt32 frameCount) noexcept
+{
+	if(!ValidateBufferList(bufferList, mFormat, frameCount))
+		return false;
+	if(frameCount == 0)
+		return true;
+
+	const auto format = *mFormat.CommonFormat();
+	const auto& filter = TruePeakCoefficients();
+
+	for(UInt32 channel = 0; channel < ChannelCount(); ++channel) {
+		auto& levels = mChannels[channel];
+		const auto samples = Samples(bufferList, mFormat, channel);
+
+		// Floating-point samples are metered in place unless they must be filtered
+		if(!mTruePeakHistory && format == CommonPCMFormat::float32) {
+			Float32 peak, sumOfSquares;
+			vDSP_maxmgv(static_cast<const Float32 *>(samples.mData), samples.mStride, &peak, frameCount);
+			vDSP_svesq(static_cast<const Float32 *>(samples.mData), samples.mStride, &sumOfSquares, frameCount);
+			levels.mPeak = std::max(levels.mPeak, peak);
+			levels.mSumOfSquares += sumOfSquares;
+			continue;
+		}
+		else if(!mTruePeakHistory && format == CommonPCMFormat::float64) {
+			Float64 peak, sumOfSquares;
+			vDSP_maxmgvD(static_cast<const Float64 *>(samples.mData), samples.mStride, &peak, frameCount);
+			vDSP_svesqD(static_cast<const Float64 *>(samples.mData), samples.mStride, &sumOfSquares, frameCount);
+			levels.mPeak = std::max(levels.mPeak, static_cast<Float32>(peak));
+			levels.mSumOfSquares += sumOfSquares;
+			continue;
+		}
+
+		// The filter history immediately precedes the converted samples
+		auto history = mTruePeakHistory ? mTruePeakHistory.get() + channel * kTruePeakHistoryLength : nullptr;
+		auto converted = mScratch.get() + kTruePeakHistoryLength;
+
+		for(UInt32 offset = 0; offset < frameCount; ) {
+			const auto count = std::min(sMaximumChunkFrames, frameCount - offset);
+			const auto scale = ConvertSamples(samples, format, offset, converted, count);
+
+			Float32 peak, sumOfSquares;
+			vDSP_maxmgv(converted, 1, &peak, count);
+			vDSP_svesq(converted, 1, &sumOfSquares, count);
+			levels.mPeak = std::max(levels.mPeak, peak * scale);
+			levels.mSumOfSquares += static_cast<Float64>(sumOfSquares) * scale * scale;
+
+			if(history) {
+				std::copy(history, history + kTruePeakHistoryLength, mScratch.get());
+
+				// Phase 0 reproduces the input samples, which are already included in the sample peak
+				for(UInt32 phase = 1; phase < kTruePeakPhases; ++phase) {
+					// Convolution with the reversed filter yields y[n] = sum h[k]x[n-k]
+					vDSP_conv(mScratch.get(), 1, filter[phase].data() + kTruePeakTaps - 1, -1, mInterpolated.get(), 1, count, kTruePeakTaps);
+					Float32 truePeak;
+					vDSP_maxmgv(mInterpolated.get(), 1, &truePeak, count);
+					levels.mTruePeak = std::max(levels.mTruePeak, truePeak * scale);
+				}
+
+				std::copy(mScratch.get() + count, mScratch.get() + count + kTruePeakHistoryLength, history);
+			}
+
+			offset += count;
+		}
+	}
+
+	mFrameCount += frameCount;
+	return true;
+}
+
+void SFB::AudioMeter::Reset() noexcept
+{
+	std::fill_n(mChannels.get(), ChannelCount(), ChannelLevels{});
+	if(mTruePeakHistory)
+		std::fill_n(mTruePeakHistory.get(), ChannelCount() * kTruePeakHistoryLength, 0.f);
+	mFrameCount = 0;
+}
+
+#pragma mark Levels
+
+Float32 SFB::AudioMeter::RMS(UInt32 channel) const noexcept
+{
+	if(channel >= ChannelCount() || mFrameCount == 0)
+		return 0;
+	return static_cast<Float32>(std::sqrt(mChannels[channel].mSumOfSquares / mFrameCount));
+}
+
+bool SFB::AudioMeter::IsSilent(Float32 threshold) const noexcept
+{
+	for(UInt32 channel = 0; channel < ChannelCount(); ++channel) {
+		if(mChannels[channel].mPeak > threshold)
+			return false;
+	}
+	return true;
+}
+
+#pragma mark Silence Detection
+
+bool SFB::AudioMeter::IsSilent(const AudioBufferList& bufferList, const CAStreamBasicDescription& format, UInt32 frameCount, Float32 threshold) noexcept
+{
+	const auto commonFormat = format.CommonFormat();
+	if(!commonFormat || !ValidateBufferList(bufferList, format, frameCount))
+		return false;
+
+	// Every sample in each buffer is examined regardless of the channel to which it belongs
+	const auto sampleCount = static_cast<size_t>(frameCount) * format.InterleavedChannelCount();
+	for(UInt32 i = 0; i < bufferList.mNumberBuffers; ++i) {
+		const auto data = bufferList.mBuffers[i].mData;
+		bool silent = false;
+		switch(*commonFormat) {
+			case CommonPCMFormat::float32:	silent = SamplesAreSilent(static_cast<const Float32 *>(data), sampleCount, threshold);	break;
+			case CommonPCMFormat::float64:	silent = SamplesAreSilent(static_cast<const Float64 *>(data), sampleCount, threshold);	break;
+			case CommonPCMFormat::int16:	silent = SamplesAreSilent(static_cast<const int16_t *>(data), sampleCount, threshold);	break;
+			case CommonPCMFormat::int32:	silent = SamplesAreSilent(static_cast<const int32_t *>(data), sampleCount, threshold);	break;
+		}
+		if(!silent)
+			return false;
+	}
+
+	return true;
+}
+
+#pragma mark Utilities
+
+Float32 SFB::AudioMeter::ConvertToDecibels(Float32 amplitude) noexcept
+{
+	if(amplitude <= 0)
+		return -std::numeric_limits<Float32>::infinity();
+	return 20 * std::log10(amplitude);
+}
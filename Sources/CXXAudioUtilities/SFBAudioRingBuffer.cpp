@@ -1,16 +1,21 @@
 //
-// Copyright © 2013-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2013-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
 
 #import <algorithm>
 #import <cassert>
+#import <cstddef>
 #import <cstdlib>
 #import <cstring>
 #import <limits>
 
+#import <mach/mach.h>
+#import <mach/mach_vm.h>
+
 #import "SFBAudioRingBuffer.hpp"
+#import "SFBChannelBuffers.hpp"
 
 namespace {
 
@@ -48,6 +53,27 @@ void FetchABL(AudioBufferList * const _Nonnull bufferList, uint32_t dstOffset, c
 	}
 }
 
+/// Returns the size in bytes of an @c AudioBufferList containing @c bufferCount buffers
+/// @param bufferCount The number of buffers
+/// @return The size in bytes of the @c AudioBufferList
+constexpr size_t BufferListSize(uint32_t bufferCount) noexcept
+{
+	return offsetof(AudioBufferList, mBuffers) + (sizeof(AudioBuffer) * bufferCount);
+}
+
+/// Sets the buffers in @c bufferList to point to a region of @c buffers
+/// @param bufferList The buffer list to modify
+/// @param buffers The source buffers
+/// @param byteOffset The byte offset in @c buffers of the region
+/// @param byteCount The number of bytes per non-interleaved buffer in the region
+void SetBufferListRegion(AudioBufferList * const _Nonnull bufferList, void * const _Nonnull * const _Nonnull buffers, uint32_t byteOffset, uint32_t byteCount) noexcept
+{
+	for(UInt32 i = 0; i < bufferList->mNumberBuffers; ++i) {
+		bufferList->mBuffers[i].mData = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(buffers[i]) + byteOffset);
+		bufferList->mBuffers[i].mDataByteSize = byteCount;
+	}
+}
+
 /// Returns the smallest power of two value greater than @c x
 /// @param x A value in the range [2..2147483648]
 /// @return The smallest power of two greater than @c x
@@ -58,11 +84,74 @@ constexpr uint32_t NextPowerOfTwo(uint32_t x) noexcept
 	return static_cast<uint32_t>(1 << (32 - __builtin_clz(x - 1)));
 }
 
+/// Allocates a region of virtual memory of @c byteCount bytes mapped twice at consecutive addresses
+/// @param byteCount The size of the region in bytes, which must be a multiple of the virtual memory page size
+/// @return The address of the region or @c nullptr on error
+void * _Nullable AllocateMirroredRegion(uint32_t byteCount) noexcept
+{
+	assert(byteCount % vm_page_size == 0);
+
+	const auto regionSize = static_cast<mach_vm_size_t>(byteCount);
+
+	// Reserve twice the required space; the pages are zero-filled
+	mach_vm_address_t address = 0;
+	auto result = mach_vm_allocate(mach_task_self(), &address, 2 * regionSize, VM_FLAGS_ANYWHERE);
+	if(result != KERN_SUCCESS)
+		return nullptr;
+
+	// Map the lower half onto the upper half, atomically replacing the upper half's pages
+	mach_vm_address_t mirrorAddress = address + regionSize;
+	vm_prot_t currentProtection, maximumProtection;
+	result = mach_vm_remap(mach_task_self(), &mirrorAddress, regionSize, 0, VM_FLAGS_FIXED | VM_FLAGS_OVERWRITE, mach_task_self(), address, FALSE, &currentProtection, &maximumProtection, VM_INHERIT_DEFAULT);
+	if(result != KERN_SUCCESS || mirrorAddress != address + regionSize) {
+		mach_vm_deallocate(mach_task_self(), address, 2 * regionSize);
+		return nullptr;
+	}
+
+	return reinterpret_cast<void *>(address);
+}
+
+/// Deallocates a region of virtual memory allocated by @c AllocateMirroredRegion
+/// @param region The address of the region
+/// @param byteCount The size of the region in bytes
+void DeallocateMirroredRegion(void * const _Nonnull region, uint32_t byteCount) noexcept
+{
+	mach_vm_deallocate(mach_task_self(), reinterpret_cast<mach_vm_address_t>(region), 2 * static_cast<mach_vm_size_t>(byteCount));
+}
+
+/// Allocates four @c AudioBufferList structures for @c format in one chunk of memory
+/// @param format The format of the audio described by the buffer lists
+/// @return The buffer lists or @c nullptr on error
+void * _Nullable AllocateBufferLists(const SFB::CAStreamBasicDescription& format) noexcept
+{
+	const auto bufferCount = format.ChannelStreamCount();
+	const auto bufferListSize = BufferListSize(bufferCount);
+	auto allocation = std::calloc(4, bufferListSize);
+	if(!allocation)
+		return nullptr;
+
+	for(auto i = 0; i < 4; ++i) {
+		auto bufferList = reinterpret_cast<AudioBufferList *>(reinterpret_cast<uintptr_t>(allocation) + (i * bufferListSize));
+		bufferList->mNumberBuffers = bufferCount;
+		for(UInt32 j = 0; j < bufferCount; ++j)
+			bufferList->mBuffers[j].mNumberChannels = format.InterleavedChannelCount();
+	}
+
+	return allocation;
+}
+
 } /* namespace */
 
 #pragma mark Buffer Management
 
-bool SFB::AudioRingBuffer::Allocate(const CAStreamBasicDescription& format, uint32_t capacityFrames) noexcept
+template <typename Counters>
+bool SFB::BasicAudioRingBuffer<Counters>::Allocate(const CAStreamBasicDescription& format, uint32_t capacityFrames) noexcept
+{
+	return Allocate(format, capacityFrames, sizeof(void *), false);
+}
+
+template <typename Counters>
+bool SFB::BasicAudioRingBuffer<Counters>::Allocate(const CAStreamBasicDescription& format, uint32_t capacityFrames, size_t alignment, bool padChannelStride) noexcept
 {
 	// Only non-interleaved formats are supported
 	if(format.IsInterleaved() || capacityFrames < 2 || capacityFrames > 0x80000000)
@@ -78,38 +167,110 @@ bool SFB::AudioRingBuffer::Allocate(const CAStreamBasicDescription& format, uint
 	mCapacityFrames = capacityFrames;
 	mCapacityFramesMask = capacityFrames - 1;
 
-	const auto capacityBytes = capacityFrames * format.mBytesPerFrame;
+	const auto capacityBytes = static_cast<size_t>(capacityFrames) * format.mBytesPerFrame;
 
 	// One memory allocation holds everything- first the pointers followed by the deinterleaved channels
-	const auto allocationSize = (capacityBytes + sizeof(void *)) * format.mChannelsPerFrame;
-	auto allocation = std::malloc(allocationSize);
-	if(!allocation)
+	mBuffers = detail::AllocateChannelBuffers(format.mChannelsPerFrame, capacityBytes, alignment, padChannelStride);
+	if(!mBuffers) {
+		mFormat.Reset();
+		mCapacityFrames = 0;
+		mCapacityFramesMask = 0;
 		return false;
+	}
 
-	// Zero the entire allocation
-	std::memset(allocation, 0, allocationSize);
+	mBufferLists = AllocateBufferLists(format);
+	if(!mBufferLists) {
+		std::free(mBuffers);
+		mBuffers = nullptr;
+		mFormat.Reset();
+		mCapacityFrames = 0;
+		mCapacityFramesMask = 0;
+		return false;
+	}
+
+	mReadPointer = 0;
+	mWritePointer = 0;
+
+	return true;
+}
+
+template <typename Counters>
+bool SFB::BasicAudioRingBuffer<Counters>::AllocateMirrored(const CAStreamBasicDescription& format, uint32_t capacityFrames) noexcept
+{
+	// Only non-interleaved formats are supported
+	if(format.IsInterleaved() || format.mBytesPerFrame == 0 || capacityFrames < 2 || capacityFrames > 0x80000000)
+		return false;
 
-	// Assign the pointers and channel buffers
-	auto address = reinterpret_cast<uintptr_t>(allocation);
+	Deallocate();
+
+	// Round up to the next power of two
+	capacityFrames = NextPowerOfTwo(capacityFrames);
+
+	// Each channel's buffer must be a multiple of the page size
+	// Since the page size is a power of two this is always satisfied once capacityFrames is a multiple of the page size
+	while((static_cast<uint64_t>(capacityFrames) * format.mBytesPerFrame) % vm_page_size != 0) {
+		if(capacityFrames == 0x80000000)
+			return false;
+		capacityFrames <<= 1;
+	}
+
+	const auto capacityBytes = static_cast<uint64_t>(capacityFrames) * format.mBytesPerFrame;
+	if(capacityBytes > 0x80000000)
+		return false;
+
+	auto bufferLists = AllocateBufferLists(format);
+	if(!bufferLists)
+		return false;
+
+	// The channel pointers are allocated separately from the channel buffers
+	auto buffers = static_cast<void **>(std::calloc(format.mChannelsPerFrame, sizeof(void *)));
+	if(!buffers) {
+		std::free(bufferLists);
+		return false;
+	}
 
-	mBuffers = reinterpret_cast<void **>(address);
-	address += format.mChannelsPerFrame * sizeof(void *);
 	for(UInt32 i = 0; i < format.mChannelsPerFrame; ++i) {
-		mBuffers[i] = reinterpret_cast<void *>(address);
-		address += capacityBytes;
+		buffers[i] = AllocateMirroredRegion(static_cast<uint32_t>(capacityBytes));
+		if(!buffers[i]) {
+			for(UInt32 j = 0; j < i; ++j)
+				DeallocateMirroredRegion(buffers[j], static_cast<uint32_t>(capacityBytes));
+			std::free(buffers);
+			std::free(bufferLists);
+			return false;
+		}
 	}
 
+	mFormat = format;
+
+	mBuffers = buffers;
+	mIsMirrored = true;
+
+	mBufferLists = bufferLists;
+
+	mCapacityFrames = capacityFrames;
+	mCapacityFramesMask = capacityFrames - 1;
+
 	mReadPointer = 0;
 	mWritePointer = 0;
 
 	return true;
 }
 
-void SFB::AudioRingBuffer::Deallocate() noexcept
+template <typename Counters>
+void SFB::BasicAudioRingBuffer<Counters>::Deallocate() noexcept
 {
 	if(mBuffers) {
+		if(mIsMirrored) {
+			const auto capacityBytes = mCapacityFrames * mFormat.mBytesPerFrame;
+			for(UInt32 i = 0; i < mFormat.mChannelsPerFrame; ++i)
+				DeallocateMirroredRegion(mBuffers[i], capacityBytes);
+		}
 		std::free(mBuffers);
 		mBuffers = nullptr;
+		mIsMirrored = false;
+
+		std::free(mBufferLists);
+		mBufferLists = nullptr;
 
 		mFormat.Reset();
 
@@ -121,13 +282,15 @@ void SFB::AudioRingBuffer::Deallocate() noexcept
 	}
 }
 
-void SFB::AudioRingBuffer::Reset() noexcept
+template <typename Counters>
+void SFB::BasicAudioRingBuffer<Counters>::Reset() noexcept
 {
 	mReadPointer = 0;
 	mWritePointer = 0;
 }
 
-uint32_t SFB::AudioRingBuffer::FramesAvailableToRead() const noexcept
+template <typename Counters>
+uint32_t SFB::BasicAudioRingBuffer<Counters>::FramesAvailableToRead() const noexcept
 {
 	const auto writePointer = mWritePointer.load(std::memory_order_acquire);
 	const auto readPointer = mReadPointer.load(std::memory_order_acquire);
@@ -138,7 +301,8 @@ uint32_t SFB::AudioRingBuffer::FramesAvailableToRead() const noexcept
 		return (writePointer - readPointer + mCapacityFrames) & mCapacityFramesMask;
 }
 
-uint32_t SFB::AudioRingBuffer::FramesAvailableToWrite() const noexcept
+template <typename Counters>
+uint32_t SFB::BasicAudioRingBuffer<Counters>::FramesAvailableToWrite() const noexcept
 {
 	const auto writePointer = mWritePointer.load(std::memory_order_acquire);
 	const auto readPointer = mReadPointer.load(std::memory_order_acquire);
@@ -153,7 +317,8 @@ uint32_t SFB::AudioRingBuffer::FramesAvailableToWrite() const noexcept
 
 #pragma mark Reading and Writing Audio
 
-uint32_t SFB::AudioRingBuffer::Read(AudioBufferList * const bufferList, uint32_t frameCount, bool allowPartial) noexcept
+template <typename Counters>
+uint32_t SFB::BasicAudioRingBuffer<Counters>::Read(AudioBufferList * const bufferList, uint32_t frameCount, bool allowPartial) noexcept
 {
 	if(!bufferList || frameCount == 0)
 		return 0;
@@ -167,11 +332,13 @@ uint32_t SFB::AudioRingBuffer::Read(AudioBufferList * const bufferList, uint32_t
 	else
 		framesAvailable = (writePointer - readPointer + mCapacityFrames) & mCapacityFramesMask;
 
+	mCounters.RecordRead(frameCount, framesAvailable, allowPartial);
+
 	if(framesAvailable == 0 || (framesAvailable < frameCount && !allowPartial))
 		return 0;
 
 	const auto framesToRead = std::min(framesAvailable, frameCount);
-	if(readPointer + framesToRead > mCapacityFrames) {
+	if(!mIsMirrored && readPointer + framesToRead > mCapacityFrames) {
 		const auto framesAfterReadPointer = mCapacityFrames - readPointer;
 		const auto bytesAfterReadPointer = framesAfterReadPointer * mFormat.mBytesPerFrame;
 		FetchABL(bufferList, 0, mBuffers, readPointer * mFormat.mBytesPerFrame, bytesAfterReadPointer);
@@ -190,7 +357,8 @@ uint32_t SFB::AudioRingBuffer::Read(AudioBufferList * const bufferList, uint32_t
 	return framesToRead;
 }
 
-uint32_t SFB::AudioRingBuffer::Write(const AudioBufferList * const bufferList, uint32_t frameCount, bool allowPartial) noexcept
+template <typename Counters>
+uint32_t SFB::BasicAudioRingBuffer<Counters>::Write(const AudioBufferList * const bufferList, uint32_t frameCount, bool allowPartial) noexcept
 {
 	if(!bufferList || frameCount == 0)
 		return 0;
@@ -206,11 +374,13 @@ uint32_t SFB::AudioRingBuffer::Write(const AudioBufferList * const bufferList, u
 	else
 		framesAvailable = mCapacityFrames - 1;
 
-	if(framesAvailable == 0 || (framesAvailable < frameCount && !allowPartial))
+	const auto framesToWrite = (framesAvailable < frameCount && !allowPartial) ? 0 : std::min(framesAvailable, frameCount);
+	mCounters.RecordWrite(frameCount, framesAvailable, allowPartial, mCapacityFramesMask - framesAvailable + framesToWrite);
+
+	if(framesToWrite == 0)
 		return 0;
 
-	const auto framesToWrite = std::min(framesAvailable, frameCount);
-	if(writePointer + framesToWrite > mCapacityFrames) {
+	if(!mIsMirrored && writePointer + framesToWrite > mCapacityFrames) {
 		auto framesAfterWritePointer = mCapacityFrames - writePointer;
 		auto bytesAfterWritePointer = framesAfterWritePointer * mFormat.mBytesPerFrame;
 		StoreABL(mBuffers, writePointer * mFormat.mBytesPerFrame, bufferList, 0, bytesAfterWritePointer);
@@ -223,3 +393,74 @@ uint32_t SFB::AudioRingBuffer::Write(const AudioBufferList * const bufferList, u
 
 	return framesToWrite;
 }
+
+#pragma mark Advanced Reading and Writing
+
+template <typename Counters>
+void SFB::BasicAudioRingBuffer<Counters>::AdvanceReadPosition(uint32_t frameCount) noexcept
+{
+	mReadPointer.store((mReadPointer.load(std::memory_order_acquire) + frameCount) & mCapacityFramesMask, std::memory_order_release);
+}
+
+template <typename Counters>
+void SFB::BasicAudioRingBuffer<Counters>::AdvanceWritePosition(uint32_t frameCount) noexcept
+{
+	mWritePointer.store((mWritePointer.load(std::memory_order_acquire) + frameCount) & mCapacityFramesMask, std::memory_order_release);
+}
+
+template <typename Counters>
+const typename SFB::BasicAudioRingBuffer<Counters>::ReadBufferPair SFB::BasicAudioRingBuffer<Counters>::ReadVector() const noexcept
+{
+	const auto framesAvailable = FramesAvailableToRead();
+	if(framesAvailable == 0)
+		return { {}, {} };
+
+	const auto readPointer = mReadPointer.load(std::memory_order_acquire);
+
+	const auto bufferListSize = BufferListSize(mFormat.ChannelStreamCount());
+	auto first = reinterpret_cast<AudioBufferList *>(mBufferLists);
+	auto second = reinterpret_cast<AudioBufferList *>(reinterpret_cast<uintptr_t>(mBufferLists) + bufferListSize);
+
+	// A mirrored buffer's readable audio is always contiguous
+	const auto endOfRead = readPointer + framesAvailable;
+	if(!mIsMirrored && endOfRead > mCapacityFrames) {
+		const auto framesAfterReadPointer = mCapacityFrames - readPointer;
+		SetBufferListRegion(first, mBuffers, readPointer * mFormat.mBytesPerFrame, framesAfterReadPointer * mFormat.mBytesPerFrame);
+		SetBufferListRegion(second, mBuffers, 0, (endOfRead & mCapacityFramesMask) * mFormat.mBytesPerFrame);
+		return { { first, framesAfterReadPointer }, { second, endOfRead & mCapacityFramesMask } };
+	}
+
+	SetBufferListRegion(first, mBuffers, readPointer * mFormat.mBytesPerFrame, framesAvailable * mFormat.mBytesPerFrame);
+	return { { first, framesAvailable }, {} };
+}
+
+template <typename Counters>
+const typename SFB::BasicAudioRingBuffer<Counters>::WriteBufferPair SFB::BasicAudioRingBuffer<Counters>::WriteVector() const noexcept
+{
+	const auto framesAvailable = FramesAvailableToWrite();
+	if(framesAvailable == 0)
+		return { {}, {} };
+
+	const auto writePointer = mWritePointer.load(std::memory_order_acquire);
+
+	const auto bufferListSize = BufferListSize(mFormat.ChannelStreamCount());
+	auto first = reinterpret_cast<AudioBufferList *>(reinterpret_cast<uintptr_t>(mBufferLists) + (2 * bufferListSize));
+	auto second = reinterpret_cast<AudioBufferList *>(reinterpret_cast<uintptr_t>(mBufferLists) + (3 * bufferListSize));
+
+	// A mirrored buffer's writable space is always contiguous
+	const auto endOfWrite = writePointer + framesAvailable;
+	if(!mIsMirrored && endOfWrite > mCapacityFrames) {
+		const auto framesAfterWritePointer = mCapacityFrames - writePointer;
+		SetBufferListRegion(first, mBuffers, writePointer * mFormat.mBytesPerFrame, framesAfterWritePointer * mFormat.mBytesPerFrame);
+		SetBufferListRegion(second, mBuffers, 0, (endOfWrite & mCapacityFramesMask) * mFormat.mBytesPerFrame);
+		return { { first, framesAfterWritePointer }, { second, endOfWrite & mCapacityFramesMask } };
+	}
+
+	SetBufferListRegion(first, mBuffers, writePointer * mFormat.mBytesPerFrame, framesAvailable * mFormat.mBytesPerFrame);
+	return { { first, framesAvailable }, {} };
+}
+
+#pragma mark Explicit Instantiations
+
+template class SFB::BasicAudioRingBuffer<SFB::NullRingBufferCounters>;
+template class SFB::BasicAudioRingBuffer<SFB::RingBufferCounters>;
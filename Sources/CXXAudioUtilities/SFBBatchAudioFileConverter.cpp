@@ -0,0 +1,201 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cerrno>
+#import <chrono>
+#import <cstring>
+#import <exception>
+#import <stdexcept>
+#import <system_error>
+#import <thread>
+
+#import <unistd.h>
+
+#import <sys/param.h>
+
+#import <os/log.h>
+
+#import "SFBBatchAudioFileConverter.hpp"
+#import "SFBCAExtAudioFile.hpp"
+
+namespace {
+
+/// Returns the number of seconds elapsed since @c start
+double SecondsSince(std::chrono::steady_clock::time_point start) noexcept
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Returns @c threadCount or the number of processors if @c threadCount is zero
+unsigned int ResolveThreadCount(unsigned int threadCount) noexcept
+{
+	return threadCount > 0 ? threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/// Deletes the file at @c url, logging any error
+void RemoveFile(CFURLRef url) noexcept
+{
+	char path [PATH_MAX];
+	if(!CFURLGetFileSystemRepresentation(url, true, reinterpret_cast<UInt8 *>(path), PATH_MAX)) {
+		os_log_error(OS_LOG_DEFAULT, "Unable to get file system representation of URL");
+		return;
+	}
+	if(unlink(path) == -1)
+		os_log_error(OS_LOG_DEFAULT, "Unable to remove partial output file \"%{public}s\": %{public}s", path, std::strerror(errno));
+}
+
+} /* namespace */
+
+#pragma mark Creation and Destruction
+
+SFB::BatchAudioFileConverter::BatchAudioFileConverter(unsigned int threadCount, UInt32 bufferFrameCapacity)
+: mThreadCount{ResolveThreadCount(threadCount)}, mBufferFrameCapacity{bufferFrameCapacity}, mBufferPool{ResolveThreadCount(threadCount)}
+{
+	if(bufferFrameCapacity == 0)
+		throw std::invalid_argument("bufferFrameCapacity == 0");
+}
+
+#pragma mark Jobs
+
+size_t SFB::BatchAudioFileConverter::AddJob(Job job)
+{
+	mJobs.push_back(std::move(job));
+	return mJobs.size() - 1;
+}
+
+#pragma mark Conversion
+
+std::vector<SFB::BatchAudioFileConverter::Result> SFB::BatchAudioFileConverter::Run(const ProgressCallback& progress)
+{
+	std::vector<Result> results(mJobs.size());
+
+	mNextJob.store(0, std::memory_order_relaxed);
+	mCancelled.store(false, std::memory_order_relaxed);
+
+	// Each result is written by exactly one worker
+	const auto worker = [&]() noexcept {
+		for(;;) {
+			const auto index = mNextJob.fetch_add(1, std::memory_order_relaxed);
+			if(index >= mJobs.size())
+				break;
+			results[index] = Convert(index, progress);
+		}
+	};
+
+	const auto workerCount = std::min(static_cast<size_t>(mThreadCount), mJobs.size());
+
+	std::vector<std::thread> threads;
+	threads.reserve(workerCount > 0 ? workerCount - 1 : 0);
+
+	// The calling thread is one of the workers
+	for(size_t i = 1; i < workerCount; ++i) {
+		try {
+			threads.emplace_back(worker);
+		}
+		catch(const std::system_error& e) {
+			os_log_error(OS_LOG_DEFAULT, "Unable to create conversion thread: %{public}s", e.what());
+			break;
+		}
+	}
+
+	worker();
+
+	for(auto& thread : threads)
+		thread.join();
+
+	return results;
+}
+
+SFB::BatchAudioFileConverter::Result SFB::BatchAudioFileConverter::Convert(size_t index, const ProgressCallback& progress) noexcept
+{
+	const auto& job = mJobs[index];
+	const auto start = std::chrono::steady_clock::now();
+
+	Result result;
+	bool outputCreated = false;
+
+	if(mCancelled.load(std::memory_order_relaxed)) {
+		result.mErrorDescription = "Cancelled";
+		return result;
+	}
+
+	try {
+		CAExtAudioFile input;
+		input.OpenURL(job.mInputURL);
+
+		const auto inputFormat = input.FileDataFormat();
+		result.mSampleRate = inputFormat.mSampleRate;
+
+		// The input file's layout is carried over when the output format doesn't change the channel count
+		CAChannelLayout channelLayout;
+		try {
+			channelLayout = input.FileChannelLayout();
+		}
+		catch(const std::system_error& e) {
+			os_log_error(OS_LOG_DEFAULT, "Unable to read channel layout for job %zu: %{public}s", index, e.what());
+		}
+
+		auto outputFormat = job.mOutputFormat;
+		if(outputFormat.mSampleRate == 0)
+			outputFormat.mSampleRate = inputFormat.mSampleRate;
+		if(outputFormat.mChannelsPerFrame == 0)
+			outputFormat.mChannelsPerFrame = inputFormat.mChannelsPerFrame;
+
+		const bool preserveChannelLayout = channelLayout && channelLayout.ChannelCount() == inputFormat.ChannelCount() && outputFormat.ChannelCount() == inputFormat.ChannelCount();
+
+		// Both files share a client format so the audio is transferred without an additional conversion
+		const CAStreamBasicDescription clientFormat{CommonPCMFormat::float32, inputFormat.mSampleRate, inputFormat.ChannelCount(), false};
+		input.SetClientDataFormat(clientFormat, preserveChannelLayout ? &channelLayout : nullptr);
+
+		CAExtAudioFile output;
+		output.CreateWithURL(job.mOutputURL, job.mFileType, outputFormat, preserveChannelLayout ? static_cast<const AudioChannelLayout *>(channelLayout) : nullptr, job.mFileFlags);
+		outputCreated = true;
+		output.SetClientDataFormat(clientFormat, preserveChannelLayout ? &channelLayout : nullptr);
+
+		auto buffer = mBufferPool.Acquire(clientFormat, mBufferFrameCapacity, false);
+		if(!buffer)
+			throw std::bad_alloc();
+
+		const auto totalFrames = input.FrameLength();
+
+		for(;;) {
+			if(mCancelled.load(std::memory_order_relaxed)) {
+				result.mErrorDescription = "Cancelled";
+				break;
+			}
+
+			input.Read(*buffer);
+			const auto frameCount = buffer->FrameLength();
+			if(frameCount == 0) {
+				output.Close();
+				result.mSucceeded = true;
+				break;
+			}
+
+			output.Write(frameCount, *buffer);
+			result.mFramesConverted += frameCount;
+
+			if(progress)
+				progress({index, result.mFramesConverted, totalFrames, SecondsSince(start)});
+		}
+	}
+	catch(const std::exception& e) {
+		os_log_error(OS_LOG_DEFAULT, "Error converting job %zu: %{public}s", index, e.what());
+		result.mSucceeded = false;
+		try {
+			result.mErrorDescription = e.what();
+		}
+		catch(...) {}
+	}
+
+	// The output file has been closed, so an incomplete file can be removed
+	if(outputCreated && !result.mSucceeded)
+		RemoveFile(job.mOutputURL);
+
+	result.mElapsedSeconds = SecondsSince(start);
+	return result;
+}
@@ -0,0 +1,258 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cmath>
+#import <exception>
+#import <limits>
+#import <new>
+
+#import <os/log.h>
+
+#import "SFBCAAUGraphCommandQueue.hpp"
+#import "SFBCAException.hpp"
+
+#pragma mark Creation and Destruction
+
+SFB::CAAUGraphCommandQueue::CAAUGraphCommandQueue(CAAUGraph& graph, uint32_t capacity)
+: mGraph{graph}
+{
+	if(!mCommands.Allocate(sizeof(Command), std::max(capacity, 2u)))
+		throw std::bad_alloc();
+
+	// Dequeued commands are held in preallocated storage so the render thread never allocates
+	mPendingCommands.reserve(mCommands.CapacityRecords());
+
+	mGraph.AddRenderNotify(RenderNotify, this);
+}
+
+SFB::CAAUGraphCommandQueue::~CAAUGraphCommandQueue()
+{
+	try {
+		mGraph.RemoveRenderNotify(RenderNotify, this);
+	}
+	catch(const std::exception& e) {
+		os_log_error(OS_LOG_DEFAULT, "Error removing AUGraph render notification: %{public}s", e.what());
+	}
+}
+
+#pragma mark Render Thread Commands
+
+bool SFB::CAAUGraphCommandQueue::SetParameter(AudioUnit unit, AudioUnitParameterID parameter, AudioUnitScope scope, AudioUnitElement element, AudioUnitParameterValue value, std::optional<Float64> sampleTime) noexcept
+{
+	return Enqueue({ Command::Type::setParameter, sampleTime.has_value(), sampleTime.value_or(0), unit, parameter, scope, element, value, value, 0, nullptr, nullptr });
+}
+
+bool SFB::CAAUGraphCommandQueue::RampParameter(AudioUnit unit, AudioUnitParameterID parameter, AudioUnitScope scope, AudioUnitElement element, AudioUnitParameterValue startValue, AudioUnitParameterValue endValue, UInt32 durationFrames, std::optional<Float64> sampleTime) noexcept
+{
+	// A ramp with no duration is a parameter change
+	if(durationFrames == 0)
+		return SetParameter(unit, parameter, scope, element, endValue, sampleTime);
+	return Enqueue({ Command::Type::rampParameter, sampleTime.has_value(), sampleTime.value_or(0), unit, parameter, scope, element, startValue, endValue, durationFrames, nullptr, nullptr });
+}
+
+bool SFB::CAAUGraphCommandQueue::Perform(PerformFunction function, void *context, std::optional<Float64> sampleTime) noexcept
+{
+	return Enqueue({ Command::Type::perform, sampleTime.has_value(), sampleTime.value_or(0), nullptr, 0, 0, 0, 0, 0, 0, function, context });
+}
+
+#pragma mark Graph Mutations
+
+void SFB::CAAUGraphCommandQueue::ConnectNodeInput(AUNode sourceNode, UInt32 sourceOutputNumber, AUNode destNode, UInt32 destInputNumber)
+{
+	std::lock_guard lock{mGraphChangesMutex};
+	mGraphChanges.push_back([this, sourceNode, sourceOutputNumber, destNode, destInputNumber] {
+		mGraph.ConnectNodeInput(sourceNode, sourceOutputNumber, destNode, destInputNumber);
+	});
+}
+
+void SFB::CAAUGraphCommandQueue::DisconnectNodeInput(AUNode destNode, UInt32 destInputNumber)
+{
+	std::lock_guard lock{mGraphChangesMutex};
+	mGraphChanges.push_back([this, destNode, destInputNumber] {
+		mGraph.DisconnectNodeInput(destNode, destInputNumber);
+	});
+}
+
+void SFB::CAAUGraphCommandQueue::SetNodeInputCallback(AUNode destNode, UInt32 destInputNumber, const AURenderCallbackStruct& inputCallback)
+{
+	std::lock_guard lock{mGraphChangesMutex};
+	mGraphChanges.push_back([this, destNode, destInputNumber, inputCallback] {
+		mGraph.SetNodeInputCallback(destNode, destInputNumber, &inputCallback);
+	});
+}
+
+void SFB::CAAUGraphCommandQueue::SetProperty(AudioUnit unit, AudioUnitPropertyID property, AudioUnitScope scope, AudioUnitElement element, const void *data, UInt32 dataSize)
+{
+	auto bytes = static_cast<const uint8_t *>(data);
+	std::vector<uint8_t> value(bytes, bytes + dataSize);
+
+	std::lock_guard lock{mGraphChangesMutex};
+	mGraphChanges.push_back([unit, property, scope, element, value = std::move(value)] {
+		auto result = AudioUnitSetProperty(unit, property, scope, element, value.data(), static_cast<UInt32>(value.size()));
+		ThrowIfCAAudioUnitError(result, "AudioUnitSetProperty");
+	});
+}
+
+bool SFB::CAAUGraphCommandQueue::CommitGraphChanges()
+{
+	std::vector<std::function<void()>> changes;
+
+	{
+		std::lock_guard lock{mGraphChangesMutex};
+		changes.swap(mGraphChanges);
+	}
+
+	if(changes.empty())
+		return true;
+
+	// A failed change does not prevent the remaining changes from being applied
+	std::exception_ptr error;
+	for(const auto& change : changes) {
+		try {
+			change();
+		}
+		catch(const std::exception& e) {
+			os_log_error(OS_LOG_DEFAULT, "Error applying AUGraph change: %{public}s", e.what());
+			if(!error)
+				error = std::current_exception();
+		}
+	}
+
+	if(!error)
+		return mGraph.Update();
+
+	// The changes that were applied take effect before the first error is reported
+	try {
+		mGraph.Update();
+	}
+	catch(const std::exception& e) {
+		os_log_error(OS_LOG_DEFAULT, "Error updating AUGraph: %{public}s", e.what());
+	}
+
+	std::rethrow_exception(error);
+}
+
+void SFB::CAAUGraphCommandQueue::DiscardGraphChanges() noexcept
+{
+	std::lock_guard lock{mGraphChangesMutex};
+	mGraphChanges.clear();
+}
+
+#pragma mark Internals
+
+bool SFB::CAAUGraphCommandQueue::Enqueue(const Command& command) noexcept
+{
+	return mCommands.WriteValue(command);
+}
+
+void SFB::CAAUGraphCommandQueue::ProcessCommands(Float64 sampleTime, UInt32 frameCount) noexcept
+{
+	// Commands without a sample time take effect at the start of the first render cycle in which they are seen
+	Command command;
+	while(mPendingCommands.size() < mPendingCommands.capacity() && mCommands.ReadValue(command)) {
+		if(!command.mHasSampleTime) {
+			command.mSampleTime = sampleTime;
+			command.mHasSampleTime = true;
+		}
+		command.mSupersededSampleTime = std::numeric_limits<Float64>::infinity();
+		mPendingCommands.push_back(command);
+	}
+
+	const auto endSampleTime = sampleTime + frameCount;
+
+	// A ramp is superseded by a later command for the same parameter once that command takes effect
+	// Commands with the same sample time take effect in the order in which they were enqueued
+	for(auto ramp = mPendingCommands.begin(); ramp != mPendingCommands.end(); ++ramp) {
+		if(ramp->mType != Command::Type::rampParameter)
+			continue;
+		for(auto other = mPendingCommands.begin(); other != mPendingCommands.end(); ++other) {
+			if(other == ramp || other->mType == Command::Type::perform || other->mSampleTime >= endSampleTime)
+				continue;
+			if(other->mUnit != ramp->mUnit || other->mParameter != ramp->mParameter || other->mScope != ramp->mScope || other->mElement != ramp->mElement)
+				continue;
+			if(other->mSampleTime > ramp->mSampleTime || (other->mSampleTime == ramp->mSampleTime && other > ramp))
+				ramp->mSupersededSampleTime = std::min(ramp->mSupersededSampleTime, other->mSampleTime);
+		}
+	}
+
+	auto processed = std::remove_if(mPendingCommands.begin(), mPendingCommands.end(), [&](const Command& command) {
+		if(command.mSampleTime >= endSampleTime)
+			return false;
+
+		// Late commands take effect at the start of the render cycle
+		const auto offset = static_cast<SInt64>(std::floor(command.mSampleTime - sampleTime));
+
+		switch(command.mType) {
+			case Command::Type::setParameter: {
+				AudioUnitParameterEvent event{ command.mScope, command.mElement, command.mParameter, kParameterEvent_Immediate, {} };
+				event.eventValues.immediate.bufferOffset = static_cast<UInt32>(std::max<SInt64>(offset, 0));
+				event.eventValues.immediate.value = command.mStartValue;
+				AudioUnitScheduleParameters(command.mUnit, &event, 1);
+				return true;
+			}
+
+			case Command::Type::rampParameter: {
+				auto durationFrames = static_cast<SInt64>(command.mDurationFrames);
+				auto endValue = command.mEndValue;
+
+				// A superseded ramp is truncated where the superseding command takes effect and then discarded
+				const auto isSuperseded = command.mSupersededSampleTime < endSampleTime;
+				if(isSuperseded) {
+					const auto supersededOffset = std::max<SInt64>(static_cast<SInt64>(std::floor(command.mSupersededSampleTime - sampleTime)), 0);
+					const auto truncatedFrames = supersededOffset - offset;
+					if(truncatedFrames < durationFrames) {
+						if(truncatedFrames > 0)
+							endValue = command.mStartValue + (command.mEndValue - command.mStartValue) * static_cast<AudioUnitParameterValue>(truncatedFrames) / static_cast<AudioUnitParameterValue>(durationFrames);
+						durationFrames = truncatedFrames;
+					}
+				}
+
+				const auto rampEnd = offset + durationFrames;
+				if(rampEnd <= 0) {
+					// The superseding command alone determines the value in this render cycle
+					if(isSuperseded)
+						return true;
+
+					// A ramp that ended before this render cycle is applied as a parameter change
+					AudioUnitParameterEvent event{ command.mScope, command.mElement, command.mParameter, kParameterEvent_Immediate, {} };
+					event.eventValues.immediate.bufferOffset = 0;
+					event.eventValues.immediate.value = endValue;
+					AudioUnitScheduleParameters(command.mUnit, &event, 1);
+					return true;
+				}
+
+				// A ramp in progress is rescheduled each render cycle with a negative start offset
+				AudioUnitParameterEvent event{ command.mScope, command.mElement, command.mParameter, kParameterEvent_Ramped, {} };
+				event.eventValues.ramp.startBufferOffset = static_cast<SInt32>(std::max<SInt64>(offset, std::numeric_limits<SInt32>::min()));
+				event.eventValues.ramp.durationInFrames = static_cast<UInt32>(durationFrames);
+				event.eventValues.ramp.startValue = command.mStartValue;
+				event.eventValues.ramp.endValue = endValue;
+				AudioUnitScheduleParameters(command.mUnit, &event, 1);
+				return isSuperseded || rampEnd <= static_cast<SInt64>(frameCount);
+			}
+
+			case Command::Type::perform:
+				command.mFunction(command.mContext);
+				return true;
+		}
+
+		return true;
+	});
+
+	mPendingCommands.erase(processed, mPendingCommands.end());
+}
+
+OSStatus SFB::CAAUGraphCommandQueue::RenderNotify(void *inRefCon, AudioUnitRenderActionFlags *ioActionFlags, const AudioTimeStamp *inTimeStamp, UInt32 inBusNumber, UInt32 inNumberFrames, AudioBufferList *ioData) noexcept
+{
+#pragma unused(ioData)
+
+	if(!(*ioActionFlags & kAudioUnitRenderAction_PreRender) || inBusNumber != 0 || !(inTimeStamp->mFlags & kAudioTimeStampSampleTimeValid))
+		return noErr;
+
+	static_cast<CAAUGraphCommandQueue *>(inRefCon)->ProcessCommands(inTimeStamp->mSampleTime, inNumberFrames);
+	return noErr;
+}
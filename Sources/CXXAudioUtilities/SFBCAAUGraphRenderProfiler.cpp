@@ -0,0 +1,244 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cmath>
+#import <stdexcept>
+
+#import <mach/mach_time.h>
+#import <os/log.h>
+#import <os/signpost.h>
+
+#import "SFBCAAUGraphRenderProfiler.hpp"
+#import "SFBCAException.hpp"
+
+namespace {
+
+/// Returns the number of host ticks per second
+Float64 HostTicksPerSecond() noexcept
+{
+	static const auto ticksPerSecond = [] {
+		mach_timebase_info_data_t timebaseInfo;
+		mach_timebase_info(&timebaseInfo);
+		return 1e9 * timebaseInfo.denom / timebaseInfo.numer;
+	}();
+	return ticksPerSecond;
+}
+
+/// Returns the log used for render signposts
+os_log_t RenderLog() noexcept
+{
+	static const auto log = os_log_create("org.sbooth.CXXAudioUtilities", "Render");
+	return log;
+}
+
+/// Returns the histogram bucket for @c duration
+size_t HistogramBucket(uint64_t duration) noexcept
+{
+	if(duration < 2)
+		return 0;
+	const auto bucket = static_cast<size_t>(63 - __builtin_clzll(duration));
+	return std::min(bucket, SFB::CAAUGraphRenderProfiler::sHistogramBucketCount - 1);
+}
+
+/// Increments a counter modified by a single thread
+void Increment(std::atomic_uint64_t& counter, uint64_t value = 1) noexcept
+{
+	counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+/// Raises a maximum modified by a single thread
+void Maximize(std::atomic_uint64_t& maximum, uint64_t value) noexcept
+{
+	if(value > maximum.load(std::memory_order_relaxed))
+		maximum.store(value, std::memory_order_relaxed);
+}
+
+} /* namespace */
+
+#pragma mark Creation and Destruction
+
+SFB::CAAUGraphRenderProfiler::CAAUGraphRenderProfiler(CAAUGraph& graph, Float64 sampleRate, UInt32 bufferFrameSize, bool emitSignposts)
+: mDeadline{sampleRate > 0 ? static_cast<uint64_t>(std::llround(bufferFrameSize / sampleRate * HostTicksPerSecond())) : 0}, mEmitSignposts{emitSignposts}
+{
+	if(!(sampleRate > 0))
+		throw std::invalid_argument("sampleRate <= 0");
+	if(bufferFrameSize == 0)
+		throw std::invalid_argument("bufferFrameSize == 0");
+	if(!graph.IsOpen())
+		throw std::invalid_argument("AUGraph not open");
+
+	const auto nodeCount = graph.GetNodeCount();
+	mNodes = std::make_unique<Node[]>(nodeCount);
+	mRenderStack = std::make_unique<Node *[]>(nodeCount);
+
+	for(UInt32 i = 0; i < nodeCount; ++i) {
+		const auto node = graph.GetIndNode(i);
+#if !TARGET_OS_IPHONE
+		// Sub graphs have no audio unit to profile
+		if(graph.IsNodeSubGraph(node))
+			continue;
+#endif /* !TARGET_OS_IPHONE */
+
+		AudioUnit audioUnit = nullptr;
+		graph.NodeInfo(node, nullptr, &audioUnit);
+		if(!audioUnit)
+			continue;
+
+		auto& record = mNodes[mNodeCount++];
+		record.mNode = node;
+		record.mAudioUnit = audioUnit;
+		record.mProfiler = this;
+	}
+
+	try {
+		for(size_t i = 0; i < mNodeCount; ++i) {
+			auto result = AudioUnitAddRenderNotify(mNodes[i].mAudioUnit, RenderNotify, &mNodes[i]);
+			ThrowIfCAAudioUnitError(result, "AudioUnitAddRenderNotify");
+			mNodes[i].mNotifyAdded = true;
+		}
+	}
+	catch(...) {
+		for(size_t i = 0; i < mNodeCount; ++i) {
+			if(mNodes[i].mNotifyAdded)
+				AudioUnitRemoveRenderNotify(mNodes[i].mAudioUnit, RenderNotify, &mNodes[i]);
+		}
+		throw;
+	}
+}
+
+SFB::CAAUGraphRenderProfiler::~CAAUGraphRenderProfiler()
+{
+	for(size_t i = 0; i < mNodeCount; ++i) {
+		auto result = AudioUnitRemoveRenderNotify(mNodes[i].mAudioUnit, RenderNotify, &mNodes[i]);
+		if(result != noErr)
+			os_log_error(OS_LOG_DEFAULT, "AudioUnitRemoveRenderNotify failed: %d", result);
+	}
+}
+
+#pragma mark Statistics
+
+std::vector<SFB::CAAUGraphRenderProfiler::NodeStatistics> SFB::CAAUGraphRenderProfiler::Statistics() const
+{
+	std::vector<NodeStatistics> statistics;
+	statistics.reserve(mNodeCount);
+	for(size_t i = 0; i < mNodeCount; ++i)
+		statistics.push_back(Snapshot(mNodes[i]));
+	return statistics;
+}
+
+SFB::CAAUGraphRenderProfiler::NodeStatistics SFB::CAAUGraphRenderProfiler::Statistics(AUNode node) const noexcept
+{
+	for(size_t i = 0; i < mNodeCount; ++i) {
+		if(mNodes[i].mNode == node)
+			return Snapshot(mNodes[i]);
+	}
+	return {};
+}
+
+void SFB::CAAUGraphRenderProfiler::Reset() noexcept
+{
+	for(size_t i = 0; i < mNodeCount; ++i) {
+		auto& node = mNodes[i];
+		node.mRenderCount.store(0, std::memory_order_relaxed);
+		node.mDeadlineMisses.store(0, std::memory_order_relaxed);
+		node.mTotalDuration.store(0, std::memory_order_relaxed);
+		node.mMaximumDuration.store(0, std::memory_order_relaxed);
+		node.mTotalInclusiveDuration.store(0, std::memory_order_relaxed);
+		node.mMaximumInclusiveDuration.store(0, std::memory_order_relaxed);
+		for(auto& bucket : node.mHistogram)
+			bucket.store(0, std::memory_order_relaxed);
+	}
+}
+
+Float64 SFB::CAAUGraphRenderProfiler::ConvertHostTicksToSeconds(uint64_t hostTicks) noexcept
+{
+	return static_cast<Float64>(hostTicks) / HostTicksPerSecond();
+}
+
+#pragma mark Internals
+
+void SFB::CAAUGraphRenderProfiler::BeginRender(Node& node) noexcept
+{
+	// Nesting deeper than the number of nodes indicates rendering from more than one thread
+	if(mRenderDepth == mNodeCount)
+		mRenderDepth = 0;
+	mRenderStack[mRenderDepth++] = &node;
+
+	node.mUpstreamDuration = 0;
+
+	if(mEmitSignposts) {
+		const auto log = RenderLog();
+		os_signpost_interval_begin(log, os_signpost_id_make_with_pointer(log, &node), "Render", "node %d", static_cast<int>(node.mNode));
+	}
+
+	node.mStartTime = mach_absolute_time();
+}
+
+void SFB::CAAUGraphRenderProfiler::EndRender(Node& node) noexcept
+{
+	const auto endTime = mach_absolute_time();
+
+	if(mEmitSignposts) {
+		const auto log = RenderLog();
+		os_signpost_interval_end(log, os_signpost_id_make_with_pointer(log, &node), "Render");
+	}
+
+	// Unbalanced notifications are discarded
+	if(mRenderDepth == 0 || mRenderStack[mRenderDepth - 1] != &node) {
+		mRenderDepth = 0;
+		return;
+	}
+	--mRenderDepth;
+
+	const auto inclusiveDuration = endTime - node.mStartTime;
+	const auto duration = inclusiveDuration - std::min(node.mUpstreamDuration, inclusiveDuration);
+
+	// The node's render time counts toward the downstream node pulling it
+	if(mRenderDepth > 0)
+		mRenderStack[mRenderDepth - 1]->mUpstreamDuration += inclusiveDuration;
+
+	Increment(node.mRenderCount);
+	if(inclusiveDuration > mDeadline)
+		Increment(node.mDeadlineMisses);
+	Increment(node.mTotalDuration, duration);
+	Maximize(node.mMaximumDuration, duration);
+	Increment(node.mTotalInclusiveDuration, inclusiveDuration);
+	Maximize(node.mMaximumInclusiveDuration, inclusiveDuration);
+	Increment(node.mHistogram[HistogramBucket(duration)]);
+}
+
+SFB::CAAUGraphRenderProfiler::NodeStatistics SFB::CAAUGraphRenderProfiler::Snapshot(const Node& node) noexcept
+{
+	NodeStatistics statistics;
+	statistics.mNode = node.mNode;
+	statistics.mAudioUnit = node.mAudioUnit;
+	statistics.mRenderCount = node.mRenderCount.load(std::memory_order_relaxed);
+	statistics.mDeadlineMisses = node.mDeadlineMisses.load(std::memory_order_relaxed);
+	statistics.mTotalDuration = node.mTotalDuration.load(std::memory_order_relaxed);
+	statistics.mMaximumDuration = node.mMaximumDuration.load(std::memory_order_relaxed);
+	statistics.mTotalInclusiveDuration = node.mTotalInclusiveDuration.load(std::memory_order_relaxed);
+	statistics.mMaximumInclusiveDuration = node.mMaximumInclusiveDuration.load(std::memory_order_relaxed);
+	for(size_t i = 0; i < sHistogramBucketCount; ++i)
+		statistics.mHistogram[i] = node.mHistogram[i].load(std::memory_order_relaxed);
+	return statistics;
+}
+
+OSStatus SFB::CAAUGraphRenderProfiler::RenderNotify(void *inRefCon, AudioUnitRenderActionFlags *ioActionFlags, const AudioTimeStamp *inTimeStamp, UInt32 inBusNumber, UInt32 inNumberFrames, AudioBufferList *ioData) noexcept
+{
+#pragma unused(inTimeStamp)
+#pragma unused(inBusNumber)
+#pragma unused(inNumberFrames)
+#pragma unused(ioData)
+
+	auto& node = *static_cast<Node *>(inRefCon);
+	if(*ioActionFlags & kAudioUnitRenderAction_PreRender)
+		node.mProfiler->BeginRender(node);
+	else if(*ioActionFlags & kAudioUnitRenderAction_PostRender)
+		node.mProfiler->EndRender(node);
+
+	return noErr;
+}
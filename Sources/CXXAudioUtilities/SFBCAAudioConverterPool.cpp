@@ -0,0 +1,155 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <mutex>
+
+#import <os/log.h>
+
+#import "SFBCAAudioConverterPool.hpp"
+
+SFB::CAAudioConverterPool::~CAAudioConverterPool()
+{
+	Purge();
+}
+
+#pragma mark Converter Management
+
+SFB::CAAudioConverterPool::Handle SFB::CAAudioConverterPool::Acquire(const CAStreamBasicDescription& sourceFormat, const CAStreamBasicDescription& destinationFormat, const Options& options)
+{
+	Entry *entry = nullptr;
+	CAAudioConverter converter;
+
+	{
+		std::lock_guard<UnfairLock> lock(mLock);
+		entry = &FindOrCreateEntry(sourceFormat, destinationFormat, options);
+		if(!entry->mConverters.empty()) {
+			converter = std::move(entry->mConverters.back());
+			entry->mConverters.pop_back();
+		}
+	}
+
+	if(converter)
+		mHits.fetch_add(1, std::memory_order_relaxed);
+	else {
+		mMisses.fetch_add(1, std::memory_order_relaxed);
+		// Converters are created without holding the lock because creation may be slow
+		converter = NewConverter(*entry);
+	}
+
+	return {std::move(converter), this, entry};
+}
+
+void SFB::CAAudioConverterPool::Reserve(const CAStreamBasicDescription& sourceFormat, const CAStreamBasicDescription& destinationFormat, const Options& options, size_t count)
+{
+	Entry *entry = nullptr;
+	size_t available = 0;
+
+	{
+		std::lock_guard<UnfairLock> lock(mLock);
+		entry = &FindOrCreateEntry(sourceFormat, destinationFormat, options);
+		available = entry->mConverters.size();
+	}
+
+	count = std::min(count, mMaximumRetainedConverters - std::min(available, mMaximumRetainedConverters));
+
+	std::vector<CAAudioConverter> converters;
+	converters.reserve(count);
+	for(size_t i = 0; i < count; ++i)
+		converters.push_back(NewConverter(*entry));
+
+	std::lock_guard<UnfairLock> lock(mLock);
+	for(auto& converter : converters) {
+		if(entry->mConverters.size() >= mMaximumRetainedConverters)
+			break;
+		entry->mConverters.push_back(std::move(converter));
+	}
+}
+
+void SFB::CAAudioConverterPool::Purge() noexcept
+{
+	// Converters are disposed without holding the lock because disposal may be slow
+	for(size_t i = 0; ; ++i) {
+		std::vector<CAAudioConverter> converters;
+		{
+			std::lock_guard<UnfairLock> lock(mLock);
+			if(i >= mEntries.size())
+				break;
+			converters.swap(mEntries[i]->mConverters);
+		}
+	}
+}
+
+#pragma mark Internals
+
+SFB::CAAudioConverter SFB::CAAudioConverterPool::NewConverter(const Entry& entry)
+{
+	CAAudioConverter converter;
+	converter.New(entry.mSourceFormat, entry.mDestinationFormat);
+
+	const auto& options = entry.mOptions;
+	if(options.mSampleRateConverterComplexity)
+		converter.SetProperty(kAudioConverterSampleRateConverterComplexity, sizeof(UInt32), &*options.mSampleRateConverterComplexity);
+	if(options.mSampleRateConverterQuality)
+		converter.SetProperty(kAudioConverterSampleRateConverterQuality, sizeof(UInt32), &*options.mSampleRateConverterQuality);
+	if(options.mPrimeMethod)
+		converter.SetProperty(kAudioConverterPrimeMethod, sizeof(UInt32), &*options.mPrimeMethod);
+	if(!options.mChannelMap.empty())
+		converter.SetProperty(kAudioConverterChannelMap, static_cast<UInt32>(options.mChannelMap.size() * sizeof(SInt32)), options.mChannelMap.data());
+
+	return converter;
+}
+
+SFB::CAAudioConverterPool::Entry& SFB::CAAudioConverterPool::FindOrCreateEntry(const CAStreamBasicDescription& sourceFormat, const CAStreamBasicDescription& destinationFormat, const Options& options)
+{
+	for(auto& entry : mEntries) {
+		if(entry->mSourceFormat == sourceFormat && entry->mDestinationFormat == destinationFormat && entry->mOptions == options)
+			return *entry;
+	}
+
+	mEntries.push_back(std::make_unique<Entry>(Entry{sourceFormat, destinationFormat, options, {}}));
+	return *mEntries.back();
+}
+
+void SFB::CAAudioConverterPool::Return(Entry& entry, CAAudioConverter& converter) noexcept
+{
+	if(!converter)
+		return;
+
+	// The converter is reset without holding the lock
+	try {
+		converter.Reset();
+	}
+	catch(const std::exception& e) {
+		os_log_error(OS_LOG_DEFAULT, "Error resetting pooled audio converter: %{public}s", e.what());
+		mDiscards.fetch_add(1, std::memory_order_relaxed);
+		converter = {};
+		return;
+	}
+
+	bool allocationFailed = false;
+
+	{
+		std::lock_guard<UnfairLock> lock(mLock);
+		if(entry.mConverters.size() < mMaximumRetainedConverters) {
+			try {
+				entry.mConverters.reserve(mMaximumRetainedConverters);
+				entry.mConverters.push_back(std::move(converter));
+				return;
+			}
+			catch(...) {
+				allocationFailed = true;
+			}
+		}
+	}
+
+	if(allocationFailed)
+		os_log_error(OS_LOG_DEFAULT, "Unable to allocate space to retain pooled audio converter");
+
+	// The converter could not be retained
+	mDiscards.fetch_add(1, std::memory_order_relaxed);
+	converter = {};
+}
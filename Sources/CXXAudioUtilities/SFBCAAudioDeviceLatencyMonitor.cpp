@@ -0,0 +1,149 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <exception>
+
+#import <os/log.h>
+
+#import "SFBCAAudioDeviceLatencyMonitor.hpp"
+
+namespace {
+
+/// The device properties affecting latency
+const AudioObjectPropertyAddress sDeviceAddresses [] = {
+	{ kAudioDevicePropertyLatency, kAudioObjectPropertyScopeWildcard, kAudioObjectPropertyElementMain },
+	{ kAudioDevicePropertySafetyOffset, kAudioObjectPropertyScopeWildcard, kAudioObjectPropertyElementMain },
+	{ kAudioDevicePropertyBufferFrameSize, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain },
+	{ kAudioDevicePropertyStreams, kAudioObjectPropertyScopeWildcard, kAudioObjectPropertyElementMain },
+	{ kAudioDevicePropertyNominalSampleRate, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain },
+};
+
+/// The stream property affecting latency
+const AudioObjectPropertyAddress sStreamLatencyAddress = { kAudioStreamPropertyLatency, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain };
+
+/// Returns @c true if @c lhs and @c rhs differ
+bool LatencyDiffers(const SFB::CAAudioDeviceIOLatency& lhs, const SFB::CAAudioDeviceIOLatency& rhs) noexcept
+{
+	return lhs.mDeviceLatency != rhs.mDeviceLatency || lhs.mStreamLatency != rhs.mStreamLatency || lhs.mSafetyOffset != rhs.mSafetyOffset || lhs.mBufferFrameSize != rhs.mBufferFrameSize;
+}
+
+} /* namespace */
+
+#pragma mark Creation and Destruction
+
+SFB::CAAudioDeviceLatencyMonitor::CAAudioDeviceLatencyMonitor(CAAudioDevice device, ChangeCallback callback)
+: mDevice{device}, mCallback{std::move(callback)}
+{
+	// Listeners are added before the initial values are retrieved so no change is missed
+	size_t added = 0;
+	try {
+		for(const auto& address : sDeviceAddresses) {
+			auto result = AudioObjectAddPropertyListener(mDevice, &address, PropertyListenerProc, this);
+			ThrowIfCAAudioObjectError(result, "AudioObjectAddPropertyListener");
+			++added;
+		}
+		Refresh(false);
+	}
+	catch(...) {
+		for(size_t i = 0; i < added; ++i)
+			AudioObjectRemovePropertyListener(mDevice, &sDeviceAddresses[i], PropertyListenerProc, this);
+		std::lock_guard lock{mRefreshMutex};
+		UpdateStreamListeners({});
+		throw;
+	}
+}
+
+SFB::CAAudioDeviceLatencyMonitor::~CAAudioDeviceLatencyMonitor()
+{
+	for(const auto& address : sDeviceAddresses) {
+		auto result = AudioObjectRemovePropertyListener(mDevice, &address, PropertyListenerProc, this);
+		if(result != kAudioHardwareNoError)
+			os_log_error(OS_LOG_DEFAULT, "AudioObjectRemovePropertyListener failed: %d", result);
+	}
+
+	std::lock_guard lock{mRefreshMutex};
+	UpdateStreamListeners({});
+}
+
+#pragma mark Latency
+
+void SFB::CAAudioDeviceLatencyMonitor::Refresh(bool notify)
+{
+	std::lock_guard refreshLock{mRefreshMutex};
+
+	const auto inputLatency = mDevice.IOLatency(CAAudioObjectDirectionalScope::input);
+	const auto outputLatency = mDevice.IOLatency(CAAudioObjectDirectionalScope::output);
+	const auto sampleRate = mDevice.NominalSampleRate();
+
+	auto streamIDs = mDevice.StreamIDs(CAAudioObjectDirectionalScope::input);
+	const auto outputStreamIDs = mDevice.StreamIDs(CAAudioObjectDirectionalScope::output);
+	streamIDs.insert(streamIDs.end(), outputStreamIDs.cbegin(), outputStreamIDs.cend());
+	UpdateStreamListeners(std::move(streamIDs));
+
+	bool inputChanged, outputChanged;
+	{
+		std::lock_guard lock{mLock};
+		inputChanged = LatencyDiffers(mInputLatency, inputLatency);
+		outputChanged = LatencyDiffers(mOutputLatency, outputLatency);
+		mInputLatency = inputLatency;
+		mOutputLatency = outputLatency;
+	}
+
+	mInputTotalLatency.store(inputLatency.Total(), std::memory_order_release);
+	mOutputTotalLatency.store(outputLatency.Total(), std::memory_order_release);
+	mNominalSampleRate.store(sampleRate, std::memory_order_release);
+
+	if(notify && mCallback) {
+		if(inputChanged)
+			mCallback(CAAudioObjectDirectionalScope::input, inputLatency);
+		if(outputChanged)
+			mCallback(CAAudioObjectDirectionalScope::output, outputLatency);
+	}
+}
+
+void SFB::CAAudioDeviceLatencyMonitor::UpdateStreamListeners(std::vector<AudioObjectID> streamIDs)
+{
+	std::sort(streamIDs.begin(), streamIDs.end());
+	if(streamIDs == mStreamIDs)
+		return;
+
+	for(auto streamID : mStreamIDs) {
+		if(!std::binary_search(streamIDs.cbegin(), streamIDs.cend(), streamID))
+			AudioObjectRemovePropertyListener(streamID, &sStreamLatencyAddress, PropertyListenerProc, this);
+	}
+
+	std::vector<AudioObjectID> listening;
+	listening.reserve(streamIDs.size());
+	for(auto streamID : streamIDs) {
+		if(std::binary_search(mStreamIDs.cbegin(), mStreamIDs.cend(), streamID)) {
+			listening.push_back(streamID);
+			continue;
+		}
+		auto result = AudioObjectAddPropertyListener(streamID, &sStreamLatencyAddress, PropertyListenerProc, this);
+		if(result == kAudioHardwareNoError)
+			listening.push_back(streamID);
+		else
+			os_log_error(OS_LOG_DEFAULT, "AudioObjectAddPropertyListener failed for stream 0x%x: %d", streamID, result);
+	}
+
+	mStreamIDs = std::move(listening);
+}
+
+OSStatus SFB::CAAudioDeviceLatencyMonitor::PropertyListenerProc(AudioObjectID inObjectID, UInt32 inNumberAddresses, const AudioObjectPropertyAddress *inAddresses, void *inClientData) noexcept
+{
+#pragma unused(inObjectID)
+#pragma unused(inNumberAddresses)
+#pragma unused(inAddresses)
+	auto monitor = static_cast<CAAudioDeviceLatencyMonitor *>(inClientData);
+	try {
+		monitor->Refresh(true);
+	}
+	catch(const std::exception& e) {
+		os_log_error(OS_LOG_DEFAULT, "Error refreshing latency for audio device 0x%x: %{public}s", static_cast<AudioObjectID>(monitor->mDevice), e.what());
+	}
+	return kAudioHardwareNoError;
+}
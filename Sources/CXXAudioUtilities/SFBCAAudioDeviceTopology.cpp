@@ -0,0 +1,140 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <exception>
+
+#import <dispatch/dispatch.h>
+#import <os/log.h>
+
+#import "SFBCAAudioDeviceTopology.hpp"
+#import "SFBCAAudioDevice.hpp"
+#import "SFBCAAudioStream.hpp"
+#import "SFBCAAudioSystemObject.hpp"
+
+namespace {
+
+/// Context for concurrent device property retrieval
+struct SnapshotContext {
+	/// The device whose properties are retrieved at each index
+	std::vector<SFB::CAAudioDeviceTopology::Device>& mDevices;
+	/// Whether the properties at each index were retrieved
+	std::vector<char>& mSucceeded;
+};
+
+/// Returns the properties of the input or output of @c device
+/// @throw @c std::system_error
+/// @throw @c std::bad_alloc
+SFB::CAAudioDeviceTopology::Scope RetrieveScope(const SFB::CAAudioDevice& device, SFB::CAAudioObjectDirectionalScope scope)
+{
+	SFB::CAAudioDeviceTopology::Scope result;
+
+	const auto streams = device.Streams(scope);
+	if(streams.empty())
+		return result;
+
+	result.mLatency = device.Latency(scope);
+	result.mSafetyOffset = device.SafetyOffset(scope);
+
+	result.mStreams.reserve(streams.size());
+	for(const auto& stream : streams) {
+		SFB::CAAudioDeviceTopology::Stream info;
+		info.mStreamID = stream;
+		info.mStartingChannel = stream.StartingChannel();
+		info.mLatency = stream.Latency();
+		info.mTerminalType = stream.TerminalType();
+		info.mVirtualFormat = stream.VirtualFormat();
+		result.mChannelCount += info.mVirtualFormat.ChannelCount();
+		result.mStreams.push_back(std::move(info));
+	}
+
+	return result;
+}
+
+/// Retrieves the properties of one device
+void RetrieveDevice(void *context, size_t index) noexcept
+{
+	auto& snapshot = *static_cast<SnapshotContext *>(context);
+	auto& info = snapshot.mDevices[index];
+
+	try {
+		const SFB::CAAudioDevice device(info.mDeviceID);
+		info.mUID = device.UID();
+		info.mName = device.Name();
+		info.mTransportType = device.ArithmeticProperty<UInt32>(SFB::CAPropertyAddress(kAudioDevicePropertyTransportType));
+		info.mNominalSampleRate = device.NominalSampleRate();
+		info.mBufferFrameSize = device.BufferFrameSize();
+		info.mInput = RetrieveScope(device, SFB::CAAudioObjectDirectionalScope::input);
+		info.mOutput = RetrieveScope(device, SFB::CAAudioObjectDirectionalScope::output);
+		snapshot.mSucceeded[index] = true;
+	}
+	catch(const std::exception& e) {
+		// The device may have been removed since the device list was retrieved
+		os_log_debug(OS_LOG_DEFAULT, "Error retrieving properties for audio device 0x%x: %{public}s", info.mDeviceID, e.what());
+	}
+}
+
+/// Returns the value of @c selector for the system object or @c kAudioObjectUnknown on error
+AudioObjectID DefaultDeviceID(AudioObjectPropertySelector selector) noexcept
+{
+	const SFB::CAPropertyAddress address(selector);
+	AudioObjectID deviceID = kAudioObjectUnknown;
+	UInt32 size = sizeof deviceID;
+	if(AudioObjectGetPropertyData(kAudioObjectSystemObject, &address, 0, nullptr, &size, &deviceID) != kAudioHardwareNoError)
+		return kAudioObjectUnknown;
+	return deviceID;
+}
+
+} /* namespace */
+
+SFB::CAAudioDeviceTopology SFB::CAAudioDeviceTopology::Snapshot()
+{
+	const auto deviceIDs = CAAudioSystemObject().DeviceIDs();
+
+	auto storage = std::make_shared<Storage>();
+	storage->mDefaultInputDeviceID = DefaultDeviceID(kAudioHardwarePropertyDefaultInputDevice);
+	storage->mDefaultOutputDeviceID = DefaultDeviceID(kAudioHardwarePropertyDefaultOutputDevice);
+	storage->mDefaultSystemOutputDeviceID = DefaultDeviceID(kAudioHardwarePropertyDefaultSystemOutputDevice);
+
+	auto& devices = storage->mDevices;
+	devices.resize(deviceIDs.size());
+	for(size_t i = 0; i < deviceIDs.size(); ++i)
+		devices[i].mDeviceID = deviceIDs[i];
+
+	// Each property retrieval is a round trip to the HAL so devices are queried concurrently
+	std::vector<char> succeeded(deviceIDs.size(), false);
+	SnapshotContext context{devices, succeeded};
+	dispatch_apply_f(devices.size(), DISPATCH_APPLY_AUTO, &context, RetrieveDevice);
+
+	size_t count = 0;
+	for(size_t i = 0; i < devices.size(); ++i) {
+		if(succeeded[i]) {
+			if(count != i)
+				devices[count] = std::move(devices[i]);
+			++count;
+		}
+	}
+	devices.erase(devices.begin() + static_cast<std::ptrdiff_t>(count), devices.end());
+	devices.shrink_to_fit();
+
+	CAAudioDeviceTopology topology;
+	topology.mSnapshot = std::move(storage);
+	return topology;
+}
+
+const SFB::CAAudioDeviceTopology::Device * SFB::CAAudioDeviceTopology::DeviceWithID(AudioObjectID deviceID) const noexcept
+{
+	const auto& devices = Devices();
+	auto iter = std::find_if(devices.cbegin(), devices.cend(), [deviceID](const Device& device) { return device.mDeviceID == deviceID; });
+	return iter != devices.cend() ? &*iter : nullptr;
+}
+
+const SFB::CAAudioDeviceTopology::Device * SFB::CAAudioDeviceTopology::DeviceWithUID(CFStringRef uid) const noexcept
+{
+	const auto& devices = Devices();
+	auto iter = std::find_if(devices.cbegin(), devices.cend(), [uid](const Device& device) { return device.mUID && CFEqual(device.mUID, uid); });
+	return iter != devices.cend() ? &*iter : nullptr;
+}
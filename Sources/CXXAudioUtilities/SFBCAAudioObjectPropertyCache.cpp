@@ -0,0 +1,245 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cstring>
+#import <mutex>
+
+#import <os/log.h>
+
+#import "SFBCAAudioObjectPropertyCache.hpp"
+
+namespace {
+
+/// Returns the FNV-1a hash of @c address
+size_t HashAddress(const AudioObjectPropertyAddress& address) noexcept
+{
+	const UInt32 words [] = { address.mSelector, address.mScope, address.mElement };
+	uint64_t hash = 0xcbf29ce484222325;
+	for(auto word : words) {
+		for(auto i = 0; i < 4; ++i) {
+			hash ^= (word >> (8 * i)) & 0xff;
+			hash *= 0x100000001b3;
+		}
+	}
+	return static_cast<size_t>(hash);
+}
+
+} /* namespace */
+
+#pragma mark Creation and Destruction
+
+SFB::CAAudioObjectPropertyCache::CAAudioObjectPropertyCache(CAAudioObject object, size_t capacity)
+: mObject{object}, mCapacity{std::max(capacity, static_cast<size_t>(1))}, mSlots{std::make_unique<Slot[]>(mCapacity)}
+{}
+
+SFB::CAAudioObjectPropertyCache::~CAAudioObjectPropertyCache()
+{
+	for(size_t i = 0; i < mCapacity; ++i) {
+		auto& slot = mSlots[i];
+		if(!slot.mPublished.load(std::memory_order_acquire) || !slot.mListening.load(std::memory_order_acquire))
+			continue;
+		auto result = AudioObjectRemovePropertyListener(mObject, &slot.mAddress, PropertyListenerProc, this);
+		if(result != kAudioHardwareNoError)
+			os_log_error(OS_LOG_DEFAULT, "AudioObjectRemovePropertyListener failed: %d", result);
+	}
+}
+
+#pragma mark Invalidation
+
+void SFB::CAAudioObjectPropertyCache::Invalidate(const AudioObjectPropertyAddress& inAddress) noexcept
+{
+	for(size_t i = 0; i < mCapacity; ++i) {
+		auto& slot = mSlots[i];
+		if(slot.mPublished.load(std::memory_order_acquire) && slot.mAddress.Congruent(inAddress))
+			InvalidateSlot(slot);
+	}
+}
+
+void SFB::CAAudioObjectPropertyCache::InvalidateAll() noexcept
+{
+	for(size_t i = 0; i < mCapacity; ++i) {
+		auto& slot = mSlots[i];
+		if(slot.mPublished.load(std::memory_order_acquire))
+			InvalidateSlot(slot);
+	}
+}
+
+#pragma mark Scalar Values
+
+bool SFB::CAAudioObjectPropertyCache::ReadScalar(const AudioObjectPropertyAddress& inAddress, void *value, size_t size) const noexcept
+{
+	auto slot = FindSlot(inAddress);
+	if(!slot)
+		return false;
+
+	uint64_t words [sScalarWordCount];
+	const auto wordCount = (size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+	for(;;) {
+		const auto sequence = slot->mSequence.load(std::memory_order_acquire);
+		if(sequence & 1)
+			return false;
+
+		const auto valid = slot->mScalarValid.load(std::memory_order_relaxed);
+		const auto scalarSize = slot->mScalarSize.load(std::memory_order_relaxed);
+		for(size_t i = 0; i < wordCount; ++i)
+			words[i] = slot->mScalar[i].load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(slot->mSequence.load(std::memory_order_relaxed) != sequence)
+			continue;
+
+		if(!valid || scalarSize != size)
+			return false;
+
+		std::memcpy(value, words, size);
+		return true;
+	}
+}
+
+void SFB::CAAudioObjectPropertyCache::FetchScalar(const AudioObjectPropertyAddress& inAddress, void *value, size_t size) const
+{
+	const auto [slot, generation] = PrepareFetch(inAddress);
+
+	auto dataSize = static_cast<UInt32>(size);
+	mObject.GetPropertyData(inAddress, 0, nullptr, dataSize, value);
+
+	if(!slot || dataSize != size)
+		return;
+
+	uint64_t words [sScalarWordCount] = {};
+	std::memcpy(words, value, size);
+
+	std::lock_guard lock{mLock};
+	if(!slot->mListening.load(std::memory_order_acquire) || slot->mGeneration.load(std::memory_order_acquire) != generation)
+		return;
+
+	slot->mSequence.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for(size_t i = 0; i < sScalarWordCount; ++i)
+		slot->mScalar[i].store(words[i], std::memory_order_relaxed);
+	slot->mScalarSize.store(static_cast<uint32_t>(size), std::memory_order_relaxed);
+	slot->mScalarValid.store(true, std::memory_order_relaxed);
+	slot->mSequence.fetch_add(1, std::memory_order_release);
+}
+
+#pragma mark Object Values
+
+std::shared_ptr<const void> SFB::CAAudioObjectPropertyCache::ReadObject(const AudioObjectPropertyAddress& inAddress, const void *type) const noexcept
+{
+	auto slot = FindSlot(inAddress);
+	if(!slot)
+		return nullptr;
+
+	std::lock_guard lock{mLock};
+	if(slot->mObjectType != type)
+		return nullptr;
+	return slot->mObject;
+}
+
+void SFB::CAAudioObjectPropertyCache::StoreObject(Slot& slot, uint32_t generation, const void *type, std::shared_ptr<const void> object) const noexcept
+{
+	{
+		std::lock_guard lock{mLock};
+		if(!slot.mListening.load(std::memory_order_acquire) || slot.mGeneration.load(std::memory_order_acquire) != generation)
+			return;
+		slot.mObject.swap(object);
+		slot.mObjectType = type;
+	}
+	// Any previous value is released here, outside the lock
+}
+
+#pragma mark Slots
+
+std::pair<SFB::CAAudioObjectPropertyCache::Slot *, uint32_t> SFB::CAAudioObjectPropertyCache::PrepareFetch(const AudioObjectPropertyAddress& inAddress) const noexcept
+{
+	// The listener is added before the generation is read so a change occurring while the value
+	// is being retrieved prevents the (possibly stale) value from being cached
+	auto slot = FindOrCreateSlot(inAddress);
+	if(!slot)
+		return {nullptr, 0};
+	return {slot, slot->mGeneration.load(std::memory_order_acquire)};
+}
+
+SFB::CAAudioObjectPropertyCache::Slot * SFB::CAAudioObjectPropertyCache::FindSlot(const AudioObjectPropertyAddress& inAddress) const noexcept
+{
+	// Slots are claimed in probe order and never released, so the first unpublished slot ends the search
+	const auto start = HashAddress(inAddress) % mCapacity;
+	for(size_t i = 0; i < mCapacity; ++i) {
+		auto& slot = mSlots[(start + i) % mCapacity];
+		if(!slot.mPublished.load(std::memory_order_acquire))
+			return nullptr;
+		if(slot.mAddress == inAddress)
+			return &slot;
+	}
+	return nullptr;
+}
+
+SFB::CAAudioObjectPropertyCache::Slot * SFB::CAAudioObjectPropertyCache::FindOrCreateSlot(const AudioObjectPropertyAddress& inAddress) const noexcept
+{
+	if(auto slot = FindSlot(inAddress); slot)
+		return slot;
+
+	Slot *slot = nullptr;
+	{
+		std::lock_guard lock{mLock};
+		const auto start = HashAddress(inAddress) % mCapacity;
+		for(size_t i = 0; i < mCapacity; ++i) {
+			auto& candidate = mSlots[(start + i) % mCapacity];
+			if(!candidate.mPublished.load(std::memory_order_relaxed)) {
+				candidate.mAddress = inAddress;
+				candidate.mPublished.store(true, std::memory_order_release);
+				slot = &candidate;
+				break;
+			}
+			if(candidate.mAddress == inAddress)
+				return &candidate;
+		}
+	}
+
+	if(!slot) {
+		os_log_debug(OS_LOG_DEFAULT, "Property cache full for audio object 0x%x", static_cast<AudioObjectID>(mObject));
+		return nullptr;
+	}
+
+	// The listener is added without holding the lock because the HAL may invoke the listener proc concurrently
+	auto result = AudioObjectAddPropertyListener(mObject, &slot->mAddress, PropertyListenerProc, const_cast<CAAudioObjectPropertyCache *>(this));
+	if(result != kAudioHardwareNoError) {
+		os_log_error(OS_LOG_DEFAULT, "AudioObjectAddPropertyListener failed: %d", result);
+		return slot;
+	}
+
+	slot->mListening.store(true, std::memory_order_release);
+	return slot;
+}
+
+void SFB::CAAudioObjectPropertyCache::InvalidateSlot(Slot& slot) const noexcept
+{
+	std::shared_ptr<const void> object;
+	{
+		std::lock_guard lock{mLock};
+		slot.mGeneration.fetch_add(1, std::memory_order_release);
+
+		slot.mSequence.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.mScalarValid.store(false, std::memory_order_relaxed);
+		slot.mSequence.fetch_add(1, std::memory_order_release);
+
+		object.swap(slot.mObject);
+		slot.mObjectType = nullptr;
+	}
+	// The previous value is released here, outside the lock
+}
+
+OSStatus SFB::CAAudioObjectPropertyCache::PropertyListenerProc(AudioObjectID inObjectID, UInt32 inNumberAddresses, const AudioObjectPropertyAddress *inAddresses, void *inClientData) noexcept
+{
+#pragma unused(inObjectID)
+	auto cache = static_cast<CAAudioObjectPropertyCache *>(inClientData);
+	for(UInt32 i = 0; i < inNumberAddresses; ++i)
+		cache->Invalidate(inAddresses[i]);
+	return kAudioHardwareNoError;
+}
@@ -1,5 +1,5 @@
 //
-// Copyright © 2013-2024 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2013-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
@@ -8,12 +8,207 @@
 #import <cstdlib>
 #import <limits>
 #import <new>
+#import <optional>
+#import <type_traits>
+
+#import <Accelerate/Accelerate.h>
 
 #import "SFBCABufferList.hpp"
 #import "SFBCAAudioFile.hpp"
 #import "SFBCAExtAudioFile.hpp"
 //#import "SFBCAAudioConverter.hpp"
 
+namespace {
+
+/// The number of samples converted at a time when an intermediate buffer is required
+constexpr vDSP_Length sConversionBlockSize = 512;
+
+/// Copies @c count samples from @c src to @c dst
+template <typename T>
+void CopySamples(const T * const _Nonnull src, vDSP_Stride srcStride, T * const _Nonnull dst, vDSP_Stride dstStride, vDSP_Length count) noexcept
+{
+	for(vDSP_Length i = 0; i < count; ++i)
+		dst[i * dstStride] = src[i * srcStride];
+}
+
+/// Converts @c count floating-point samples from @c src to 16-bit integer samples in @c dst
+template <typename T>
+void ConvertFloatToInt16(const T * const _Nonnull src, vDSP_Stride srcStride, int16_t * const _Nonnull dst, vDSP_Stride dstStride, vDSP_Length count) noexcept
+{
+	const T scale = 32768;
+	const T low = -32768;
+	const T high = 32767;
+
+	T buffer [sConversionBlockSize];
+	for(vDSP_Length i = 0; i < count; i += sConversionBlockSize) {
+		const auto n = std::min(sConversionBlockSize, count - i);
+		if constexpr (std::is_same_v<T, float>) {
+			vDSP_vsmul(src + (i * srcStride), srcStride, &scale, buffer, 1, n);
+			vDSP_vclip(buffer, 1, &low, &high, buffer, 1, n);
+			vDSP_vfixr16(buffer, 1, dst + (i * dstStride), dstStride, n);
+		}
+		else {
+			vDSP_vsmulD(src + (i * srcStride), srcStride, &scale, buffer, 1, n);
+			vDSP_vclipD(buffer, 1, &low, &high, buffer, 1, n);
+			vDSP_vfixr16D(buffer, 1, dst + (i * dstStride), dstStride, n);
+		}
+	}
+}
+
+/// Converts @c count floating-point samples from @c src to 32-bit integer samples in @c dst
+/// @note Single-precision samples are converted using double precision since @c float cannot represent @c INT32_MAX
+template <typename T>
+void ConvertFloatToInt32(const T * const _Nonnull src, vDSP_Stride srcStride, int32_t * const _Nonnull dst, vDSP_Stride dstStride, vDSP_Length count) noexcept
+{
+	const double scale = 2147483648.0;
+	const double low = -2147483648.0;
+	const double high = 2147483647.0;
+
+	double buffer [sConversionBlockSize];
+	for(vDSP_Length i = 0; i < count; i += sConversionBlockSize) {
+		const auto n = std::min(sConversionBlockSize, count - i);
+		if constexpr (std::is_same_v<T, float>) {
+			vDSP_vspdp(src + (i * srcStride), srcStride, buffer, 1, n);
+			vDSP_vsmulD(buffer, 1, &scale, buffer, 1, n);
+		}
+		else
+			vDSP_vsmulD(src + (i * srcStride), srcStride, &scale, buffer, 1, n);
+		vDSP_vclipD(buffer, 1, &low, &high, buffer, 1, n);
+		vDSP_vfixr32D(buffer, 1, dst + (i * dstStride), dstStride, n);
+	}
+}
+
+/// Converts @c count samples from @c src in @c srcFormat to @c dst in @c dstFormat
+/// @param srcFormat The sample format of @c src
+/// @param src The first source sample
+/// @param srcStride The distance between consecutive source samples, in samples
+/// @param dstFormat The sample format of @c dst
+/// @param dst The first destination sample
+/// @param dstStride The distance between consecutive destination samples, in samples
+/// @param count The number of samples to convert
+void ConvertSamples(SFB::CommonPCMFormat srcFormat, const void * const _Nonnull src, vDSP_Stride srcStride, SFB::CommonPCMFormat dstFormat, void * const _Nonnull dst, vDSP_Stride dstStride, vDSP_Length count) noexcept
+{
+	switch(srcFormat) {
+		case SFB::CommonPCMFormat::float32: {
+			const auto s = static_cast<const float *>(src);
+			switch(dstFormat) {
+				case SFB::CommonPCMFormat::float32:
+					CopySamples(s, srcStride, static_cast<float *>(dst), dstStride, count);
+					break;
+				case SFB::CommonPCMFormat::float64:
+					vDSP_vspdp(s, srcStride, static_cast<double *>(dst), dstStride, count);
+					break;
+				case SFB::CommonPCMFormat::int16:
+					ConvertFloatToInt16(s, srcStride, static_cast<int16_t *>(dst), dstStride, count);
+					break;
+				case SFB::CommonPCMFormat::int32:
+					ConvertFloatToInt32(s, srcStride, static_cast<int32_t *>(dst), dstStride, count);
+					break;
+			}
+			break;
+		}
+
+		case SFB::CommonPCMFormat::float64: {
+			const auto s = static_cast<const double *>(src);
+			switch(dstFormat) {
+				case SFB::CommonPCMFormat::float32:
+					vDSP_vdpsp(s, srcStride, static_cast<float *>(dst), dstStride, count);
+					break;
+				case SFB::CommonPCMFormat::float64:
+					CopySamples(s, srcStride, static_cast<double *>(dst), dstStride, count);
+					break;
+				case SFB::CommonPCMFormat::int16:
+					ConvertFloatToInt16(s, srcStride, static_cast<int16_t *>(dst), dstStride, count);
+					break;
+				case SFB::CommonPCMFormat::int32:
+					ConvertFloatToInt32(s, srcStride, static_cast<int32_t *>(dst), dstStride, count);
+					break;
+			}
+			break;
+		}
+
+		case SFB::CommonPCMFormat::int16: {
+			const auto s = static_cast<const int16_t *>(src);
+			switch(dstFormat) {
+				case SFB::CommonPCMFormat::float32: {
+					const float scale = 1.f / 32768.f;
+					const auto d = static_cast<float *>(dst);
+					vDSP_vflt16(s, srcStride, d, dstStride, count);
+					vDSP_vsmul(d, dstStride, &scale, d, dstStride, count);
+					break;
+				}
+				case SFB::CommonPCMFormat::float64: {
+					const double scale = 1.0 / 32768.0;
+					const auto d = static_cast<double *>(dst);
+					vDSP_vflt16D(s, srcStride, d, dstStride, count);
+					vDSP_vsmulD(d, dstStride, &scale, d, dstStride, count);
+					break;
+				}
+				case SFB::CommonPCMFormat::int16:
+					CopySamples(s, srcStride, static_cast<int16_t *>(dst), dstStride, count);
+					break;
+				case SFB::CommonPCMFormat::int32: {
+					const auto d = static_cast<int32_t *>(dst);
+					for(vDSP_Length i = 0; i < count; ++i)
+						d[i * dstStride] = static_cast<int32_t>(static_cast<uint32_t>(s[i * srcStride]) << 16);
+					break;
+				}
+			}
+			break;
+		}
+
+		case SFB::CommonPCMFormat::int32: {
+			const auto s = static_cast<const int32_t *>(src);
+			switch(dstFormat) {
+				case SFB::CommonPCMFormat::float32: {
+					const float scale = 1.f / 2147483648.f;
+					const auto d = static_cast<float *>(dst);
+					vDSP_vflt32(s, srcStride, d, dstStride, count);
+					vDSP_vsmul(d, dstStride, &scale, d, dstStride, count);
+					break;
+				}
+				case SFB::CommonPCMFormat::float64: {
+					const double scale = 1.0 / 2147483648.0;
+					const auto d = static_cast<double *>(dst);
+					vDSP_vflt32D(s, srcStride, d, dstStride, count);
+					vDSP_vsmulD(d, dstStride, &scale, d, dstStride, count);
+					break;
+				}
+				case SFB::CommonPCMFormat::int16: {
+					const auto d = static_cast<int16_t *>(dst);
+					for(vDSP_Length i = 0; i < count; ++i)
+						d[i * dstStride] = static_cast<int16_t>(s[i * srcStride] >> 16);
+					break;
+				}
+				case SFB::CommonPCMFormat::int32:
+					CopySamples(s, srcStride, static_cast<int32_t *>(dst), dstStride, count);
+					break;
+			}
+			break;
+		}
+	}
+}
+
+/// Returns the address of the sample for @c channel at @c frameOffset in @c bufferList and the stride between its samples
+/// @param bufferList The buffer list
+/// @param format The format of @c bufferList
+/// @param channel The channel number
+/// @param frameOffset The frame offset
+/// @param stride Receives the distance between consecutive samples of @c channel, in samples
+/// @return The address of the sample
+uintptr_t ChannelSampleAddress(const AudioBufferList * const _Nonnull bufferList, const SFB::CAStreamBasicDescription& format, UInt32 channel, UInt32 frameOffset, vDSP_Stride& stride) noexcept
+{
+	const auto bytesPerSample = format.mBitsPerChannel / 8;
+	if(format.IsInterleaved()) {
+		stride = format.mChannelsPerFrame;
+		return reinterpret_cast<uintptr_t>(bufferList->mBuffers[0].mData) + (frameOffset * format.mBytesPerFrame) + (channel * bytesPerSample);
+	}
+	stride = 1;
+	return reinterpret_cast<uintptr_t>(bufferList->mBuffers[channel].mData) + (frameOffset * format.mBytesPerFrame);
+}
+
+} /* namespace */
+
 AudioBufferList * SFB::AllocateAudioBufferList(const CAStreamBasicDescription& format, UInt32 frameCapacity) noexcept
 {
 	if(format.mBytesPerFrame == 0 || frameCapacity > (std::numeric_limits<UInt32>::max() / format.mBytesPerFrame))
@@ -46,6 +241,47 @@ AudioBufferList * SFB::AllocateAudioBufferList(const CAStreamBasicDescription& f
 	return abl;
 }
 
+AudioBufferList * SFB::AllocateAudioBufferList(const CAStreamBasicDescription& format, UInt32 frameCapacity, size_t alignment, bool zeroFill) noexcept
+{
+	if(format.mBytesPerFrame == 0 || frameCapacity > (std::numeric_limits<UInt32>::max() / format.mBytesPerFrame))
+		return nullptr;
+
+	if(alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0)
+		return nullptr;
+
+	const auto bufferDataSize = format.FrameCountToByteSize(frameCapacity);
+	const auto bufferCount = format.ChannelStreamCount();
+	const auto bufferListSize = offsetof(AudioBufferList, mBuffers) + (sizeof(AudioBuffer) * bufferCount);
+
+	// Each buffer begins on an alignment boundary
+	const auto alignedBufferListSize = (bufferListSize + alignment - 1) & ~(alignment - 1);
+	const auto alignedBufferDataSize = (static_cast<size_t>(bufferDataSize) + alignment - 1) & ~(alignment - 1);
+	const auto allocationSize = alignedBufferListSize + (alignedBufferDataSize * bufferCount);
+
+	void *allocation = nullptr;
+	if(posix_memalign(&allocation, alignment, allocationSize) != 0)
+		return nullptr;
+
+	if(zeroFill)
+		std::memset(allocation, 0, allocationSize);
+	else
+		std::memset(allocation, 0, bufferListSize);
+
+	// Assign the buffers
+	auto address = reinterpret_cast<uintptr_t>(allocation);
+
+	auto abl = static_cast<AudioBufferList *>(reinterpret_cast<void *>(address));
+	abl->mNumberBuffers = bufferCount;
+
+	for(UInt32 i = 0; i < bufferCount; ++i) {
+		abl->mBuffers[i].mNumberChannels = format.InterleavedChannelCount();
+		abl->mBuffers[i].mDataByteSize = bufferDataSize;
+		abl->mBuffers[i].mData = reinterpret_cast<void *>(address + alignedBufferListSize + (alignedBufferDataSize * i));
+	}
+
+	return abl;
+}
+
 SFB::CABufferList::CABufferList(CABufferList&& rhs) noexcept
 : mBufferList{rhs.mBufferList}, mFormat{rhs.mFormat}, mFrameCapacity{rhs.mFrameCapacity}, mFrameLength{rhs.mFrameLength}
 {
@@ -151,9 +387,15 @@ bool SFB::CABufferList::InferFrameLengthFromABL()
 
 UInt32 SFB::CABufferList::InsertFromBuffer(const CABufferList& buffer, UInt32 readOffset, UInt32 frameLength, UInt32 writeOffset) noexcept
 {
-	if(mFormat != buffer.mFormat)
-//		throw std::invalid_argument("mFormat != buffer.mFormat");
-		return 0;
+	// Formats differing only in interleaving or common PCM sample format are converted directly
+	std::optional<CommonPCMFormat> sourceCommonFormat, destinationCommonFormat;
+	if(mFormat != buffer.mFormat) {
+		if(!CanInsertFromFormat(buffer.mFormat))
+//			throw std::invalid_argument("mFormat != buffer.mFormat");
+			return 0;
+		sourceCommonFormat = buffer.mFormat.CommonFormat();
+		destinationCommonFormat = mFormat.CommonFormat();
+	}
 
 	if(readOffset > buffer.mFrameLength || writeOffset > mFrameLength || frameLength == 0 || buffer.mFrameLength == 0)
 		return 0;
@@ -171,7 +413,17 @@ UInt32 SFB::CABufferList::InsertFromBuffer(const CABufferList& buffer, UInt32 re
 		}
 	}
 
-	if(framesToInsert) {
+	if(framesToInsert && sourceCommonFormat) {
+		for(UInt32 channel = 0; channel < mFormat.mChannelsPerFrame; ++channel) {
+			vDSP_Stride srcStride, dstStride;
+			const auto src = ChannelSampleAddress(buffer.mBufferList, buffer.mFormat, channel, readOffset, srcStride);
+			const auto dst = ChannelSampleAddress(mBufferList, mFormat, channel, writeOffset, dstStride);
+			ConvertSamples(*sourceCommonFormat, reinterpret_cast<const void *>(src), srcStride, *destinationCommonFormat, reinterpret_cast<void *>(dst), dstStride, framesToInsert);
+		}
+
+		SetFrameLength(mFrameLength + framesToInsert);
+	}
+	else if(framesToInsert) {
 		for(UInt32 i = 0; i < buffer.mBufferList->mNumberBuffers; ++i)
 			std::memcpy(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(mBufferList->mBuffers[i].mData) + (writeOffset * mFormat.mBytesPerFrame)),
 						reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(buffer.mBufferList->mBuffers[i].mData) + (readOffset * mFormat.mBytesPerFrame)),
@@ -183,6 +435,17 @@ UInt32 SFB::CABufferList::InsertFromBuffer(const CABufferList& buffer, UInt32 re
 	return framesToInsert;
 }
 
+bool SFB::CABufferList::CanInsertFromFormat(const CAStreamBasicDescription& format) const noexcept
+{
+	if(format == mFormat)
+		return true;
+
+	if(format.mSampleRate != mFormat.mSampleRate || format.mChannelsPerFrame != mFormat.mChannelsPerFrame)
+		return false;
+
+	return format.CommonFormat().has_value() && mFormat.CommonFormat().has_value();
+}
+
 UInt32 SFB::CABufferList::TrimAtOffset(UInt32 offset, UInt32 frameLength) noexcept
 {
 	if(offset > mFrameLength || frameLength == 0)
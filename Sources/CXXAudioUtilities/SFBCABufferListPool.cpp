@@ -0,0 +1,141 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cstdlib>
+#import <cstring>
+#import <mutex>
+#import <new>
+
+#import "SFBCABufferListPool.hpp"
+
+SFB::CABufferListPool::~CABufferListPool()
+{
+	Purge();
+}
+
+#pragma mark Buffer Management
+
+SFB::CABufferListPool::Handle SFB::CABufferListPool::Acquire(const CAStreamBasicDescription& format, UInt32 frameCapacity, bool zeroFill) noexcept
+{
+	AudioBufferList *abl = nullptr;
+
+	{
+		std::lock_guard<UnfairLock> lock(mLock);
+		auto entry = FindEntry(format, frameCapacity);
+		if(entry && !entry->mBufferLists.empty()) {
+			abl = entry->mBufferLists.back();
+			entry->mBufferLists.pop_back();
+		}
+	}
+
+	if(abl) {
+		// Reused buffers retain the previous contents
+		if(zeroFill) {
+			const auto bufferDataSize = format.FrameCountToByteSize(frameCapacity);
+			for(UInt32 i = 0; i < abl->mNumberBuffers; ++i)
+				std::memset(abl->mBuffers[i].mData, 0, bufferDataSize);
+		}
+	}
+	else {
+		abl = AllocateAudioBufferList(format, frameCapacity, sBufferAlignment, zeroFill);
+		if(!abl)
+			return {};
+	}
+
+	CABufferList bufferList;
+	bufferList.AdoptABL(abl, format, frameCapacity, 0);
+	return {std::move(bufferList), this};
+}
+
+bool SFB::CABufferListPool::Reserve(const CAStreamBasicDescription& format, UInt32 frameCapacity, size_t count) noexcept
+{
+	std::lock_guard<UnfairLock> lock(mLock);
+
+	auto entry = FindEntry(format, frameCapacity);
+	if(!entry) {
+		try {
+			mEntries.push_back({format, frameCapacity, {}});
+		}
+		catch(const std::exception& e) {
+			return false;
+		}
+		entry = &mEntries.back();
+	}
+
+	try {
+		entry->mBufferLists.reserve(std::max(entry->mBufferLists.size() + count, mMaximumRetainedBufferLists));
+	}
+	catch(const std::exception& e) {
+		return false;
+	}
+
+	for(size_t i = 0; i < count; ++i) {
+		auto abl = AllocateAudioBufferList(format, frameCapacity, sBufferAlignment, false);
+		if(!abl)
+			return false;
+		entry->mBufferLists.push_back(abl);
+	}
+
+	return true;
+}
+
+void SFB::CABufferListPool::Purge() noexcept
+{
+	std::lock_guard<UnfairLock> lock(mLock);
+
+	for(auto& entry : mEntries) {
+		for(auto abl : entry.mBufferLists)
+			std::free(abl);
+	}
+
+	mEntries.clear();
+}
+
+#pragma mark Internals
+
+void SFB::CABufferListPool::Return(CABufferList& bufferList) noexcept
+{
+	if(!bufferList)
+		return;
+
+	const auto format = bufferList.Format();
+	const auto frameCapacity = bufferList.FrameCapacity();
+
+	{
+		std::lock_guard<UnfairLock> lock(mLock);
+
+		auto entry = FindEntry(format, frameCapacity);
+		if(!entry) {
+			try {
+				mEntries.push_back({format, frameCapacity, {}});
+				entry = &mEntries.back();
+			}
+			catch(...) {}
+		}
+
+		if(entry && entry->mBufferLists.size() < mMaximumRetainedBufferLists) {
+			try {
+				entry->mBufferLists.reserve(mMaximumRetainedBufferLists);
+				entry->mBufferLists.push_back(bufferList.RelinquishABL());
+				return;
+			}
+			catch(...) {}
+		}
+	}
+
+	// The buffer list could not be retained
+	bufferList.Deallocate();
+}
+
+SFB::CABufferListPool::Entry * SFB::CABufferListPool::FindEntry(const CAStreamBasicDescription& format, UInt32 frameCapacity) noexcept
+{
+	for(auto& entry : mEntries) {
+		if(entry.mFrameCapacity == frameCapacity && entry.mFormat == format)
+			return &entry;
+	}
+	return nullptr;
+}
@@ -1,16 +1,18 @@
 //
-// Copyright © 2013-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2013-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
 
 #import <algorithm>
 #import <cassert>
+#import <cstddef>
 #import <cstdlib>
 #import <cstring>
 #import <limits>
 
 #import "SFBCARingBuffer.hpp"
+#import "SFBChannelBuffers.hpp"
 
 namespace {
 
@@ -75,6 +77,48 @@ void FetchABL(AudioBufferList * const _Nonnull bufferList, uint32_t dstOffset, c
 	}
 }
 
+/// Returns the size in bytes of an @c AudioBufferList containing @c bufferCount buffers
+/// @param bufferCount The number of buffers
+/// @return The size in bytes of the @c AudioBufferList
+constexpr size_t BufferListSize(uint32_t bufferCount) noexcept
+{
+	return offsetof(AudioBufferList, mBuffers) + (sizeof(AudioBuffer) * bufferCount);
+}
+
+/// Allocates four @c AudioBufferList structures for @c format in one chunk of memory
+/// @param format The format of the audio described by the buffer lists
+/// @return The buffer lists or @c nullptr on error
+void * _Nullable AllocateBufferLists(const SFB::CAStreamBasicDescription& format) noexcept
+{
+	const auto bufferCount = format.ChannelStreamCount();
+	const auto bufferListSize = BufferListSize(bufferCount);
+	auto allocation = std::calloc(4, bufferListSize);
+	if(!allocation)
+		return nullptr;
+
+	for(auto i = 0; i < 4; ++i) {
+		auto bufferList = reinterpret_cast<AudioBufferList *>(reinterpret_cast<uintptr_t>(allocation) + (i * bufferListSize));
+		bufferList->mNumberBuffers = bufferCount;
+		for(UInt32 j = 0; j < bufferCount; ++j)
+			bufferList->mBuffers[j].mNumberChannels = format.InterleavedChannelCount();
+	}
+
+	return allocation;
+}
+
+/// Sets the buffers in @c bufferList to point to a region of @c buffers
+/// @param bufferList The buffer list to modify
+/// @param buffers The source buffers
+/// @param byteOffset The byte offset in @c buffers of the region
+/// @param byteCount The number of bytes per non-interleaved buffer in the region
+void SetBufferListRegion(AudioBufferList * const _Nonnull bufferList, void * const _Nonnull * const _Nonnull buffers, uint32_t byteOffset, uint32_t byteCount) noexcept
+{
+	for(UInt32 i = 0; i < bufferList->mNumberBuffers; ++i) {
+		bufferList->mBuffers[i].mData = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(buffers[i]) + byteOffset);
+		bufferList->mBuffers[i].mDataByteSize = byteCount;
+	}
+}
+
 /// Returns the smallest power of two value greater than @c x
 /// @param x A value in the range [2..2147483648]
 /// @return The smallest power of two greater than @c x
@@ -89,7 +133,14 @@ constexpr uint32_t NextPowerOfTwo(uint32_t x) noexcept
 
 #pragma mark Buffer Management
 
-bool SFB::CARingBuffer::Allocate(const CAStreamBasicDescription& format, uint32_t capacityFrames) noexcept
+template <typename Counters>
+bool SFB::BasicCARingBuffer<Counters>::Allocate(const CAStreamBasicDescription& format, uint32_t capacityFrames) noexcept
+{
+	return Allocate(format, capacityFrames, sizeof(void *), false);
+}
+
+template <typename Counters>
+bool SFB::BasicCARingBuffer<Counters>::Allocate(const CAStreamBasicDescription& format, uint32_t capacityFrames, size_t alignment, bool padChannelStride) noexcept
 {
 	// Only non-interleaved formats are supported
 	if(format.IsInterleaved() || capacityFrames < 2 || capacityFrames > 0x80000000)
@@ -105,25 +156,25 @@ bool SFB::CARingBuffer::Allocate(const CAStreamBasicDescription& format, uint32_
 	mCapacityFrames = capacityFrames;
 	mCapacityFramesMask = capacityFrames - 1;
 
-	const auto capacityBytes = capacityFrames * format.mBytesPerFrame;
+	const auto capacityBytes = static_cast<size_t>(capacityFrames) * format.mBytesPerFrame;
 
 	// One memory allocation holds everything- first the pointers followed by the deinterleaved channels
-	const auto allocationSize = (capacityBytes + sizeof(void *)) * format.mChannelsPerFrame;
-	auto allocation = std::malloc(allocationSize);
-	if(!allocation)
+	mBuffers = detail::AllocateChannelBuffers(format.mChannelsPerFrame, capacityBytes, alignment, padChannelStride);
+	if(!mBuffers) {
+		mFormat.Reset();
+		mCapacityFrames = 0;
+		mCapacityFramesMask = 0;
 		return false;
+	}
 
-	// Zero the entire allocation
-	std::memset(allocation, 0, allocationSize);
-
-	// Assign the pointers and channel buffers
-	auto address = reinterpret_cast<uintptr_t>(allocation);
-
-	mBuffers = reinterpret_cast<void **>(address);
-	address += format.mChannelsPerFrame * sizeof(void *);
-	for(UInt32 i = 0; i < format.mChannelsPerFrame; ++i) {
-		mBuffers[i] = reinterpret_cast<void *>(address);
-		address += capacityBytes;
+	mBufferLists = AllocateBufferLists(format);
+	if(!mBufferLists) {
+		std::free(mBuffers);
+		mBuffers = nullptr;
+		mFormat.Reset();
+		mCapacityFrames = 0;
+		mCapacityFramesMask = 0;
+		return false;
 	}
 
 	// Zero the time bounds queue
@@ -138,12 +189,16 @@ bool SFB::CARingBuffer::Allocate(const CAStreamBasicDescription& format, uint32_
 	return true;
 }
 
-void SFB::CARingBuffer::Deallocate() noexcept
+template <typename Counters>
+void SFB::BasicCARingBuffer<Counters>::Deallocate() noexcept
 {
 	if(mBuffers) {
 		std::free(mBuffers);
 		mBuffers = nullptr;
 
+		std::free(mBufferLists);
+		mBufferLists = nullptr;
+
 		mFormat.Reset();
 
 		mCapacityFrames = 0;
@@ -159,13 +214,14 @@ void SFB::CARingBuffer::Deallocate() noexcept
 	}
 }
 
-bool SFB::CARingBuffer::GetTimeBounds(int64_t& startTime, int64_t& endTime) const noexcept
+template <typename Counters>
+bool SFB::BasicCARingBuffer<Counters>::GetTimeBounds(int64_t& startTime, int64_t& endTime) const noexcept
 {
 	for(auto i = 0; i < 8; ++i) {
 		const auto currentCounter = mTimeBoundsQueueCounter.load(std::memory_order_acquire);
 		const auto currentIndex = currentCounter & sTimeBoundsQueueMask;
 
-		const SFB::CARingBuffer::TimeBounds * const bounds = mTimeBoundsQueue + currentIndex;
+		const TimeBounds * const bounds = mTimeBoundsQueue + currentIndex;
 
 		startTime = bounds->mStartTime;
 		endTime = bounds->mEndTime;
@@ -175,12 +231,15 @@ bool SFB::CARingBuffer::GetTimeBounds(int64_t& startTime, int64_t& endTime) cons
 			return true;
 	}
 
+	mCounters.RecordTimeBoundsFailure();
+
 	return false;
 }
 
 #pragma mark Reading and Writing Audio
 
-bool SFB::CARingBuffer::Read(AudioBufferList * const bufferList, uint32_t frameCount, int64_t startRead) noexcept
+template <typename Counters>
+bool SFB::BasicCARingBuffer<Counters>::Read(AudioBufferList * const bufferList, uint32_t frameCount, int64_t startRead) noexcept
 {
 	if(frameCount == 0)
 		return true;
@@ -196,6 +255,9 @@ bool SFB::CARingBuffer::Read(AudioBufferList * const bufferList, uint32_t frameC
 	if(!ClampTimesToBounds(startRead, endRead))
 		return false;
 
+	if(startRead != startRead0 || endRead != endRead0)
+		mCounters.RecordZeroFilledRead();
+
 	if(startRead == endRead) {
 		ZeroABL(bufferList, 0, frameCount * mFormat.mBytesPerFrame);
 		return true;
@@ -232,7 +294,8 @@ bool SFB::CARingBuffer::Read(AudioBufferList * const bufferList, uint32_t frameC
 	return true;
 }
 
-bool SFB::CARingBuffer::Write(const AudioBufferList * const bufferList, uint32_t frameCount, int64_t startWrite) noexcept
+template <typename Counters>
+bool SFB::BasicCARingBuffer<Counters>::Write(const AudioBufferList * const bufferList, uint32_t frameCount, int64_t startWrite) noexcept
 {
 	if(frameCount == 0)
 		return true;
@@ -242,6 +305,98 @@ bool SFB::CARingBuffer::Write(const AudioBufferList * const bufferList, uint32_t
 
 	const auto endWrite = startWrite + static_cast<int64_t>(frameCount);
 
+	const auto offset0 = PrepareWrite(startWrite, endWrite);
+	const auto offset1 = FrameByteOffset(endWrite);
+	if(offset0 < offset1)
+		StoreABL(mBuffers, offset0, bufferList, 0, offset1 - offset0);
+	else {
+		auto byteCount = (mCapacityFrames * mFormat.mBytesPerFrame) - offset0;
+		StoreABL(mBuffers, offset0, bufferList, 0, byteCount);
+		StoreABL(mBuffers, 0, bufferList, byteCount, offset1);
+	}
+
+	// Update the end time
+	SetTimeBounds(StartTime(), endWrite);
+
+	return true;
+}
+
+#pragma mark Advanced Reading and Writing
+
+template <typename Counters>
+const typename SFB::BasicCARingBuffer<Counters>::ReadBufferPair SFB::BasicCARingBuffer<Counters>::ReadVector(int64_t startRead, uint32_t frameCount) const noexcept
+{
+	if(frameCount == 0 || frameCount > mCapacityFrames || startRead < 0)
+		return { {}, {} };
+
+	auto endRead = startRead + static_cast<int64_t>(frameCount);
+	if(!ClampTimesToBounds(startRead, endRead) || startRead == endRead)
+		return { {}, {} };
+
+	const auto framesToRead = static_cast<uint32_t>(endRead - startRead);
+	const auto offset0 = FrameByteOffset(startRead);
+	const auto framesAfterOffset0 = mCapacityFrames - (offset0 / mFormat.mBytesPerFrame);
+
+	const auto bufferListSize = BufferListSize(mFormat.ChannelStreamCount());
+	auto first = reinterpret_cast<AudioBufferList *>(mBufferLists);
+	auto second = reinterpret_cast<AudioBufferList *>(reinterpret_cast<uintptr_t>(mBufferLists) + bufferListSize);
+
+	if(framesToRead > framesAfterOffset0) {
+		SetBufferListRegion(first, mBuffers, offset0, framesAfterOffset0 * mFormat.mBytesPerFrame);
+		SetBufferListRegion(second, mBuffers, 0, (framesToRead - framesAfterOffset0) * mFormat.mBytesPerFrame);
+		return { { first, startRead, framesAfterOffset0 }, { second, startRead + framesAfterOffset0, framesToRead - framesAfterOffset0 } };
+	}
+
+	SetBufferListRegion(first, mBuffers, offset0, framesToRead * mFormat.mBytesPerFrame);
+	return { { first, startRead, framesToRead }, {} };
+}
+
+template <typename Counters>
+const typename SFB::BasicCARingBuffer<Counters>::WriteBufferPair SFB::BasicCARingBuffer<Counters>::WriteVector(int64_t startWrite, uint32_t frameCount) noexcept
+{
+	if(frameCount == 0 || frameCount > mCapacityFrames || startWrite < 0)
+		return { {}, {} };
+
+	const auto endWrite = startWrite + static_cast<int64_t>(frameCount);
+	const auto offset0 = PrepareWrite(startWrite, endWrite);
+
+	// Any skipped samples are now silence and become part of the buffer's valid range
+	// so AdvanceWritePosition() may extend the end time from startWrite
+	if(EndTime() < startWrite)
+		SetTimeBounds(StartTime(), startWrite);
+
+	const auto framesAfterOffset0 = mCapacityFrames - (offset0 / mFormat.mBytesPerFrame);
+
+	const auto bufferListSize = BufferListSize(mFormat.ChannelStreamCount());
+	auto first = reinterpret_cast<AudioBufferList *>(reinterpret_cast<uintptr_t>(mBufferLists) + (2 * bufferListSize));
+	auto second = reinterpret_cast<AudioBufferList *>(reinterpret_cast<uintptr_t>(mBufferLists) + (3 * bufferListSize));
+
+	if(frameCount > framesAfterOffset0) {
+		SetBufferListRegion(first, mBuffers, offset0, framesAfterOffset0 * mFormat.mBytesPerFrame);
+		SetBufferListRegion(second, mBuffers, 0, (frameCount - framesAfterOffset0) * mFormat.mBytesPerFrame);
+		return { { first, framesAfterOffset0 }, { second, frameCount - framesAfterOffset0 } };
+	}
+
+	SetBufferListRegion(first, mBuffers, offset0, frameCount * mFormat.mBytesPerFrame);
+	return { { first, frameCount }, {} };
+}
+
+template <typename Counters>
+void SFB::BasicCARingBuffer<Counters>::AdvanceWritePosition(uint32_t frameCount) noexcept
+{
+	if(frameCount == 0)
+		return;
+
+	const auto endTime = EndTime() + static_cast<int64_t>(frameCount);
+	const auto startTime = std::max(StartTime(), endTime - static_cast<int64_t>(mCapacityFrames));
+	SetTimeBounds(startTime, endTime);
+}
+
+#pragma mark Internals
+
+template <typename Counters>
+uint32_t SFB::BasicCARingBuffer<Counters>::PrepareWrite(int64_t startWrite, int64_t endWrite) noexcept
+{
 	// Going backwards, throw everything out
 	if(startWrite < EndTime())
 		SetTimeBounds(startWrite, startWrite);
@@ -255,13 +410,12 @@ bool SFB::CARingBuffer::Write(const AudioBufferList * const bufferList, uint32_t
 		SetTimeBounds(newStart, newEnd);
 	}
 
-	uint32_t offset0, offset1;
 	const auto curEnd = EndTime();
 
 	if(startWrite > curEnd) {
 		// Zero the range of samples being skipped
-		offset0 = FrameByteOffset(curEnd);
-		offset1 = FrameByteOffset(startWrite);
+		const auto offset0 = FrameByteOffset(curEnd);
+		const auto offset1 = FrameByteOffset(startWrite);
 		if(offset0 < offset1)
 			ZeroRange(mBuffers, mFormat.ChannelStreamCount(), offset0, offset1 - offset0);
 		else {
@@ -269,29 +423,14 @@ bool SFB::CARingBuffer::Write(const AudioBufferList * const bufferList, uint32_t
 			ZeroRange(mBuffers, mFormat.ChannelStreamCount(), 0, offset1);
 		}
 
-		offset0 = offset1;
-	}
-	else
-		offset0 = FrameByteOffset(startWrite);
-
-	offset1 = FrameByteOffset(endWrite);
-	if(offset0 < offset1)
-		StoreABL(mBuffers, offset0, bufferList, 0, offset1 - offset0);
-	else {
-		auto byteCount = (mCapacityFrames * mFormat.mBytesPerFrame) - offset0;
-		StoreABL(mBuffers, offset0, bufferList, 0, byteCount);
-		StoreABL(mBuffers, 0, bufferList, byteCount, offset1);
+		return offset1;
 	}
 
-	// Update the end time
-	SetTimeBounds(StartTime(), endWrite);
-
-	return true;
+	return FrameByteOffset(startWrite);
 }
 
-#pragma mark Internals
-
-void SFB::CARingBuffer::SetTimeBounds(int64_t startTime, int64_t endTime) noexcept
+template <typename Counters>
+void SFB::BasicCARingBuffer<Counters>::SetTimeBounds(int64_t startTime, int64_t endTime) noexcept
 {
 	const auto nextCounter = mTimeBoundsQueueCounter.load(std::memory_order_acquire) + 1;
 	const auto nextIndex = nextCounter & sTimeBoundsQueueMask;
@@ -303,7 +442,8 @@ void SFB::CARingBuffer::SetTimeBounds(int64_t startTime, int64_t endTime) noexce
 	mTimeBoundsQueueCounter.store(nextCounter, std::memory_order_release);
 }
 
-bool SFB::CARingBuffer::ClampTimesToBounds(int64_t& startRead, int64_t& endRead) const noexcept
+template <typename Counters>
+bool SFB::BasicCARingBuffer<Counters>::ClampTimesToBounds(int64_t& startRead, int64_t& endRead) const noexcept
 {
 	int64_t startTime, endTime;
 	if(!GetTimeBounds(startTime, endTime))
@@ -319,3 +459,8 @@ bool SFB::CARingBuffer::ClampTimesToBounds(int64_t& startRead, int64_t& endRead)
 
 	return true;
 }
+
+#pragma mark Explicit Instantiations
+
+template class SFB::BasicCARingBuffer<SFB::NullRingBufferCounters>;
+template class SFB::BasicCARingBuffer<SFB::RingBufferCounters>;
@@ -0,0 +1,383 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cstring>
+#import <stdexcept>
+#import <string>
+#import <system_error>
+
+#import <fcntl.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import <unistd.h>
+
+#import "SFBCachingAudioFileDataSource.hpp"
+
+namespace {
+
+/// Returns the file system path of @c url
+/// @throw @c std::invalid_argument If @c url is not a file URL
+std::string FileSystemPath(CFURLRef url)
+{
+	char path [PATH_MAX];
+	if(!CFURLGetFileSystemRepresentation(url, true, reinterpret_cast<UInt8 *>(path), PATH_MAX))
+		throw std::invalid_argument("Unable to get file system representation of URL");
+	return path;
+}
+
+} /* namespace */
+
+#pragma mark Creation and Destruction
+
+SFB::CachingAudioFileDataSource::CachingAudioFileDataSource(int64_t size, FetchFunction fetch)
+: CachingAudioFileDataSource(size, std::move(fetch), Options())
+{}
+
+SFB::CachingAudioFileDataSource::CachingAudioFileDataSource(int64_t size, FetchFunction fetch, const Options& options)
+: mSize{size}, mFetch{std::move(fetch)}, mBlockSize{options.mBlockSize}, mCacheBlocks{options.mCacheBlocks}, mReadAheadBlocks{options.mReadAheadBlocks}
+{
+	if(size < 0)
+		throw std::invalid_argument("size < 0");
+	if(!mFetch)
+		throw std::invalid_argument("Empty fetch function");
+	if(options.mBlockSize == 0)
+		throw std::invalid_argument("mBlockSize == 0");
+	if(options.mCacheBlocks <= options.mReadAheadBlocks)
+		throw std::invalid_argument("mCacheBlocks <= mReadAheadBlocks");
+	if(options.mFetchThreads == 0)
+		throw std::invalid_argument("mFetchThreads == 0");
+
+	mBlockIndex.reserve(mCacheBlocks);
+
+	try {
+		for(uint32_t i = 0; i < options.mFetchThreads; ++i)
+			mWorkers.emplace_back(&CachingAudioFileDataSource::WorkerThreadEntry, this);
+	}
+	catch(...) {
+		{
+			std::lock_guard lock{mMutex};
+			mStopWorkers = true;
+		}
+		mWorkCondition.notify_all();
+		for(auto& worker : mWorkers)
+			worker.join();
+		throw;
+	}
+}
+
+SFB::CachingAudioFileDataSource::CachingAudioFileDataSource(const void *bytes, size_t size) noexcept
+: mSize{static_cast<int64_t>(size)}, mBytes{bytes}
+{}
+
+SFB::CachingAudioFileDataSource::CachingAudioFileDataSource(const char *path)
+{
+	const auto fd = open(path, O_RDONLY);
+	if(fd == -1)
+		throw std::system_error(errno, std::generic_category(), "open");
+
+	struct stat s;
+	if(fstat(fd, &s) == -1) {
+		const auto error = errno;
+		close(fd);
+		throw std::system_error(error, std::generic_category(), "fstat");
+	}
+
+	// An empty file cannot be mapped but is a valid, empty data source
+	if(s.st_size > 0) {
+		auto mapping = mmap(nullptr, static_cast<size_t>(s.st_size), PROT_READ, MAP_SHARED, fd, 0);
+		const auto error = errno;
+		// The mapping remains valid after the file descriptor is closed
+		close(fd);
+		if(mapping == MAP_FAILED)
+			throw std::system_error(error, std::generic_category(), "mmap");
+		mMapping = mapping;
+		mBytes = mapping;
+	}
+	else
+		close(fd);
+
+	mSize = s.st_size;
+}
+
+SFB::CachingAudioFileDataSource::CachingAudioFileDataSource(CFURLRef url)
+: CachingAudioFileDataSource(FileSystemPath(url).c_str())
+{}
+
+SFB::CachingAudioFileDataSource::~CachingAudioFileDataSource()
+{
+	{
+		std::lock_guard lock{mMutex};
+		mStopWorkers = true;
+	}
+	mWorkCondition.notify_all();
+	for(auto& worker : mWorkers)
+		worker.join();
+
+	if(mMapping)
+		munmap(mMapping, static_cast<size_t>(mSize));
+}
+
+#pragma mark Audio Files
+
+OSStatus SFB::CachingAudioFileDataSource::ReadProc(void *inClientData, SInt64 inPosition, UInt32 requestCount, void *buffer, UInt32 *actualCount) noexcept
+{
+	auto source = static_cast<CachingAudioFileDataSource *>(inClientData);
+	auto bytesRead = source->Read(inPosition, buffer, requestCount);
+	if(!bytesRead) {
+		*actualCount = 0;
+		return kAudioFileUnspecifiedError;
+	}
+	*actualCount = static_cast<UInt32>(*bytesRead);
+	return noErr;
+}
+
+SInt64 SFB::CachingAudioFileDataSource::GetSizeProc(void *inClientData) noexcept
+{
+	return static_cast<CachingAudioFileDataSource *>(inClientData)->mSize;
+}
+
+#pragma mark Reading
+
+std::optional<size_t> SFB::CachingAudioFileDataSource::Read(int64_t position, void *buffer, size_t count) noexcept
+{
+	if(position < 0)
+		return std::nullopt;
+	if(position >= mSize || count == 0)
+		return 0;
+
+	count = static_cast<size_t>(std::min(static_cast<uint64_t>(count), static_cast<uint64_t>(mSize - position)));
+
+	if(!mFetch) {
+		std::memcpy(buffer, static_cast<const uint8_t *>(mBytes) + position, count);
+		return count;
+	}
+
+	const auto firstBlock = static_cast<uint64_t>(position) / mBlockSize;
+	const auto lastBlock = static_cast<uint64_t>(position + static_cast<int64_t>(count) - 1) / mBlockSize;
+	const auto blockCount = (static_cast<uint64_t>(mSize) + mBlockSize - 1) / mBlockSize;
+
+	// Declared before the lock so evicted blocks are freed after it is released
+	BlockList evicted;
+	std::unique_lock lock{mMutex};
+
+	// Request every block in the range before waiting for any so missing blocks are fetched in parallel
+	auto pinnedEnd = firstBlock;
+	try {
+		for(; pinnedEnd <= lastBlock; ++pinnedEnd)
+			++RequestBlock(pinnedEnd, true)->mPinCount;
+	}
+	catch(...) {
+		for(auto index = firstBlock; index < pinnedEnd; ++index)
+			--mBlockIndex.find(index)->second->mPinCount;
+		return std::nullopt;
+	}
+
+	// Reads continuing from the end of the previous read trigger read-ahead
+	if(position == mSequentialPosition) {
+		const auto endBlock = std::min(lastBlock + 1 + mReadAheadBlocks, blockCount);
+		try {
+			for(auto index = lastBlock + 1; index < endBlock; ++index) {
+				if(!RequestBlock(index, false))
+					break;
+			}
+		}
+		catch(...) {
+			// Prefetching is advisory
+		}
+	}
+	mSequentialPosition = position + static_cast<int64_t>(count);
+
+	mWorkCondition.notify_all();
+
+	auto success = true;
+	auto destination = static_cast<uint8_t *>(buffer);
+	for(auto index = firstBlock; index <= lastBlock; ++index) {
+		// Pinned blocks are never evicted
+		auto& block = *mBlockIndex.find(index)->second;
+		mBlockCondition.wait(lock, [&block] { return block.mState != Block::State::pending; });
+
+		if(success && block.mState == Block::State::ready) {
+			const auto blockStart = static_cast<int64_t>(index * mBlockSize);
+			const auto copyStart = std::max(position, blockStart);
+			const auto copyEnd = std::min(position + static_cast<int64_t>(count), blockStart + static_cast<int64_t>(mBlockSize));
+
+			lock.unlock();
+			std::memcpy(destination, block.mData.get() + (copyStart - blockStart), static_cast<size_t>(copyEnd - copyStart));
+			lock.lock();
+
+			destination += copyEnd - copyStart;
+		}
+		else
+			success = false;
+
+		--block.mPinCount;
+	}
+
+	// Blocks added beyond the cache capacity are evicted once no reader needs them
+	if(mBlocks.size() > mCacheBlocks)
+		TrimCache(evicted);
+
+	if(!success)
+		return std::nullopt;
+	return count;
+}
+
+void SFB::CachingAudioFileDataSource::Prefetch(int64_t position, size_t count) noexcept
+{
+	if(!mFetch || position < 0 || position >= mSize || count == 0)
+		return;
+
+	count = static_cast<size_t>(std::min(static_cast<uint64_t>(count), static_cast<uint64_t>(mSize - position)));
+
+	const auto firstBlock = static_cast<uint64_t>(position) / mBlockSize;
+	const auto lastBlock = static_cast<uint64_t>(position + static_cast<int64_t>(count) - 1) / mBlockSize;
+
+	{
+		std::lock_guard lock{mMutex};
+		try {
+			for(auto index = firstBlock; index <= lastBlock; ++index) {
+				if(!RequestBlock(index, false))
+					break;
+			}
+		}
+		catch(...) {
+			// Prefetching is advisory
+		}
+	}
+
+	mWorkCondition.notify_all();
+}
+
+#pragma mark Internals
+
+SFB::CachingAudioFileDataSource::Block * SFB::CachingAudioFileDataSource::RequestBlock(uint64_t index, bool demand)
+{
+	if(auto iter = mBlockIndex.find(index); iter != mBlockIndex.end()) {
+		auto& block = *iter->second;
+		mBlocks.splice(mBlocks.begin(), mBlocks, iter->second);
+
+		if(demand) {
+			mHits.fetch_add(1, std::memory_order_relaxed);
+
+			// Retry a failed fetch once no other reader is waiting on it
+			if(block.mState == Block::State::failed && block.mPinCount == 0) {
+				block.mState = Block::State::pending;
+				mRequests.push_front(&block);
+			}
+			// Move a queued prefetch ahead of the other requests
+			else if(block.mState == Block::State::pending) {
+				if(auto request = std::find(mRequests.begin(), mRequests.end(), &block); request != mRequests.end() && request != mRequests.begin()) {
+					mRequests.erase(request);
+					mRequests.push_front(&block);
+				}
+			}
+		}
+
+		return &block;
+	}
+
+	// Reuse the least recently used block that is neither being fetched nor being read
+	auto victim = mBlocks.end();
+	if(mBlocks.size() >= mCacheBlocks) {
+		for(auto iter = mBlocks.rbegin(); iter != mBlocks.rend(); ++iter) {
+			if(iter->mState != Block::State::pending && iter->mPinCount == 0) {
+				victim = std::prev(iter.base());
+				break;
+			}
+		}
+
+		// The cache may grow temporarily for blocks needed by readers but not for prefetching
+		if(victim == mBlocks.end() && !demand)
+			return nullptr;
+	}
+
+	if(victim != mBlocks.end()) {
+		mBlockIndex.erase(victim->mIndex);
+		mBlocks.splice(mBlocks.begin(), mBlocks, victim);
+	}
+	else
+		mBlocks.push_front({ 0, Block::State::pending, 0, std::make_unique<uint8_t[]>(mBlockSize) });
+
+	auto& block = mBlocks.front();
+	block.mIndex = index;
+	block.mState = Block::State::pending;
+	block.mPinCount = 0;
+
+	try {
+		mBlockIndex.emplace(index, mBlocks.begin());
+		if(demand)
+			mRequests.push_front(&block);
+		else
+			mRequests.push_back(&block);
+	}
+	catch(...) {
+		mBlockIndex.erase(index);
+		mBlocks.pop_front();
+		throw;
+	}
+
+	if(demand)
+		mMisses.fetch_add(1, std::memory_order_relaxed);
+	else
+		mPrefetches.fetch_add(1, std::memory_order_relaxed);
+
+	return &block;
+}
+
+void SFB::CachingAudioFileDataSource::TrimCache(BlockList& evicted) noexcept
+{
+	for(auto iter = mBlocks.end(); iter != mBlocks.begin() && mBlocks.size() > mCacheBlocks;) {
+		--iter;
+		if(iter->mState != Block::State::pending && iter->mPinCount == 0) {
+			mBlockIndex.erase(iter->mIndex);
+			evicted.splice(evicted.end(), mBlocks, iter++);
+		}
+	}
+}
+
+size_t SFB::CachingAudioFileDataSource::BlockLength(uint64_t index) const noexcept
+{
+	const auto blockStart = index * mBlockSize;
+	return static_cast<size_t>(std::min(static_cast<uint64_t>(mBlockSize), static_cast<uint64_t>(mSize) - blockStart));
+}
+
+void SFB::CachingAudioFileDataSource::WorkerThreadEntry() noexcept
+{
+	std::unique_lock lock{mMutex};
+	for(;;) {
+		mWorkCondition.wait(lock, [this] { return mStopWorkers || !mRequests.empty(); });
+		if(mStopWorkers)
+			return;
+
+		// Blocks being fetched are never evicted so the block remains valid while the lock is released
+		auto block = mRequests.front();
+		mRequests.pop_front();
+
+		const auto offset = static_cast<int64_t>(block->mIndex * mBlockSize);
+		const auto length = BlockLength(block->mIndex);
+		const auto data = block->mData.get();
+
+		lock.unlock();
+		auto success = false;
+		try {
+			success = mFetch(offset, data, length);
+		}
+		catch(...) {}
+		lock.lock();
+
+		if(success) {
+			block->mState = Block::State::ready;
+			mBytesFetched.fetch_add(length, std::memory_order_relaxed);
+		}
+		else {
+			block->mState = Block::State::failed;
+			mFetchErrors.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		mBlockCondition.notify_all();
+	}
+}
@@ -0,0 +1,46 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <cstdlib>
+#import <cstring>
+#import <limits>
+
+#import "SFBChannelBuffers.hpp"
+
+void * _Nonnull * _Nullable SFB::detail::AllocateChannelBuffers(uint32_t channelCount, size_t byteCount, size_t alignment, bool padChannelStride) noexcept
+{
+	if(channelCount == 0 || alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0)
+		return nullptr;
+
+	const auto alignmentMask = alignment - 1;
+	const auto pointersSize = (channelCount * sizeof(void *) + alignmentMask) & ~alignmentMask;
+
+	if(byteCount > std::numeric_limits<size_t>::max() - alignment - sCacheLineSize)
+		return nullptr;
+
+	const auto channelStride = ChannelStride(byteCount, alignment, padChannelStride && channelCount > 1);
+
+	if(channelStride > (std::numeric_limits<size_t>::max() - pointersSize) / channelCount)
+		return nullptr;
+
+	const auto allocationSize = pointersSize + (channelStride * channelCount);
+
+	void *allocation = nullptr;
+	if(posix_memalign(&allocation, alignment, allocationSize) != 0)
+		return nullptr;
+
+	// Zero the entire allocation
+	std::memset(allocation, 0, allocationSize);
+
+	// Assign the pointers and channel buffers
+	const auto address = reinterpret_cast<uintptr_t>(allocation);
+
+	auto buffers = reinterpret_cast<void **>(address);
+	for(uint32_t i = 0; i < channelCount; ++i)
+		buffers[i] = reinterpret_cast<void *>(address + pointersSize + (channelStride * i));
+
+	return buffers;
+}
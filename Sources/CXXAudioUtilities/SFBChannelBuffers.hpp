@@ -0,0 +1,58 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <cstddef>
+#import <cstdint>
+
+namespace SFB {
+
+namespace detail {
+
+/// The assumed size of a cache line in bytes
+#if defined(__arm64__) || defined(__aarch64__)
+constexpr size_t sCacheLineSize = 128;
+#else
+constexpr size_t sCacheLineSize = 64;
+#endif /* defined(__arm64__) || defined(__aarch64__) */
+
+/// The distance in bytes at which addresses map to the same L1 cache set on supported processors
+constexpr size_t sCacheSetAliasingStride = 4096;
+
+/// Returns the distance in bytes between consecutive channel buffers holding @c byteCount bytes each
+///
+/// The stride is a multiple of @c alignment. If @c padChannelStride is @c true and the stride is a multiple of
+/// @c sCacheSetAliasingStride it is increased by one cache line so corresponding samples in different channels do not
+/// map to the same cache set. A padded stride is a multiple of the smaller of @c alignment and @c sCacheLineSize.
+/// @param byteCount The size of each channel buffer in bytes
+/// @param alignment The alignment of the channel buffers, which must be a power of two
+/// @param padChannelStride Whether to pad the stride to avoid cache set aliasing
+/// @return The channel stride in bytes
+constexpr size_t ChannelStride(size_t byteCount, size_t alignment, bool padChannelStride) noexcept
+{
+	auto channelStride = (byteCount + alignment - 1) & ~(alignment - 1);
+	if(padChannelStride && channelStride % sCacheSetAliasingStride == 0)
+		channelStride += sCacheLineSize;
+	return channelStride;
+}
+
+/// Allocates zero-filled storage for @c channelCount channel buffers of @c byteCount bytes in one chunk of memory
+///
+/// The allocation begins with the array of channel pointers followed by the channel buffers. The allocation and the
+/// first channel buffer begin on an @c alignment boundary. If @c padChannelStride is @c true and there is more than one
+/// channel the channel stride is padded as described for @c ChannelStride(), in which case the remaining channel buffers
+/// are guaranteed only to begin on a boundary of the smaller of @c alignment and @c sCacheLineSize.
+/// @param channelCount The number of channels
+/// @param byteCount The size of each channel buffer in bytes
+/// @param alignment The alignment of the allocation, which must be a power of two multiple of @c sizeof(void *)
+/// @param padChannelStride Whether to pad the distance between channel buffers to avoid cache set aliasing
+/// @return The channel pointers, which should be deallocated using @c std::free, or @c nullptr on error
+void * _Nonnull * _Nullable AllocateChannelBuffers(uint32_t channelCount, size_t byteCount, size_t alignment, bool padChannelStride) noexcept;
+
+} /* namespace detail */
+
+} /* namespace SFB */
@@ -0,0 +1,248 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cstring>
+#import <stdexcept>
+#import <system_error>
+
+#import <Accelerate/Accelerate.h>
+#import <AudioToolbox/AudioFormat.h>
+
+#import "SFBChannelRemixPlan.hpp"
+#import "SFBCAException.hpp"
+
+namespace {
+
+/// A pointer to the samples of one channel and the distance between them
+struct ChannelSamples {
+	/// The first sample
+	Float32 *mData;
+	/// The distance between samples
+	vDSP_Stride mStride;
+};
+
+/// Returns @c true if @c bufferList has the layout described by @c format, @c channelCount channels, and at least
+/// @c frameCount frames of capacity in each buffer
+bool ValidateBufferList(const AudioBufferList& bufferList, const SFB::CAStreamBasicDescription& format, UInt32 channelCount, UInt32 frameCount) noexcept
+{
+	if(format.CommonFormat() != SFB::CommonPCMFormat::float32 || format.ChannelCount() != channelCount)
+		return false;
+
+	const auto bufferCount = format.IsInterleaved() ? 1 : channelCount;
+	if(bufferList.mNumberBuffers != bufferCount)
+		return false;
+
+	const auto bytesPerBuffer = static_cast<size_t>(frameCount) * format.mBytesPerFrame;
+	for(UInt32 i = 0; i < bufferCount; ++i) {
+		if(!bufferList.mBuffers[i].mData || bufferList.mBuffers[i].mDataByteSize < bytesPerBuffer)
+			return false;
+	}
+
+	return true;
+}
+
+/// Returns the samples for @c channel in @c bufferList
+ChannelSamples Samples(const AudioBufferList& bufferList, const SFB::CAStreamBasicDescription& format, UInt32 channel) noexcept
+{
+	if(format.IsInterleaved())
+		return { static_cast<Float32 *>(bufferList.mBuffers[0].mData) + channel, static_cast<vDSP_Stride>(format.mChannelsPerFrame) };
+	return { static_cast<Float32 *>(bufferList.mBuffers[channel].mData), 1 };
+}
+
+} /* namespace */
+
+#pragma mark Creation and Destruction
+
+SFB::ChannelRemixPlan::ChannelRemixPlan(const CAChannelLayout& inputLayout, const CAChannelLayout& outputLayout)
+{
+	if(!inputLayout || !outputLayout)
+		throw std::invalid_argument("Empty channel layout");
+
+	mInputChannelCount = inputLayout.ChannelCount();
+	mOutputChannelCount = outputLayout.ChannelCount();
+	if(mInputChannelCount == 0 || mOutputChannelCount == 0)
+		throw std::invalid_argument("Channel layout with no channels");
+
+	const AudioChannelLayout *layouts [] = {
+		inputLayout.ChannelLayout(),
+		outputLayout.ChannelLayout()
+	};
+
+	std::vector<Float32> matrix(static_cast<size_t>(mInputChannelCount) * mOutputChannelCount);
+	auto size = static_cast<UInt32>(matrix.size() * sizeof(Float32));
+	auto result = AudioFormatGetProperty(kAudioFormatProperty_MatrixMixMap, sizeof(layouts), static_cast<void *>(layouts), &size, matrix.data());
+	ThrowIfCAAudioFormatError(result, "AudioFormatGetProperty (kAudioFormatProperty_MatrixMixMap)");
+	if(size != matrix.size() * sizeof(Float32))
+		throw std::system_error(std::error_code(kAudioFormatBadPropertySizeError, CAAudioFormatErrorCategory()), "AudioFormatGetProperty (kAudioFormatProperty_MatrixMixMap)");
+
+	Compile(matrix);
+}
+
+SFB::ChannelRemixPlan::ChannelRemixPlan(UInt32 inputChannelCount, UInt32 outputChannelCount, const std::vector<Float32>& matrix)
+: mInputChannelCount{inputChannelCount}, mOutputChannelCount{outputChannelCount}
+{
+	if(inputChannelCount == 0 || outputChannelCount == 0)
+		throw std::invalid_argument("Channel count of zero");
+	if(matrix.size() != static_cast<size_t>(inputChannelCount) * outputChannelCount)
+		throw std::invalid_argument("Mixing matrix size does not match channel counts");
+
+	Compile(matrix);
+}
+
+#pragma mark Properties
+
+Float32 SFB::ChannelRemixPlan::Gain(UInt32 inputChannel, UInt32 outputChannel) const noexcept
+{
+	if(outputChannel >= mOutputChannelCount)
+		return 0;
+	for(auto i = mTermOffsets[outputChannel]; i < mTermOffsets[outputChannel + 1]; ++i) {
+		if(mTerms[i].mInputChannel == inputChannel)
+			return mTerms[i].mGain;
+	}
+	return 0;
+}
+
+#pragma mark Remixing
+
+bool SFB::ChannelRemixPlan::Apply(const CABufferList& input, CABufferList& output) const noexcept
+{
+	if(!input || !output || output.FrameCapacity() < input.FrameLength())
+		return false;
+
+	// Setting the frame length sets each buffer's mDataByteSize, which is validated as the output capacity
+	const auto frameCount = input.FrameLength();
+	if(!output.SetFrameLength(frameCount))
+		return false;
+
+	if(!Apply(*input.ABL(), input.Format(), *output.ABL(), output.Format(), frameCount)) {
+		output.Clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool SFB::ChannelRemixPlan::Apply(const AudioBufferList& input, const CAStreamBasicDescription& inputFormat, AudioBufferList& output, const CAStreamBasicDescription& outputFormat, UInt32 frameCount) const noexcept
+{
+	if(!ValidateBufferList(input, inputFormat, mInputChannelCount, frameCount) || !ValidateBufferList(output, outputFormat, mOutputChannelCount, frameCount))
+		return false;
+
+	for(UInt32 outputChannel = 0; outputChannel < mOutputChannelCount; ++outputChannel) {
+		const auto dst = Samples(output, outputFormat, outputChannel);
+		const auto first = mTermOffsets[outputChannel];
+		const auto last = mTermOffsets[outputChannel + 1];
+
+		if(first == last) {
+			vDSP_vclr(dst.mData, dst.mStride, frameCount);
+			continue;
+		}
+
+		// The first term initializes the output and subsequent terms are accumulated
+		const auto& term = mTerms[first];
+		const auto src = Samples(input, inputFormat, term.mInputChannel);
+		if(term.mGain == 1 && src.mStride == 1 && dst.mStride == 1)
+			std::memcpy(dst.mData, src.mData, frameCount * sizeof(Float32));
+		else
+			vDSP_vsmul(src.mData, src.mStride, &term.mGain, dst.mData, dst.mStride, frameCount);
+
+		for(auto i = first + 1; i < last; ++i) {
+			const auto src = Samples(input, inputFormat, mTerms[i].mInputChannel);
+			vDSP_vsma(src.mData, src.mStride, &mTerms[i].mGain, dst.mData, dst.mStride, dst.mData, dst.mStride, frameCount);
+		}
+	}
+
+	const auto bufferCount = outputFormat.IsInterleaved() ? 1 : mOutputChannelCount;
+	for(UInt32 i = 0; i < bufferCount; ++i)
+		output.mBuffers[i].mDataByteSize = frameCount * outputFormat.mBytesPerFrame;
+
+	return true;
+}
+
+bool SFB::ChannelRemixPlan::RebindBuffers(const AudioBufferList& input, AudioBufferList& output) const noexcept
+{
+	if(!mIsChannelMap || input.mNumberBuffers != mInputChannelCount || output.mNumberBuffers != mOutputChannelCount)
+		return false;
+
+	for(auto channel : mChannelMap) {
+		if(channel < 0)
+			return false;
+	}
+
+	for(UInt32 i = 0; i < mOutputChannelCount; ++i)
+		output.mBuffers[i] = input.mBuffers[mChannelMap[i]];
+
+	return true;
+}
+
+void SFB::ChannelRemixPlan::Compile(const std::vector<Float32>& matrix)
+{
+	mTermOffsets.reserve(mOutputChannelCount + 1);
+	mIsChannelMap = true;
+
+	for(UInt32 outputChannel = 0; outputChannel < mOutputChannelCount; ++outputChannel) {
+		mTermOffsets.push_back(static_cast<UInt32>(mTerms.size()));
+		for(UInt32 inputChannel = 0; inputChannel < mInputChannelCount; ++inputChannel) {
+			const auto gain = matrix[static_cast<size_t>(inputChannel) * mOutputChannelCount + outputChannel];
+			if(gain != 0)
+				mTerms.push_back({ inputChannel, gain });
+		}
+
+		const auto termCount = mTerms.size() - mTermOffsets.back();
+		if(termCount > 1 || (termCount == 1 && mTerms.back().mGain != 1))
+			mIsChannelMap = false;
+	}
+	mTermOffsets.push_back(static_cast<UInt32>(mTerms.size()));
+
+	if(mIsChannelMap) {
+		mChannelMap.resize(mOutputChannelCount);
+		for(UInt32 outputChannel = 0; outputChannel < mOutputChannelCount; ++outputChannel) {
+			const auto first = mTermOffsets[outputChannel];
+			mChannelMap[outputChannel] = first < mTermOffsets[outputChannel + 1] ? static_cast<SInt32>(mTerms[first].mInputChannel) : -1;
+		}
+	}
+}
+
+#pragma mark - ChannelRemixPlanCache
+
+std::shared_ptr<const SFB::ChannelRemixPlan> SFB::ChannelRemixPlanCache::Plan(const CAChannelLayout& inputLayout, const CAChannelLayout& outputLayout)
+{
+	auto find = [&] {
+		return std::find_if(mEntries.begin(), mEntries.end(), [&](const Entry& entry) {
+			return entry.mInputLayout == inputLayout && entry.mOutputLayout == outputLayout;
+		});
+	};
+
+	{
+		std::lock_guard lock{mMutex};
+		if(auto iter = find(); iter != mEntries.end()) {
+			mEntries.splice(mEntries.begin(), mEntries, iter);
+			return iter->mPlan;
+		}
+	}
+
+	// Plans are created without holding the lock because retrieving the mixing matrix may be slow
+	auto plan = std::make_shared<const ChannelRemixPlan>(inputLayout, outputLayout);
+	Entry entry{inputLayout, outputLayout, plan};
+
+	std::lock_guard lock{mMutex};
+	if(auto iter = find(); iter != mEntries.end()) {
+		mEntries.splice(mEntries.begin(), mEntries, iter);
+		return iter->mPlan;
+	}
+
+	mEntries.push_front(std::move(entry));
+	if(mEntries.size() > mCapacity)
+		mEntries.pop_back();
+
+	return plan;
+}
+
+void SFB::ChannelRemixPlanCache::RemoveAll() noexcept
+{
+	std::lock_guard lock{mMutex};
+	mEntries.clear();
+}
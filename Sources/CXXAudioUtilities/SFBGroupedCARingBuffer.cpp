@@ -0,0 +1,378 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cassert>
+#import <cstdlib>
+#import <cstring>
+#import <limits>
+
+#import "SFBGroupedCARingBuffer.hpp"
+#import "SFBChannelBuffers.hpp"
+
+namespace {
+
+/// The alignment of each channel buffer in bytes
+constexpr size_t sChannelAlignment = 64;
+
+/// Zeroes a range of bytes in @c buffers
+/// @param buffers The destination buffers
+/// @param bufferCount The number of buffers
+/// @param byteOffset The byte offset in @c buffers to begin writing
+/// @param byteCount The number of bytes per non-interleaved buffer to write
+void ZeroRange(void * const _Nonnull * const _Nonnull buffers, uint32_t bufferCount, uint32_t byteOffset, uint32_t byteCount)
+{
+	for(uint32_t i = 0; i < bufferCount; ++i) {
+		const auto s = reinterpret_cast<uintptr_t>(buffers[i]) + byteOffset;
+		std::memset(reinterpret_cast<void *>(s), 0, byteCount);
+	}
+}
+
+/// Zeroes a range of bytes in @c bufferList
+/// @param bufferList The destination buffers
+/// @param byteOffset The byte offset in @c bufferList to begin writing
+/// @param byteCount The maximum number of bytes per non-interleaved buffer to write
+void ZeroABL(AudioBufferList * const _Nonnull bufferList, uint32_t byteOffset, uint32_t byteCount)
+{
+	for(UInt32 i = 0; i < bufferList->mNumberBuffers; ++i) {
+		assert(byteOffset <= bufferList->mBuffers[i].mDataByteSize);
+		const auto s = reinterpret_cast<uintptr_t>(bufferList->mBuffers[i].mData) + byteOffset;
+		const auto n = std::min(byteCount, bufferList->mBuffers[i].mDataByteSize - byteOffset);
+		std::memset(reinterpret_cast<void *>(s), 0, n);
+	}
+}
+
+/// Copies non-interleaved audio from @c bufferList to @c buffers
+/// @param buffers The destination buffers
+/// @param dstOffset The byte offset in @c buffers to begin writing
+/// @param bufferList The source buffers
+/// @param srcOffset The byte offset in @c bufferList to begin reading
+/// @param byteCount The maximum number of bytes per non-interleaved buffer to read and write
+void StoreABL(void * const _Nonnull * const _Nonnull buffers, uint32_t dstOffset, const AudioBufferList * const _Nonnull bufferList, uint32_t srcOffset, uint32_t byteCount) noexcept
+{
+	for(UInt32 i = 0; i < bufferList->mNumberBuffers; ++i) {
+		assert(srcOffset <= bufferList->mBuffers[i].mDataByteSize);
+		const auto dst = reinterpret_cast<uintptr_t>(buffers[i]) + dstOffset;
+		const auto src = reinterpret_cast<uintptr_t>(bufferList->mBuffers[i].mData) + srcOffset;
+		const auto n = std::min(byteCount, bufferList->mBuffers[i].mDataByteSize - srcOffset);
+		std::memcpy(reinterpret_cast<void *>(dst), reinterpret_cast<const void *>(src), n);
+	}
+}
+
+/// Copies non-interleaved audio from @c buffers to @c bufferList
+/// @param bufferList The destination buffers
+/// @param dstOffset The byte offset in @c bufferList to begin writing
+/// @param buffers The source buffers
+/// @param srcOffset The byte offset in @c bufferList to begin reading
+/// @param byteCount The maximum number of bytes per non-interleaved buffer to read and write
+void FetchABL(AudioBufferList * const _Nonnull bufferList, uint32_t dstOffset, const void * const _Nonnull * const _Nonnull buffers, uint32_t srcOffset, uint32_t byteCount) noexcept
+{
+	for(UInt32 i = 0; i < bufferList->mNumberBuffers; ++i) {
+		assert(dstOffset <= bufferList->mBuffers[i].mDataByteSize);
+		const auto dst = reinterpret_cast<uintptr_t>(bufferList->mBuffers[i].mData) + dstOffset;
+		const auto src = reinterpret_cast<uintptr_t>(buffers[i]) + srcOffset;
+		const auto n = std::min(byteCount, bufferList->mBuffers[i].mDataByteSize - dstOffset);
+		std::memcpy(reinterpret_cast<void *>(dst), reinterpret_cast<const void *>(src), n);
+	}
+}
+
+/// Returns the smallest power of two value greater than @c x
+/// @param x A value in the range [2..2147483648]
+/// @return The smallest power of two greater than @c x
+constexpr uint32_t NextPowerOfTwo(uint32_t x) noexcept
+{
+	assert(x > 1);
+	assert(x <= ((std::numeric_limits<uint32_t>::max() / 2) + 1));
+	return static_cast<uint32_t>(1 << (32 - __builtin_clz(x - 1)));
+}
+
+} /* namespace */
+
+#pragma mark Buffer Management
+
+bool SFB::GroupedCARingBuffer::Allocate(const std::vector<CAStreamBasicDescription>& formats, uint32_t capacityFrames) noexcept
+{
+	if(formats.empty() || capacityFrames < 2 || capacityFrames > 0x80000000)
+		return false;
+
+	// Only non-interleaved formats sharing a sample rate are supported
+	const auto sampleRate = formats.front().mSampleRate;
+	for(const auto& format : formats) {
+		if(format.IsInterleaved() || format.mBytesPerFrame == 0 || format.mChannelsPerFrame == 0 || format.mSampleRate != sampleRate)
+			return false;
+	}
+
+	Deallocate();
+
+	// Round up to the next power of two
+	capacityFrames = NextPowerOfTwo(capacityFrames);
+
+	// One memory allocation holds everything- first the pointers for all groups followed by the deinterleaved channels
+	size_t channelCount = 0;
+	size_t channelsSize = 0;
+	for(const auto& format : formats) {
+		const auto capacityBytes = static_cast<uint64_t>(capacityFrames) * format.mBytesPerFrame;
+		if(capacityBytes > std::numeric_limits<uint32_t>::max())
+			return false;
+		const auto groupSize = detail::ChannelStride(static_cast<size_t>(capacityBytes), sChannelAlignment, true) * format.mChannelsPerFrame;
+		if(groupSize > std::numeric_limits<size_t>::max() - channelsSize)
+			return false;
+		channelCount += format.mChannelsPerFrame;
+		channelsSize += groupSize;
+	}
+
+	const auto pointersSize = (channelCount * sizeof(void *) + sChannelAlignment - 1) & ~(sChannelAlignment - 1);
+	if(pointersSize > std::numeric_limits<size_t>::max() - channelsSize)
+		return false;
+
+	const auto allocationSize = pointersSize + channelsSize;
+
+	void *allocation = nullptr;
+	if(posix_memalign(&allocation, sChannelAlignment, allocationSize) != 0)
+		return false;
+
+	try {
+		mGroups.reserve(formats.size());
+	}
+	catch(const std::exception& e) {
+		std::free(allocation);
+		return false;
+	}
+
+	// Zero the entire allocation
+	std::memset(allocation, 0, allocationSize);
+
+	// Assign the pointers and channel buffers
+	auto buffers = static_cast<void **>(allocation);
+	auto address = reinterpret_cast<uintptr_t>(allocation) + pointersSize;
+
+	for(const auto& format : formats) {
+		const auto channelStride = detail::ChannelStride(static_cast<size_t>(capacityFrames) * format.mBytesPerFrame, sChannelAlignment, true);
+		for(UInt32 i = 0; i < format.mChannelsPerFrame; ++i) {
+			buffers[i] = reinterpret_cast<void *>(address);
+			address += channelStride;
+		}
+		mGroups.push_back({format, buffers});
+		buffers += format.mChannelsPerFrame;
+	}
+
+	mAllocation = allocation;
+
+	mCapacityFrames = capacityFrames;
+	mCapacityFramesMask = capacityFrames - 1;
+
+	// Zero the time bounds queue
+	for(uint32_t i = 0; i < sTimeBoundsQueueSize; ++i) {
+		mTimeBoundsQueue[i].mStartTime = 0;
+		mTimeBoundsQueue[i].mEndTime = 0;
+		mTimeBoundsQueue[i].mUpdateCounter = 0;
+	}
+
+	mTimeBoundsQueueCounter = 0;
+
+	return true;
+}
+
+bool SFB::GroupedCARingBuffer::Allocate(const CAStreamBasicDescription& format, uint32_t groupCount, uint32_t capacityFrames) noexcept
+{
+	if(groupCount == 0)
+		return false;
+
+	try {
+		return Allocate(std::vector<CAStreamBasicDescription>(groupCount, format), capacityFrames);
+	}
+	catch(const std::exception& e) {
+		return false;
+	}
+}
+
+void SFB::GroupedCARingBuffer::Deallocate() noexcept
+{
+	if(mAllocation) {
+		std::free(mAllocation);
+		mAllocation = nullptr;
+
+		mGroups.clear();
+
+		mCapacityFrames = 0;
+		mCapacityFramesMask = 0;
+
+		for(uint32_t i = 0; i < sTimeBoundsQueueSize; ++i) {
+			mTimeBoundsQueue[i].mStartTime = 0;
+			mTimeBoundsQueue[i].mEndTime = 0;
+			mTimeBoundsQueue[i].mUpdateCounter = 0;
+		}
+
+		mTimeBoundsQueueCounter = 0;
+	}
+}
+
+bool SFB::GroupedCARingBuffer::GetTimeBounds(int64_t& startTime, int64_t& endTime) const noexcept
+{
+	for(auto i = 0; i < 8; ++i) {
+		const auto currentCounter = mTimeBoundsQueueCounter.load(std::memory_order_acquire);
+		const auto currentIndex = currentCounter & sTimeBoundsQueueMask;
+
+		const SFB::GroupedCARingBuffer::TimeBounds * const bounds = mTimeBoundsQueue + currentIndex;
+
+		startTime = bounds->mStartTime;
+		endTime = bounds->mEndTime;
+
+		const auto counter = bounds->mUpdateCounter.load(std::memory_order_acquire);
+		if(counter == currentCounter)
+			return true;
+	}
+
+	return false;
+}
+
+#pragma mark Reading and Writing Audio
+
+bool SFB::GroupedCARingBuffer::Read(AudioBufferList * const * const bufferLists, uint32_t frameCount, int64_t startRead) noexcept
+{
+	if(frameCount == 0)
+		return true;
+
+	if(!bufferLists || frameCount > mCapacityFrames || startRead < 0)
+		return false;
+
+	auto endRead = startRead + static_cast<int64_t>(frameCount);
+
+	const auto startRead0 = startRead;
+	const auto endRead0 = endRead;
+
+	// All groups are read using the same time bounds
+	if(!ClampTimesToBounds(startRead, endRead))
+		return false;
+
+	const auto framesOfLeadingSilence = static_cast<uint32_t>(startRead - startRead0);
+	const auto framesToRead = static_cast<uint32_t>(endRead - startRead);
+	const auto framesOfTrailingSilence = static_cast<uint32_t>(endRead0 - endRead);
+
+	const auto index0 = FrameIndex(startRead);
+	const auto framesAfterIndex0 = mCapacityFrames - index0;
+
+	for(size_t i = 0; i < mGroups.size(); ++i) {
+		const auto& group = mGroups[i];
+		const auto bufferList = bufferLists[i];
+		const auto bytesPerFrame = group.mFormat.mBytesPerFrame;
+
+		if(framesOfLeadingSilence > 0)
+			ZeroABL(bufferList, 0, framesOfLeadingSilence * bytesPerFrame);
+
+		if(framesToRead > 0) {
+			const auto dstOffset = framesOfLeadingSilence * bytesPerFrame;
+			if(framesToRead <= framesAfterIndex0)
+				FetchABL(bufferList, dstOffset, group.mBuffers, index0 * bytesPerFrame, framesToRead * bytesPerFrame);
+			else {
+				FetchABL(bufferList, dstOffset, group.mBuffers, index0 * bytesPerFrame, framesAfterIndex0 * bytesPerFrame);
+				FetchABL(bufferList, dstOffset + (framesAfterIndex0 * bytesPerFrame), group.mBuffers, 0, (framesToRead - framesAfterIndex0) * bytesPerFrame);
+			}
+		}
+
+		if(framesOfTrailingSilence > 0)
+			ZeroABL(bufferList, (framesOfLeadingSilence + framesToRead) * bytesPerFrame, framesOfTrailingSilence * bytesPerFrame);
+
+		for(UInt32 j = 0; j < bufferList->mNumberBuffers; ++j)
+			bufferList->mBuffers[j].mDataByteSize = std::min(bufferList->mBuffers[j].mDataByteSize, frameCount * bytesPerFrame);
+	}
+
+	return true;
+}
+
+bool SFB::GroupedCARingBuffer::Write(const AudioBufferList * const * const bufferLists, uint32_t frameCount, int64_t startWrite) noexcept
+{
+	if(frameCount == 0)
+		return true;
+
+	if(!bufferLists || frameCount > mCapacityFrames || startWrite < 0)
+		return false;
+
+	const auto endWrite = startWrite + static_cast<int64_t>(frameCount);
+
+	// Going backwards, throw everything out
+	if(startWrite < EndTime())
+		SetTimeBounds(startWrite, startWrite);
+	// The buffer has not yet wrapped and will not need to
+	else if(endWrite - StartTime() <= static_cast<int64_t>(mCapacityFrames))
+		;
+	// Advance the start time past the region about to be overwritten
+	else {
+		const int64_t newStart = endWrite - static_cast<int64_t>(mCapacityFrames);	// one buffer of time behind the write position
+		const int64_t newEnd = std::max(newStart, EndTime());
+		SetTimeBounds(newStart, newEnd);
+	}
+
+	const auto curEnd = EndTime();
+
+	// Zero the range of samples being skipped
+	if(startWrite > curEnd) {
+		const auto skipIndex0 = FrameIndex(curEnd);
+		const auto skipIndex1 = FrameIndex(startWrite);
+		for(const auto& group : mGroups) {
+			const auto bytesPerFrame = group.mFormat.mBytesPerFrame;
+			const auto channelCount = group.mFormat.ChannelStreamCount();
+			if(skipIndex0 < skipIndex1)
+				ZeroRange(group.mBuffers, channelCount, skipIndex0 * bytesPerFrame, (skipIndex1 - skipIndex0) * bytesPerFrame);
+			else {
+				ZeroRange(group.mBuffers, channelCount, skipIndex0 * bytesPerFrame, (mCapacityFrames - skipIndex0) * bytesPerFrame);
+				ZeroRange(group.mBuffers, channelCount, 0, skipIndex1 * bytesPerFrame);
+			}
+		}
+	}
+
+	const auto index0 = FrameIndex(startWrite);
+	const auto framesAfterIndex0 = mCapacityFrames - index0;
+
+	for(size_t i = 0; i < mGroups.size(); ++i) {
+		const auto& group = mGroups[i];
+		const auto bufferList = bufferLists[i];
+		const auto bytesPerFrame = group.mFormat.mBytesPerFrame;
+
+		if(frameCount <= framesAfterIndex0)
+			StoreABL(group.mBuffers, index0 * bytesPerFrame, bufferList, 0, frameCount * bytesPerFrame);
+		else {
+			StoreABL(group.mBuffers, index0 * bytesPerFrame, bufferList, 0, framesAfterIndex0 * bytesPerFrame);
+			StoreABL(group.mBuffers, 0, bufferList, framesAfterIndex0 * bytesPerFrame, (frameCount - framesAfterIndex0) * bytesPerFrame);
+		}
+	}
+
+	// Update the end time once all groups have been written
+	SetTimeBounds(StartTime(), endWrite);
+
+	return true;
+}
+
+#pragma mark Internals
+
+void SFB::GroupedCARingBuffer::SetTimeBounds(int64_t startTime, int64_t endTime) noexcept
+{
+	const auto nextCounter = mTimeBoundsQueueCounter.load(std::memory_order_acquire) + 1;
+	const auto nextIndex = nextCounter & sTimeBoundsQueueMask;
+
+	mTimeBoundsQueue[nextIndex].mStartTime = startTime;
+	mTimeBoundsQueue[nextIndex].mEndTime = endTime;
+	mTimeBoundsQueue[nextIndex].mUpdateCounter.store(nextCounter, std::memory_order_release);
+
+	mTimeBoundsQueueCounter.store(nextCounter, std::memory_order_release);
+}
+
+bool SFB::GroupedCARingBuffer::ClampTimesToBounds(int64_t& startRead, int64_t& endRead) const noexcept
+{
+	int64_t startTime, endTime;
+	if(!GetTimeBounds(startTime, endTime))
+		return false;
+
+	if(startRead > endTime || endRead < startTime) {
+		endRead = startRead;
+		return true;
+	}
+
+	startRead = std::max(startRead, startTime);
+	endRead = std::max(std::min(endRead, endTime), startRead);
+
+	return true;
+}
@@ -0,0 +1,90 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <cstring>
+#import <memory>
+#import <mutex>
+#import <unordered_map>
+
+#import "SFBInternedChannelLayout.hpp"
+#import "SFBUnfairLock.hpp"
+
+namespace {
+
+/// Returns the FNV-1a hash of @c length bytes at @c data
+size_t HashBytes(const void * _Nonnull data, size_t length) noexcept
+{
+	auto bytes = static_cast<const unsigned char *>(data);
+	uint64_t hash = 0xcbf29ce484222325;
+	for(size_t i = 0; i < length; ++i) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3;
+	}
+	return static_cast<size_t>(hash);
+}
+
+} /* namespace */
+
+/// The global table of interned layouts
+struct SFB::InternedChannelLayout::Table {
+	/// Interned layouts keyed by hash
+	std::unordered_multimap<size_t, const Entry *> mEntries;
+	/// Protects @c mEntries
+	UnfairLock mLock;
+
+	/// Returns the global table
+	static Table& Shared() noexcept
+	{
+		// The table is intentionally never destroyed so handles remain valid during static destruction
+		static auto table = new Table;
+		return *table;
+	}
+};
+
+SFB::InternedChannelLayout SFB::InternedChannelLayout::Intern(const AudioChannelLayout *channelLayout)
+{
+	if(!channelLayout)
+		return {};
+
+	const auto size = AudioChannelLayoutSize(channelLayout);
+	const auto hash = HashBytes(channelLayout, size);
+
+	auto& table = Table::Shared();
+	auto find = [&]() -> const Entry * {
+		auto [first, last] = table.mEntries.equal_range(hash);
+		for(auto iter = first; iter != last; ++iter) {
+			const auto layout = iter->second->mLayout.ChannelLayout();
+			if(iter->second->mLayout.Size() == size && !std::memcmp(layout, channelLayout, size))
+				return iter->second;
+		}
+		return nullptr;
+	};
+
+	{
+		std::lock_guard lock{table.mLock};
+		if(auto entry = find(); entry)
+			return InternedChannelLayout(entry);
+	}
+
+	// The copy is made without holding the lock because CAChannelLayout::ChannelCount() may call AudioFormat
+	CAChannelLayout copy{channelLayout};
+	const auto channelCount = copy.ChannelCount();
+	std::unique_ptr<const Entry> entry{new Entry{std::move(copy), hash, channelCount}};
+
+	std::lock_guard lock{table.mLock};
+	if(auto existing = find(); existing)
+		return InternedChannelLayout(existing);
+
+	table.mEntries.emplace(hash, entry.get());
+	return InternedChannelLayout(entry.release());
+}
+
+size_t SFB::InternedChannelLayout::InternedCount() noexcept
+{
+	auto& table = Table::Shared();
+	std::lock_guard lock{table.mLock};
+	return table.mEntries.size();
+}
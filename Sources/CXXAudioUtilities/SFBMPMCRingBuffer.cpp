@@ -0,0 +1,186 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cassert>
+#import <cstdlib>
+#import <cstring>
+#import <limits>
+#import <new>
+
+#import "SFBMPMCRingBuffer.hpp"
+
+namespace {
+
+/// Returns the smallest power of two value greater than @c x
+/// @param x A value in the range [2..2147483648]
+/// @return The smallest power of two greater than @c x
+constexpr uint32_t NextPowerOfTwo(uint32_t x) noexcept
+{
+	assert(x > 1);
+	assert(x <= ((std::numeric_limits<uint32_t>::max() / 2) + 1));
+	return static_cast<uint32_t>(1 << (32 - __builtin_clz(x - 1)));
+}
+
+} /* namespace */
+
+#pragma mark Buffer Management
+
+bool SFB::MPMCRingBuffer::Allocate(uint32_t maximumRecordSize, uint32_t recordCount) noexcept
+{
+	if(maximumRecordSize == 0 || recordCount < 2 || recordCount > 0x80000000)
+		return false;
+
+	Deallocate();
+
+	// Round up to the next power of two
+	recordCount = NextPowerOfTwo(recordCount);
+
+	// Each slot is aligned so its sequence number may be accessed atomically
+	const auto slotStride = (sizeof(Slot) + maximumRecordSize + alignof(Slot) - 1) & ~(alignof(Slot) - 1);
+	if(slotStride > std::numeric_limits<size_t>::max() / recordCount)
+		return false;
+
+	void *slots = nullptr;
+	if(posix_memalign(&slots, sCacheLineSize, slotStride * recordCount) != 0)
+		return false;
+
+	mSlots = slots;
+	mSlotStride = slotStride;
+
+	mCapacityRecords = recordCount;
+	mCapacityRecordsMask = recordCount - 1;
+
+	mMaximumRecordSize = maximumRecordSize;
+
+	for(uint32_t i = 0; i < recordCount; ++i)
+		new(SlotAtPosition(i)) Slot;
+
+	Reset();
+
+	return true;
+}
+
+void SFB::MPMCRingBuffer::Deallocate() noexcept
+{
+	if(mSlots) {
+		std::free(mSlots);
+		mSlots = nullptr;
+
+		mSlotStride = 0;
+
+		mCapacityRecords = 0;
+		mCapacityRecordsMask = 0;
+
+		mMaximumRecordSize = 0;
+
+		mReadPosition = 0;
+		mWritePosition = 0;
+	}
+}
+
+void SFB::MPMCRingBuffer::Reset() noexcept
+{
+	for(uint32_t i = 0; i < mCapacityRecords; ++i) {
+		auto slot = SlotAtPosition(i);
+		slot->mSequence.store(i, std::memory_order_relaxed);
+		slot->mRecordSize.store(0, std::memory_order_relaxed);
+	}
+
+	mReadPosition.store(0, std::memory_order_relaxed);
+	mWritePosition.store(0, std::memory_order_release);
+}
+
+#pragma mark Buffer Information
+
+uint32_t SFB::MPMCRingBuffer::RecordsAvailableToRead() const noexcept
+{
+	const auto readPosition = mReadPosition.load(std::memory_order_acquire);
+	const auto writePosition = mWritePosition.load(std::memory_order_acquire);
+	// The positions are loaded independently so the read position may appear to have passed the write position
+	return writePosition > readPosition ? static_cast<uint32_t>(std::min(writePosition - readPosition, static_cast<uint64_t>(mCapacityRecords))) : 0;
+}
+
+uint32_t SFB::MPMCRingBuffer::RecordsAvailableToWrite() const noexcept
+{
+	return mCapacityRecords - RecordsAvailableToRead();
+}
+
+#pragma mark Reading and Writing Data
+
+uint32_t SFB::MPMCRingBuffer::ReadRecord(void * const destinationBuffer, uint32_t byteCount, bool exactSize) noexcept
+{
+	if(!destinationBuffer || byteCount == 0 || !mSlots)
+		return 0;
+
+	auto readPosition = mReadPosition.load(std::memory_order_relaxed);
+	Slot *slot;
+
+	for(;;) {
+		slot = SlotAtPosition(readPosition);
+		const auto sequence = slot->mSequence.load(std::memory_order_acquire);
+		const auto difference = static_cast<int64_t>(sequence - (readPosition + 1));
+
+		// The slot contains a record for this read position
+		if(difference == 0) {
+			// Leave records that don't fit in the buffer for a subsequent read
+			const auto recordSize = slot->mRecordSize.load(std::memory_order_relaxed);
+			if(recordSize > byteCount || (exactSize && recordSize != byteCount))
+				return 0;
+			if(mReadPosition.compare_exchange_weak(readPosition, readPosition + 1, std::memory_order_relaxed))
+				break;
+		}
+		// The slot has not been written; the buffer is empty
+		else if(difference < 0)
+			return 0;
+		// Another reader claimed the slot
+		else
+			readPosition = mReadPosition.load(std::memory_order_relaxed);
+	}
+
+	const auto recordSize = slot->mRecordSize.load(std::memory_order_relaxed);
+	std::memcpy(destinationBuffer, RecordData(slot), recordSize);
+
+	// Mark the slot as free for writing one lap later
+	slot->mSequence.store(readPosition + mCapacityRecordsMask + 1, std::memory_order_release);
+
+	return recordSize;
+}
+
+bool SFB::MPMCRingBuffer::Write(const void * const sourceBuffer, uint32_t byteCount) noexcept
+{
+	if(!sourceBuffer || byteCount == 0 || byteCount > mMaximumRecordSize)
+		return false;
+
+	auto writePosition = mWritePosition.load(std::memory_order_relaxed);
+	Slot *slot;
+
+	for(;;) {
+		slot = SlotAtPosition(writePosition);
+		const auto sequence = slot->mSequence.load(std::memory_order_acquire);
+		const auto difference = static_cast<int64_t>(sequence - writePosition);
+
+		// The slot is free for this write position
+		if(difference == 0) {
+			if(mWritePosition.compare_exchange_weak(writePosition, writePosition + 1, std::memory_order_relaxed))
+				break;
+		}
+		// The slot has not been read; the buffer is full
+		else if(difference < 0)
+			return false;
+		// Another writer claimed the slot
+		else
+			writePosition = mWritePosition.load(std::memory_order_relaxed);
+	}
+
+	std::memcpy(RecordData(slot), sourceBuffer, byteCount);
+	slot->mRecordSize.store(byteCount, std::memory_order_relaxed);
+
+	// Publish the record
+	slot->mSequence.store(writePosition + 1, std::memory_order_release);
+
+	return true;
+}
@@ -0,0 +1,448 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cerrno>
+#import <cmath>
+#import <cstring>
+#import <optional>
+#import <stdexcept>
+#import <system_error>
+
+#import <fcntl.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import <unistd.h>
+
+#import <sys/param.h>
+
+#import <os/log.h>
+
+#import "SFBMemoryMappedAudioFile.hpp"
+#import "SFBByteStream.hpp"
+
+namespace {
+
+/// The location and format of the audio in a file
+struct AudioDataDescription {
+	/// The file's type
+	AudioFileTypeID mFileType = 0;
+	/// The format of the audio
+	SFB::CAStreamBasicDescription mFormat;
+	/// The offset of the audio from the start of the file in bytes
+	size_t mDataOffset = 0;
+	/// The length of the audio in bytes
+	size_t mDataLength = 0;
+	/// The number of frames specified by the header, or @c -1 if unspecified
+	SInt64 mFrameLength = -1;
+};
+
+/// Sets @c format to interleaved linear PCM
+void SetLinearPCMFormat(SFB::CAStreamBasicDescription& format, Float64 sampleRate, UInt32 channelsPerFrame, UInt32 validBitsPerChannel, UInt32 bytesPerFrame, bool isFloat, bool isBigEndian, bool isSigned) noexcept
+{
+	format.mSampleRate = sampleRate;
+	format.mFormatID = kAudioFormatLinearPCM;
+	format.mFormatFlags = isFloat ? kAudioFormatFlagIsFloat : (isSigned ? kAudioFormatFlagIsSignedInteger : 0);
+	if(isBigEndian && validBitsPerChannel > 8)
+		format.mFormatFlags |= kAudioFormatFlagIsBigEndian;
+	if(channelsPerFrame > 0 && validBitsPerChannel == (bytesPerFrame / channelsPerFrame) * 8)
+		format.mFormatFlags |= kAudioFormatFlagIsPacked;
+	else
+		format.mFormatFlags |= kAudioFormatFlagIsAlignedHigh;
+	format.mBytesPerPacket = bytesPerFrame;
+	format.mFramesPerPacket = 1;
+	format.mBytesPerFrame = bytesPerFrame;
+	format.mChannelsPerFrame = channelsPerFrame;
+	format.mBitsPerChannel = validBitsPerChannel;
+	format.mReserved = 0;
+}
+
+/// Converts an 80-bit IEEE 754 extended precision value to @c double
+double ExtendedToDouble(uint16_t signAndExponent, uint64_t mantissa) noexcept
+{
+	const auto exponent = static_cast<int>(signAndExponent & 0x7FFF);
+	if(exponent == 0 && mantissa == 0)
+		return 0;
+	const auto value = std::ldexp(static_cast<double>(mantissa), exponent - 16383 - 63);
+	return (signAndExponent & 0x8000) ? -value : value;
+}
+
+#pragma mark WAVE
+
+/// Parses a WAVE file
+std::optional<AudioDataDescription> ParseWAVE(SFB::ByteStream& stream) noexcept
+{
+	// The RIFF header has been consumed
+	if(stream.ReadBE<uint32_t>() != 'WAVE')
+		return std::nullopt;
+
+	AudioDataDescription description;
+	description.mFileType = kAudioFileWAVEType;
+
+	bool haveFormat = false;
+	bool haveData = false;
+
+	while(!(haveFormat && haveData) && stream.Remaining() >= 8) {
+		const auto chunkID = *stream.ReadBE<uint32_t>();
+		const auto chunkSize = *stream.ReadLE<uint32_t>();
+		const auto chunkStart = stream.Position();
+
+		if(chunkID == 'fmt ') {
+			const auto formatTag = stream.ReadLE<uint16_t>();
+			const auto channelCount = stream.ReadLE<uint16_t>();
+			const auto sampleRate = stream.ReadLE<uint32_t>();
+			stream.Skip(4); // Average bytes per second
+			const auto blockAlign = stream.ReadLE<uint16_t>();
+			const auto bitsPerSample = stream.ReadLE<uint16_t>();
+
+			if(!formatTag || !channelCount || !sampleRate || !blockAlign || !bitsPerSample || *channelCount == 0 || *blockAlign == 0)
+				return std::nullopt;
+
+			auto format = *formatTag;
+			auto validBits = *bitsPerSample;
+
+			// WAVE_FORMAT_EXTENSIBLE
+			if(format == 0xFFFE && chunkSize >= 40) {
+				stream.Skip(2); // Extension size
+				const auto validBitsPerSample = stream.ReadLE<uint16_t>();
+				stream.Skip(4); // Channel mask
+				const auto subFormat = stream.ReadLE<uint16_t>();
+				if(!validBitsPerSample || !subFormat)
+					return std::nullopt;
+				if(*validBitsPerSample > 0)
+					validBits = *validBitsPerSample;
+				format = *subFormat;
+			}
+
+			// WAVE_FORMAT_PCM and WAVE_FORMAT_IEEE_FLOAT
+			if(format != 1 && format != 3)
+				return std::nullopt;
+
+			// 8-bit samples are unsigned
+			SetLinearPCMFormat(description.mFormat, *sampleRate, *channelCount, validBits, *blockAlign, format == 3, false, validBits > 8);
+			haveFormat = true;
+		}
+		else if(chunkID == 'data') {
+			description.mDataOffset = chunkStart;
+			description.mDataLength = std::min(static_cast<size_t>(chunkSize), stream.Remaining());
+			haveData = true;
+		}
+
+		// Chunks are padded to an even length
+		stream.SetPosition(chunkStart + chunkSize + (chunkSize & 1));
+	}
+
+	if(!haveFormat || !haveData)
+		return std::nullopt;
+
+	return description;
+}
+
+#pragma mark AIFF and AIFF-C
+
+/// Parses an AIFF or AIFF-C file
+std::optional<AudioDataDescription> ParseAIFF(SFB::ByteStream& stream) noexcept
+{
+	// The FORM header has been consumed
+	const auto formType = stream.ReadBE<uint32_t>();
+	if(formType != 'AIFF' && formType != 'AIFC')
+		return std::nullopt;
+
+	const bool isAIFC = formType == 'AIFC';
+
+	AudioDataDescription description;
+	description.mFileType = isAIFC ? kAudioFileAIFCType : kAudioFileAIFFType;
+
+	bool haveFormat = false;
+	bool haveData = false;
+
+	while(!(haveFormat && haveData) && stream.Remaining() >= 8) {
+		const auto chunkID = *stream.ReadBE<uint32_t>();
+		const auto chunkSize = *stream.ReadBE<uint32_t>();
+		const auto chunkStart = stream.Position();
+
+		if(chunkID == 'COMM') {
+			const auto channelCount = stream.ReadBE<uint16_t>();
+			const auto frameCount = stream.ReadBE<uint32_t>();
+			const auto sampleSize = stream.ReadBE<uint16_t>();
+			const auto sampleRateExponent = stream.ReadBE<uint16_t>();
+			const auto sampleRateMantissa = stream.ReadBE<uint64_t>();
+
+			if(!channelCount || !frameCount || !sampleSize || !sampleRateExponent || !sampleRateMantissa || *channelCount == 0 || *sampleSize == 0)
+				return std::nullopt;
+
+			auto compressionType = isAIFC ? stream.ReadBE<uint32_t>() : std::optional<uint32_t>{'NONE'};
+			if(!compressionType)
+				return std::nullopt;
+
+			const auto sampleRate = ExtendedToDouble(*sampleRateExponent, *sampleRateMantissa);
+			const auto bytesPerSample = (*sampleSize + 7u) / 8u;
+			const auto bytesPerFrame = bytesPerSample * *channelCount;
+
+			switch(*compressionType) {
+				case 'NONE':
+				case 'twos':
+					SetLinearPCMFormat(description.mFormat, sampleRate, *channelCount, *sampleSize, bytesPerFrame, false, true, true);
+					break;
+				case 'sowt':
+					SetLinearPCMFormat(description.mFormat, sampleRate, *channelCount, *sampleSize, bytesPerFrame, false, false, true);
+					break;
+				case 'raw ':
+					SetLinearPCMFormat(description.mFormat, sampleRate, *channelCount, *sampleSize, bytesPerFrame, false, true, false);
+					break;
+				case 'fl32':
+				case 'FL32':
+					SetLinearPCMFormat(description.mFormat, sampleRate, *channelCount, 32, 4 * *channelCount, true, true, true);
+					break;
+				case 'fl64':
+				case 'FL64':
+					SetLinearPCMFormat(description.mFormat, sampleRate, *channelCount, 64, 8 * *channelCount, true, true, true);
+					break;
+				default:
+					return std::nullopt;
+			}
+
+			description.mFrameLength = *frameCount;
+			haveFormat = true;
+		}
+		else if(chunkID == 'SSND') {
+			const auto offset = stream.ReadBE<uint32_t>();
+			stream.Skip(4); // Block size
+			if(!offset || chunkSize < 8 + *offset)
+				return std::nullopt;
+			stream.Skip(*offset);
+			description.mDataOffset = stream.Position();
+			description.mDataLength = std::min(static_cast<size_t>(chunkSize - 8 - *offset), stream.Remaining());
+			haveData = true;
+		}
+
+		// Chunks are padded to an even length
+		stream.SetPosition(chunkStart + chunkSize + (chunkSize & 1));
+	}
+
+	if(!haveFormat || !haveData)
+		return std::nullopt;
+
+	return description;
+}
+
+#pragma mark CAF
+
+/// Parses a CAF file
+std::optional<AudioDataDescription> ParseCAF(SFB::ByteStream& stream) noexcept
+{
+	// The file type has been consumed
+	const auto fileVersion = stream.ReadBE<uint16_t>();
+	stream.Skip(2); // File flags
+	if(fileVersion != 1)
+		return std::nullopt;
+
+	AudioDataDescription description;
+	description.mFileType = kAudioFileCAFType;
+
+	bool haveFormat = false;
+	bool haveData = false;
+
+	while(!haveData && stream.Remaining() >= 12) {
+		const auto chunkType = *stream.ReadBE<uint32_t>();
+		const auto chunkSize = static_cast<int64_t>(*stream.ReadBE<uint64_t>());
+		const auto chunkStart = stream.Position();
+
+		if(chunkType == 'desc') {
+			const auto sampleRateBits = stream.ReadBE<uint64_t>();
+			const auto formatID = stream.ReadBE<uint32_t>();
+			const auto formatFlags = stream.ReadBE<uint32_t>();
+			const auto bytesPerPacket = stream.ReadBE<uint32_t>();
+			const auto framesPerPacket = stream.ReadBE<uint32_t>();
+			const auto channelsPerFrame = stream.ReadBE<uint32_t>();
+			const auto bitsPerChannel = stream.ReadBE<uint32_t>();
+
+			if(!sampleRateBits || !formatID || !formatFlags || !bytesPerPacket || !framesPerPacket || !channelsPerFrame || !bitsPerChannel)
+				return std::nullopt;
+			if(*formatID != kAudioFormatLinearPCM || *framesPerPacket != 1 || *bytesPerPacket == 0 || *channelsPerFrame == 0)
+				return std::nullopt;
+
+			Float64 sampleRate;
+			std::memcpy(&sampleRate, &*sampleRateBits, sizeof(sampleRate));
+
+			// kCAFLinearPCMFormatFlagIsFloat and kCAFLinearPCMFormatFlagIsLittleEndian
+			const bool isFloat = (*formatFlags & (1 << 0)) != 0;
+			const bool isLittleEndian = (*formatFlags & (1 << 1)) != 0;
+			SetLinearPCMFormat(description.mFormat, sampleRate, *channelsPerFrame, *bitsPerChannel, *bytesPerPacket, isFloat, !isLittleEndian, true);
+			haveFormat = true;
+		}
+		else if(chunkType == 'data') {
+			stream.Skip(4); // Edit count
+			description.mDataOffset = stream.Position();
+			// A size of -1 indicates the data extends to the end of the file
+			if(chunkSize < 4)
+				description.mDataLength = stream.Remaining();
+			else
+				description.mDataLength = std::min(static_cast<size_t>(chunkSize - 4), stream.Remaining());
+			haveData = true;
+		}
+
+		if(chunkSize < 0)
+			break;
+		stream.SetPosition(chunkStart + static_cast<size_t>(chunkSize));
+	}
+
+	// The audio description chunk must precede the audio data chunk
+	if(!haveFormat || !haveData)
+		return std::nullopt;
+
+	return description;
+}
+
+/// Parses the container header in @c buffer
+std::optional<AudioDataDescription> ParseAudioFile(const void *buffer, size_t length) noexcept
+{
+	SFB::ByteStream stream{buffer, length};
+
+	switch(stream.ReadBE<uint32_t>().value_or(0)) {
+		case 'RIFF':
+			stream.Skip(4); // RIFF size
+			return ParseWAVE(stream);
+		case 'FORM':
+			stream.Skip(4); // FORM size
+			return ParseAIFF(stream);
+		case 'caff':
+			return ParseCAF(stream);
+		default:
+			return std::nullopt;
+	}
+}
+
+} /* namespace */
+
+#pragma mark Opening and Closing
+
+void SFB::MemoryMappedAudioFile::OpenURL(CFURLRef url)
+{
+	char path [PATH_MAX];
+	if(!CFURLGetFileSystemRepresentation(url, true, reinterpret_cast<UInt8 *>(path), PATH_MAX))
+		throw std::invalid_argument("Unable to get file system representation of URL");
+	Open(path);
+}
+
+void SFB::MemoryMappedAudioFile::Open(const char *path)
+{
+	Close();
+
+	const auto fd = open(path, O_RDONLY);
+	if(fd == -1)
+		throw std::system_error(errno, std::generic_category(), "open");
+
+	struct stat s;
+	if(fstat(fd, &s) == -1) {
+		const auto error = errno;
+		close(fd);
+		throw std::system_error(error, std::generic_category(), "fstat");
+	}
+
+	const auto length = static_cast<size_t>(s.st_size);
+	if(length == 0) {
+		close(fd);
+		throw std::runtime_error("Empty file");
+	}
+
+	auto mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+	const auto error = errno;
+	// The mapping remains valid after the file descriptor is closed
+	close(fd);
+	if(mapping == MAP_FAILED)
+		throw std::system_error(error, std::generic_category(), "mmap");
+
+	const auto description = ParseAudioFile(mapping, length);
+	if(!description || description->mFormat.mBytesPerFrame == 0) {
+		munmap(mapping, length);
+		throw std::runtime_error("Unsupported file format");
+	}
+
+	auto frameLength = static_cast<SInt64>(description->mDataLength / description->mFormat.mBytesPerFrame);
+	if(description->mFrameLength >= 0)
+		frameLength = std::min(frameLength, description->mFrameLength);
+
+	mMapping = mapping;
+	mMappingLength = length;
+	mAudioData = reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(mapping) + description->mDataOffset);
+	mFrameLength = frameLength;
+	mFormat = description->mFormat;
+	mFileType = description->mFileType;
+}
+
+void SFB::MemoryMappedAudioFile::Close() noexcept
+{
+	if(mMapping) {
+		munmap(mMapping, mMappingLength);
+		mMapping = nullptr;
+		mMappingLength = 0;
+		mAudioData = nullptr;
+		mFrameLength = 0;
+		mFormat = CAStreamBasicDescription{};
+		mFileType = 0;
+	}
+}
+
+#pragma mark Audio Access
+
+AudioBufferList SFB::MemoryMappedAudioFile::BufferList(SInt64 frame, UInt32 frameCount) const noexcept
+{
+	AudioBufferList bufferList{1, {{mFormat.mChannelsPerFrame, 0, nullptr}}};
+	if(frame < 0 || frame >= mFrameLength)
+		return bufferList;
+
+	const auto framesAvailable = static_cast<UInt32>(std::min(static_cast<SInt64>(frameCount), mFrameLength - frame));
+	bufferList.mBuffers[0].mData = const_cast<void *>(FrameData(frame));
+	bufferList.mBuffers[0].mDataByteSize = framesAvailable * mFormat.mBytesPerFrame;
+	return bufferList;
+}
+
+#pragma mark Paging Hints
+
+bool SFB::MemoryMappedAudioFile::SetAccessPattern(AccessPattern pattern) noexcept
+{
+	int advice = MADV_NORMAL;
+	switch(pattern) {
+		case AccessPattern::normal: 	advice = MADV_NORMAL; 		break;
+		case AccessPattern::sequential: advice = MADV_SEQUENTIAL; 	break;
+		case AccessPattern::random: 	advice = MADV_RANDOM; 		break;
+	}
+
+	const auto dataOffset = reinterpret_cast<uintptr_t>(mAudioData) - reinterpret_cast<uintptr_t>(mMapping);
+	return Advise(dataOffset, static_cast<size_t>(mFrameLength) * mFormat.mBytesPerFrame, advice);
+}
+
+bool SFB::MemoryMappedAudioFile::WillNeed(SInt64 frame, SInt64 frameCount) noexcept
+{
+	if(frame < 0 || frame >= mFrameLength || frameCount <= 0)
+		return false;
+
+	frameCount = std::min(frameCount, mFrameLength - frame);
+	const auto dataOffset = reinterpret_cast<uintptr_t>(FrameData(frame)) - reinterpret_cast<uintptr_t>(mMapping);
+	return Advise(dataOffset, static_cast<size_t>(frameCount) * mFormat.mBytesPerFrame, MADV_WILLNEED);
+}
+
+#pragma mark Internals
+
+bool SFB::MemoryMappedAudioFile::Advise(size_t offset, size_t length, int advice) noexcept
+{
+	if(!mMapping || length == 0)
+		return false;
+
+	// madvise requires a page-aligned address
+	const auto pageSize = static_cast<size_t>(getpagesize());
+	const auto alignedOffset = offset & ~(pageSize - 1);
+	const auto alignedLength = std::min(length + (offset - alignedOffset), mMappingLength - alignedOffset);
+
+	const auto address = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(mMapping) + alignedOffset);
+	if(madvise(address, alignedLength, advice) == -1) {
+		os_log_error(OS_LOG_DEFAULT, "madvise failed: %{public}s", std::strerror(errno));
+		return false;
+	}
+
+	return true;
+}
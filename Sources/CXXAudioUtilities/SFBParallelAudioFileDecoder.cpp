@@ -0,0 +1,321 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <atomic>
+#import <cstring>
+#import <exception>
+#import <mutex>
+#import <stdexcept>
+#import <system_error>
+#import <thread>
+
+#import <os/log.h>
+
+#import "SFBParallelAudioFileDecoder.hpp"
+#import "SFBCAAudioConverter.hpp"
+
+namespace {
+
+/// The approximate number of bytes read from the file at a time
+constexpr UInt32 sReadSize = 64 * 1024;
+
+/// State used to supply packets to an @c AudioConverter
+struct PacketReader {
+	/// The file being read
+	SFB::CAAudioFile& mFile;
+	/// The file's data format
+	const SFB::CAStreamBasicDescription& mFormat;
+	/// The next packet to read
+	SInt64 mNextPacket;
+	/// The packet following the last packet to read
+	SInt64 mEndPacket;
+	/// The maximum number of packets read at a time
+	UInt32 mPacketsPerRead;
+	/// The packet data
+	std::vector<UInt8> mData;
+	/// The packet descriptions
+	std::vector<AudioStreamPacketDescription> mPacketDescriptions;
+};
+
+/// Supplies packets from a @c PacketReader to an @c AudioConverter
+OSStatus InputDataProc(AudioConverterRef inAudioConverter, UInt32 *ioNumberDataPackets, AudioBufferList *ioData, AudioStreamPacketDescription * _Nullable * _Nullable outDataPacketDescription, void *inUserData) noexcept
+{
+#pragma unused(inAudioConverter)
+	auto reader = static_cast<PacketReader *>(inUserData);
+
+	auto packetCount = static_cast<UInt32>(std::min({static_cast<SInt64>(*ioNumberDataPackets), static_cast<SInt64>(reader->mPacketsPerRead), reader->mEndPacket - reader->mNextPacket}));
+	auto byteCount = static_cast<UInt32>(reader->mData.size());
+
+	if(packetCount > 0) {
+		try {
+			reader->mFile.ReadPacketData(false, byteCount, reader->mPacketDescriptions.data(), reader->mNextPacket, packetCount, reader->mData.data());
+		}
+		catch(const std::system_error& e) {
+			os_log_error(OS_LOG_DEFAULT, "Error reading audio packets: %{public}s", e.what());
+			return static_cast<OSStatus>(e.code().value());
+		}
+	}
+
+	// Zero packets signals the end of the range
+	if(packetCount == 0)
+		byteCount = 0;
+
+	reader->mNextPacket += packetCount;
+
+	*ioNumberDataPackets = packetCount;
+	ioData->mBuffers[0].mNumberChannels = reader->mFormat.mChannelsPerFrame;
+	ioData->mBuffers[0].mDataByteSize = byteCount;
+	ioData->mBuffers[0].mData = packetCount > 0 ? reader->mData.data() : nullptr;
+
+	if(outDataPacketDescription)
+		*outDataPacketDescription = packetCount > 0 ? reader->mPacketDescriptions.data() : nullptr;
+
+	return noErr;
+}
+
+/// Returns @c threadCount or the number of processors if @c threadCount is zero
+unsigned int ResolveThreadCount(unsigned int threadCount) noexcept
+{
+	return threadCount > 0 ? threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/// Throws @c std::invalid_argument if @c outputFormat is not usable for decoding a file in @c fileDataFormat
+void ValidateOutputFormat(const SFB::CAStreamBasicDescription& outputFormat, const SFB::CAStreamBasicDescription& fileDataFormat)
+{
+	if(!outputFormat.IsPCM())
+		throw std::invalid_argument("Output format must be PCM");
+	// Sample rate conversion would not be sample-accurate across range boundaries
+	if(outputFormat.mSampleRate != fileDataFormat.mSampleRate)
+		throw std::invalid_argument("Output format sample rate must match the file's sample rate");
+}
+
+} /* namespace */
+
+#pragma mark Creation and Destruction
+
+SFB::ParallelAudioFileDecoder::ParallelAudioFileDecoder(CFURLRef url)
+: mURL{static_cast<CFURLRef>(CFRetain(url))}
+{
+	mFile.OpenURL(url, kAudioFileReadPermission, 0);
+
+	mFileDataFormat = mFile.FileDataFormat();
+	if(mFileDataFormat.mFramesPerPacket == 0)
+		throw std::invalid_argument("Formats with a variable number of frames per packet are not supported");
+
+	mPacketCount = static_cast<SInt64>(mFile.AudioDataPacketCount());
+	mPacketSizeUpperBound = mFile.PacketSizeUpperBound();
+	mMagicCookie = mFile.MagicCookie();
+
+	const auto decodedFrames = mPacketCount * mFileDataFormat.mFramesPerPacket;
+	mValidFrames = decodedFrames;
+
+	try {
+		const auto packetTableInfo = mFile.PacketTableInfo();
+		if(packetTableInfo.mNumberValidFrames > 0 && packetTableInfo.mPrimingFrames + packetTableInfo.mNumberValidFrames <= decodedFrames) {
+			mValidFrames = packetTableInfo.mNumberValidFrames;
+			mPrimingFrames = packetTableInfo.mPrimingFrames;
+			mRemainderFrames = packetTableInfo.mRemainderFrames;
+		}
+	}
+	catch(const std::system_error&) {}
+
+	if(!mFileDataFormat.IsPCM()) {
+		try {
+			mFile.PacketToRollDistance(0);
+			mHasRollDistance = true;
+		}
+		catch(const std::system_error&) {}
+	}
+}
+
+#pragma mark Decoding
+
+std::vector<SFB::ParallelAudioFileDecoder::Range> SFB::ParallelAudioFileDecoder::Ranges(size_t rangeCount) const
+{
+	const SInt64 framesPerPacket = mFileDataFormat.mFramesPerPacket;
+
+	// Packets following the last valid frame contain only remainder frames
+	const auto endFrame = mPrimingFrames + mValidFrames;
+	const auto packetCount = std::min(mPacketCount, (endFrame + framesPerPacket - 1) / framesPerPacket);
+	if(packetCount == 0)
+		return {};
+
+	const auto count = static_cast<SInt64>(std::clamp(rangeCount, static_cast<size_t>(1), static_cast<size_t>(packetCount)));
+	const auto packetsPerRange = (packetCount + count - 1) / count;
+
+	std::vector<Range> ranges;
+	ranges.reserve(static_cast<size_t>(count));
+
+	for(SInt64 packet = 0; packet < packetCount; packet += packetsPerRange) {
+		const auto rangePacketCount = std::min(packetsPerRange, packetCount - packet);
+
+		const auto firstFrame = std::max(packet * framesPerPacket, mPrimingFrames);
+		const auto lastFrame = std::min((packet + rangePacketCount) * framesPerPacket, endFrame);
+		if(lastFrame <= firstFrame)
+			continue;
+
+		const auto preroll = packet > 0 ? std::min(PrerollPackets(packet), packet) : 0;
+		const auto startPacket = packet - preroll;
+
+		ranges.push_back({
+			startPacket,
+			rangePacketCount + preroll,
+			firstFrame - startPacket * framesPerPacket,
+			firstFrame - mPrimingFrames,
+			lastFrame - firstFrame
+		});
+	}
+
+	return ranges;
+}
+
+void SFB::ParallelAudioFileDecoder::Decode(const Range& range, const CAStreamBasicDescription& outputFormat, const OutputCallback& callback, UInt32 bufferFrameCapacity) const
+{
+	ValidateOutputFormat(outputFormat, mFileDataFormat);
+
+	CAAudioFile file;
+	file.OpenURL(mURL, kAudioFileReadPermission, 0);
+
+	CAAudioConverter converter;
+	converter.New(mFileDataFormat, outputFormat);
+	if(!mMagicCookie.empty())
+		converter.SetProperty(kAudioConverterDecompressionMagicCookie, static_cast<UInt32>(mMagicCookie.size()), mMagicCookie.data());
+
+	// Priming and remainder frames are removed using the packet table
+	try {
+		UInt32 primeMethod = kConverterPrimeMethod_None;
+		converter.SetProperty(kAudioConverterPrimeMethod, sizeof(primeMethod), &primeMethod);
+	}
+	catch(const std::system_error&) {}
+
+	const auto packetSize = std::max(mPacketSizeUpperBound, 1u);
+	const auto packetsPerRead = std::max(sReadSize / packetSize, 1u);
+
+	PacketReader reader{file, mFileDataFormat, range.mStartPacket, range.mStartPacket + range.mPacketCount, packetsPerRead, std::vector<UInt8>(packetsPerRead * packetSize), std::vector<AudioStreamPacketDescription>(packetsPerRead)};
+
+	CABufferList buffer{outputFormat, bufferFrameCapacity};
+
+	auto framesToDiscard = range.mDiscardFrames;
+	auto framesRemaining = range.mFrameCount;
+	auto framePosition = range.mFramePosition;
+
+	while(framesRemaining > 0) {
+		buffer.Reset();
+		UInt32 frameCount = buffer.FrameCapacity();
+		converter.FillComplexBuffer(InputDataProc, &reader, frameCount, buffer, nullptr);
+		if(frameCount == 0)
+			throw std::runtime_error("Decoder produced fewer frames than expected");
+
+		buffer.SetFrameLength(frameCount);
+
+		if(framesToDiscard > 0) {
+			const auto discardCount = static_cast<UInt32>(std::min(framesToDiscard, static_cast<SInt64>(frameCount)));
+			buffer.TrimFirst(discardCount);
+			framesToDiscard -= discardCount;
+		}
+
+		if(buffer.FrameLength() > framesRemaining)
+			buffer.TrimLast(buffer.FrameLength() - static_cast<UInt32>(framesRemaining));
+
+		if(buffer.IsEmpty())
+			continue;
+
+		callback(framePosition, buffer);
+
+		framePosition += buffer.FrameLength();
+		framesRemaining -= buffer.FrameLength();
+	}
+}
+
+void SFB::ParallelAudioFileDecoder::Decode(const CAStreamBasicDescription& outputFormat, const OutputCallback& callback, unsigned int threadCount, UInt32 bufferFrameCapacity) const
+{
+	ValidateOutputFormat(outputFormat, mFileDataFormat);
+
+	const auto workerCount = ResolveThreadCount(threadCount);
+	const auto ranges = Ranges(workerCount * sRangesPerThread);
+
+	std::atomic_size_t nextRange = 0;
+	std::atomic_bool failed = false;
+	std::exception_ptr error;
+	std::mutex errorLock;
+
+	const auto worker = [&]() noexcept {
+		while(!failed.load(std::memory_order_relaxed)) {
+			const auto index = nextRange.fetch_add(1, std::memory_order_relaxed);
+			if(index >= ranges.size())
+				break;
+
+			try {
+				Decode(ranges[index], outputFormat, callback, bufferFrameCapacity);
+			}
+			catch(...) {
+				std::lock_guard<std::mutex> lock(errorLock);
+				if(!error)
+					error = std::current_exception();
+				failed.store(true, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	const auto threadsNeeded = std::min(static_cast<size_t>(workerCount), ranges.size());
+	threads.reserve(threadsNeeded > 0 ? threadsNeeded - 1 : 0);
+
+	// The calling thread is one of the workers
+	for(size_t i = 1; i < threadsNeeded; ++i) {
+		try {
+			threads.emplace_back(worker);
+		}
+		catch(const std::system_error& e) {
+			os_log_error(OS_LOG_DEFAULT, "Unable to create decoding thread: %{public}s", e.what());
+			break;
+		}
+	}
+
+	worker();
+
+	for(auto& thread : threads)
+		thread.join();
+
+	if(error)
+		std::rethrow_exception(error);
+}
+
+void SFB::ParallelAudioFileDecoder::Decode(CABufferList& buffer, unsigned int threadCount) const
+{
+	if(mValidFrames > buffer.FrameCapacity())
+		throw std::invalid_argument("Insufficient buffer capacity");
+
+	const auto& format = buffer.Format();
+	const auto bytesPerFrame = format.mBytesPerFrame;
+
+	// Ranges are disjoint so each worker copies to a distinct region of the buffer
+	Decode(format, [&buffer, bytesPerFrame](SInt64 framePosition, const CABufferList& decoded) {
+		const auto byteOffset = static_cast<uintptr_t>(framePosition) * bytesPerFrame;
+		const auto byteCount = decoded.FrameLength() * bytesPerFrame;
+		for(UInt32 i = 0; i < decoded->mNumberBuffers; ++i)
+			std::memcpy(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(buffer->mBuffers[i].mData) + byteOffset), decoded->mBuffers[i].mData, byteCount);
+	}, threadCount);
+
+	buffer.SetFrameLength(static_cast<UInt32>(mValidFrames));
+}
+
+#pragma mark Internals
+
+SInt64 SFB::ParallelAudioFileDecoder::PrerollPackets(SInt64 packet) const
+{
+	// Packets in PCM formats are independent
+	if(mFileDataFormat.IsPCM())
+		return 0;
+
+	if(mHasRollDistance)
+		return mFile.PacketToRollDistance(packet);
+
+	// Without roll distance information assume the decoder converges after the priming frames, or two packets of overlap
+	const SInt64 framesPerPacket = mFileDataFormat.mFramesPerPacket;
+	return std::max((mPrimingFrames + framesPerPacket - 1) / framesPerPacket, static_cast<SInt64>(2));
+}
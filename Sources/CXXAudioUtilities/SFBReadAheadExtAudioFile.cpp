@@ -0,0 +1,196 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cmath>
+#import <new>
+#import <stdexcept>
+
+#import <os/log.h>
+
+#import "SFBReadAheadExtAudioFile.hpp"
+
+#pragma mark Creation and Destruction
+
+SFB::ReadAheadExtAudioFile::ReadAheadExtAudioFile(CAExtAudioFile&& file, uint32_t readAheadFrames, uint32_t decodeChunkFrames)
+: mFile{std::move(file)}, mDecodeChunkFrames{std::min(decodeChunkFrames, readAheadFrames)}, mSemaphore{0}
+{
+	if(!mFile.IsValid())
+		throw std::invalid_argument("Invalid CAExtAudioFile");
+	if(readAheadFrames == 0 || readAheadFrames >= 0x80000000)
+		throw std::invalid_argument("Invalid readAheadFrames");
+	if(decodeChunkFrames == 0)
+		throw std::invalid_argument("decodeChunkFrames == 0");
+
+	const auto clientFormat = mFile.ClientDataFormat();
+	if(clientFormat.IsInterleaved())
+		throw std::invalid_argument("Interleaved client data formats are not supported");
+
+	const auto fileFormat = mFile.FileDataFormat();
+	if(fileFormat.mSampleRate > 0)
+		mSampleRateRatio = clientFormat.mSampleRate / fileFormat.mSampleRate;
+
+	mReaderFramePosition = std::llround(static_cast<double>(mFile.Tell()) * mSampleRateRatio);
+
+	// One frame of the ring buffer is always unused
+	if(!mRingBuffer.Allocate(clientFormat, readAheadFrames + 1))
+		throw std::bad_alloc();
+
+	mWorker = std::thread(&ReadAheadExtAudioFile::DecoderThreadEntry, this);
+}
+
+SFB::ReadAheadExtAudioFile::~ReadAheadExtAudioFile()
+{
+	mStopWorker.store(true, std::memory_order_release);
+	mSemaphore.Signal();
+	if(mWorker.joinable())
+		mWorker.join();
+}
+
+#pragma mark Reading
+
+uint32_t SFB::ReadAheadExtAudioFile::Read(AudioBufferList * const bufferList, uint32_t frameCount) noexcept
+{
+	if(!bufferList || frameCount == 0)
+		return 0;
+
+	// Audio decoded for the previous position is stale
+	if(mSeekRequested.load(std::memory_order_acquire) || !DiscardFlushedAudio())
+		return 0;
+
+	const auto framesRead = mRingBuffer.Read(bufferList, frameCount, true);
+	mFramesRead += framesRead;
+	mReaderFramePosition += framesRead;
+
+	// Wake the worker if there is space for another chunk; after an error only a seek can restart decoding
+	if(!mDecoderIsFinished.load(std::memory_order_relaxed) && !mDecoderErrorOccurred.load(std::memory_order_relaxed) && mRingBuffer.FramesAvailableToWrite() >= mDecodeChunkFrames)
+		WakeWorker();
+
+	return framesRead;
+}
+
+#pragma mark Seeking
+
+void SFB::ReadAheadExtAudioFile::Seek(int64_t frame) noexcept
+{
+	mRequestedSeekFrame.store(frame, std::memory_order_relaxed);
+	mSeekRequested.store(true, std::memory_order_release);
+	WakeWorker();
+}
+
+#pragma mark Internals
+
+void SFB::ReadAheadExtAudioFile::WakeWorker() noexcept
+{
+	// Pairs with the fence in DecoderThreadEntry(): either the worker sees the new state before waiting or this sees the flag
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	// Only the caller that clears the flag signals, so the semaphore count never exceeds one wakeup
+	if(mWorkerIsWaiting.load(std::memory_order_relaxed) && mWorkerIsWaiting.exchange(false, std::memory_order_relaxed))
+		mSemaphore.Signal();
+}
+
+bool SFB::ReadAheadExtAudioFile::DiscardFlushedAudio() noexcept
+{
+	const auto sequence = mSeekSequence.load(std::memory_order_acquire);
+	if(sequence == mReaderSeekSequence)
+		return true;
+
+	// The worker is performing a seek; try again on the next read
+	if((sequence & 1) != 0)
+		return false;
+
+	const auto flushBoundary = mFlushBoundary.load(std::memory_order_relaxed);
+	const auto flushFramePosition = mFlushFramePosition.load(std::memory_order_relaxed);
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if(mSeekSequence.load(std::memory_order_relaxed) != sequence)
+		return false;
+
+	mReaderSeekSequence = sequence;
+
+	// All frames before the boundary were written before the boundary was published
+	if(flushBoundary > mFramesRead) {
+		mRingBuffer.AdvanceReadPosition(static_cast<uint32_t>(flushBoundary - mFramesRead));
+		mFramesRead = flushBoundary;
+		mReaderFramePosition = flushFramePosition;
+	}
+	// Frames following the boundary were read before the seek was observed
+	else
+		mReaderFramePosition = flushFramePosition + static_cast<int64_t>(mFramesRead - flushBoundary);
+
+	return true;
+}
+
+void SFB::ReadAheadExtAudioFile::DecoderThreadEntry() noexcept
+{
+	const auto bytesPerFrame = mRingBuffer.Format().mBytesPerFrame;
+
+	while(!mStopWorker.load(std::memory_order_acquire)) {
+		if(mSeekRequested.load(std::memory_order_acquire)) {
+			// Mark the seek as in progress before clearing the request so the reader never observes stale audio
+			const auto sequence = mSeekSequence.load(std::memory_order_relaxed);
+			mSeekSequence.store(sequence + 1, std::memory_order_relaxed);
+
+			// A seek requested before the exchange is coalesced with this one
+			mSeekRequested.exchange(false, std::memory_order_acq_rel);
+			const auto frame = mRequestedSeekFrame.load(std::memory_order_relaxed);
+
+			try {
+				mFile.Seek(frame);
+				mDecoderErrorOccurred.store(false, std::memory_order_release);
+			}
+			catch(const std::exception& e) {
+				os_log_error(OS_LOG_DEFAULT, "Error seeking to frame %lld: %{public}s", frame, e.what());
+				mDecoderErrorOccurred.store(true, std::memory_order_release);
+			}
+
+			mDecoderIsFinished.store(false, std::memory_order_release);
+
+			// Publish the flush boundary
+			mFlushBoundary.store(mFramesWritten, std::memory_order_relaxed);
+			mFlushFramePosition.store(std::llround(static_cast<double>(frame) * mSampleRateRatio), std::memory_order_relaxed);
+			mSeekSequence.store(sequence + 2, std::memory_order_release);
+
+			continue;
+		}
+
+		if(!mDecoderIsFinished.load(std::memory_order_relaxed) && !mDecoderErrorOccurred.load(std::memory_order_relaxed) && mRingBuffer.FramesAvailableToWrite() >= mDecodeChunkFrames) {
+			// Decode directly into the ring buffer
+			const auto wvec = mRingBuffer.WriteVector();
+
+			UInt32 frameCount = std::min(mDecodeChunkFrames, wvec.first.mFrameCapacity);
+			for(UInt32 i = 0; i < wvec.first.mBufferList->mNumberBuffers; ++i)
+				wvec.first.mBufferList->mBuffers[i].mDataByteSize = frameCount * bytesPerFrame;
+
+			try {
+				mFile.Read(frameCount, wvec.first.mBufferList);
+			}
+			catch(const std::exception& e) {
+				os_log_error(OS_LOG_DEFAULT, "Error decoding audio: %{public}s", e.what());
+				mDecoderErrorOccurred.store(true, std::memory_order_release);
+				continue;
+			}
+
+			if(frameCount == 0)
+				mDecoderIsFinished.store(true, std::memory_order_release);
+			else {
+				mRingBuffer.AdvanceWritePosition(frameCount);
+				mFramesWritten += frameCount;
+			}
+
+			continue;
+		}
+
+		// Announce the wait and then check again for work that arrived after the checks above
+		mWorkerIsWaiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(WorkIsAvailable() && mWorkerIsWaiting.exchange(false, std::memory_order_relaxed))
+			continue;
+
+		// If the flag was already cleared the waker has signaled or will signal the semaphore
+		mSemaphore.Wait();
+	}
+}
@@ -1,5 +1,5 @@
 //
-// Copyright © 2014-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2014-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
@@ -10,6 +10,9 @@
 #import <cstring>
 #import <limits>
 
+#import <mach/mach.h>
+#import <mach/mach_vm.h>
+
 #import "SFBRingBuffer.hpp"
 
 namespace {
@@ -24,11 +27,68 @@ constexpr uint32_t NextPowerOfTwo(uint32_t x) noexcept
 	return static_cast<uint32_t>(1 << (32 - __builtin_clz(x - 1)));
 }
 
+/// Returns the number of bytes available for reading
+/// @param writePosition The write position
+/// @param readPosition The read position
+/// @param capacityBytesMask The buffer capacity in bytes minus one
+/// @return The number of bytes available for reading
+constexpr uint32_t BytesAvailableToRead(uint32_t writePosition, uint32_t readPosition, uint32_t capacityBytesMask) noexcept
+{
+	return (writePosition - readPosition) & capacityBytesMask;
+}
+
+/// Returns the free space available for writing in bytes
+/// @note One byte is always kept free to distinguish a full buffer from an empty one
+/// @param writePosition The write position
+/// @param readPosition The read position
+/// @param capacityBytesMask The buffer capacity in bytes minus one
+/// @return The free space available for writing in bytes
+constexpr uint32_t BytesAvailableToWrite(uint32_t writePosition, uint32_t readPosition, uint32_t capacityBytesMask) noexcept
+{
+	return (readPosition - writePosition - 1) & capacityBytesMask;
+}
+
+/// Allocates a region of virtual memory of @c byteCount bytes mapped twice at consecutive addresses
+/// @param byteCount The size of the region in bytes, which must be a multiple of the virtual memory page size
+/// @return The address of the region or @c nullptr on error
+void * _Nullable AllocateMirroredRegion(uint32_t byteCount) noexcept
+{
+	assert(byteCount % vm_page_size == 0);
+
+	const auto regionSize = static_cast<mach_vm_size_t>(byteCount);
+
+	// Reserve twice the required space; the pages are zero-filled
+	mach_vm_address_t address = 0;
+	auto result = mach_vm_allocate(mach_task_self(), &address, 2 * regionSize, VM_FLAGS_ANYWHERE);
+	if(result != KERN_SUCCESS)
+		return nullptr;
+
+	// Map the lower half onto the upper half, atomically replacing the upper half's pages
+	mach_vm_address_t mirrorAddress = address + regionSize;
+	vm_prot_t currentProtection, maximumProtection;
+	result = mach_vm_remap(mach_task_self(), &mirrorAddress, regionSize, 0, VM_FLAGS_FIXED | VM_FLAGS_OVERWRITE, mach_task_self(), address, FALSE, &currentProtection, &maximumProtection, VM_INHERIT_DEFAULT);
+	if(result != KERN_SUCCESS || mirrorAddress != address + regionSize) {
+		mach_vm_deallocate(mach_task_self(), address, 2 * regionSize);
+		return nullptr;
+	}
+
+	return reinterpret_cast<void *>(address);
+}
+
+/// Deallocates a region of virtual memory allocated by @c AllocateMirroredRegion
+/// @param region The address of the region
+/// @param byteCount The size of the region in bytes
+void DeallocateMirroredRegion(void * const _Nonnull region, uint32_t byteCount) noexcept
+{
+	mach_vm_deallocate(mach_task_self(), reinterpret_cast<mach_vm_address_t>(region), 2 * static_cast<mach_vm_size_t>(byteCount));
+}
+
 } /* namespace */
 
 #pragma mark Buffer Management
 
-bool SFB::RingBuffer::Allocate(uint32_t capacityBytes) noexcept
+template <typename Counters>
+bool SFB::BasicRingBuffer<Counters>::Allocate(uint32_t capacityBytes) noexcept
 {
 	if(capacityBytes < 2 || capacityBytes > 0x80000000)
 		return false;
@@ -48,73 +108,100 @@ bool SFB::RingBuffer::Allocate(uint32_t capacityBytes) noexcept
 	return true;
 }
 
-void SFB::RingBuffer::Deallocate() noexcept
+template <typename Counters>
+bool SFB::BasicRingBuffer<Counters>::AllocateMirrored(uint32_t capacityBytes) noexcept
+{
+	if(capacityBytes < 2 || capacityBytes > 0x80000000)
+		return false;
+
+	Deallocate();
+
+	// Round up to the next power of two, which must also be a multiple of the page size
+	capacityBytes = std::max(NextPowerOfTwo(capacityBytes), static_cast<uint32_t>(vm_page_size));
+
+	mBuffer = AllocateMirroredRegion(capacityBytes);
+	if(!mBuffer)
+		return false;
+
+	mCapacityBytes = capacityBytes;
+	mCapacityBytesMask = capacityBytes - 1;
+	mIsMirrored = true;
+
+	return true;
+}
+
+template <typename Counters>
+void SFB::BasicRingBuffer<Counters>::Deallocate() noexcept
 {
 	if(mBuffer) {
-		std::free(mBuffer);
+		if(mIsMirrored)
+			DeallocateMirroredRegion(mBuffer, mCapacityBytes);
+		else
+			std::free(mBuffer);
 		mBuffer = nullptr;
 
 		mCapacityBytes = 0;
 		mCapacityBytesMask = 0;
+		mIsMirrored = false;
 
-		mReadPosition = 0;
-		mWritePosition = 0;
+		Reset();
 	}
 }
 
-void SFB::RingBuffer::Reset() noexcept
+template <typename Counters>
+void SFB::BasicRingBuffer<Counters>::Reset() noexcept
 {
 	mReadPosition = 0;
 	mWritePosition = 0;
+
+	mCachedReadPosition = 0;
+	mCachedWritePosition = 0;
 }
 
 #pragma mark Buffer Information
 
-uint32_t SFB::RingBuffer::BytesAvailableToRead() const noexcept
+template <typename Counters>
+uint32_t SFB::BasicRingBuffer<Counters>::BytesAvailableToRead() const noexcept
 {
 	const auto writePosition = mWritePosition.load(std::memory_order_acquire);
 	const auto readPosition = mReadPosition.load(std::memory_order_acquire);
-
-	if(writePosition > readPosition)
-		return writePosition - readPosition;
-	else
-		return (writePosition - readPosition + mCapacityBytes) & mCapacityBytesMask;
+	return ::BytesAvailableToRead(writePosition, readPosition, mCapacityBytesMask);
 }
 
-uint32_t SFB::RingBuffer::BytesAvailableToWrite() const noexcept
+template <typename Counters>
+uint32_t SFB::BasicRingBuffer<Counters>::BytesAvailableToWrite() const noexcept
 {
 	const auto writePosition = mWritePosition.load(std::memory_order_acquire);
 	const auto readPosition = mReadPosition.load(std::memory_order_acquire);
-
-	if(writePosition > readPosition)
-		return ((readPosition - writePosition + mCapacityBytes) & mCapacityBytesMask) - 1;
-	else if(writePosition < readPosition)
-		return (readPosition - writePosition) - 1;
-	else
-		return mCapacityBytes - 1;
+	return ::BytesAvailableToWrite(writePosition, readPosition, mCapacityBytesMask);
 }
 
 #pragma mark Reading and Writing Data
 
-uint32_t SFB::RingBuffer::Read(void * const destinationBuffer, uint32_t byteCount, bool allowPartial) noexcept
+template <typename Counters>
+uint32_t SFB::BasicRingBuffer<Counters>::Read(void * const destinationBuffer, uint32_t byteCount, bool allowPartial) noexcept
 {
 	if(!destinationBuffer || byteCount == 0)
 		return 0;
 
-	const auto writePosition = mWritePosition.load(std::memory_order_acquire);
-	const auto readPosition = mReadPosition.load(std::memory_order_acquire);
+	// Only the reader modifies the read position
+	const auto readPosition = mReadPosition.load(std::memory_order_relaxed);
 
-	uint32_t bytesAvailable;
-	if(writePosition > readPosition)
-		bytesAvailable = writePosition - readPosition;
-	else
-		bytesAvailable = (writePosition - readPosition + mCapacityBytes) & mCapacityBytesMask;
+	// Refresh the cached write position only if it indicates insufficient data, or always when collecting
+	// statistics since the low watermark requires the current fill level
+	auto bytesAvailable = ::BytesAvailableToRead(mCachedWritePosition, readPosition, mCapacityBytesMask);
+	if(Counters::sIsEnabled || bytesAvailable < byteCount) {
+		mCachedWritePosition = mWritePosition.load(std::memory_order_acquire);
+		bytesAvailable = ::BytesAvailableToRead(mCachedWritePosition, readPosition, mCapacityBytesMask);
+	}
+
+	mCounters.RecordRead(byteCount, bytesAvailable, allowPartial);
 
 	if(bytesAvailable == 0 || (bytesAvailable < byteCount && !allowPartial))
 		return 0;
 
 	const auto bytesToRead = std::min(bytesAvailable, byteCount);
-	if(readPosition + bytesToRead > mCapacityBytes) {
+	if(!mIsMirrored && readPosition + bytesToRead > mCapacityBytes) {
 		const auto bytesAfterReadPointer = mCapacityBytes - readPosition;
 		std::memcpy(destinationBuffer,
 					reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(mBuffer) + readPosition),
@@ -131,25 +218,27 @@ uint32_t SFB::RingBuffer::Read(void * const destinationBuffer, uint32_t byteCoun
 	return bytesToRead;
 }
 
-uint32_t SFB::RingBuffer::Peek(void * const destinationBuffer, uint32_t byteCount, bool allowPartial) const noexcept
+template <typename Counters>
+uint32_t SFB::BasicRingBuffer<Counters>::Peek(void * const destinationBuffer, uint32_t byteCount, bool allowPartial) const noexcept
 {
 	if(!destinationBuffer || byteCount == 0)
 		return 0;
 
-	const auto writePosition = mWritePosition.load(std::memory_order_acquire);
-	const auto readPosition = mReadPosition.load(std::memory_order_acquire);
+	// Only the reader modifies the read position
+	const auto readPosition = mReadPosition.load(std::memory_order_relaxed);
 
-	uint32_t bytesAvailable;
-	if(writePosition > readPosition)
-		bytesAvailable = writePosition - readPosition;
-	else
-		bytesAvailable = (writePosition - readPosition + mCapacityBytes) & mCapacityBytesMask;
+	// Refresh the cached write position only if it indicates insufficient data
+	auto bytesAvailable = ::BytesAvailableToRead(mCachedWritePosition, readPosition, mCapacityBytesMask);
+	if(bytesAvailable < byteCount) {
+		mCachedWritePosition = mWritePosition.load(std::memory_order_acquire);
+		bytesAvailable = ::BytesAvailableToRead(mCachedWritePosition, readPosition, mCapacityBytesMask);
+	}
 
 	if(bytesAvailable == 0 || (bytesAvailable < byteCount && !allowPartial))
 		return 0;
 
 	const auto bytesToRead = std::min(bytesAvailable, byteCount);
-	if(readPosition + bytesToRead > mCapacityBytes) {
+	if(!mIsMirrored && readPosition + bytesToRead > mCapacityBytes) {
 		auto bytesAfterReadPointer = mCapacityBytes - readPosition;
 		std::memcpy(destinationBuffer,
 					reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(mBuffer) + readPosition),
@@ -164,27 +253,30 @@ uint32_t SFB::RingBuffer::Peek(void * const destinationBuffer, uint32_t byteCoun
 	return bytesToRead;
 }
 
-uint32_t SFB::RingBuffer::Write(const void * const sourceBuffer, uint32_t byteCount, bool allowPartial) noexcept
+template <typename Counters>
+uint32_t SFB::BasicRingBuffer<Counters>::Write(const void * const sourceBuffer, uint32_t byteCount, bool allowPartial) noexcept
 {
 	if(!sourceBuffer || byteCount == 0)
 		return 0;
 
-	const auto writePosition = mWritePosition.load(std::memory_order_acquire);
-	const auto readPosition = mReadPosition.load(std::memory_order_acquire);
+	// Only the writer modifies the write position
+	const auto writePosition = mWritePosition.load(std::memory_order_relaxed);
 
-	uint32_t bytesAvailable;
-	if(writePosition > readPosition)
-		bytesAvailable = ((readPosition - writePosition + mCapacityBytes) & mCapacityBytesMask) - 1;
-	else if(writePosition < readPosition)
-		bytesAvailable = (readPosition - writePosition) - 1;
-	else
-		bytesAvailable = mCapacityBytes - 1;
+	// Refresh the cached read position only if it indicates insufficient space, or always when collecting
+	// statistics since the high watermark requires the current fill level
+	auto bytesAvailable = ::BytesAvailableToWrite(writePosition, mCachedReadPosition, mCapacityBytesMask);
+	if(Counters::sIsEnabled || bytesAvailable < byteCount) {
+		mCachedReadPosition = mReadPosition.load(std::memory_order_acquire);
+		bytesAvailable = ::BytesAvailableToWrite(writePosition, mCachedReadPosition, mCapacityBytesMask);
+	}
 
-	if(bytesAvailable == 0 || (bytesAvailable < byteCount && !allowPartial))
+	const auto bytesToWrite = (bytesAvailable < byteCount && !allowPartial) ? 0 : std::min(bytesAvailable, byteCount);
+	mCounters.RecordWrite(byteCount, bytesAvailable, allowPartial, mCapacityBytesMask - bytesAvailable + bytesToWrite);
+
+	if(bytesToWrite == 0)
 		return 0;
 
-	const auto bytesToWrite = std::min(bytesAvailable, byteCount);
-	if(writePosition + bytesToWrite > mCapacityBytes) {
+	if(!mIsMirrored && writePosition + bytesToWrite > mCapacityBytes) {
 		auto bytesAfterWritePointer = mCapacityBytes - writePosition;
 		std::memcpy(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(mBuffer) + writePosition),
 					sourceBuffer,
@@ -203,52 +295,53 @@ uint32_t SFB::RingBuffer::Write(const void * const sourceBuffer, uint32_t byteCo
 
 #pragma mark Advanced Reading and Writing
 
-void SFB::RingBuffer::AdvanceReadPosition(uint32_t byteCount) noexcept
+template <typename Counters>
+void SFB::BasicRingBuffer<Counters>::AdvanceReadPosition(uint32_t byteCount) noexcept
 {
-	mReadPosition.store((mReadPosition.load(std::memory_order_acquire) + byteCount) & mCapacityBytesMask, std::memory_order_release);
+	mReadPosition.store((mReadPosition.load(std::memory_order_relaxed) + byteCount) & mCapacityBytesMask, std::memory_order_release);
 }
 
-void SFB::RingBuffer::AdvanceWritePosition(uint32_t byteCount) noexcept
+template <typename Counters>
+void SFB::BasicRingBuffer<Counters>::AdvanceWritePosition(uint32_t byteCount) noexcept
 {
-	mWritePosition.store((mWritePosition.load(std::memory_order_acquire) + byteCount) & mCapacityBytesMask, std::memory_order_release);
+	mWritePosition.store((mWritePosition.load(std::memory_order_relaxed) + byteCount) & mCapacityBytesMask, std::memory_order_release);
 }
 
-const SFB::RingBuffer::ReadBufferPair SFB::RingBuffer::ReadVector() const noexcept
+template <typename Counters>
+const typename SFB::BasicRingBuffer<Counters>::ReadBufferPair SFB::BasicRingBuffer<Counters>::ReadVector() const noexcept
 {
-	const auto writePosition = mWritePosition.load(std::memory_order_acquire);
-	const auto readPosition = mReadPosition.load(std::memory_order_acquire);
-
-	uint32_t bytesAvailable;
-	if(writePosition > readPosition)
-		bytesAvailable = writePosition - readPosition;
-	else
-		bytesAvailable = (writePosition - readPosition + mCapacityBytes) & mCapacityBytesMask;
+	// The read vector describes all readable data so the cached write position is always refreshed
+	mCachedWritePosition = mWritePosition.load(std::memory_order_acquire);
+	const auto readPosition = mReadPosition.load(std::memory_order_relaxed);
 
+	const auto bytesAvailable = ::BytesAvailableToRead(mCachedWritePosition, readPosition, mCapacityBytesMask);
 	const auto endOfRead = readPosition + bytesAvailable;
 
-	if(endOfRead > mCapacityBytes)
-		return { { reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(mBuffer) + readPosition), mCapacityBytes - readPosition }, { mBuffer, endOfRead & mCapacityBytes } };
+	// A mirrored buffer's readable data is always contiguous
+	if(!mIsMirrored && endOfRead > mCapacityBytes)
+		return { { reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(mBuffer) + readPosition), mCapacityBytes - readPosition }, { mBuffer, endOfRead & mCapacityBytesMask } };
 	else
 		return { { reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(mBuffer) + readPosition), bytesAvailable }, {} };
 }
 
-const SFB::RingBuffer::WriteBufferPair SFB::RingBuffer::WriteVector() const noexcept
+template <typename Counters>
+const typename SFB::BasicRingBuffer<Counters>::WriteBufferPair SFB::BasicRingBuffer<Counters>::WriteVector() const noexcept
 {
-	const auto writePosition = mWritePosition.load(std::memory_order_acquire);
-	const auto readPosition = mReadPosition.load(std::memory_order_acquire);
-
-	uint32_t bytesAvailable;
-	if(writePosition > readPosition)
-		bytesAvailable = ((readPosition - writePosition + mCapacityBytes) & mCapacityBytesMask) - 1;
-	else if(writePosition < readPosition)
-		bytesAvailable = (readPosition - writePosition) - 1;
-	else
-		bytesAvailable = mCapacityBytes - 1;
+	// The write vector describes all writable space so the cached read position is always refreshed
+	mCachedReadPosition = mReadPosition.load(std::memory_order_acquire);
+	const auto writePosition = mWritePosition.load(std::memory_order_relaxed);
 
+	const auto bytesAvailable = ::BytesAvailableToWrite(writePosition, mCachedReadPosition, mCapacityBytesMask);
 	const auto endOfWrite = writePosition + bytesAvailable;
 
-	if(endOfWrite > mCapacityBytes)
-		return { { reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(mBuffer) + writePosition), mCapacityBytes - writePosition }, { mBuffer, endOfWrite & mCapacityBytes } };
+	// A mirrored buffer's writable space is always contiguous
+	if(!mIsMirrored && endOfWrite > mCapacityBytes)
+		return { { reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(mBuffer) + writePosition), mCapacityBytes - writePosition }, { mBuffer, endOfWrite & mCapacityBytesMask } };
 	else
 		return { { reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(mBuffer) + writePosition), bytesAvailable }, {} };
 }
+
+#pragma mark Explicit Instantiations
+
+template class SFB::BasicRingBuffer<SFB::NullRingBufferCounters>;
+template class SFB::BasicRingBuffer<SFB::RingBufferCounters>;
@@ -0,0 +1,147 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import <algorithm>
+#import <cmath>
+#import <cstring>
+#import <new>
+#import <stdexcept>
+
+#import "SFBStreamingAudioConverter.hpp"
+
+namespace {
+
+/// The status returned by the input data procedure when no input is currently available
+constexpr OSStatus kNoInputAvailableStatus = 'nada';
+
+} /* namespace */
+
+#pragma mark Creation and Destruction
+
+SFB::StreamingAudioConverter::StreamingAudioConverter(const CAStreamBasicDescription& sourceFormat, const CAStreamBasicDescription& destinationFormat, UInt32 maximumFramesPerConversion, UInt32 inputBufferFrames)
+: mSourceFormat{sourceFormat}, mDestinationFormat{destinationFormat}, mMaximumFramesPerConversion{maximumFramesPerConversion}
+{
+	if(!sourceFormat.IsPCM() || !destinationFormat.IsPCM())
+		throw std::invalid_argument("Non-PCM formats are not supported");
+	if(maximumFramesPerConversion == 0)
+		throw std::invalid_argument("maximumFramesPerConversion == 0");
+	if(inputBufferFrames > 0 && sourceFormat.IsInterleaved())
+		throw std::invalid_argument("Interleaved source formats are not supported with an input buffer");
+
+	mConverter.New(sourceFormat, destinationFormat);
+
+	// Stage enough input to produce a full conversion in a single call to the input data procedure
+	const auto stagingFrames = static_cast<UInt32>(std::ceil(maximumFramesPerConversion * sourceFormat.mSampleRate / destinationFormat.mSampleRate)) + 1;
+	if(!mStagingBuffer.Allocate(sourceFormat, stagingFrames))
+		throw std::bad_alloc();
+
+	if(inputBufferFrames > 0 && !mInputBuffer.Allocate(sourceFormat, std::max(inputBufferFrames, 2u)))
+		throw std::bad_alloc();
+}
+
+#pragma mark Properties
+
+AudioConverterPrimeInfo SFB::StreamingAudioConverter::PrimeInfo()
+{
+	AudioConverterPrimeInfo primeInfo{};
+	UInt32 size = sizeof(primeInfo);
+	mConverter.GetProperty(kAudioConverterPrimeInfo, size, &primeInfo);
+	return primeInfo;
+}
+
+UInt32 SFB::StreamingAudioConverter::OutputLatencyFrames()
+{
+	UInt32 primeMethod = kConverterPrimeMethod_Normal;
+	UInt32 size = sizeof(primeMethod);
+	mConverter.GetProperty(kAudioConverterPrimeMethod, size, &primeMethod);
+	if(primeMethod == kConverterPrimeMethod_Pre)
+		return 0;
+
+	const auto primeInfo = PrimeInfo();
+	return static_cast<UInt32>(std::ceil(primeInfo.leadingFrames * mDestinationFormat.mSampleRate / mSourceFormat.mSampleRate));
+}
+
+#pragma mark Input
+
+void SFB::StreamingAudioConverter::Reset()
+{
+	mConverter.Reset();
+	mInputBuffer.Reset();
+	mEndOfInput.store(false, std::memory_order_release);
+	mInputFramesConsumed = 0;
+	mOutputFramesConverted = 0;
+	mUnderrunFrames = 0;
+}
+
+#pragma mark Conversion
+
+UInt32 SFB::StreamingAudioConverter::Convert(PullFunction pull, void *context, AudioBufferList& output, UInt32 frameCount) noexcept
+{
+	if(frameCount > mMaximumFramesPerConversion || output.mNumberBuffers != mDestinationFormat.ChannelStreamCount())
+		return 0;
+
+	const auto byteSize = mDestinationFormat.FrameCountToByteSize(frameCount);
+	for(UInt32 i = 0; i < output.mNumberBuffers; ++i) {
+		if(!output.mBuffers[i].mData || output.mBuffers[i].mDataByteSize < byteSize)
+			return 0;
+		output.mBuffers[i].mDataByteSize = byteSize;
+	}
+
+	mPull = pull;
+	mPullContext = context;
+
+	auto framesConverted = frameCount;
+	auto result = AudioConverterFillComplexBuffer(mConverter, InputDataProc, this, &framesConverted, &output, nullptr);
+
+	mPull = nullptr;
+	mPullContext = nullptr;
+
+	// The conversion stops early without losing converter state when no input is available
+	if(result != noErr && result != kNoInputAvailableStatus)
+		framesConverted = 0;
+
+	// Fill any remaining frames with silence
+	const auto convertedByteSize = mDestinationFormat.FrameCountToByteSize(framesConverted);
+	for(UInt32 i = 0; i < output.mNumberBuffers; ++i) {
+		std::memset(static_cast<uint8_t *>(output.mBuffers[i].mData) + convertedByteSize, 0, byteSize - convertedByteSize);
+		output.mBuffers[i].mDataByteSize = byteSize;
+	}
+
+	mOutputFramesConverted += framesConverted;
+	mUnderrunFrames += frameCount - framesConverted;
+
+	return framesConverted;
+}
+
+OSStatus SFB::StreamingAudioConverter::InputDataProc(AudioConverterRef inAudioConverter, UInt32 *ioNumberDataPackets, AudioBufferList *ioData, AudioStreamPacketDescription **outDataPacketDescription, void *inUserData) noexcept
+{
+#pragma unused(inAudioConverter)
+#pragma unused(outDataPacketDescription)
+
+	auto converter = static_cast<StreamingAudioConverter *>(inUserData);
+	auto& staging = converter->mStagingBuffer;
+
+	const auto frameCount = std::min(*ioNumberDataPackets, staging.FrameCapacity());
+	staging.SetFrameLength(frameCount);
+
+	const auto framesRead = std::min(converter->mPull(converter->mPullContext, *staging.ABL(), frameCount), frameCount);
+	if(framesRead == 0) {
+		*ioNumberDataPackets = 0;
+		// Zero frames with noErr signals the end of the stream and flushes the converter
+		return converter->mEndOfInput.load(std::memory_order_acquire) ? noErr : kNoInputAvailableStatus;
+	}
+
+	staging.SetFrameLength(framesRead);
+	converter->mInputFramesConsumed += framesRead;
+
+	const auto bufferList = staging.ABL();
+	ioData->mNumberBuffers = bufferList->mNumberBuffers;
+	for(UInt32 i = 0; i < bufferList->mNumberBuffers; ++i)
+		ioData->mBuffers[i] = bufferList->mBuffers[i];
+	*ioNumberDataPackets = framesRead;
+
+	return noErr;
+}
@@ -0,0 +1,112 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#import "SFBWaitableAudioRingBuffer.hpp"
+
+namespace {
+
+/// Blocks until @c available returns at least @c frameCount or @c timeout occurs
+/// @param threshold The waiter's threshold
+/// @param semaphore The semaphore signaled when @c threshold is reached
+/// @param frameCount The desired number of frames
+/// @param timeout The time at which to stop waiting
+/// @param available A function returning the number of frames currently available
+/// @return @c true if at least @c frameCount frames are available, @c false otherwise
+template <typename F>
+bool WaitForThreshold(std::atomic_uint32_t& threshold, SFB::DispatchSemaphore& semaphore, uint32_t frameCount, dispatch_time_t timeout, F&& available) noexcept
+{
+	for(;;) {
+		if(available() >= frameCount)
+			return true;
+
+		// Arm the threshold and check again in case the frames became available before the signaler could observe it
+		threshold.store(frameCount, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if(available() >= frameCount) {
+			// If the signaler has already disarmed the threshold it will signal; consume the signal
+			if(threshold.exchange(0, std::memory_order_relaxed) == 0)
+				semaphore.Wait();
+			return true;
+		}
+
+		if(!semaphore.Wait(timeout)) {
+			// A signal may have raced with the timeout; consume it
+			if(threshold.exchange(0, std::memory_order_relaxed) == 0)
+				semaphore.Wait();
+			return available() >= frameCount;
+		}
+
+		// The signaler disarmed the threshold before signaling; loop to confirm the frames are available
+	}
+}
+
+/// Signals @c semaphore if @c threshold is armed and @c available returns at least its value
+/// @param threshold The waiter's threshold
+/// @param semaphore The semaphore to signal
+/// @param available A function returning the number of frames currently available
+template <typename F>
+void SignalIfThresholdReached(std::atomic_uint32_t& threshold, SFB::DispatchSemaphore& semaphore, F&& available) noexcept
+{
+	// Order the preceding position update before the threshold load; pairs with the fence in WaitForThreshold()
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	const auto frameCount = threshold.load(std::memory_order_relaxed);
+	if(frameCount == 0 || available() < frameCount)
+		return;
+
+	// Only one of the signaler and the waiter may disarm the threshold
+	if(threshold.exchange(0, std::memory_order_relaxed) != 0)
+		semaphore.Signal();
+}
+
+} /* namespace */
+
+#pragma mark Waiting
+
+bool SFB::WaitableAudioRingBuffer::WaitForFramesToRead(uint32_t frameCount, dispatch_time_t timeout) noexcept
+{
+	if(frameCount == 0)
+		return true;
+
+	// At most CapacityFrames()-1 frames may be available
+	if(frameCount >= mRingBuffer.CapacityFrames())
+		return false;
+
+	return WaitForThreshold(mReadThreshold, mFramesAvailableToReadSemaphore, frameCount, timeout, [this]() noexcept {
+		return mRingBuffer.FramesAvailableToRead();
+	});
+}
+
+bool SFB::WaitableAudioRingBuffer::WaitForSpaceToWrite(uint32_t frameCount, dispatch_time_t timeout) noexcept
+{
+	if(frameCount == 0)
+		return true;
+
+	// At most CapacityFrames()-1 frames of space may be available
+	if(frameCount >= mRingBuffer.CapacityFrames())
+		return false;
+
+	return WaitForThreshold(mWriteThreshold, mFramesAvailableToWriteSemaphore, frameCount, timeout, [this]() noexcept {
+		return mRingBuffer.FramesAvailableToWrite();
+	});
+}
+
+#pragma mark Internals
+
+void SFB::WaitableAudioRingBuffer::SignalReaderIfNeeded() noexcept
+{
+	SignalIfThresholdReached(mReadThreshold, mFramesAvailableToReadSemaphore, [this]() noexcept {
+		return mRingBuffer.FramesAvailableToRead();
+	});
+}
+
+void SFB::WaitableAudioRingBuffer::SignalWriterIfNeeded() noexcept
+{
+	SignalIfThresholdReached(mWriteThreshold, mFramesAvailableToWriteSemaphore, [this]() noexcept {
+		return mRingBuffer.FramesAvailableToWrite();
+	});
+}
@@ -0,0 +1,211 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <chrono>
+#import <cstdint>
+
+#import <os/lock.h>
+
+namespace SFB {
+
+/// An @c os_unfair_lock that spins briefly before parking, implementing C++ @c TimedLockable
+///
+/// When the lock is held, @c lock() retries for a bounded number of spins before parking the thread in
+/// @c os_unfair_lock_lock(). Critical sections that are shorter than a context switch are usually released while the
+/// waiting thread is still spinning. The spin limit adapts to how long recent contended acquisitions took to succeed.
+///
+/// @c try_lock_for() and @c try_lock_until() spin until the lock is acquired or the timeout expires and never park
+/// the thread. They are suitable for use on a realtime thread with a timeout far shorter than the render deadline.
+///
+/// Contention counters are updated only on the contended paths, so uncontended locking costs the same as
+/// @c UnfairLock. This class may replace @c UnfairLock with no other changes.
+///
+/// @code
+/// SFB::AdaptiveUnfairLock _lock;
+/// // Later
+/// std::lock_guard<SFB::AdaptiveUnfairLock> lock(_lock);
+/// // On the render thread
+/// if(_lock.try_lock_for(std::chrono::microseconds(20))) { ... }
+/// @endcode
+class AdaptiveUnfairLock
+{
+
+public:
+
+	/// The default maximum number of spins before parking
+	static constexpr uint32_t sDefaultMaximumSpinCount = 1000;
+
+	/// Lock contention statistics
+	struct Statistics {
+		/// The number of calls to @c lock(), @c try_lock_for(), or @c try_lock_until() that found the lock held
+		uint64_t mContentions;
+		/// The number of contended calls to @c lock() that acquired the lock while spinning
+		uint64_t mSpinAcquisitions;
+		/// The number of contended calls to @c lock() that parked the thread
+		uint64_t mParks;
+		/// The number of calls to @c try_lock(), @c try_lock_for(), or @c try_lock_until() that failed
+		uint64_t mTryLockFailures;
+	};
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c AdaptiveUnfairLock
+	/// @param maximumSpinCount The maximum number of spins before parking, or @c 0 to park immediately
+	constexpr explicit AdaptiveUnfairLock(uint32_t maximumSpinCount = sDefaultMaximumSpinCount) noexcept
+	: mLock{OS_UNFAIR_LOCK_INIT}, mMaximumSpinCount{maximumSpinCount}
+	{}
+
+	// This class is non-copyable
+	AdaptiveUnfairLock(const AdaptiveUnfairLock&) = delete;
+
+	// This class is non-assignable
+	AdaptiveUnfairLock& operator=(const AdaptiveUnfairLock&) = delete;
+
+	// Destructor
+	~AdaptiveUnfairLock() = default;
+
+	// This class is non-movable
+	AdaptiveUnfairLock(AdaptiveUnfairLock&&) = delete;
+
+	// This class is non-move assignable
+	AdaptiveUnfairLock& operator=(AdaptiveUnfairLock&&) = delete;
+
+#pragma mark Lockable
+
+	/// Locks the lock, spinning briefly before parking the thread
+	void lock() noexcept
+	{
+		if(!os_unfair_lock_trylock(&mLock))
+			LockContended();
+	}
+
+	/// Unlocks the lock
+	void unlock() noexcept
+	{
+		os_unfair_lock_unlock(&mLock);
+	}
+
+	/// Attempts to lock the lock
+	/// @return @c true if the lock was successfully locked, @c false on error
+	bool try_lock() noexcept
+	{
+		if(os_unfair_lock_trylock(&mLock))
+			return true;
+		mTryLockFailures.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+#pragma mark TimedLockable
+
+	/// Attempts to lock the lock, spinning for at most @c timeout
+	/// @note The thread is never parked
+	/// @param timeout The maximum time to spin
+	/// @return @c true if the lock was successfully locked, @c false if the timeout expired
+	template <typename Rep, typename Period>
+	bool try_lock_for(const std::chrono::duration<Rep, Period>& timeout) noexcept
+	{
+		if(os_unfair_lock_trylock(&mLock))
+			return true;
+		const auto nanoseconds = std::chrono::duration<double, std::nano>(timeout).count();
+		return TryLockContended(nanoseconds > 0 ? ConvertNanosecondsToHostTicks(nanoseconds) : 0);
+	}
+
+	/// Attempts to lock the lock, spinning until at most @c deadline
+	/// @note The thread is never parked
+	/// @param deadline The time at which to stop spinning
+	/// @return @c true if the lock was successfully locked, @c false if the deadline passed
+	template <typename Clock, typename Duration>
+	bool try_lock_until(const std::chrono::time_point<Clock, Duration>& deadline) noexcept
+	{
+		return try_lock_for(deadline - Clock::now());
+	}
+
+	/// Attempts to lock the lock, spinning for at most @c hostTicks
+	/// @note The thread is never parked
+	/// @param hostTicks The maximum time to spin in host time units
+	/// @return @c true if the lock was successfully locked, @c false if the timeout expired
+	bool try_lock_for_host_time(uint64_t hostTicks) noexcept
+	{
+		if(os_unfair_lock_trylock(&mLock))
+			return true;
+		return TryLockContended(hostTicks);
+	}
+
+	/// Converts nanoseconds to host time units
+	static uint64_t ConvertNanosecondsToHostTicks(double nanoseconds) noexcept;
+
+#pragma mark Ownership
+
+	/// Asserts that the calling thread is the current owner of the lock.
+	///
+	/// If the lock is currently owned by the calling thread, this function returns.
+	///
+	/// If the lock is unlocked or owned by a different thread, this function
+	/// asserts and terminates the process.
+	void assert_owner() noexcept
+	{
+		os_unfair_lock_assert_owner(&mLock);
+	}
+
+	///	Asserts that the calling thread is not the current owner of the lock.
+	///
+	///	If the lock is unlocked or owned by a different thread, this function returns.
+	///
+	///	If the lock is currently owned by the current thread, this function asserts
+	///	and terminates the process.
+	void assert_not_owner() noexcept
+	{
+		os_unfair_lock_assert_not_owner(&mLock);
+	}
+
+#pragma mark Contention Statistics
+
+	/// Returns the lock contention statistics
+	Statistics UsageStatistics() const noexcept
+	{
+		return { mContentions.load(std::memory_order_relaxed), mSpinAcquisitions.load(std::memory_order_relaxed), mParks.load(std::memory_order_relaxed), mTryLockFailures.load(std::memory_order_relaxed) };
+	}
+
+	/// Resets the lock contention statistics
+	void ResetUsageStatistics() noexcept
+	{
+		mContentions.store(0, std::memory_order_relaxed);
+		mSpinAcquisitions.store(0, std::memory_order_relaxed);
+		mParks.store(0, std::memory_order_relaxed);
+		mTryLockFailures.store(0, std::memory_order_relaxed);
+	}
+
+private:
+
+	/// Spins and then parks until the lock is acquired
+	void LockContended() noexcept;
+
+	/// Spins until the lock is acquired or @c hostTicks elapse
+	bool TryLockContended(uint64_t hostTicks) noexcept;
+
+	/// The primitive lock
+	os_unfair_lock mLock;
+
+	/// The maximum number of spins before parking
+	const uint32_t mMaximumSpinCount;
+	/// A moving average of the spins needed by contended acquisitions
+	std::atomic_uint32_t mSpinEstimate = 0;
+
+	/// The number of contended acquisitions
+	std::atomic_uint64_t mContentions = 0;
+	/// The number of contended acquisitions that succeeded while spinning
+	std::atomic_uint64_t mSpinAcquisitions = 0;
+	/// The number of contended acquisitions that parked
+	std::atomic_uint64_t mParks = 0;
+	/// The number of failed attempts to lock
+	std::atomic_uint64_t mTryLockFailures = 0;
+
+};
+
+} /* namespace SFB */
@@ -0,0 +1,283 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <optional>
+
+#import <CoreAudioTypes/CoreAudioTypes.h>
+
+#import "SFBCARingBuffer.hpp"
+
+namespace SFB {
+
+/// A delay-locked loop estimating the relationship between an audio device's sample time and host time
+///
+/// Successive timestamps from the device, typically those passed to its IO procedure, are filtered by a second-order
+/// delay-locked loop. The loop estimates the device's actual sample period in host ticks, which differs slightly from
+/// the period implied by the nominal sample rate, and a smoothed mapping between sample time and host time.
+///
+/// A discontinuity in the timestamps, such as a jump in sample time when a device is restarted, reinitializes the loop.
+///
+/// This class is thread safe when @c Update() and @c Reset() are called from one thread. The estimate may be read
+/// lock-free from other threads.
+class AudioClockEstimator
+{
+
+public:
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c AudioClockEstimator
+	/// @param nominalSampleRate The device's nominal sample rate
+	/// @param bandwidth The loop bandwidth in Hz. Lower values reject more timestamp jitter but track changes more slowly.
+	explicit AudioClockEstimator(Float64 nominalSampleRate, Float64 bandwidth = 0.5) noexcept;
+
+	// This class is non-copyable
+	AudioClockEstimator(const AudioClockEstimator&) = delete;
+
+	// This class is non-assignable
+	AudioClockEstimator& operator=(const AudioClockEstimator&) = delete;
+
+	/// Destroys the @c AudioClockEstimator
+	~AudioClockEstimator() = default;
+
+	// This class is non-movable
+	AudioClockEstimator(AudioClockEstimator&&) = delete;
+
+	// This class is non-move assignable
+	AudioClockEstimator& operator=(AudioClockEstimator&&) = delete;
+
+#pragma mark Updating
+
+	/// Updates the estimate with a timestamp from the device
+	/// @note This method is safe to call from a realtime thread
+	/// @param timeStamp A timestamp with valid sample and host times
+	/// @return @c true if @c timeStamp was used, @c false if it lacked a sample or host time or did not advance
+	bool Update(const AudioTimeStamp& timeStamp) noexcept;
+
+	/// Discards the current estimate
+	void Reset() noexcept;
+
+#pragma mark Estimate
+
+	/// Returns the device's nominal sample rate
+	Float64 NominalSampleRate() const noexcept
+	{
+		return mNominalSampleRate;
+	}
+
+	/// Returns @c true if an estimate is available
+	bool HasEstimate() const noexcept
+	{
+		return mValid.load(std::memory_order_acquire);
+	}
+
+	/// Returns the number of timestamps filtered since the loop was last initialized
+	uint64_t UpdateCount() const noexcept
+	{
+		return mUpdateCount.load(std::memory_order_relaxed);
+	}
+
+	/// Returns the estimated actual sample rate in frames per second of host time
+	std::optional<Float64> SampleRate() const noexcept;
+
+	/// Returns the ratio of the estimated sample period to the nominal sample period
+	///
+	/// This has the same sense as @c AudioTimeStamp::mRateScalar: a value greater than one indicates the device is
+	/// running slower than its nominal sample rate.
+	std::optional<Float64> RateScalar() const noexcept;
+
+	/// Returns the estimated sample time at @c hostTime
+	std::optional<Float64> SampleTimeAtHostTime(UInt64 hostTime) const noexcept;
+
+	/// Returns the estimated host time at @c sampleTime
+	std::optional<UInt64> HostTimeAtSampleTime(Float64 sampleTime) const noexcept;
+
+private:
+
+	/// The filtered state of the loop
+	struct State {
+		/// The sample time of the most recent update
+		Float64 mSampleTime;
+		/// The filtered host time at @c mSampleTime
+		Float64 mHostTime;
+		/// The estimated sample period in host ticks
+		Float64 mPeriod;
+	};
+
+	/// Returns a consistent copy of the published state or @c std::nullopt if none
+	std::optional<State> LoadState() const noexcept;
+
+	/// Publishes @c state
+	void StoreState(const State& state) noexcept;
+
+	/// Initializes the loop at @c sampleTime and @c hostTime
+	void Initialize(Float64 sampleTime, Float64 hostTime) noexcept;
+
+	/// The nominal sample rate
+	const Float64 mNominalSampleRate;
+	/// The loop bandwidth in Hz
+	const Float64 mBandwidth;
+	/// The nominal sample period in host ticks
+	const Float64 mNominalPeriod;
+
+	/// The state of the loop as seen by the updating thread
+	State mState{};
+
+	/// Sequence number protecting the published state; odd while the state is being modified
+	std::atomic_uint32_t mSequence = 0;
+	/// The published sample time
+	std::atomic<Float64> mPublishedSampleTime = 0;
+	/// The published host time
+	std::atomic<Float64> mPublishedHostTime = 0;
+	/// The published sample period
+	std::atomic<Float64> mPublishedPeriod = 0;
+	/// Whether the published state is valid
+	std::atomic_bool mValid = false;
+	/// The number of updates since initialization
+	std::atomic_uint64_t mUpdateCount = 0;
+
+	static_assert(std::atomic<Float64>::is_always_lock_free, "Lock-free std::atomic<Float64> required");
+
+};
+
+/// A class relating the clocks of two audio devices for bridging audio from one to the other without an aggregate device
+///
+/// The input device's IO procedure writes audio to a @c CARingBuffer at its own sample times and calls
+/// @c UpdateInput(). The output device's IO procedure calls @c UpdateOutput() and reads the audio by host time, which
+/// the input clock estimate converts to the input device's sample time delayed by the target latency.
+///
+/// Reading by host time alone keeps the buffer from slowly overrunning or underrunning but corrects accumulated drift by
+/// skipping or repeating frames. For glitch-free bridging pass @c CorrectedPlaybackRate() to a varispeed resampler
+/// between the buffer and the output.
+///
+/// @code
+/// SFB::AudioClockBridge bridge(48000, 44100, 256);
+/// // In the input IO procedure
+/// ringBuffer.Write(inputData, frameCount, static_cast<int64_t>(inInputTime->mSampleTime));
+/// bridge.UpdateInput(*inInputTime);
+/// // In the output IO procedure
+/// bridge.UpdateOutput(*inOutputTime);
+/// bridge.Read(ringBuffer, outputData, frameCount, inOutputTime->mHostTime);
+/// @endcode
+class AudioClockBridge
+{
+
+public:
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c AudioClockBridge
+	/// @param inputSampleRate The input device's nominal sample rate
+	/// @param outputSampleRate The output device's nominal sample rate
+	/// @param targetLatencyFrames The desired delay between writing and reading audio, in input frames
+	/// @param bandwidth The bandwidth in Hz of the clock estimators' delay-locked loops
+	AudioClockBridge(Float64 inputSampleRate, Float64 outputSampleRate, Float64 targetLatencyFrames, Float64 bandwidth = 0.5) noexcept
+	: mInputClock{inputSampleRate, bandwidth}, mOutputClock{outputSampleRate, bandwidth}, mTargetLatencyFrames{targetLatencyFrames}
+	{}
+
+	// This class is non-copyable
+	AudioClockBridge(const AudioClockBridge&) = delete;
+
+	// This class is non-assignable
+	AudioClockBridge& operator=(const AudioClockBridge&) = delete;
+
+	/// Destroys the @c AudioClockBridge
+	~AudioClockBridge() = default;
+
+	// This class is non-movable
+	AudioClockBridge(AudioClockBridge&&) = delete;
+
+	// This class is non-move assignable
+	AudioClockBridge& operator=(AudioClockBridge&&) = delete;
+
+#pragma mark Clocks
+
+	/// Updates the input clock estimate
+	/// @note This method should only be called from the input device's IO thread
+	bool UpdateInput(const AudioTimeStamp& timeStamp) noexcept
+	{
+		return mInputClock.Update(timeStamp);
+	}
+
+	/// Updates the output clock estimate
+	/// @note This method should only be called from the output device's IO thread
+	bool UpdateOutput(const AudioTimeStamp& timeStamp) noexcept
+	{
+		return mOutputClock.Update(timeStamp);
+	}
+
+	/// Returns the input clock estimate
+	const AudioClockEstimator& InputClock() const noexcept
+	{
+		return mInputClock;
+	}
+
+	/// Returns the output clock estimate
+	const AudioClockEstimator& OutputClock() const noexcept
+	{
+		return mOutputClock;
+	}
+
+	/// Returns the desired delay between writing and reading audio, in input frames
+	Float64 TargetLatencyFrames() const noexcept
+	{
+		return mTargetLatencyFrames;
+	}
+
+#pragma mark Rate
+
+	/// Returns the estimated number of input frames per output frame
+	std::optional<Float64> RateRatio() const noexcept;
+
+	/// Returns the estimated rate ratio relative to the nominal rate ratio
+	///
+	/// This is the feed-forward playback rate for a varispeed resampler whose nominal conversion is from the input
+	/// sample rate to the output sample rate. It is @c 1 when both devices run at exactly their nominal rates.
+	std::optional<Float64> PlaybackRate() const noexcept;
+
+	/// Returns @c PlaybackRate() adjusted to steer the buffered latency toward @c TargetLatencyFrames()
+	///
+	/// The adjustment is proportional to the difference between the actual and target latency and is limited to
+	/// ±1000 ppm so it remains inaudible.
+	/// @param readSampleTime The input sample time of the next frame the resampler will consume
+	/// @param hostTime The host time at which that frame will be consumed
+	std::optional<Float64> CorrectedPlaybackRate(Float64 readSampleTime, UInt64 hostTime) const noexcept;
+
+#pragma mark Reading
+
+	/// Returns the input sample time to read at @c hostTime
+	std::optional<Float64> ReadSampleTimeAtHostTime(UInt64 hostTime) const noexcept
+	{
+		auto sampleTime = mInputClock.SampleTimeAtHostTime(hostTime);
+		if(!sampleTime)
+			return std::nullopt;
+		return *sampleTime - mTargetLatencyFrames;
+	}
+
+	/// Reads audio from @c ringBuffer at the input sample time corresponding to @c hostTime
+	/// @note This method is safe to call from a realtime thread
+	/// @param ringBuffer The ring buffer written by the input device at its sample times
+	/// @param bufferList An @c AudioBufferList to receive the audio
+	/// @param frameCount The number of frames to read
+	/// @param hostTime The host time of the first frame, typically the output timestamp's host time
+	/// @return @c true on success, @c false if no input clock estimate is available or the read failed
+	bool Read(CARingBuffer& ringBuffer, AudioBufferList * const _Nonnull bufferList, uint32_t frameCount, UInt64 hostTime) const noexcept;
+
+private:
+
+	/// The input clock estimate
+	AudioClockEstimator mInputClock;
+	/// The output clock estimate
+	AudioClockEstimator mOutputClock;
+	/// The target latency in input frames
+	const Float64 mTargetLatencyFrames;
+
+};
+
+} /* namespace SFB */
@@ -0,0 +1,225 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <algorithm>
+#import <memory>
+#import <utility>
+
+#import <CoreAudioTypes/CoreAudioTypes.h>
+
+#import "SFBAudioRingBuffer.hpp"
+#import "SFBCABufferList.hpp"
+#import "SFBCARingBuffer.hpp"
+#import "SFBCAStreamBasicDescription.hpp"
+
+CF_ASSUME_NONNULL_BEGIN
+
+namespace SFB {
+
+/// A per-channel peak, RMS, and true peak meter using vDSP
+///
+/// Levels accumulate incrementally over the audio passed to @c Process() until @c Reset() is called. Samples are read
+/// once, in place when possible, so metering costs one pass over the audio. Levels are linear amplitudes relative to
+/// full scale.
+///
+/// True peak is measured by 4x oversampling with a polyphase interpolation filter as described in ITU-R BS.1770. The
+/// filter history is carried between calls to @c Process(), so the result does not depend on how the audio is divided
+/// into blocks.
+///
+/// The audio must be in one of the formats in @c CommonPCMFormat. @c Process() does not allocate and is suitable for
+/// use on a realtime thread.
+/// @note This class is not thread safe
+///
+/// @code
+/// SFB::AudioMeter meter(ringBuffer.Format(), true);
+/// meter.Process(ringBuffer.ReadVector());
+/// auto truePeak = SFB::AudioMeter::ConvertToDecibels(meter.TruePeak(0));
+/// @endcode
+class AudioMeter
+{
+
+public:
+
+	/// The maximum number of frames converted at once
+	static constexpr UInt32 sMaximumChunkFrames = 1024;
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c AudioMeter
+	/// @param format The format of the audio to meter
+	/// @param measureTruePeak Whether to measure true peak in addition to sample peak and RMS
+	/// @throw @c std::invalid_argument If @c format is not a common PCM format or has no channels
+	/// @throw @c std::bad_alloc
+	explicit AudioMeter(const CAStreamBasicDescription& format, bool measureTruePeak = false);
+
+	// This class is non-copyable
+	AudioMeter(const AudioMeter&) = delete;
+
+	// This class is non-assignable
+	AudioMeter& operator=(const AudioMeter&) = delete;
+
+	/// Destroys the @c AudioMeter
+	~AudioMeter() = default;
+
+	// This class is non-movable
+	AudioMeter(AudioMeter&&) = delete;
+
+	// This class is non-move assignable
+	AudioMeter& operator=(AudioMeter&&) = delete;
+
+#pragma mark Metering
+
+	/// Accumulates the levels of @c frameCount frames of audio in @c bufferList
+	/// @param bufferList A buffer list in the meter's format
+	/// @param frameCount The number of frames to meter
+	/// @return @c true on success, @c false if @c bufferList does not match the meter's format or contains fewer than @c frameCount frames
+	bool Process(const AudioBufferList& bufferList, UInt32 frameCount) noexcept;
+
+	/// Accumulates the levels of the audio in @c bufferList
+	/// @param bufferList A buffer list in the meter's format
+	/// @return @c true on success, @c false if @c bufferList does not match the meter's format
+	bool Process(const CABufferList& bufferList) noexcept
+	{
+		if(!bufferList)
+			return false;
+		return Process(*bufferList.ABL(), bufferList.FrameLength());
+	}
+
+	/// Accumulates the levels of the audio in an @c AudioRingBuffer or @c CARingBuffer read vector
+	/// @note The read position is not advanced
+	/// @param readVector The read vector
+	/// @return @c true on success, @c false if the ring buffer's format does not match the meter's format
+	template <typename ReadBuffer>
+	bool Process(const std::pair<const ReadBuffer, const ReadBuffer>& readVector) noexcept
+	{
+		return Process(readVector.first.mBufferList, readVector.first.mFrameCount) && Process(readVector.second.mBufferList, readVector.second.mFrameCount);
+	}
+
+	/// Resets the accumulated levels and the true peak filter history
+	void Reset() noexcept;
+
+#pragma mark Levels
+
+	/// Returns the format of the audio being metered
+	const CAStreamBasicDescription& Format() const noexcept
+	{
+		return mFormat;
+	}
+
+	/// Returns the number of channels being metered
+	UInt32 ChannelCount() const noexcept
+	{
+		return mFormat.ChannelCount();
+	}
+
+	/// Returns @c true if true peak is being measured
+	bool MeasuresTruePeak() const noexcept
+	{
+		return mTruePeakHistory != nullptr;
+	}
+
+	/// Returns the number of frames metered since the last reset
+	uint64_t FrameCount() const noexcept
+	{
+		return mFrameCount;
+	}
+
+	/// Returns the peak sample magnitude of @c channel since the last reset
+	Float32 Peak(UInt32 channel) const noexcept
+	{
+		return channel < ChannelCount() ? mChannels[channel].mPeak : 0;
+	}
+
+	/// Returns the RMS level of @c channel since the last reset
+	Float32 RMS(UInt32 channel) const noexcept;
+
+	/// Returns the true peak of @c channel since the last reset, or the sample peak if true peak is not being measured
+	Float32 TruePeak(UInt32 channel) const noexcept
+	{
+		return channel < ChannelCount() ? std::max(mChannels[channel].mPeak, mChannels[channel].mTruePeak) : 0;
+	}
+
+	/// Returns @c true if the peak sample magnitude of @c channel since the last reset does not exceed @c threshold
+	bool IsChannelSilent(UInt32 channel, Float32 threshold = 0) const noexcept
+	{
+		return Peak(channel) <= threshold;
+	}
+
+	/// Returns @c true if the peak sample magnitude of every channel since the last reset does not exceed @c threshold
+	bool IsSilent(Float32 threshold = 0) const noexcept;
+
+#pragma mark Silence Detection
+
+	/// Returns @c true if no sample in @c frameCount frames of @c bufferList has a magnitude exceeding @c threshold
+	///
+	/// The scan stops at the first sample exceeding @c threshold. Zero of either sign is silent.
+	/// @param bufferList A buffer list
+	/// @param format The format of @c bufferList, which must be a common PCM format
+	/// @param frameCount The number of frames to examine
+	/// @param threshold The maximum magnitude of a silent sample relative to full scale
+	/// @return @c true if the audio is silent, @c false otherwise or if @c bufferList does not match @c format
+	static bool IsSilent(const AudioBufferList& bufferList, const CAStreamBasicDescription& format, UInt32 frameCount, Float32 threshold = 0) noexcept;
+
+	/// Returns @c true if no sample in @c bufferList has a magnitude exceeding @c threshold
+	/// @param bufferList A buffer list in a common PCM format
+	/// @param threshold The maximum magnitude of a silent sample relative to full scale
+	/// @return @c true if the audio is silent, @c false otherwise
+	static bool IsSilent(const CABufferList& bufferList, Float32 threshold = 0) noexcept
+	{
+		if(!bufferList)
+			return false;
+		return IsSilent(*bufferList.ABL(), bufferList.Format(), bufferList.FrameLength(), threshold);
+	}
+
+#pragma mark Utilities
+
+	/// Converts a linear amplitude relative to full scale to decibels
+	/// @return The level in dBFS, or @c -infinity if @c amplitude is zero
+	static Float32 ConvertToDecibels(Float32 amplitude) noexcept;
+
+private:
+
+	/// Accumulated levels for one channel
+	struct ChannelLevels {
+		/// The peak sample magnitude
+		Float32 mPeak = 0;
+		/// The peak magnitude of the interpolated samples
+		Float32 mTruePeak = 0;
+		/// The sum of the squared samples
+		Float64 mSumOfSquares = 0;
+	};
+
+	/// Accumulates the levels of a buffer list that may be @c nullptr if @c frameCount is zero
+	bool Process(const AudioBufferList * const _Nullable bufferList, UInt32 frameCount) noexcept
+	{
+		if(frameCount == 0)
+			return true;
+		if(!bufferList)
+			return false;
+		return Process(*bufferList, frameCount);
+	}
+
+	/// The format of the audio being metered
+	CAStreamBasicDescription mFormat;
+	/// The levels for each channel
+	std::unique_ptr<ChannelLevels[]> mChannels;
+	/// The number of frames metered since the last reset
+	uint64_t mFrameCount = 0;
+
+	/// Converted samples preceded by the true peak filter history
+	std::unique_ptr<Float32[]> mScratch;
+	/// The true peak filter history for each channel or @c nullptr if true peak is not being measured
+	std::unique_ptr<Float32[]> mTruePeakHistory;
+	/// The output of one true peak filter phase
+	std::unique_ptr<Float32[]> mInterpolated;
+
+};
+
+} /* namespace SFB */
+
+CF_ASSUME_NONNULL_END
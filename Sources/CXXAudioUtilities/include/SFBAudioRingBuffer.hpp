@@ -1,5 +1,5 @@
 //
-// Copyright © 2013-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2013-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
@@ -8,44 +8,56 @@
 
 #import <atomic>
 #import <cstdlib>
+#import <type_traits>
+#import <utility>
 
 #import <CoreAudioTypes/CoreAudioTypes.h>
 
 #import "SFBCAStreamBasicDescription.hpp"
+#import "SFBRingBufferStatistics.hpp"
 
 namespace SFB {
 
 /// A ring buffer supporting non-interleaved audio.
 ///
 /// This class is thread safe when used from one reader thread and one writer thread (single producer, single consumer model).
-class AudioRingBuffer
+///
+/// The buffer may optionally be allocated using virtual memory mirroring, in which each channel's pages are mapped
+/// twice at consecutive addresses so reads and writes never wrap.
+///
+/// Statistics are collected by @c Counters, which must be either @c NullRingBufferCounters or @c RingBufferCounters.
+/// This template is not used directly; use @c AudioRingBuffer or @c InstrumentedAudioRingBuffer instead.
+template <typename Counters>
+class BasicAudioRingBuffer
 {
 
+	static_assert(std::is_same_v<Counters, NullRingBufferCounters> || std::is_same_v<Counters, RingBufferCounters>, "Unsupported counters type");
+
 public:
 
 #pragma mark Creation and Destruction
 
 	/// Creates a new @c AudioRingBuffer
 	/// @note @c Allocate() must be called before the object may be used.
-	constexpr AudioRingBuffer() noexcept = default;
+	constexpr BasicAudioRingBuffer() noexcept = default;
 
 	// This class is non-copyable
-	AudioRingBuffer(const AudioRingBuffer&) = delete;
+	BasicAudioRingBuffer(const BasicAudioRingBuffer&) = delete;
 
 	// This class is non-assignable
-	AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+	BasicAudioRingBuffer& operator=(const BasicAudioRingBuffer&) = delete;
 
 	/// Destroys the @c AudioRingBuffer and releases all associated resources.
-	~AudioRingBuffer()
+	~BasicAudioRingBuffer()
 	{
-		std::free(mBuffers);
+		Deallocate();
 	}
 
 	// This class is non-movable
-	AudioRingBuffer(AudioRingBuffer&&) = delete;
+	BasicAudioRingBuffer(BasicAudioRingBuffer&&) = delete;
 
 	// This class is non-move assignable
-	AudioRingBuffer& operator=(AudioRingBuffer&&) = delete;
+	BasicAudioRingBuffer& operator=(BasicAudioRingBuffer&&) = delete;
 
 #pragma mark Buffer management
 
@@ -58,6 +70,34 @@ public:
 	/// @return @c true on success, @c false on error
 	bool Allocate(const CAStreamBasicDescription& format, uint32_t capacityFrames) noexcept;
 
+	/// Allocates space for audio data with aligned channel buffers.
+	///
+	/// Each channel's buffer begins on an @c alignment boundary. When @c padChannelStride is @c true and the distance between
+	/// consecutive channel buffers would be a multiple of 4096 bytes, the distance is increased by one cache line so that
+	/// corresponding frames in different channels do not compete for the same L1 cache set. Padding takes precedence over
+	/// alignment: if @c alignment is larger than a cache line, such as @c vm_page_size, only the first channel's buffer is
+	/// then aligned to @c alignment and the others begin on a cache line boundary.
+	/// @note Only non-interleaved formats are supported.
+	/// @note This method is not thread safe.
+	/// @note Capacities from 2 to 2,147,483,648 (0x80000000) frames are supported
+	/// @param format The format of the audio that will be written to and read from this buffer.
+	/// @param capacityFrames The desired capacity, in frames
+	/// @param alignment The alignment of each channel's buffer in bytes, which must be a power of two multiple of @c sizeof(void *), such as 64 or @c vm_page_size
+	/// @param padChannelStride Whether the distance between channel buffers should be padded to avoid cache set aliasing, or @c false to align every channel's buffer to @c alignment
+	/// @return @c true on success, @c false on error
+	bool Allocate(const CAStreamBasicDescription& format, uint32_t capacityFrames, size_t alignment, bool padChannelStride = true) noexcept;
+
+	/// Allocates space for audio data using virtual memory mirroring.
+	///
+	/// Each channel's buffer is mapped twice, back to back, so that every read and write is a single contiguous copy.
+	/// @note Only non-interleaved formats are supported.
+	/// @note This method is not thread safe.
+	/// @note The capacity is rounded up to a power of two such that each channel's buffer is a multiple of the virtual memory page size
+	/// @param format The format of the audio that will be written to and read from this buffer.
+	/// @param capacityFrames The desired capacity, in frames
+	/// @return @c true on success, @c false on error
+	bool AllocateMirrored(const CAStreamBasicDescription& format, uint32_t capacityFrames) noexcept;
+
 	/// Frees the resources used by this @c AudioRingBuffer
 	/// @note This method is not thread safe.
 	void Deallocate() noexcept;
@@ -74,6 +114,12 @@ public:
 		return mCapacityFrames;
 	}
 
+	/// Returns @c true if this @c AudioRingBuffer was allocated using virtual memory mirroring
+	bool IsMirrored() const noexcept
+	{
+		return mIsMirrored;
+	}
+
 	/// Returns the format of this @c AudioRingBuffer
 	const CAStreamBasicDescription& Format() const noexcept
 	{
@@ -102,13 +148,114 @@ public:
 	/// @return The number of frames actually written
 	uint32_t Write(const AudioBufferList * const _Nonnull bufferList, uint32_t frameCount, bool allowPartial = true) noexcept;
 
+#pragma mark Advanced reading and writing
+
+	/// Advances the read position by the specified number of frames.
+	/// @note This method should only be called from the reader thread
+	void AdvanceReadPosition(uint32_t frameCount) noexcept;
+
+	/// Advances the write position by the specified number of frames.
+	/// @note This method should only be called from the writer thread
+	void AdvanceWritePosition(uint32_t frameCount) noexcept;
+
+
+	/// A read-only view of audio in the ring buffer
+	struct ReadBuffer {
+		/// An @c AudioBufferList whose buffers point directly into the ring buffer's storage
+		const AudioBufferList * const _Nullable mBufferList = nullptr;
+		/// The number of frames of valid audio in @c mBufferList
+		const uint32_t mFrameCount = 0;
+
+	private:
+		friend class BasicAudioRingBuffer;
+
+		/// Construct an empty @c ReadBuffer
+		ReadBuffer() noexcept = default;
+
+		/// Construct a @c ReadBuffer for the specified buffer list and frame count
+		/// @param bufferList The buffer list
+		/// @param frameCount The number of frames of valid audio in @c bufferList
+		ReadBuffer(const AudioBufferList * const _Nullable bufferList, uint32_t frameCount) noexcept
+		: mBufferList{bufferList}, mFrameCount{frameCount}
+		{}
+	};
+
+	/// A pair of @c ReadBuffer objects
+	using ReadBufferPair = std::pair<const ReadBuffer, const ReadBuffer>;
+
+	/// Returns the read vector containing the current readable audio.
+	///
+	/// The buffer lists point directly at the ring buffer's storage and remain valid until the next call to
+	/// @c ReadVector(), @c Allocate(), or @c Deallocate(). After consuming audio call @c AdvanceReadPosition().
+	/// @note For a mirrored buffer the second @c ReadBuffer is always empty
+	/// @note This method should only be called from the reader thread
+	const ReadBufferPair ReadVector() const noexcept;
+
+
+	/// A write-only view of space in the ring buffer
+	struct WriteBuffer {
+		/// An @c AudioBufferList whose buffers point directly into the ring buffer's storage
+		AudioBufferList * const _Nullable mBufferList = nullptr;
+		/// The capacity of @c mBufferList in frames
+		const uint32_t mFrameCapacity = 0;
+
+	private:
+		friend class BasicAudioRingBuffer;
+
+		/// Construct an empty @c WriteBuffer
+		WriteBuffer() noexcept = default;
+
+		/// Construct a @c WriteBuffer for the specified buffer list and frame capacity
+		/// @param bufferList The buffer list
+		/// @param frameCapacity The capacity of @c bufferList in frames
+		WriteBuffer(AudioBufferList * const _Nullable bufferList, uint32_t frameCapacity) noexcept
+		: mBufferList{bufferList}, mFrameCapacity{frameCapacity}
+		{}
+	};
+
+	/// A pair of @c WriteBuffer objects
+	using WriteBufferPair = std::pair<const WriteBuffer, const WriteBuffer>;
+
+	/// Returns the write vector containing the current writable space.
+	///
+	/// The buffer lists point directly at the ring buffer's storage and remain valid until the next call to
+	/// @c WriteVector(), @c Allocate(), or @c Deallocate(). The @c mDataByteSize of each buffer is set to its capacity
+	/// and may be modified by the caller. After storing audio call @c AdvanceWritePosition().
+	/// @note For a mirrored buffer the second @c WriteBuffer is always empty
+	/// @note This method should only be called from the writer thread
+	const WriteBufferPair WriteVector() const noexcept;
+
+#pragma mark Statistics
+
+	/// Returns a snapshot of the statistics collected by this @c AudioRingBuffer
+	/// @note Statistics are only collected when @c Counters is @c RingBufferCounters
+	/// @note This method may be called from any thread
+	RingBufferStatistics Statistics() const noexcept
+	{
+		return mCounters.Snapshot();
+	}
+
+	/// Resets the statistics collected by this @c AudioRingBuffer
+	/// @note This method should not be called while the buffer is being read or written
+	void ResetStatistics() noexcept
+	{
+		mCounters.Reset();
+	}
+
 private:
 
 	/// The format of the audio
 	CAStreamBasicDescription mFormat = {};
 
 	/// The channel pointers and buffers allocated in one chunk of memory
+	/// @note For a mirrored buffer the channel pointers and each channel's buffer are allocated separately
 	void * _Nonnull * _Nullable mBuffers = nullptr;
+	/// Whether each channel's buffer is mapped twice in consecutive virtual memory
+	bool mIsMirrored = false;
+
+	/// Four @c AudioBufferList structures allocated in one chunk of memory, used by @c ReadVector() and @c WriteVector()
+	/// @note The first two belong to the reader and the second two to the writer
+	void * _Nullable mBufferLists = nullptr;
 
 	/// The frame capacity per channel
 	uint32_t mCapacityFrames = 0;
@@ -121,8 +268,20 @@ private:
 	/// The offset in frames of the read location
 	std::atomic_uint32_t mReadPointer = 0;
 
+	/// Statistics counters
+	mutable Counters mCounters;
+
 	static_assert(std::atomic_uint32_t::is_always_lock_free, "Lock-free std::atomic_uint32_t required");
 
 };
 
+extern template class BasicAudioRingBuffer<NullRingBufferCounters>;
+extern template class BasicAudioRingBuffer<RingBufferCounters>;
+
+/// A ring buffer supporting non-interleaved audio that does not collect statistics
+using AudioRingBuffer = BasicAudioRingBuffer<NullRingBufferCounters>;
+
+/// A ring buffer supporting non-interleaved audio that collects statistics
+using InstrumentedAudioRingBuffer = BasicAudioRingBuffer<RingBufferCounters>;
+
 } /* namespace SFB */
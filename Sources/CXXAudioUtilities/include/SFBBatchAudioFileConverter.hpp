@@ -0,0 +1,191 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <cstdint>
+#import <functional>
+#import <string>
+#import <vector>
+
+#import <AudioToolbox/AudioFile.h>
+
+#import "SFBCABufferListPool.hpp"
+#import "SFBCAStreamBasicDescription.hpp"
+#import "SFBCFWrapper.hpp"
+
+CF_ASSUME_NONNULL_BEGIN
+
+namespace SFB {
+
+/// A class that converts many audio files concurrently using @c CAExtAudioFile
+///
+/// Jobs are taken from a shared queue by a fixed number of worker threads, one job per worker at a time. Each job
+/// decodes the input file to a non-interleaved 32-bit float client format and encodes it to the output file using the
+/// same client format. Decode buffers are obtained from a @c CABufferListPool shared by the workers, so jobs with the
+/// same sample rate and channel count reuse the same buffers.
+///
+/// @code
+/// SFB::BatchAudioFileConverter converter;
+/// converter.AddJob({inputURL, outputURL, kAudioFileM4AType, aacFormat});
+/// auto results = converter.Run([](const SFB::BatchAudioFileConverter::Progress& progress) {
+///     // Called from worker threads
+/// });
+/// @endcode
+class BatchAudioFileConverter
+{
+
+public:
+
+	/// A file conversion
+	struct Job {
+		/// The URL of the file to convert
+		CFURL mInputURL;
+		/// The URL of the file to create
+		CFURL mOutputURL;
+		/// The type of the file to create
+		AudioFileTypeID mFileType;
+		/// The data format of the file to create
+		/// @note If @c mSampleRate or @c mChannelsPerFrame is zero the input file's value is used
+		CAStreamBasicDescription mOutputFormat;
+		/// The flags passed to @c ExtAudioFileCreateWithURL
+		UInt32 mFileFlags = kAudioFileFlags_EraseFile;
+	};
+
+	/// The progress of a job in progress
+	struct Progress {
+		/// The index of the job
+		size_t mJobIndex;
+		/// The number of frames converted so far, in the input file's sample rate
+		int64_t mFramesConverted;
+		/// The length of the input file in frames, which may be an estimate
+		int64_t mTotalFrames;
+		/// The time elapsed since the job was started, in seconds
+		double mElapsedSeconds;
+	};
+
+	/// The outcome of a job
+	/// @note If a job fails or is cancelled after its output file was created the partially written file is deleted
+	struct Result {
+		/// @c true if the file was converted successfully
+		bool mSucceeded = false;
+		/// A description of the error that occurred, or an empty string on success
+		std::string mErrorDescription;
+		/// The number of frames converted, in the input file's sample rate
+		int64_t mFramesConverted = 0;
+		/// The input file's sample rate
+		double mSampleRate = 0;
+		/// The time taken by the job, in seconds
+		double mElapsedSeconds = 0;
+
+		/// Returns the conversion throughput in frames per second
+		double FramesPerSecond() const noexcept
+		{
+			return mElapsedSeconds > 0 ? static_cast<double>(mFramesConverted) / mElapsedSeconds : 0;
+		}
+
+		/// Returns the ratio of the duration of the converted audio to the time taken to convert it
+		double RealtimeFactor() const noexcept
+		{
+			return mSampleRate > 0 ? FramesPerSecond() / mSampleRate : 0;
+		}
+	};
+
+	/// A function called to report the progress of a job
+	/// @note This function is called concurrently from the worker threads, once per converted buffer
+	using ProgressCallback = std::function<void(const Progress&)>;
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c BatchAudioFileConverter
+	/// @param threadCount The maximum number of files to convert concurrently, or @c 0 to use one per processor
+	/// @param bufferFrameCapacity The capacity in frames of the buffers used to transfer audio between files
+	/// @throw @c std::invalid_argument If @c bufferFrameCapacity is zero
+	explicit BatchAudioFileConverter(unsigned int threadCount = 0, UInt32 bufferFrameCapacity = 16384);
+
+	// This class is non-copyable
+	BatchAudioFileConverter(const BatchAudioFileConverter&) = delete;
+
+	// This class is non-assignable
+	BatchAudioFileConverter& operator=(const BatchAudioFileConverter&) = delete;
+
+	/// Destroys the @c BatchAudioFileConverter
+	~BatchAudioFileConverter() = default;
+
+	// This class is non-movable
+	BatchAudioFileConverter(BatchAudioFileConverter&&) = delete;
+
+	// This class is non-move assignable
+	BatchAudioFileConverter& operator=(BatchAudioFileConverter&&) = delete;
+
+#pragma mark Jobs
+
+	/// Appends a job to the queue
+	/// @note This method must not be called while @c Run() is executing
+	/// @param job The job to append
+	/// @return The index of the job
+	/// @throw @c std::bad_alloc
+	size_t AddJob(Job job);
+
+	/// Returns the number of jobs in the queue
+	size_t JobCount() const noexcept
+	{
+		return mJobs.size();
+	}
+
+	/// Removes all jobs from the queue
+	/// @note This method must not be called while @c Run() is executing
+	void RemoveAllJobs() noexcept
+	{
+		mJobs.clear();
+	}
+
+#pragma mark Conversion
+
+	/// Converts all jobs in the queue and blocks until they are complete
+	///
+	/// The calling thread participates as one of the workers. An error converting one file does not affect the others.
+	/// @param progress An optional function called to report the progress of each job
+	/// @return The outcome of each job, in the order the jobs were added
+	/// @throw @c std::bad_alloc
+	std::vector<Result> Run(const ProgressCallback& progress = {});
+
+	/// Requests that @c Run() stop as soon as possible
+	///
+	/// Jobs in progress are stopped after the current buffer and their output files are deleted. Jobs not yet started
+	/// are skipped. Both are reported as unsuccessful.
+	/// @note This method may be called from any thread
+	void Cancel() noexcept
+	{
+		mCancelled.store(true, std::memory_order_relaxed);
+	}
+
+private:
+
+	/// Performs the job at @c index
+	Result Convert(size_t index, const ProgressCallback& progress) noexcept;
+
+	/// The maximum number of concurrent conversions
+	const unsigned int mThreadCount;
+	/// The capacity of the transfer buffers in frames
+	const UInt32 mBufferFrameCapacity;
+
+	/// The queued jobs
+	std::vector<Job> mJobs;
+	/// The index of the next job to be started
+	std::atomic_size_t mNextJob = 0;
+	/// Flag set when cancellation is requested
+	std::atomic_bool mCancelled = false;
+
+	/// Transfer buffers shared by the workers
+	CABufferListPool mBufferPool;
+
+};
+
+} /* namespace SFB */
+
+CF_ASSUME_NONNULL_END
@@ -1,5 +1,5 @@
 //
-// Copyright © 2020-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2020-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
@@ -7,7 +7,9 @@
 #pragma once
 
 #import <algorithm>
+#import <cassert>
 #import <cstdint>
+#import <cstring>
 #import <optional>
 #import <stdexcept>
 #import <type_traits>
@@ -22,6 +24,92 @@ class ByteStream
 
 public:
 
+	/// A range of bytes in a @c ByteStream whose bounds have been checked
+	///
+	/// Values are read from a @c Reservation without bounds checks, so a structure of known size can be parsed with
+	/// a single check when the reservation is made with @c ByteStream::Reserve().
+	/// @note A @c Reservation refers to the buffer of the @c ByteStream from which it was obtained
+	class Reservation
+	{
+
+	public:
+
+		/// Creates an empty @c Reservation
+		constexpr Reservation() noexcept = default;
+
+		/// Returns @c true if the reservation was successful
+		explicit operator bool() const noexcept
+		{
+			return mBuffer != nullptr;
+		}
+
+		/// Returns the number of bytes remaining in the reservation
+		constexpr size_t Remaining() const noexcept
+		{
+			return mLength - mPosition;
+		}
+
+		/// Reads a value
+		/// @note The reservation must contain at least @c sizeof(T) remaining bytes
+		/// @tparam T The type to read
+		/// @return The value read
+		template <typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>>>
+		T Read() noexcept
+		{
+			assert(sizeof(T) <= Remaining());
+			T value;
+			std::memcpy(&value, reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(mBuffer) + mPosition), sizeof(T));
+			mPosition += sizeof(T);
+			return value;
+		}
+
+		/// Reads a little endian value and converts it to host byte ordering
+		/// @note The reservation must contain at least @c sizeof(T) remaining bytes
+		/// @tparam T The type to read
+		/// @return The value read
+		template <typename T, typename = std::enable_if_t<std::is_same_v<T, std::uint16_t> || std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::uint64_t>>>
+		T ReadLE() noexcept
+		{
+			return LittleToHost(Read<T>());
+		}
+
+		/// Reads a big endian value and converts it to host byte ordering
+		/// @note The reservation must contain at least @c sizeof(T) remaining bytes
+		/// @tparam T The type to read
+		/// @return The value read
+		template <typename T, typename = std::enable_if_t<std::is_same_v<T, std::uint16_t> || std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::uint64_t>>>
+		T ReadBE() noexcept
+		{
+			return BigToHost(Read<T>());
+		}
+
+		/// Advances the read position
+		/// @note The reservation must contain at least @c count remaining bytes
+		/// @param count The number of bytes to skip
+		void Skip(size_t count) noexcept
+		{
+			assert(count <= Remaining());
+			mPosition += count;
+		}
+
+	private:
+
+		friend class ByteStream;
+
+		/// Creates a @c Reservation of @c len bytes starting at @c buf
+		Reservation(const void * _Nonnull buf, size_t len) noexcept
+		: mBuffer{buf}, mLength{len}
+		{}
+
+		/// The first reserved byte
+		const void * _Nullable mBuffer = nullptr;
+		/// The number of reserved bytes
+		size_t mLength = 0;
+		/// The current read position
+		size_t mPosition = 0;
+
+	};
+
 	/// Creates an empty @c ByteStream
 	constexpr ByteStream() noexcept = default;
 
@@ -250,6 +338,102 @@ public:
 	}
 
 
+	/// Reads little endian values, converts them to host byte ordering, and advances the read position.
+	///
+	/// The values are bounds checked and copied as a single block.
+	/// @tparam T The type to read
+	/// @param values The destination array
+	/// @param count The number of values to read
+	/// @return @c true on success, @c false if fewer than @c count values remain
+	template <typename T, typename = std::enable_if_t<std::is_same_v<T, std::uint16_t> || std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::uint64_t>>>
+	bool ReadLE(T * const _Nonnull values, size_t count) noexcept
+	{
+		if(!ReadArray(values, count))
+			return false;
+		// This loop is a no-op on little endian hosts
+		for(size_t i = 0; i < count; ++i)
+			values[i] = LittleToHost(values[i]);
+		return true;
+	}
+
+	/// Reads big endian values, converts them to host byte ordering, and advances the read position.
+	///
+	/// The values are bounds checked and copied as a single block, and the byte swap loop is vectorized by the compiler.
+	/// @tparam T The type to read
+	/// @param values The destination array
+	/// @param count The number of values to read
+	/// @return @c true on success, @c false if fewer than @c count values remain
+	template <typename T, typename = std::enable_if_t<std::is_same_v<T, std::uint16_t> || std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::uint64_t>>>
+	bool ReadBE(T * const _Nonnull values, size_t count) noexcept
+	{
+		if(!ReadArray(values, count))
+			return false;
+		for(size_t i = 0; i < count; ++i)
+			values[i] = BigToHost(values[i]);
+		return true;
+	}
+
+	/// Reads values, swaps their byte ordering, and advances the read position.
+	///
+	/// The values are bounds checked and copied as a single block, and the byte swap loop is vectorized by the compiler.
+	/// @tparam T The type to read
+	/// @param values The destination array
+	/// @param count The number of values to read
+	/// @return @c true on success, @c false if fewer than @c count values remain
+	template <typename T, typename = std::enable_if_t<std::is_same_v<T, std::uint16_t> || std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::uint64_t>>>
+	bool ReadSwapped(T * const _Nonnull values, size_t count) noexcept
+	{
+		if(!ReadArray(values, count))
+			return false;
+		for(size_t i = 0; i < count; ++i)
+			values[i] = Swap(values[i]);
+		return true;
+	}
+
+	/// Reserves @c count bytes for unchecked reading and advances the read position past them.
+	///
+	/// If fewer than @c count bytes remain the read position is unchanged and the returned reservation is empty.
+	/// @code
+	/// if(auto header = stream.Reserve(12)) {
+	///     auto chunkID = header.ReadBE<uint32_t>();
+	///     auto chunkSize = header.ReadBE<uint64_t>();
+	/// }
+	/// @endcode
+	/// @param count The number of bytes to reserve
+	/// @return A @c Reservation of @c count bytes or an empty @c Reservation on failure
+	Reservation Reserve(size_t count) noexcept
+	{
+		if(!mBuffer || count > Remaining())
+			return {};
+		Reservation reservation{reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(mBuffer) + mReadPosition), count};
+		mReadPosition += count;
+		return reservation;
+	}
+
+	/// Returns a pointer to @c count bytes in the buffer and advances the read position without copying.
+	/// @param count The number of bytes to read
+	/// @return A pointer to the bytes or @c nullptr if fewer than @c count bytes remain
+	const void * _Nullable ReadNoCopy(size_t count) noexcept
+	{
+		if(!mBuffer || count > Remaining())
+			return nullptr;
+		auto bytes = reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(mBuffer) + mReadPosition);
+		mReadPosition += count;
+		return bytes;
+	}
+
+	/// Returns a @c ByteStream for @c count bytes in the buffer and advances the read position without copying.
+	/// @param count The number of bytes in the returned stream
+	/// @return A @c ByteStream for the bytes or @c std::nullopt if fewer than @c count bytes remain
+	std::optional<ByteStream> ReadSubstream(size_t count) noexcept
+	{
+		auto bytes = ReadNoCopy(count);
+		if(!bytes)
+			return std::nullopt;
+		return ByteStream{bytes, count, 0};
+	}
+
+
 	/// Reads bytes and advances the read position.
 	/// @param buf The destination buffer or @c nullptr to discard the bytes
 	/// @param count The number of bytes to read
@@ -314,6 +498,57 @@ public:
 
 private:
 
+	/// Creates a @c ByteStream for a buffer known to be valid
+	ByteStream(const void * _Nullable buf, size_t len, size_t pos) noexcept
+	: mBuffer{buf}, mBufferLength{len}, mReadPosition{pos}
+	{}
+
+	/// Copies @c count values and advances the read position if at least @c count values remain
+	template <typename T>
+	bool ReadArray(T * const _Nonnull values, size_t count) noexcept
+	{
+		if(count > Remaining() / sizeof(T))
+			return false;
+		Read(static_cast<void *>(values), count * sizeof(T));
+		return true;
+	}
+
+	/// Converts a little endian value to host byte ordering
+	template <typename T>
+	static T LittleToHost(T value) noexcept
+	{
+		if constexpr (std::is_same_v<T, std::uint16_t>)
+			return OSSwapLittleToHostInt16(value);
+		else if constexpr (std::is_same_v<T, std::uint32_t>)
+			return OSSwapLittleToHostInt32(value);
+		else
+			return OSSwapLittleToHostInt64(value);
+	}
+
+	/// Converts a big endian value to host byte ordering
+	template <typename T>
+	static T BigToHost(T value) noexcept
+	{
+		if constexpr (std::is_same_v<T, std::uint16_t>)
+			return OSSwapBigToHostInt16(value);
+		else if constexpr (std::is_same_v<T, std::uint32_t>)
+			return OSSwapBigToHostInt32(value);
+		else
+			return OSSwapBigToHostInt64(value);
+	}
+
+	/// Swaps the byte ordering of a value
+	template <typename T>
+	static T Swap(T value) noexcept
+	{
+		if constexpr (std::is_same_v<T, std::uint16_t>)
+			return OSSwapInt16(value);
+		else if constexpr (std::is_same_v<T, std::uint32_t>)
+			return OSSwapInt32(value);
+		else
+			return OSSwapInt64(value);
+	}
+
 	/// The wrapped buffer
 	const void * _Nullable mBuffer = nullptr;
 	/// The number of bytes in @c mBuffer
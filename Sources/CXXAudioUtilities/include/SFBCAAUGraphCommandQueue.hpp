@@ -0,0 +1,217 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <functional>
+#import <mutex>
+#import <optional>
+#import <type_traits>
+#import <vector>
+
+#import <AudioToolbox/AUGraph.h>
+#import <AudioToolbox/AudioUnit.h>
+
+#import "SFBCAAUGraph.hpp"
+#import "SFBMPMCRingBuffer.hpp"
+
+CF_ASSUME_NONNULL_BEGIN
+
+namespace SFB {
+
+/// A queue of deferred changes to a running @c CAAUGraph
+///
+/// Parameter changes and other realtime-safe commands are enqueued from any thread into a preallocated lock-free ring
+/// buffer. The queue's pre-render notification, added to the graph using @c AddRenderNotify(), dequeues them on the
+/// render thread and applies parameter changes sample-accurately using @c AudioUnitScheduleParameters. Commands
+/// scheduled for a future sample time are held until the render cycle containing that time, and parameter ramps
+/// spanning several render cycles are rescheduled in each.
+///
+/// Graph mutations such as connection changes and property sets, which are not realtime safe, are instead collected and
+/// applied together by @c CommitGraphChanges() followed by a single call to @c CAAUGraph::Update().
+///
+/// Sample times refer to the timeline of the graph's output, as passed to render notifications.
+///
+/// @code
+/// SFB::CAAUGraphCommandQueue queue(graph);
+/// // On the UI thread
+/// queue.RampParameter(mixerUnit, kMultiChannelMixerParam_Volume, kAudioUnitScope_Input, 0, 1, 0, 4410);
+/// queue.ConnectNodeInput(playerNode, 0, mixerNode, 1);
+/// queue.CommitGraphChanges();
+/// @endcode
+class CAAUGraphCommandQueue
+{
+
+public:
+
+	/// A function performed on the render thread
+	using PerformFunction = void (*)(void * _Nullable context) noexcept;
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c CAAUGraphCommandQueue for @c graph and adds its render notification
+	/// @note @c graph must outlive the queue
+	/// @param graph The graph to which commands are applied
+	/// @param capacity The maximum number of queued and pending commands
+	/// @throw @c std::bad_alloc
+	/// @throw @c std::system_error If the render notification could not be added
+	explicit CAAUGraphCommandQueue(CAAUGraph& graph, uint32_t capacity = 256);
+
+	// This class is non-copyable
+	CAAUGraphCommandQueue(const CAAUGraphCommandQueue&) = delete;
+
+	// This class is non-assignable
+	CAAUGraphCommandQueue& operator=(const CAAUGraphCommandQueue&) = delete;
+
+	/// Removes the render notification and destroys the @c CAAUGraphCommandQueue
+	~CAAUGraphCommandQueue();
+
+	// This class is non-movable
+	CAAUGraphCommandQueue(CAAUGraphCommandQueue&&) = delete;
+
+	// This class is non-move assignable
+	CAAUGraphCommandQueue& operator=(CAAUGraphCommandQueue&&) = delete;
+
+#pragma mark Render Thread Commands
+
+	/// Enqueues a parameter change
+	/// @note This method is lock-free and may be called from any thread
+	/// @param unit The audio unit
+	/// @param parameter The parameter to change
+	/// @param scope The parameter's scope
+	/// @param element The parameter's element
+	/// @param value The new value
+	/// @param sampleTime The sample time at which to change the parameter, or @c std::nullopt for the next render cycle
+	/// @return @c true if the command was enqueued, @c false if the queue is full
+	bool SetParameter(AudioUnit unit, AudioUnitParameterID parameter, AudioUnitScope scope, AudioUnitElement element, AudioUnitParameterValue value, std::optional<Float64> sampleTime = std::nullopt) noexcept;
+
+	/// Enqueues a linear parameter ramp
+	///
+	/// The ramp ends early if a later parameter command for the same parameter, scope, and element takes effect before
+	/// the ramp completes.
+	/// @note This method is lock-free and may be called from any thread
+	/// @param unit The audio unit
+	/// @param parameter The parameter to ramp
+	/// @param scope The parameter's scope
+	/// @param element The parameter's element
+	/// @param startValue The value at the start of the ramp
+	/// @param endValue The value at the end of the ramp
+	/// @param durationFrames The length of the ramp in frames
+	/// @param sampleTime The sample time at which the ramp starts, or @c std::nullopt for the next render cycle
+	/// @return @c true if the command was enqueued, @c false if the queue is full
+	bool RampParameter(AudioUnit unit, AudioUnitParameterID parameter, AudioUnitScope scope, AudioUnitElement element, AudioUnitParameterValue startValue, AudioUnitParameterValue endValue, UInt32 durationFrames, std::optional<Float64> sampleTime = std::nullopt) noexcept;
+
+	/// Enqueues a function to be performed on the render thread before rendering
+	/// @note This method is lock-free and may be called from any thread
+	/// @param function The function to perform, which must be realtime safe
+	/// @param context A pointer passed to @c function
+	/// @param sampleTime The sample time before which to perform @c function, or @c std::nullopt for the next render cycle
+	/// @return @c true if the command was enqueued, @c false if the queue is full
+	bool Perform(PerformFunction _Nonnull function, void * _Nullable context, std::optional<Float64> sampleTime = std::nullopt) noexcept;
+
+#pragma mark Graph Mutations
+
+	/// Adds a connection from a node's output to a node's input to the pending graph changes
+	/// @throw @c std::bad_alloc
+	void ConnectNodeInput(AUNode sourceNode, UInt32 sourceOutputNumber, AUNode destNode, UInt32 destInputNumber);
+
+	/// Adds the disconnection of a node's input to the pending graph changes
+	/// @throw @c std::bad_alloc
+	void DisconnectNodeInput(AUNode destNode, UInt32 destInputNumber);
+
+	/// Adds setting a node input's render callback to the pending graph changes
+	/// @throw @c std::bad_alloc
+	void SetNodeInputCallback(AUNode destNode, UInt32 destInputNumber, const AURenderCallbackStruct& inputCallback);
+
+	/// Adds an audio unit property change to the pending graph changes
+	/// @note The property data is copied
+	/// @throw @c std::bad_alloc
+	void SetProperty(AudioUnit unit, AudioUnitPropertyID property, AudioUnitScope scope, AudioUnitElement element, const void *data, UInt32 dataSize);
+
+	/// Applies all pending graph changes and updates the graph once
+	///
+	/// Changes are applied in the order they were added. If a change fails the remaining changes are still applied and
+	/// the graph is updated before the first error is rethrown.
+	/// @return The value returned by @c CAAUGraph::Update(), or @c true if there were no pending changes
+	/// @throw @c std::system_error
+	bool CommitGraphChanges();
+
+	/// Discards all pending graph changes
+	void DiscardGraphChanges() noexcept;
+
+private:
+
+	/// A command performed on the render thread
+	struct Command {
+		/// Command types
+		enum class Type {
+			/// Set a parameter
+			setParameter,
+			/// Ramp a parameter
+			rampParameter,
+			/// Perform a function
+			perform,
+		};
+
+		/// The command type
+		Type mType;
+		/// Whether @c mSampleTime is valid
+		bool mHasSampleTime;
+		/// The sample time at which the command takes effect
+		Float64 mSampleTime;
+		/// The audio unit
+		AudioUnit _Nullable mUnit;
+		/// The parameter
+		AudioUnitParameterID mParameter;
+		/// The parameter's scope
+		AudioUnitScope mScope;
+		/// The parameter's element
+		AudioUnitElement mElement;
+		/// The parameter value, or the start value for a ramp
+		AudioUnitParameterValue mStartValue;
+		/// The end value for a ramp
+		AudioUnitParameterValue mEndValue;
+		/// The length of a ramp in frames
+		UInt32 mDurationFrames;
+		/// The function to perform
+		PerformFunction _Nullable mFunction;
+		/// The context for @c mFunction
+		void * _Nullable mContext;
+		/// The sample time at which a later command for the same parameter supersedes a ramp
+		/// @note Only accessed from the render thread
+		Float64 mSupersededSampleTime;
+	};
+
+	static_assert(std::is_trivially_copyable_v<Command>, "Command must be trivially copyable");
+
+	/// Enqueues @c command
+	bool Enqueue(const Command& command) noexcept;
+
+	/// Applies commands taking effect in the render cycle starting at @c sampleTime
+	void ProcessCommands(Float64 sampleTime, UInt32 frameCount) noexcept;
+
+	/// The graph's render notification
+	static OSStatus RenderNotify(void *inRefCon, AudioUnitRenderActionFlags *ioActionFlags, const AudioTimeStamp *inTimeStamp, UInt32 inBusNumber, UInt32 inNumberFrames, AudioBufferList * _Nullable ioData) noexcept;
+
+	/// The graph
+	CAAUGraph& mGraph;
+
+	/// Commands waiting to be dequeued by the render thread
+	MPMCRingBuffer mCommands;
+	/// Dequeued commands not yet completed
+	/// @note Only accessed from the render thread
+	std::vector<Command> mPendingCommands;
+
+	/// Graph changes waiting to be committed
+	std::vector<std::function<void()>> mGraphChanges;
+	/// Protects @c mGraphChanges
+	std::mutex mGraphChangesMutex;
+
+};
+
+} /* namespace SFB */
+
+CF_ASSUME_NONNULL_END
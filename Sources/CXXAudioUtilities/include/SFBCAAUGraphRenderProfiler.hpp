@@ -0,0 +1,210 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <array>
+#import <atomic>
+#import <cstdint>
+#import <memory>
+#import <vector>
+
+#import <AudioToolbox/AUGraph.h>
+#import <AudioToolbox/AudioUnit.h>
+
+#import "SFBCAAUGraph.hpp"
+
+CF_ASSUME_NONNULL_BEGIN
+
+namespace SFB {
+
+/// A profiler measuring the render time of each node in a @c CAAUGraph
+///
+/// @c CAAUGraph::GetCPULoad() reports a single load for the entire graph. This class instead adds pre- and post-render
+/// notifications to the audio unit of every node in the graph and measures the host time spent rendering each node.
+///
+/// Because a node renders by pulling its inputs, the time between a node's pre- and post-render notifications includes
+/// the time spent rendering upstream nodes. The profiler subtracts this so each node's duration histogram reflects only
+/// its own processing, including any input render callbacks it invokes. A deadline miss is counted when a node's
+/// inclusive render time, the time to produce its output, exceeds the IO buffer period.
+///
+/// Each render may additionally be emitted as an @c os_signpost interval in the @c "Render" category of the
+/// @c org.sbooth.CXXAudioUtilities subsystem, so the per-node timeline can be viewed in Instruments.
+///
+/// Statistics are collected lock-free on the render thread and may be read from any thread.
+/// @note The graph must be open and must be rendered from a single thread. Nodes added after the profiler is created
+/// are not profiled.
+///
+/// @code
+/// SFB::CAAUGraphRenderProfiler profiler(graph, device.NominalSampleRate(), device.BufferFrameSize());
+/// // Later
+/// for(const auto& statistics : profiler.Statistics())
+///     os_log(OS_LOG_DEFAULT, "Node %d: %llu deadline misses", statistics.mNode, statistics.mDeadlineMisses);
+/// @endcode
+class CAAUGraphRenderProfiler
+{
+
+public:
+
+	/// The number of buckets in a duration histogram
+	static constexpr size_t sHistogramBucketCount = 32;
+
+	/// A snapshot of the statistics collected for a node
+	///
+	/// Durations are in host ticks.
+	struct NodeStatistics {
+		/// The node
+		AUNode mNode = 0;
+		/// The node's audio unit
+		AudioUnit _Nullable mAudioUnit = nullptr;
+		/// The number of completed renders
+		uint64_t mRenderCount = 0;
+		/// The number of renders whose inclusive duration exceeded the IO buffer period
+		uint64_t mDeadlineMisses = 0;
+		/// The total render duration excluding upstream nodes
+		uint64_t mTotalDuration = 0;
+		/// The longest render duration excluding upstream nodes
+		uint64_t mMaximumDuration = 0;
+		/// The total render duration including upstream nodes
+		uint64_t mTotalInclusiveDuration = 0;
+		/// The longest render duration including upstream nodes
+		uint64_t mMaximumInclusiveDuration = 0;
+		/// A histogram of render durations excluding upstream nodes
+		///
+		/// Bucket @c 0 counts durations less than two host ticks and bucket @c i counts durations in [2^i, 2^(i+1)). The
+		/// final bucket also counts all longer durations.
+		std::array<uint64_t, sHistogramBucketCount> mHistogram{};
+	};
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c CAAUGraphRenderProfiler and adds render notifications to each node in @c graph
+	/// @note @c graph must be open and must remain open for the lifetime of the profiler
+	/// @param graph The graph to profile
+	/// @param sampleRate The sample rate of the IO device rendering the graph
+	/// @param bufferFrameSize The IO buffer size of the device, typically @c CAAudioDevice::BufferFrameSize()
+	/// @param emitSignposts Whether to emit an @c os_signpost interval for each render
+	/// @throw @c std::bad_alloc
+	/// @throw @c std::invalid_argument If @c sampleRate or @c bufferFrameSize is zero or the graph is not open
+	/// @throw @c std::system_error If the render notifications could not be added
+	CAAUGraphRenderProfiler(CAAUGraph& graph, Float64 sampleRate, UInt32 bufferFrameSize, bool emitSignposts = true);
+
+	// This class is non-copyable
+	CAAUGraphRenderProfiler(const CAAUGraphRenderProfiler&) = delete;
+
+	// This class is non-assignable
+	CAAUGraphRenderProfiler& operator=(const CAAUGraphRenderProfiler&) = delete;
+
+	/// Removes the render notifications and destroys the @c CAAUGraphRenderProfiler
+	~CAAUGraphRenderProfiler();
+
+	// This class is non-movable
+	CAAUGraphRenderProfiler(CAAUGraphRenderProfiler&&) = delete;
+
+	// This class is non-move assignable
+	CAAUGraphRenderProfiler& operator=(CAAUGraphRenderProfiler&&) = delete;
+
+#pragma mark Statistics
+
+	/// Returns the number of profiled nodes
+	size_t NodeCount() const noexcept
+	{
+		return mNodeCount;
+	}
+
+	/// Returns the IO buffer period in host ticks
+	uint64_t Deadline() const noexcept
+	{
+		return mDeadline;
+	}
+
+	/// Returns a snapshot of the statistics for each profiled node
+	/// @note The counters are read individually so a snapshot may reflect renders in progress
+	/// @throw @c std::bad_alloc
+	std::vector<NodeStatistics> Statistics() const;
+
+	/// Returns the statistics for @c node or empty statistics if @c node is not profiled
+	NodeStatistics Statistics(AUNode node) const noexcept;
+
+	/// Zeroes all statistics
+	/// @note This method should not be called while the graph is rendering
+	void Reset() noexcept;
+
+	/// Converts a duration in host ticks to seconds
+	static Float64 ConvertHostTicksToSeconds(uint64_t hostTicks) noexcept;
+
+private:
+
+	/// A profiled node
+	struct Node {
+		/// The node
+		AUNode mNode = 0;
+		/// The node's audio unit
+		AudioUnit _Nullable mAudioUnit = nullptr;
+		/// The owning profiler
+		CAAUGraphRenderProfiler * _Nullable mProfiler = nullptr;
+		/// Whether the render notification was added
+		bool mNotifyAdded = false;
+
+		/// The host time of the pre-render notification
+		/// @note Only accessed from the render thread
+		uint64_t mStartTime = 0;
+		/// The inclusive render time of upstream nodes during the current render
+		/// @note Only accessed from the render thread
+		uint64_t mUpstreamDuration = 0;
+
+		/// The number of completed renders
+		std::atomic_uint64_t mRenderCount = 0;
+		/// The number of deadline misses
+		std::atomic_uint64_t mDeadlineMisses = 0;
+		/// The total exclusive render duration
+		std::atomic_uint64_t mTotalDuration = 0;
+		/// The maximum exclusive render duration
+		std::atomic_uint64_t mMaximumDuration = 0;
+		/// The total inclusive render duration
+		std::atomic_uint64_t mTotalInclusiveDuration = 0;
+		/// The maximum inclusive render duration
+		std::atomic_uint64_t mMaximumInclusiveDuration = 0;
+		/// The exclusive render duration histogram
+		std::array<std::atomic_uint64_t, sHistogramBucketCount> mHistogram{};
+	};
+
+	static_assert(std::atomic_uint64_t::is_always_lock_free, "Lock-free std::atomic_uint64_t required");
+
+	/// Handles a pre-render notification for @c node
+	void BeginRender(Node& node) noexcept;
+
+	/// Handles a post-render notification for @c node
+	void EndRender(Node& node) noexcept;
+
+	/// Returns a snapshot of the statistics for @c node
+	static NodeStatistics Snapshot(const Node& node) noexcept;
+
+	/// The audio units' render notification
+	static OSStatus RenderNotify(void *inRefCon, AudioUnitRenderActionFlags *ioActionFlags, const AudioTimeStamp *inTimeStamp, UInt32 inBusNumber, UInt32 inNumberFrames, AudioBufferList * _Nullable ioData) noexcept;
+
+	/// The IO buffer period in host ticks
+	const uint64_t mDeadline;
+	/// Whether to emit signposts
+	const bool mEmitSignposts;
+
+	/// The profiled nodes
+	std::unique_ptr<Node[]> mNodes;
+	/// The number of profiled nodes
+	size_t mNodeCount = 0;
+
+	/// The nodes currently rendering, outermost first
+	/// @note Only accessed from the render thread
+	std::unique_ptr<Node *[]> mRenderStack;
+	/// The number of nodes currently rendering
+	/// @note Only accessed from the render thread
+	size_t mRenderDepth = 0;
+
+};
+
+} /* namespace SFB */
+
+CF_ASSUME_NONNULL_END
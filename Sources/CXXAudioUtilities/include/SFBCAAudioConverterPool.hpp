@@ -0,0 +1,288 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <memory>
+#import <optional>
+#import <vector>
+
+#import <AudioToolbox/AudioConverter.h>
+
+#import "SFBCAAudioConverter.hpp"
+#import "SFBCAStreamBasicDescription.hpp"
+#import "SFBUnfairLock.hpp"
+
+namespace SFB {
+
+/// A thread-safe pool of reusable @c CAAudioConverter objects keyed by format pair and converter options
+///
+/// Creating an audio converter, particularly one that resamples or uses a codec, is expensive. A converter obtained
+/// from the pool is reset and returned to it when the @c CAAudioConverterPool::Handle owning it is destroyed, and
+/// subsequent requests for the same formats and options reuse it.
+///
+/// @code
+/// SFB::CAAudioConverterPool pool;
+/// // Later, per request
+/// auto converter = pool.Acquire(sourceFormat, destinationFormat);
+/// converter->FillComplexBuffer(proc, context, frameCount, abl, nullptr);
+/// @endcode
+class CAAudioConverterPool
+{
+
+public:
+
+	/// Converter properties applied when a converter is created and considered when matching pooled converters
+	struct Options {
+		/// The sample rate converter complexity (@c kAudioConverterSampleRateConverterComplexity)
+		std::optional<UInt32> mSampleRateConverterComplexity;
+		/// The sample rate converter quality (@c kAudioConverterSampleRateConverterQuality)
+		std::optional<UInt32> mSampleRateConverterQuality;
+		/// The priming method (@c kAudioConverterPrimeMethod)
+		std::optional<UInt32> mPrimeMethod;
+		/// The channel map (@c kAudioConverterChannelMap) or empty for the default
+		std::vector<SInt32> mChannelMap;
+
+		/// Returns @c true if @c rhs is equal to @c this
+		bool operator==(const Options& rhs) const noexcept
+		{
+			return mSampleRateConverterComplexity == rhs.mSampleRateConverterComplexity && mSampleRateConverterQuality == rhs.mSampleRateConverterQuality && mPrimeMethod == rhs.mPrimeMethod && mChannelMap == rhs.mChannelMap;
+		}
+
+		/// Returns @c true if @c rhs is not equal to @c this
+		bool operator!=(const Options& rhs) const noexcept
+		{
+			return !operator==(rhs);
+		}
+	};
+
+	/// Pool usage statistics
+	struct Statistics {
+		/// The number of requests satisfied by a pooled converter
+		uint64_t mHits;
+		/// The number of requests requiring a new converter
+		uint64_t mMisses;
+		/// The number of converters discarded when returned because the pool was full or reset failed
+		uint64_t mDiscards;
+	};
+
+private:
+
+	/// A collection of unused converters sharing formats and options
+	struct Entry;
+
+public:
+
+	/// A move-only owner of a @c CAAudioConverter obtained from a @c CAAudioConverterPool
+	///
+	/// When a @c Handle is destroyed its converter is reset and returned to the pool.
+	/// @note A @c Handle must not outlive the pool from which it was obtained
+	/// @note The properties in @c Options must not be changed on the owned converter
+	class Handle
+	{
+
+	public:
+
+		/// Creates an empty @c Handle
+		Handle() noexcept = default;
+
+		// This class is non-copyable
+		Handle(const Handle&) = delete;
+
+		// This class is non-assignable
+		Handle& operator=(const Handle&) = delete;
+
+		/// Returns the converter to the pool and destroys the @c Handle
+		~Handle()
+		{
+			Release();
+		}
+
+		/// Creates a new @c Handle by moving the contents of @c rhs
+		Handle(Handle&& rhs) noexcept
+		: mConverter{std::move(rhs.mConverter)}, mPool{rhs.mPool}, mEntry{rhs.mEntry}
+		{
+			rhs.mPool = nullptr;
+			rhs.mEntry = nullptr;
+		}
+
+		/// Returns the current converter to the pool and moves the contents of @c rhs
+		Handle& operator=(Handle&& rhs) noexcept
+		{
+			if(this != &rhs) {
+				Release();
+				mConverter = std::move(rhs.mConverter);
+				mPool = rhs.mPool;
+				mEntry = rhs.mEntry;
+				rhs.mPool = nullptr;
+				rhs.mEntry = nullptr;
+			}
+			return *this;
+		}
+
+		/// Returns the converter to the pool and empties this @c Handle
+		void Release() noexcept
+		{
+			if(mPool) {
+				mPool->Return(*mEntry, mConverter);
+				mPool = nullptr;
+				mEntry = nullptr;
+			}
+		}
+
+		/// Returns @c true if this @c Handle owns a converter
+		explicit operator bool() const noexcept
+		{
+			return static_cast<bool>(mConverter);
+		}
+
+		/// Returns the owned converter
+		CAAudioConverter& operator*() noexcept
+		{
+			return mConverter;
+		}
+
+		/// Returns the owned converter
+		const CAAudioConverter& operator*() const noexcept
+		{
+			return mConverter;
+		}
+
+		/// Returns a pointer to the owned converter
+		CAAudioConverter * _Nonnull operator->() noexcept
+		{
+			return &mConverter;
+		}
+
+		/// Returns a pointer to the owned converter
+		const CAAudioConverter * _Nonnull operator->() const noexcept
+		{
+			return &mConverter;
+		}
+
+	private:
+
+		friend class CAAudioConverterPool;
+
+		/// Creates a @c Handle owning @c converter
+		Handle(CAAudioConverter&& converter, CAAudioConverterPool * _Nonnull pool, Entry * _Nonnull entry) noexcept
+		: mConverter{std::move(converter)}, mPool{pool}, mEntry{entry}
+		{}
+
+		/// The owned converter
+		CAAudioConverter mConverter;
+		/// The pool to which @c mConverter is returned
+		CAAudioConverterPool * _Nullable mPool = nullptr;
+		/// The pool entry for @c mConverter
+		Entry * _Nullable mEntry = nullptr;
+
+	};
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c CAAudioConverterPool
+	/// @param maximumRetainedConverters The maximum number of unused converters retained for each format pair and options
+	explicit CAAudioConverterPool(size_t maximumRetainedConverters = 4) noexcept
+	: mMaximumRetainedConverters{maximumRetainedConverters}
+	{}
+
+	// This class is non-copyable
+	CAAudioConverterPool(const CAAudioConverterPool&) = delete;
+
+	// This class is non-assignable
+	CAAudioConverterPool& operator=(const CAAudioConverterPool&) = delete;
+
+	/// Destroys the @c CAAudioConverterPool and disposes all unused converters
+	~CAAudioConverterPool();
+
+	// This class is non-movable
+	CAAudioConverterPool(CAAudioConverterPool&&) = delete;
+
+	// This class is non-move assignable
+	CAAudioConverterPool& operator=(CAAudioConverterPool&&) = delete;
+
+#pragma mark Converter Management
+
+	/// Returns a reset converter from @c sourceFormat to @c destinationFormat configured with @c options
+	/// @param sourceFormat The format of the source audio
+	/// @param destinationFormat The format of the destination audio
+	/// @param options The converter properties to apply
+	/// @return A @c Handle owning the converter
+	/// @throw @c std::system_error If the converter could not be created or configured
+	/// @throw @c std::bad_alloc
+	Handle Acquire(const CAStreamBasicDescription& sourceFormat, const CAStreamBasicDescription& destinationFormat, const Options& options = {});
+
+	/// Creates converters from @c sourceFormat to @c destinationFormat configured with @c options for later use
+	/// @param sourceFormat The format of the source audio
+	/// @param destinationFormat The format of the destination audio
+	/// @param options The converter properties to apply
+	/// @param count The number of converters to create, limited to the maximum number retained
+	/// @throw @c std::system_error If a converter could not be created or configured
+	/// @throw @c std::bad_alloc
+	void Reserve(const CAStreamBasicDescription& sourceFormat, const CAStreamBasicDescription& destinationFormat, const Options& options, size_t count);
+
+	/// Disposes all unused converters
+	void Purge() noexcept;
+
+	/// Returns the pool's usage statistics
+	/// @note This method is lock-free
+	Statistics UsageStatistics() const noexcept
+	{
+		return { mHits.load(std::memory_order_relaxed), mMisses.load(std::memory_order_relaxed), mDiscards.load(std::memory_order_relaxed) };
+	}
+
+	/// Resets the pool's usage statistics to zero
+	void ResetUsageStatistics() noexcept
+	{
+		mHits.store(0, std::memory_order_relaxed);
+		mMisses.store(0, std::memory_order_relaxed);
+		mDiscards.store(0, std::memory_order_relaxed);
+	}
+
+private:
+
+	struct Entry {
+		/// The source format of the converters
+		const CAStreamBasicDescription mSourceFormat;
+		/// The destination format of the converters
+		const CAStreamBasicDescription mDestinationFormat;
+		/// The options applied to the converters
+		const Options mOptions;
+		/// The unused converters
+		std::vector<CAAudioConverter> mConverters;
+	};
+
+	/// Returns a new converter for @c entry
+	/// @throw @c std::system_error
+	static CAAudioConverter NewConverter(const Entry& entry);
+
+	/// Returns the entry for the specified formats and options, creating it if necessary
+	/// @note This method must be called with @c mLock held
+	/// @throw @c std::bad_alloc
+	Entry& FindOrCreateEntry(const CAStreamBasicDescription& sourceFormat, const CAStreamBasicDescription& destinationFormat, const Options& options);
+
+	/// Resets @c converter and returns it to @c entry
+	void Return(Entry& entry, CAAudioConverter& converter) noexcept;
+
+	/// The maximum number of unused converters retained per entry
+	const size_t mMaximumRetainedConverters;
+
+	/// The pool entries, which are never removed so handles may refer to them
+	std::vector<std::unique_ptr<Entry>> mEntries;
+	/// Lock protecting @c mEntries
+	UnfairLock mLock;
+
+	/// The number of requests satisfied by a pooled converter
+	std::atomic_uint64_t mHits = 0;
+	/// The number of requests requiring a new converter
+	std::atomic_uint64_t mMisses = 0;
+	/// The number of converters discarded on return
+	std::atomic_uint64_t mDiscards = 0;
+
+};
+
+} /* namespace SFB */
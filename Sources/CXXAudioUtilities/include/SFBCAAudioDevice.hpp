@@ -1,16 +1,57 @@
 //
-// Copyright © 2021-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2021-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
 
 #pragma once
 
+#import <algorithm>
+
 #import "SFBCAAudioObject.hpp"
 #import "SFBCAAudioStream.hpp"
 
 namespace SFB {
 
+/// The components of an audio device's latency in one direction, in frames
+struct CAAudioDeviceIOLatency {
+	/// The device's latency (@c kAudioDevicePropertyLatency)
+	UInt32 mDeviceLatency = 0;
+	/// The largest latency of the device's streams (@c kAudioStreamPropertyLatency)
+	UInt32 mStreamLatency = 0;
+	/// The device's safety offset (@c kAudioDevicePropertySafetyOffset)
+	UInt32 mSafetyOffset = 0;
+	/// The device's IO buffer size (@c kAudioDevicePropertyBufferFrameSize)
+	UInt32 mBufferFrameSize = 0;
+
+	/// Returns the total latency between an IOProc and the device's terminal
+	UInt32 Total() const noexcept
+	{
+		return mDeviceLatency + mStreamLatency + mSafetyOffset + mBufferFrameSize;
+	}
+
+	/// Returns a ring buffer capacity in frames sufficient to bridge this latency glitch-free
+	///
+	/// The capacity covers the total latency, one additional IO cycle for the other side of the ring buffer, and
+	/// @c marginSeconds of additional audio. It is rounded up to the power of two used by @c AudioRingBuffer and
+	/// @c CARingBuffer, accounting for the frame those buffers keep unused.
+	/// @param sampleRate The sample rate of the audio in the ring buffer
+	/// @param marginSeconds The additional safety margin in seconds
+	/// @return The suggested capacity in frames
+	uint32_t SuggestedRingBufferCapacity(Float64 sampleRate, double marginSeconds = 0) const noexcept
+	{
+		auto frames = static_cast<uint64_t>(Total()) + mBufferFrameSize + 1;
+		if(sampleRate > 0 && marginSeconds > 0)
+			frames += static_cast<uint64_t>(marginSeconds * sampleRate + 0.5);
+		if(frames > 0x80000000)
+			return 0x80000000;
+		uint64_t capacity = 2;
+		while(capacity < frames)
+			capacity <<= 1;
+		return static_cast<uint32_t>(capacity);
+	}
+};
+
 class CAAudioDevice : public CAAudioObject
 {
 
@@ -71,6 +112,13 @@ public:
 		return ArrayProperty<AudioObjectID>(CAPropertyAddress(kAudioDevicePropertyStreams, scope == CAAudioObjectDirectionalScope::input ? kAudioObjectPropertyScopeInput : kAudioObjectPropertyScopeOutput));
 	}
 
+	/// Retrieves at most @c inCapacity stream IDs into @c outStreamIDs without allocating
+	/// @return The number of stream IDs retrieved
+	UInt32 StreamIDs(CAAudioObjectDirectionalScope scope, AudioObjectID * _Nonnull outStreamIDs, UInt32 inCapacity) const
+	{
+		return ArrayProperty<AudioObjectID>(CAPropertyAddress(kAudioDevicePropertyStreams, scope == CAAudioObjectDirectionalScope::input ? kAudioObjectPropertyScopeInput : kAudioObjectPropertyScopeOutput), outStreamIDs, inCapacity);
+	}
+
 	std::vector<CAAudioStream> Streams(CAAudioObjectDirectionalScope scope) const
 	{
 		auto vec = StreamIDs(scope);
@@ -86,6 +134,26 @@ public:
 		return ArithmeticProperty<UInt32>(CAPropertyAddress(kAudioDevicePropertySafetyOffset, scope == CAAudioObjectDirectionalScope::input ? kAudioObjectPropertyScopeInput : kAudioObjectPropertyScopeOutput));
 	}
 
+	/// Returns the components of the device's latency for @c scope, including the latency of its streams
+	/// @throw @c std::system_error
+	CAAudioDeviceIOLatency IOLatency(CAAudioObjectDirectionalScope scope) const
+	{
+		CAAudioDeviceIOLatency latency;
+		latency.mDeviceLatency = Latency(scope);
+		latency.mSafetyOffset = SafetyOffset(scope);
+		latency.mBufferFrameSize = BufferFrameSize();
+		for(const auto& stream : Streams(scope))
+			latency.mStreamLatency = std::max(latency.mStreamLatency, stream.Latency());
+		return latency;
+	}
+
+	/// Returns the device's total latency for @c scope in frames
+	/// @throw @c std::system_error
+	UInt32 TotalLatency(CAAudioObjectDirectionalScope scope) const
+	{
+		return IOLatency(scope).Total();
+	}
+
 	Float64 NominalSampleRate() const
 	{
 		return ArithmeticProperty<Float64>(CAPropertyAddress(kAudioDevicePropertyNominalSampleRate));
@@ -0,0 +1,149 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <functional>
+#import <mutex>
+#import <vector>
+
+#import <CoreAudio/CoreAudio.h>
+
+#import "SFBCAAudioDevice.hpp"
+#import "SFBUnfairLock.hpp"
+
+namespace SFB {
+
+/// A class tracking an audio device's input and output latency as its configuration changes
+///
+/// The latency is recomputed whenever the device's latency, safety offset, buffer frame size, nominal sample rate, or
+/// streams change, or a stream's latency changes. The total latency and sample rate may be read lock-free.
+///
+/// @code
+/// SFB::CAAudioDeviceLatencyMonitor monitor(device, [](SFB::CAAudioObjectDirectionalScope scope, const SFB::CAAudioDeviceIOLatency& latency) {
+///     // Called on a HAL notification thread
+/// });
+/// auto capacity = monitor.SuggestedRingBufferCapacity(SFB::CAAudioObjectDirectionalScope::output, 0.005);
+/// @endcode
+class CAAudioDeviceLatencyMonitor
+{
+
+public:
+
+	/// A function called when the latency for a scope changes
+	/// @note This function is called on a HAL notification thread and must not destroy the monitor
+	using ChangeCallback = std::function<void(CAAudioObjectDirectionalScope scope, const CAAudioDeviceIOLatency& latency)>;
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c CAAudioDeviceLatencyMonitor for @c device
+	/// @param device The audio device to monitor
+	/// @param callback An optional function called when the latency changes
+	/// @throw @c std::system_error If the device's properties could not be retrieved or listeners could not be added
+	/// @throw @c std::bad_alloc
+	explicit CAAudioDeviceLatencyMonitor(CAAudioDevice device, ChangeCallback callback = {});
+
+	// This class is non-copyable
+	CAAudioDeviceLatencyMonitor(const CAAudioDeviceLatencyMonitor&) = delete;
+
+	// This class is non-assignable
+	CAAudioDeviceLatencyMonitor& operator=(const CAAudioDeviceLatencyMonitor&) = delete;
+
+	/// Removes all property listeners and destroys the @c CAAudioDeviceLatencyMonitor
+	~CAAudioDeviceLatencyMonitor();
+
+	// This class is non-movable
+	CAAudioDeviceLatencyMonitor(CAAudioDeviceLatencyMonitor&&) = delete;
+
+	// This class is non-move assignable
+	CAAudioDeviceLatencyMonitor& operator=(CAAudioDeviceLatencyMonitor&&) = delete;
+
+#pragma mark Latency
+
+	/// Returns the monitored device
+	const CAAudioDevice& Device() const noexcept
+	{
+		return mDevice;
+	}
+
+	/// Returns the components of the device's latency for @c scope
+	CAAudioDeviceIOLatency IOLatency(CAAudioObjectDirectionalScope scope) const noexcept
+	{
+		std::lock_guard lock{mLock};
+		return scope == CAAudioObjectDirectionalScope::input ? mInputLatency : mOutputLatency;
+	}
+
+	/// Returns the device's total latency for @c scope in frames
+	/// @note This method is lock-free
+	UInt32 TotalLatency(CAAudioObjectDirectionalScope scope) const noexcept
+	{
+		return (scope == CAAudioObjectDirectionalScope::input ? mInputTotalLatency : mOutputTotalLatency).load(std::memory_order_acquire);
+	}
+
+	/// Returns the device's nominal sample rate
+	/// @note This method is lock-free
+	Float64 NominalSampleRate() const noexcept
+	{
+		return mNominalSampleRate.load(std::memory_order_acquire);
+	}
+
+	/// Returns a ring buffer capacity in frames sufficient to bridge the latency for @c scope glitch-free
+	/// @param scope The direction of audio through the ring buffer
+	/// @param marginSeconds The additional safety margin in seconds
+	/// @return The suggested capacity in frames
+	/// @see CAAudioDeviceIOLatency::SuggestedRingBufferCapacity()
+	uint32_t SuggestedRingBufferCapacity(CAAudioObjectDirectionalScope scope, double marginSeconds = 0) const noexcept
+	{
+		return IOLatency(scope).SuggestedRingBufferCapacity(NominalSampleRate(), marginSeconds);
+	}
+
+private:
+
+	/// Retrieves the device's latency and updates stream listeners
+	/// @param notify Whether to call the change callback if the latency changed
+	/// @throw @c std::system_error
+	/// @throw @c std::bad_alloc
+	void Refresh(bool notify);
+
+	/// Adds or removes stream latency listeners so they match @c streamIDs
+	/// @note @c mRefreshMutex must be held
+	/// @throw @c std::bad_alloc
+	void UpdateStreamListeners(std::vector<AudioObjectID> streamIDs);
+
+	/// Property listener calling @c Refresh()
+	static OSStatus PropertyListenerProc(AudioObjectID inObjectID, UInt32 inNumberAddresses, const AudioObjectPropertyAddress *inAddresses, void * _Nullable inClientData) noexcept;
+
+	/// The monitored device
+	const CAAudioDevice mDevice;
+	/// The change callback
+	const ChangeCallback mCallback;
+
+	/// Serializes calls to @c Refresh()
+	std::mutex mRefreshMutex;
+	/// The streams with latency listeners
+	/// @note Protected by @c mRefreshMutex
+	std::vector<AudioObjectID> mStreamIDs;
+
+	/// Protects @c mInputLatency and @c mOutputLatency
+	mutable UnfairLock mLock;
+	/// The input latency
+	CAAudioDeviceIOLatency mInputLatency;
+	/// The output latency
+	CAAudioDeviceIOLatency mOutputLatency;
+
+	/// The total input latency
+	std::atomic_uint32_t mInputTotalLatency = 0;
+	/// The total output latency
+	std::atomic_uint32_t mOutputTotalLatency = 0;
+	/// The nominal sample rate
+	std::atomic<Float64> mNominalSampleRate = 0;
+
+	static_assert(std::atomic<Float64>::is_always_lock_free, "Lock-free std::atomic<Float64> required");
+
+};
+
+} /* namespace SFB */
@@ -0,0 +1,170 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <memory>
+#import <vector>
+
+#import <CoreAudio/CoreAudio.h>
+
+#import "SFBCAAudioObject.hpp"
+#import "SFBCAStreamBasicDescription.hpp"
+#import "SFBCFWrapper.hpp"
+
+namespace SFB {
+
+/// An immutable snapshot of the audio devices present in the system and their commonly used properties
+///
+/// A snapshot is created with @c Snapshot(), which retrieves the properties of all devices concurrently. Copies of a
+/// snapshot share its storage and are inexpensive.
+///
+/// @code
+/// auto topology = SFB::CAAudioDeviceTopology::Snapshot();
+/// for(const auto& device : topology.Devices())
+///     // Use device.mUID, device.mName, device.mOutput.mChannelCount, ...
+/// @endcode
+class CAAudioDeviceTopology
+{
+
+public:
+
+	/// An audio stream
+	struct Stream {
+		/// The stream's object ID
+		AudioObjectID mStreamID = kAudioObjectUnknown;
+		/// The first device channel of the stream (@c kAudioStreamPropertyStartingChannel)
+		UInt32 mStartingChannel = 0;
+		/// The stream's latency in frames (@c kAudioStreamPropertyLatency)
+		UInt32 mLatency = 0;
+		/// The stream's terminal type (@c kAudioStreamPropertyTerminalType)
+		UInt32 mTerminalType = 0;
+		/// The stream's virtual format (@c kAudioStreamPropertyVirtualFormat)
+		CAStreamBasicDescription mVirtualFormat;
+	};
+
+	/// A device's input or output
+	struct Scope {
+		/// The device's latency in frames (@c kAudioDevicePropertyLatency)
+		UInt32 mLatency = 0;
+		/// The device's safety offset in frames (@c kAudioDevicePropertySafetyOffset)
+		UInt32 mSafetyOffset = 0;
+		/// The total number of channels in @c mStreams
+		UInt32 mChannelCount = 0;
+		/// The device's streams (@c kAudioDevicePropertyStreams)
+		std::vector<Stream> mStreams;
+	};
+
+	/// An audio device
+	struct Device {
+		/// The device's object ID
+		AudioObjectID mDeviceID = kAudioObjectUnknown;
+		/// The device's UID (@c kAudioDevicePropertyDeviceUID)
+		CFString mUID;
+		/// The device's name (@c kAudioObjectPropertyName)
+		CFString mName;
+		/// The device's transport type (@c kAudioDevicePropertyTransportType)
+		UInt32 mTransportType = 0;
+		/// The device's nominal sample rate (@c kAudioDevicePropertyNominalSampleRate)
+		Float64 mNominalSampleRate = 0;
+		/// The device's buffer frame size (@c kAudioDevicePropertyBufferFrameSize)
+		UInt32 mBufferFrameSize = 0;
+		/// The device's input
+		Scope mInput;
+		/// The device's output
+		Scope mOutput;
+
+		/// Returns the device's input or output
+		const Scope& operator[](CAAudioObjectDirectionalScope scope) const noexcept
+		{
+			return scope == CAAudioObjectDirectionalScope::input ? mInput : mOutput;
+		}
+	};
+
+#pragma mark Creation and Destruction
+
+	/// Creates a snapshot of the audio devices present in the system
+	///
+	/// Device properties are retrieved concurrently. A device that disappears or whose properties cannot be
+	/// retrieved while the snapshot is being created is omitted.
+	/// @return A snapshot of the system's audio devices
+	/// @throw @c std::system_error If the list of devices could not be retrieved
+	/// @throw @c std::bad_alloc
+	static CAAudioDeviceTopology Snapshot();
+
+	/// Creates an empty @c CAAudioDeviceTopology
+	CAAudioDeviceTopology() noexcept = default;
+
+	/// Copy constructor
+	CAAudioDeviceTopology(const CAAudioDeviceTopology& rhs) noexcept = default;
+
+	/// Assignment operator
+	CAAudioDeviceTopology& operator=(const CAAudioDeviceTopology& rhs) noexcept = default;
+
+	/// Destructor
+	~CAAudioDeviceTopology() = default;
+
+	/// Move constructor
+	CAAudioDeviceTopology(CAAudioDeviceTopology&& rhs) noexcept = default;
+
+	/// Move assignment operator
+	CAAudioDeviceTopology& operator=(CAAudioDeviceTopology&& rhs) noexcept = default;
+
+#pragma mark Devices
+
+	/// Returns the devices in the order reported by the HAL
+	const std::vector<Device>& Devices() const noexcept
+	{
+		return mSnapshot ? mSnapshot->mDevices : sNoDevices;
+	}
+
+	/// Returns the default input device ID at the time of the snapshot
+	AudioObjectID DefaultInputDeviceID() const noexcept
+	{
+		return mSnapshot ? mSnapshot->mDefaultInputDeviceID : kAudioObjectUnknown;
+	}
+
+	/// Returns the default output device ID at the time of the snapshot
+	AudioObjectID DefaultOutputDeviceID() const noexcept
+	{
+		return mSnapshot ? mSnapshot->mDefaultOutputDeviceID : kAudioObjectUnknown;
+	}
+
+	/// Returns the default system output device ID at the time of the snapshot
+	AudioObjectID DefaultSystemOutputDeviceID() const noexcept
+	{
+		return mSnapshot ? mSnapshot->mDefaultSystemOutputDeviceID : kAudioObjectUnknown;
+	}
+
+	/// Returns the device with object ID @c deviceID or @c nullptr if none
+	const Device * _Nullable DeviceWithID(AudioObjectID deviceID) const noexcept;
+
+	/// Returns the device with UID @c uid or @c nullptr if none
+	const Device * _Nullable DeviceWithUID(CFStringRef _Nonnull uid) const noexcept;
+
+private:
+
+	/// Shared snapshot storage
+	struct Storage {
+		/// The devices
+		std::vector<Device> mDevices;
+		/// The default input device ID
+		AudioObjectID mDefaultInputDeviceID = kAudioObjectUnknown;
+		/// The default output device ID
+		AudioObjectID mDefaultOutputDeviceID = kAudioObjectUnknown;
+		/// The default system output device ID
+		AudioObjectID mDefaultSystemOutputDeviceID = kAudioObjectUnknown;
+	};
+
+	/// The empty device list
+	static inline const std::vector<Device> sNoDevices;
+
+	/// The snapshot storage or @c nullptr if empty
+	std::shared_ptr<const Storage> mSnapshot;
+
+};
+
+} /* namespace SFB */
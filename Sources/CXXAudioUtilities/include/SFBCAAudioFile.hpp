@@ -1,5 +1,5 @@
 //
-// Copyright © 2021-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2021-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
@@ -257,6 +257,60 @@ public:
 		return fileDataFormat;
 	}
 
+	/// Returns the number of packets of audio data in the file (@c kAudioFilePropertyAudioDataPacketCount)
+	/// @throw @c std::system_error
+	UInt64 AudioDataPacketCount() const
+	{
+		UInt64 packetCount;
+		UInt32 size = sizeof(packetCount);
+		GetProperty(kAudioFilePropertyAudioDataPacketCount, size, &packetCount);
+		return packetCount;
+	}
+
+	/// Returns the theoretical maximum packet size in the file (@c kAudioFilePropertyPacketSizeUpperBound)
+	/// @throw @c std::system_error
+	UInt32 PacketSizeUpperBound() const
+	{
+		UInt32 packetSize;
+		UInt32 size = sizeof(packetSize);
+		GetProperty(kAudioFilePropertyPacketSizeUpperBound, size, &packetSize);
+		return packetSize;
+	}
+
+	/// Returns the file's packet table information (@c kAudioFilePropertyPacketTableInfo)
+	/// @throw @c std::system_error
+	AudioFilePacketTableInfo PacketTableInfo() const
+	{
+		AudioFilePacketTableInfo packetTableInfo;
+		UInt32 size = sizeof(packetTableInfo);
+		GetProperty(kAudioFilePropertyPacketTableInfo, size, &packetTableInfo);
+		return packetTableInfo;
+	}
+
+	/// Returns the file's magic cookie (@c kAudioFilePropertyMagicCookieData) or an empty vector if none
+	/// @throw @c std::system_error
+	/// @throw @c std::bad_alloc
+	std::vector<UInt8> MagicCookie() const
+	{
+		UInt32 size;
+		if(AudioFileGetPropertyInfo(mAudioFileID, kAudioFilePropertyMagicCookieData, &size, nullptr) != noErr || size == 0)
+			return {};
+		std::vector<UInt8> magicCookie(size);
+		GetProperty(kAudioFilePropertyMagicCookieData, size, magicCookie.data());
+		magicCookie.resize(size);
+		return magicCookie;
+	}
+
+	/// Returns the number of packets preceding @c packet that must be decoded for @c packet to decode correctly (@c kAudioFilePropertyPacketToRollDistance)
+	/// @throw @c std::system_error
+	SInt64 PacketToRollDistance(SInt64 packet) const
+	{
+		AudioPacketRollDistanceTranslation translation{packet, 0};
+		UInt32 size = sizeof(translation);
+		GetProperty(kAudioFilePropertyPacketToRollDistance, size, &translation);
+		return translation.mRollDistance;
+	}
+
 #pragma mark Global Properties
 
 	/// Gets the size of a global audio file property.
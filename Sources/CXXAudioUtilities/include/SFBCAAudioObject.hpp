@@ -1,11 +1,13 @@
 //
-// Copyright © 2021-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2021-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
 
 #pragma once
 
+#import <cstddef>
+#import <iterator>
 #import <type_traits>
 #import <vector>
 
@@ -22,6 +24,99 @@ enum class CAAudioObjectDirectionalScope {
 	output,
 };
 
+/// A non-owning view of an array of @c AudioObjectID presented as objects of type @c T
+///
+/// This allows object IDs retrieved into a caller-provided buffer to be used as @c CAAudioObject instances without
+/// allocating a second container.
+/// @code
+/// AudioObjectID buffer [64];
+/// auto count = device.StreamIDs(SFB::CAAudioObjectDirectionalScope::output, buffer, 64);
+/// for(auto stream : SFB::CAAudioObjectIDRange<SFB::CAAudioStream>(buffer, count))
+///     // Use stream
+/// @endcode
+template <typename T>
+class CAAudioObjectIDRange
+{
+
+public:
+
+	/// A random access iterator producing objects of type @c T
+	class const_iterator
+	{
+
+	public:
+
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = T;
+
+		constexpr const_iterator() noexcept = default;
+
+		constexpr explicit const_iterator(const AudioObjectID * _Nullable objectID) noexcept
+		: mObjectID{objectID}
+		{}
+
+		T operator*() const noexcept { return T(*mObjectID); }
+		T operator[](difference_type n) const noexcept { return T(mObjectID[n]); }
+
+		const_iterator& operator++() noexcept { ++mObjectID; return *this; }
+		const_iterator operator++(int) noexcept { auto tmp = *this; ++mObjectID; return tmp; }
+		const_iterator& operator--() noexcept { --mObjectID; return *this; }
+		const_iterator operator--(int) noexcept { auto tmp = *this; --mObjectID; return tmp; }
+
+		const_iterator& operator+=(difference_type n) noexcept { mObjectID += n; return *this; }
+		const_iterator& operator-=(difference_type n) noexcept { mObjectID -= n; return *this; }
+		const_iterator operator+(difference_type n) const noexcept { return const_iterator(mObjectID + n); }
+		const_iterator operator-(difference_type n) const noexcept { return const_iterator(mObjectID - n); }
+		difference_type operator-(const const_iterator& rhs) const noexcept { return mObjectID - rhs.mObjectID; }
+
+		bool operator==(const const_iterator& rhs) const noexcept { return mObjectID == rhs.mObjectID; }
+		bool operator!=(const const_iterator& rhs) const noexcept { return mObjectID != rhs.mObjectID; }
+		bool operator<(const const_iterator& rhs) const noexcept { return mObjectID < rhs.mObjectID; }
+		bool operator>(const const_iterator& rhs) const noexcept { return mObjectID > rhs.mObjectID; }
+		bool operator<=(const const_iterator& rhs) const noexcept { return mObjectID <= rhs.mObjectID; }
+		bool operator>=(const const_iterator& rhs) const noexcept { return mObjectID >= rhs.mObjectID; }
+
+	private:
+
+		const AudioObjectID * _Nullable mObjectID = nullptr;
+
+	};
+
+	/// Creates an empty @c CAAudioObjectIDRange
+	constexpr CAAudioObjectIDRange() noexcept = default;
+
+	/// Creates a @c CAAudioObjectIDRange viewing @c count object IDs starting at @c objectIDs
+	constexpr CAAudioObjectIDRange(const AudioObjectID * _Nullable objectIDs, size_t count) noexcept
+	: mObjectIDs{objectIDs}, mCount{count}
+	{}
+
+	/// Creates a @c CAAudioObjectIDRange viewing the object IDs in @c objectIDs
+	template <typename Allocator>
+	CAAudioObjectIDRange(const std::vector<AudioObjectID, Allocator>& objectIDs) noexcept
+	: mObjectIDs{objectIDs.data()}, mCount{objectIDs.size()}
+	{}
+
+	const_iterator begin() const noexcept { return const_iterator(mObjectIDs); }
+	const_iterator end() const noexcept { return const_iterator(mObjectIDs + mCount); }
+
+	/// Returns the number of objects
+	size_t size() const noexcept { return mCount; }
+	/// Returns @c true if there are no objects
+	bool empty() const noexcept { return mCount == 0; }
+
+	/// Returns the object at @c index
+	T operator[](size_t index) const noexcept { return T(mObjectIDs[index]); }
+
+private:
+
+	const AudioObjectID * _Nullable mObjectIDs = nullptr;
+	size_t mCount = 0;
+
+};
+
 class CAAudioObject
 {
 
@@ -148,6 +243,38 @@ public:
 		return vec;
 	}
 
+	/// Returns the number of elements of type @c T in an array property
+	template <typename T, typename = std::enable_if_t<std::is_trivial_v<T>>>
+	UInt32 ArrayPropertyCount(const AudioObjectPropertyAddress& inAddress, UInt32 inQualifierDataSize = 0, const void * _Nullable inQualifierData = nullptr) const
+	{
+		return GetPropertyDataSize(inAddress, inQualifierDataSize, inQualifierData) / sizeof(T);
+	}
+
+	/// Retrieves at most @c inCapacity elements of an array property into @c outValues without allocating
+	/// @return The number of elements retrieved
+	template <typename T, typename = std::enable_if_t<std::is_trivial_v<T>>>
+	UInt32 ArrayProperty(const AudioObjectPropertyAddress& inAddress, T * _Nonnull outValues, UInt32 inCapacity, UInt32 inQualifierDataSize = 0, const void * _Nullable inQualifierData = nullptr) const
+	{
+		UInt32 size = inCapacity * sizeof(T);
+		GetPropertyData(inAddress, inQualifierDataSize, inQualifierData, size, outValues);
+		return size / sizeof(T);
+	}
+
+	/// Retrieves an array property into @c outValues, reusing its storage when the capacity is sufficient
+	/// @note @c outValues may use any allocator, such as @c std::pmr::polymorphic_allocator
+	/// @return The number of elements retrieved
+	template <typename T, typename Allocator, typename = std::enable_if_t<std::is_trivial_v<T>>>
+	UInt32 ArrayProperty(const AudioObjectPropertyAddress& inAddress, std::vector<T, Allocator>& outValues, UInt32 inQualifierDataSize = 0, const void * _Nullable inQualifierData = nullptr) const
+	{
+		auto size = GetPropertyDataSize(inAddress, inQualifierDataSize, inQualifierData);
+		outValues.resize(size / sizeof(T));
+		if(outValues.empty())
+			return 0;
+		GetPropertyData(inAddress, inQualifierDataSize, inQualifierData, size, outValues.data());
+		outValues.resize(size / sizeof(T));
+		return static_cast<UInt32>(outValues.size());
+	}
+
 	template <typename T, typename = std::enable_if_t</*std::is_class_v<T> &&*/ std::is_pointer_v<T>>>
 	CFWrapper<T> CFTypeProperty(const AudioObjectPropertyAddress& inAddress, UInt32 inQualifierDataSize = 0, const void * _Nullable inQualifierData = nullptr) const
 	{
@@ -239,6 +366,13 @@ public:
 		return ArrayProperty<AudioObjectID>(CAPropertyAddress(kAudioObjectPropertyOwnedObjects));
 	}
 
+	/// Retrieves at most @c inCapacity owned object IDs into @c outObjectIDs without allocating
+	/// @return The number of object IDs retrieved
+	UInt32 OwnedObjectIDs(AudioObjectID * _Nonnull outObjectIDs, UInt32 inCapacity) const
+	{
+		return ArrayProperty<AudioObjectID>(CAPropertyAddress(kAudioObjectPropertyOwnedObjects), outObjectIDs, inCapacity);
+	}
+
 	std::vector<CAAudioObject> OwnedObjects() const
 	{
 		auto vec = OwnedObjectIDs();
@@ -0,0 +1,293 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <cstddef>
+#import <memory>
+#import <type_traits>
+#import <utility>
+#import <vector>
+
+#import <CoreAudio/CoreAudio.h>
+
+#import "SFBCAAudioObject.hpp"
+#import "SFBCAPropertyAddress.hpp"
+#import "SFBCFWrapper.hpp"
+#import "SFBUnfairLock.hpp"
+
+namespace SFB {
+
+/// A cache of property values for an audio object, invalidated by property change notifications
+///
+/// A property's value is retrieved from the HAL the first time it is requested and a property listener is added for
+/// its address. Subsequent requests return the cached value until the HAL reports that the property has changed.
+///
+/// Reads of cached scalar properties (those retrieved with @c ArithmeticProperty() or @c StructProperty() for
+/// structures no larger than @c sMaximumScalarSize) are lock-free. Reads of cached larger structure, array, and Core
+/// Foundation properties hold an uncontended unfair lock only long enough to copy a @c std::shared_ptr, and never
+/// allocate.
+///
+/// This class is thread safe.
+///
+/// @code
+/// SFB::CAAudioObjectPropertyCache cache(device);
+/// // Later, potentially polled frequently
+/// auto sampleRate = cache.ArithmeticProperty<Float64>(SFB::CAPropertyAddress(kAudioDevicePropertyNominalSampleRate));
+/// @endcode
+class CAAudioObjectPropertyCache
+{
+
+public:
+
+	/// The maximum size in bytes of a scalar property value
+	///
+	/// This is large enough for structures such as @c AudioStreamBasicDescription and @c AudioTimeStamp.
+	static constexpr size_t sMaximumScalarSize = 64;
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c CAAudioObjectPropertyCache for @c object
+	/// @param object The audio object whose properties are cached
+	/// @param capacity The maximum number of distinct property addresses cached
+	/// @throw @c std::bad_alloc
+	explicit CAAudioObjectPropertyCache(CAAudioObject object, size_t capacity = 64);
+
+	// This class is non-copyable
+	CAAudioObjectPropertyCache(const CAAudioObjectPropertyCache&) = delete;
+
+	// This class is non-assignable
+	CAAudioObjectPropertyCache& operator=(const CAAudioObjectPropertyCache&) = delete;
+
+	/// Removes all property listeners and destroys the @c CAAudioObjectPropertyCache
+	~CAAudioObjectPropertyCache();
+
+	// This class is non-movable
+	CAAudioObjectPropertyCache(CAAudioObjectPropertyCache&&) = delete;
+
+	// This class is non-move assignable
+	CAAudioObjectPropertyCache& operator=(CAAudioObjectPropertyCache&&) = delete;
+
+	/// Returns the audio object whose properties are cached
+	const CAAudioObject& Object() const noexcept
+	{
+		return mObject;
+	}
+
+#pragma mark Cached Properties
+
+	/// Returns the value of an arithmetic property
+	/// @throw @c std::system_error If the value was not cached and could not be retrieved
+	template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+	T ArithmeticProperty(const AudioObjectPropertyAddress& inAddress) const
+	{
+		return ScalarProperty<T>(inAddress);
+	}
+
+	/// Returns the value of a structure property
+	/// @note Structures larger than @c sMaximumScalarSize are cached as objects, like array properties
+	/// @throw @c std::system_error If the value was not cached and could not be retrieved
+	/// @throw @c std::bad_alloc If a structure larger than @c sMaximumScalarSize was not cached
+	template <typename T, typename = std::enable_if_t<std::is_trivial_v<T>>>
+	T StructProperty(const AudioObjectPropertyAddress& inAddress) const
+	{
+		if constexpr (sizeof(T) <= sMaximumScalarSize) {
+			return ScalarProperty<T>(inAddress);
+		}
+		else {
+			return *ObjectProperty<T>(inAddress, [&] {
+				return mObject.StructProperty<T>(inAddress);
+			});
+		}
+	}
+
+	/// Returns the value of an array property
+	/// @note The returned array is shared and must not be modified
+	/// @throw @c std::system_error If the value was not cached and could not be retrieved
+	/// @throw @c std::bad_alloc
+	template <typename T, typename = std::enable_if_t<std::is_trivial_v<T>>>
+	std::shared_ptr<const std::vector<T>> ArrayProperty(const AudioObjectPropertyAddress& inAddress) const
+	{
+		return ObjectProperty<std::vector<T>>(inAddress, [&] {
+			return mObject.ArrayProperty<T>(inAddress);
+		});
+	}
+
+	/// Returns the value of a Core Foundation property
+	/// @throw @c std::system_error If the value was not cached and could not be retrieved
+	/// @throw @c std::bad_alloc
+	template <typename T, typename = std::enable_if_t<std::is_pointer_v<T>>>
+	CFWrapper<T> CFTypeProperty(const AudioObjectPropertyAddress& inAddress) const
+	{
+		return *ObjectProperty<CFWrapper<T>>(inAddress, [&] {
+			return mObject.CFTypeProperty<T>(inAddress);
+		});
+	}
+
+#pragma mark Common Properties
+
+	/// Returns the object's name (@c kAudioObjectPropertyName)
+	/// @throw @c std::system_error
+	CFString Name() const
+	{
+		return CFTypeProperty<CFStringRef>(CAPropertyAddress(kAudioObjectPropertyName));
+	}
+
+	/// Returns the device's nominal sample rate (@c kAudioDevicePropertyNominalSampleRate)
+	/// @throw @c std::system_error
+	Float64 NominalSampleRate() const
+	{
+		return ArithmeticProperty<Float64>(CAPropertyAddress(kAudioDevicePropertyNominalSampleRate));
+	}
+
+	/// Returns the device's buffer frame size (@c kAudioDevicePropertyBufferFrameSize)
+	/// @throw @c std::system_error
+	UInt32 BufferFrameSize() const
+	{
+		return ArithmeticProperty<UInt32>(CAPropertyAddress(kAudioDevicePropertyBufferFrameSize));
+	}
+
+	/// Returns the device's latency for @c scope (@c kAudioDevicePropertyLatency)
+	/// @throw @c std::system_error
+	UInt32 Latency(CAAudioObjectDirectionalScope scope) const
+	{
+		return ArithmeticProperty<UInt32>(CAPropertyAddress(kAudioDevicePropertyLatency, scope == CAAudioObjectDirectionalScope::input ? kAudioObjectPropertyScopeInput : kAudioObjectPropertyScopeOutput));
+	}
+
+	/// Returns the device's safety offset for @c scope (@c kAudioDevicePropertySafetyOffset)
+	/// @throw @c std::system_error
+	UInt32 SafetyOffset(CAAudioObjectDirectionalScope scope) const
+	{
+		return ArithmeticProperty<UInt32>(CAPropertyAddress(kAudioDevicePropertySafetyOffset, scope == CAAudioObjectDirectionalScope::input ? kAudioObjectPropertyScopeInput : kAudioObjectPropertyScopeOutput));
+	}
+
+	/// Returns the device's stream IDs for @c scope (@c kAudioDevicePropertyStreams)
+	/// @throw @c std::system_error
+	/// @throw @c std::bad_alloc
+	std::shared_ptr<const std::vector<AudioObjectID>> StreamIDs(CAAudioObjectDirectionalScope scope) const
+	{
+		return ArrayProperty<AudioObjectID>(CAPropertyAddress(kAudioDevicePropertyStreams, scope == CAAudioObjectDirectionalScope::input ? kAudioObjectPropertyScopeInput : kAudioObjectPropertyScopeOutput));
+	}
+
+#pragma mark Invalidation
+
+	/// Discards the cached value for @c inAddress
+	/// @note Wildcards in @c inAddress are respected
+	void Invalidate(const AudioObjectPropertyAddress& inAddress) noexcept;
+
+	/// Discards all cached values
+	void InvalidateAll() noexcept;
+
+private:
+
+	/// The number of 64-bit words holding a scalar value
+	static constexpr size_t sScalarWordCount = sMaximumScalarSize / sizeof(uint64_t);
+
+	/// A cached property value
+	struct Slot {
+		/// Set once @c mAddress is valid; slots are never reused
+		std::atomic_bool mPublished = false;
+		/// The property address
+		CAPropertyAddress mAddress;
+		/// Set once a property listener has been added for @c mAddress; values are cached only when set
+		std::atomic_bool mListening = false;
+
+		/// Incremented each time the value is invalidated
+		std::atomic_uint32_t mGeneration = 0;
+
+		/// Sequence number protecting the scalar value; odd while the value is being modified
+		std::atomic_uint32_t mSequence = 0;
+		/// Whether the scalar value is valid
+		std::atomic_bool mScalarValid = false;
+		/// The size of the scalar value in bytes
+		std::atomic_uint32_t mScalarSize = 0;
+		/// The scalar value
+		std::atomic_uint64_t mScalar[sScalarWordCount] = {};
+
+		/// The object value or @c nullptr if none
+		/// @note Protected by @c mLock
+		std::shared_ptr<const void> mObject;
+		/// A tag identifying the type of @c mObject
+		/// @note Protected by @c mLock
+		const void * _Nullable mObjectType = nullptr;
+	};
+
+	/// A unique address identifying the type @c T
+	template <typename T>
+	static inline const char sTypeTag = 0;
+
+	/// Returns the value of a scalar property
+	template <typename T>
+	T ScalarProperty(const AudioObjectPropertyAddress& inAddress) const
+	{
+		static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sMaximumScalarSize, "Unsupported scalar property type");
+		T value;
+		if(!ReadScalar(inAddress, &value, sizeof(T)))
+			FetchScalar(inAddress, &value, sizeof(T));
+		return value;
+	}
+
+	/// Returns the value of a property stored as an object of type @c T, calling @c fetch to retrieve it if necessary
+	template <typename T, typename F>
+	std::shared_ptr<const T> ObjectProperty(const AudioObjectPropertyAddress& inAddress, F&& fetch) const
+	{
+		const void *type = &sTypeTag<T>;
+		if(auto object = ReadObject(inAddress, type))
+			return std::static_pointer_cast<const T>(object);
+
+		const auto [slot, generation] = PrepareFetch(inAddress);
+		auto object = std::make_shared<const T>(fetch());
+		if(slot)
+			StoreObject(*slot, generation, type, object);
+		return object;
+	}
+
+	/// Copies the cached scalar value for @c inAddress to @c value if valid
+	/// @return @c true if a valid value of @c size bytes was cached
+	bool ReadScalar(const AudioObjectPropertyAddress& inAddress, void * _Nonnull value, size_t size) const noexcept;
+
+	/// Retrieves the scalar value for @c inAddress from the HAL and caches it
+	/// @throw @c std::system_error
+	void FetchScalar(const AudioObjectPropertyAddress& inAddress, void * _Nonnull value, size_t size) const;
+
+	/// Returns the cached object for @c inAddress if valid and of the specified type
+	std::shared_ptr<const void> ReadObject(const AudioObjectPropertyAddress& inAddress, const void * _Nonnull type) const noexcept;
+
+	/// Caches @c object if @c slot has not been invalidated since @c generation
+	void StoreObject(Slot& slot, uint32_t generation, const void * _Nonnull type, std::shared_ptr<const void> object) const noexcept;
+
+	/// Returns the slot for @c inAddress, creating it if necessary, and its current generation
+	/// @return The slot or @c nullptr if the cache is full, and the slot's generation
+	std::pair<Slot * _Nullable, uint32_t> PrepareFetch(const AudioObjectPropertyAddress& inAddress) const noexcept;
+
+	/// Returns the slot for @c inAddress or @c nullptr if none
+	Slot * _Nullable FindSlot(const AudioObjectPropertyAddress& inAddress) const noexcept;
+
+	/// Returns the slot for @c inAddress, creating it and adding a property listener if necessary
+	Slot * _Nullable FindOrCreateSlot(const AudioObjectPropertyAddress& inAddress) const noexcept;
+
+	/// Invalidates the value cached in @c slot
+	void InvalidateSlot(Slot& slot) const noexcept;
+
+	/// Property listener invalidating changed properties
+	static OSStatus PropertyListenerProc(AudioObjectID inObjectID, UInt32 inNumberAddresses, const AudioObjectPropertyAddress *inAddresses, void * _Nullable inClientData) noexcept;
+
+	/// The audio object whose properties are cached
+	const CAAudioObject mObject;
+	/// The number of slots
+	const size_t mCapacity;
+	/// The slots
+	std::unique_ptr<Slot[]> mSlots;
+	/// Lock serializing slot creation and value stores
+	mutable UnfairLock mLock;
+
+	static_assert(std::atomic_uint64_t::is_always_lock_free, "Lock-free std::atomic_uint64_t required");
+	static_assert(std::atomic_uint32_t::is_always_lock_free, "Lock-free std::atomic_uint32_t required");
+
+};
+
+} /* namespace SFB */
@@ -1,5 +1,5 @@
 //
-// Copyright © 2021-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2021-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
@@ -8,6 +8,7 @@
 
 #import "SFBCAAudioObject.hpp"
 #import "SFBCAAudioDevice.hpp"
+#import "SFBCAAudioDeviceTopology.hpp"
 
 namespace SFB {
 
@@ -42,6 +43,13 @@ public:
 		return ArrayProperty<AudioObjectID>(CAPropertyAddress(kAudioHardwarePropertyDevices));
 	}
 
+	/// Retrieves at most @c inCapacity device IDs into @c outDeviceIDs without allocating
+	/// @return The number of device IDs retrieved
+	UInt32 DeviceIDs(AudioObjectID * _Nonnull outDeviceIDs, UInt32 inCapacity) const
+	{
+		return ArrayProperty<AudioObjectID>(CAPropertyAddress(kAudioHardwarePropertyDevices), outDeviceIDs, inCapacity);
+	}
+
 	std::vector<CAAudioDevice> Devices() const
 	{
 		auto vec = DeviceIDs();
@@ -50,6 +58,15 @@ public:
 		return result;
 	}
 
+	/// Returns a snapshot of the audio devices and their commonly used properties
+	/// @note Device properties are retrieved concurrently
+	/// @throw @c std::system_error
+	/// @throw @c std::bad_alloc
+	CAAudioDeviceTopology DeviceTopology() const
+	{
+		return CAAudioDeviceTopology::Snapshot();
+	}
+
 	AudioObjectID DefaultInputDeviceID() const
 	{
 		return ArithmeticProperty<AudioObjectID>(CAPropertyAddress(kAudioHardwarePropertyDefaultInputDevice));
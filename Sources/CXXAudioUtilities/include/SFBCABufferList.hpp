@@ -1,5 +1,5 @@
 //
-// Copyright © 2013-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2013-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
@@ -21,6 +21,15 @@ namespace SFB {
 /// @return A newly-allocated @c AudioBufferList or @c nullptr
 AudioBufferList * _Nullable AllocateAudioBufferList(const CAStreamBasicDescription& format, UInt32 frameCapacity) noexcept;
 
+/// Allocates and returns a new @c AudioBufferList in a single allocation with aligned buffers
+/// @note The allocation is performed using @c posix_memalign and should be deallocated using @c std::free
+/// @param format The format of the audio the @c AudioBufferList will hold
+/// @param frameCapacity The desired buffer capacity in audio frames
+/// @param alignment The desired alignment of each buffer in bytes, which must be a power of two multiple of @c sizeof(void *)
+/// @param zeroFill Whether the buffers should be zeroed
+/// @return A newly-allocated @c AudioBufferList or @c nullptr
+AudioBufferList * _Nullable AllocateAudioBufferList(const CAStreamBasicDescription& format, UInt32 frameCapacity, size_t alignment, bool zeroFill = true) noexcept;
+
 /// A class wrapping a Core Audio @c AudioBufferList with a specific format, frame capacity, and frame length
 class CABufferList
 {
@@ -132,7 +141,7 @@ public:
 #pragma mark Buffer utilities
 
 	/// Prepends the contents of @c buffer
-	/// @note The format of @c buffer must match the format of this @c CABufferList
+	/// @note The format of @c buffer must be one for which @c CanInsertFromFormat() returns @c true
 	/// @param buffer A buffer of audio data
 	/// @return The number of frames prepended
 	UInt32 PrependContentsOfBuffer(const CABufferList& buffer) noexcept
@@ -141,7 +150,7 @@ public:
 	}
 
 	/// Prepends frames from @c buffer starting at @c readOffset
-	/// @note The format of @c buffer must match the format of this @c CABufferList
+	/// @note The format of @c buffer must be one for which @c CanInsertFromFormat() returns @c true
 	/// @param buffer A buffer of audio data
 	/// @param readOffset The desired starting offset in @c buffer
 	/// @return The number of frames prepended
@@ -153,7 +162,7 @@ public:
 	}
 
 	/// Prepends at most @c frameLength frames from @c buffer starting at @c readOffset
-	/// @note The format of @c buffer must match the format of this @c CABufferList
+	/// @note The format of @c buffer must be one for which @c CanInsertFromFormat() returns @c true
 	/// @param buffer A buffer of audio data
 	/// @param readOffset The desired starting offset in @c buffer
 	/// @param frameLength The desired number of frames
@@ -164,7 +173,7 @@ public:
 	}
 
 	/// Appends the contents of @c buffer
-	/// @note The format of @c buffer must match the format of this @c CABufferList
+	/// @note The format of @c buffer must be one for which @c CanInsertFromFormat() returns @c true
 	/// @param buffer A buffer of audio data
 	/// @return The number of frames appended
 	UInt32 AppendContentsOfBuffer(const CABufferList& buffer) noexcept
@@ -173,7 +182,7 @@ public:
 	}
 
 	/// Appends frames from @c buffer starting at @c readOffset
-	/// @note The format of @c buffer must match the format of this @c CABufferList
+	/// @note The format of @c buffer must be one for which @c CanInsertFromFormat() returns @c true
 	/// @param buffer A buffer of audio data
 	/// @param readOffset The desired starting offset in @c buffer
 	/// @return The number of frames appended
@@ -185,7 +194,7 @@ public:
 	}
 
 	/// Appends at most @c frameLength frames from @c buffer starting at @c readOffset
-	/// @note The format of @c buffer must match the format of this @c CABufferList
+	/// @note The format of @c buffer must be one for which @c CanInsertFromFormat() returns @c true
 	/// @param buffer A buffer of audio data
 	/// @param readOffset The desired starting offset in @c buffer
 	/// @param frameLength The desired number of frames
@@ -196,7 +205,7 @@ public:
 	}
 
 	/// Inserts the contents of @c buffer in this @c CABufferList starting at @c writeOffset
-	/// @note The format of @c buffer must match the format of this @c CABufferList
+	/// @note The format of @c buffer must be one for which @c CanInsertFromFormat() returns @c true
 	/// @param buffer A buffer of audio data
 	/// @param writeOffset The desired starting offset in this @c CABufferList
 	/// @return The number of frames inserted
@@ -205,8 +214,17 @@ public:
 		return InsertFromBuffer(buffer, 0, buffer.mFrameLength, writeOffset);
 	}
 
+	/// Returns @c true if audio in @c format may be inserted into this @c CABufferList
+	///
+	/// Audio may be inserted if @c format matches the format of this @c CABufferList, or if both formats have the same
+	/// sample rate and channel count and are common PCM formats. Common PCM formats may differ in interleaving and
+	/// sample format and are converted directly during insertion. Other conversions require an @c AudioConverter.
+	/// @param format The format of the audio to insert
+	/// @return @c true if audio in @c format may be inserted, @c false otherwise
+	bool CanInsertFromFormat(const CAStreamBasicDescription& format) const noexcept;
+
 	/// Inserts at most @c readLength frames from @c buffer starting at @c readOffset starting at @c writeOffset
-	/// @note The format of @c buffer must match the format of this @c CABufferList
+	/// @note The format of @c buffer must be one for which @c CanInsertFromFormat() returns @c true
 	/// @param buffer A buffer of audio data
 	/// @param readOffset The desired starting offset in @c buffer
 	/// @param frameLength The desired number of frames
@@ -0,0 +1,211 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <vector>
+
+#import <CoreAudioTypes/CoreAudioTypes.h>
+
+#import "SFBCABufferList.hpp"
+#import "SFBCAStreamBasicDescription.hpp"
+#import "SFBUnfairLock.hpp"
+
+namespace SFB {
+
+/// A thread-safe pool of reusable @c CABufferList objects keyed by format and frame capacity
+///
+/// Buffer lists are allocated in a single allocation with each buffer aligned to a 64-byte boundary. A buffer list
+/// obtained from the pool is returned to it when the @c CABufferListPool::Handle owning it is destroyed, and
+/// subsequent requests for the same format and frame capacity reuse it without allocating.
+///
+/// @code
+/// SFB::CABufferListPool pool;
+/// // Later
+/// auto buffer = pool.Acquire(format, 4096);
+/// if(buffer)
+///     buffer->AppendSilence(512);
+/// @endcode
+class CABufferListPool
+{
+
+public:
+
+	/// The alignment of each buffer in bytes
+	static constexpr size_t sBufferAlignment = 64;
+
+	/// A move-only owner of a @c CABufferList obtained from a @c CABufferListPool
+	///
+	/// When a @c Handle is destroyed its @c CABufferList is returned to the pool.
+	/// @note A @c Handle must not outlive the pool from which it was obtained
+	class Handle
+	{
+
+	public:
+
+		/// Creates an empty @c Handle
+		Handle() noexcept = default;
+
+		// This class is non-copyable
+		Handle(const Handle&) = delete;
+
+		// This class is non-assignable
+		Handle& operator=(const Handle&) = delete;
+
+		/// Returns the buffer list to the pool and destroys the @c Handle
+		~Handle()
+		{
+			Release();
+		}
+
+		/// Creates a new @c Handle by moving the contents of @c rhs
+		Handle(Handle&& rhs) noexcept
+		: mBufferList{std::move(rhs.mBufferList)}, mPool{rhs.mPool}
+		{
+			rhs.mPool = nullptr;
+		}
+
+		/// Returns the current buffer list to the pool and moves the contents of @c rhs
+		Handle& operator=(Handle&& rhs) noexcept
+		{
+			if(this != &rhs) {
+				Release();
+				mBufferList = std::move(rhs.mBufferList);
+				mPool = rhs.mPool;
+				rhs.mPool = nullptr;
+			}
+			return *this;
+		}
+
+		/// Returns the buffer list to the pool and empties this @c Handle
+		void Release() noexcept
+		{
+			if(mPool) {
+				mPool->Return(mBufferList);
+				mPool = nullptr;
+			}
+		}
+
+		/// Returns @c true if this @c Handle owns a buffer list
+		explicit operator bool() const noexcept
+		{
+			return static_cast<bool>(mBufferList);
+		}
+
+		/// Returns the owned buffer list
+		CABufferList& operator*() noexcept
+		{
+			return mBufferList;
+		}
+
+		/// Returns the owned buffer list
+		const CABufferList& operator*() const noexcept
+		{
+			return mBufferList;
+		}
+
+		/// Returns a pointer to the owned buffer list
+		CABufferList * _Nonnull operator->() noexcept
+		{
+			return &mBufferList;
+		}
+
+		/// Returns a pointer to the owned buffer list
+		const CABufferList * _Nonnull operator->() const noexcept
+		{
+			return &mBufferList;
+		}
+
+	private:
+
+		friend class CABufferListPool;
+
+		/// Creates a @c Handle owning @c bufferList
+		Handle(CABufferList&& bufferList, CABufferListPool * _Nonnull pool) noexcept
+		: mBufferList{std::move(bufferList)}, mPool{pool}
+		{}
+
+		/// The owned buffer list
+		CABufferList mBufferList;
+		/// The pool to which @c mBufferList is returned
+		CABufferListPool * _Nullable mPool = nullptr;
+
+	};
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c CABufferListPool
+	/// @param maximumRetainedBufferLists The maximum number of unused buffer lists retained for each format and frame capacity
+	explicit CABufferListPool(size_t maximumRetainedBufferLists = 16) noexcept
+	: mMaximumRetainedBufferLists{maximumRetainedBufferLists}
+	{}
+
+	// This class is non-copyable
+	CABufferListPool(const CABufferListPool&) = delete;
+
+	// This class is non-assignable
+	CABufferListPool& operator=(const CABufferListPool&) = delete;
+
+	/// Destroys the @c CABufferListPool and frees all unused buffer lists
+	~CABufferListPool();
+
+	// This class is non-movable
+	CABufferListPool(CABufferListPool&&) = delete;
+
+	// This class is non-move assignable
+	CABufferListPool& operator=(CABufferListPool&&) = delete;
+
+#pragma mark Buffer Management
+
+	/// Returns a buffer list with the specified format and frame capacity
+	///
+	/// The buffer list's frame length is zero.
+	/// @param format The format of the audio the buffer list will hold
+	/// @param frameCapacity The desired buffer capacity in audio frames
+	/// @param zeroFill Whether the audio buffers should be zeroed. Pass @c false if the buffer will be overwritten.
+	/// @return A @c Handle owning the buffer list, which is empty if an allocation error occurred
+	Handle Acquire(const CAStreamBasicDescription& format, UInt32 frameCapacity, bool zeroFill = true) noexcept;
+
+	/// Allocates buffer lists with the specified format and frame capacity for later use
+	/// @param format The format of the audio the buffer lists will hold
+	/// @param frameCapacity The buffer capacity in audio frames
+	/// @param count The number of buffer lists to allocate
+	/// @return @c true on success, @c false otherwise
+	bool Reserve(const CAStreamBasicDescription& format, UInt32 frameCapacity, size_t count) noexcept;
+
+	/// Frees all unused buffer lists
+	void Purge() noexcept;
+
+private:
+
+	/// Returns @c bufferList to the pool
+	void Return(CABufferList& bufferList) noexcept;
+
+	/// A collection of unused buffer lists sharing a format and frame capacity
+	struct Entry {
+		/// The format of the buffer lists
+		CAStreamBasicDescription mFormat;
+		/// The frame capacity of the buffer lists
+		UInt32 mFrameCapacity;
+		/// The unused buffer lists
+		std::vector<AudioBufferList *> mBufferLists;
+	};
+
+	/// Returns the entry for @c format and @c frameCapacity or @c nullptr if none
+	/// @note This method must be called with @c mLock held
+	Entry * _Nullable FindEntry(const CAStreamBasicDescription& format, UInt32 frameCapacity) noexcept;
+
+	/// The maximum number of unused buffer lists retained per entry
+	const size_t mMaximumRetainedBufferLists;
+
+	/// The pool entries
+	std::vector<Entry> mEntries;
+	/// Lock protecting @c mEntries
+	UnfairLock mLock;
+
+};
+
+} /* namespace SFB */
@@ -1,5 +1,5 @@
 //
-// Copyright © 2021-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2021-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
@@ -16,6 +16,7 @@
 #import "SFBCABufferList.hpp"
 #import "SFBCAChannelLayout.hpp"
 #import "SFBCAStreamBasicDescription.hpp"
+#import "SFBInternedChannelLayout.hpp"
 
 CF_ASSUME_NONNULL_BEGIN
 
@@ -322,6 +323,15 @@ public:
 		return layout.get();
 	}
 
+	/// Returns the interned copy of the file's channel layout (@c kExtAudioFileProperty_FileChannelLayout)
+	/// @note Common layouts are retrieved without allocating and the result may be compared by pointer
+	/// @throw @c std::system_error
+	/// @throw @c std::bad_alloc
+	InternedChannelLayout InternedFileChannelLayout() const
+	{
+		return InternedChannelLayoutProperty(kExtAudioFileProperty_FileChannelLayout);
+	}
+
 	/// Sets the file's channel layout (@c kExtAudioFileProperty_FileChannelLayout)
 	/// @throw @c std::system_error
 	void SetFileChannelLayout(const CAChannelLayout& fileChannelLayout)
@@ -373,6 +383,15 @@ public:
 		return layout.get();
 	}
 
+	/// Returns the interned copy of the client channel layout (@c kExtAudioFileProperty_ClientChannelLayout)
+	/// @note Common layouts are retrieved without allocating and the result may be compared by pointer
+	/// @throw @c std::system_error
+	/// @throw @c std::bad_alloc
+	InternedChannelLayout InternedClientChannelLayout() const
+	{
+		return InternedChannelLayoutProperty(kExtAudioFileProperty_ClientChannelLayout);
+	}
+
 	/// Sets the client channel layout (@c kExtAudioFileProperty_ClientChannelLayout)
 	/// @throw @c std::system_error
 	void SetClientChannelLayout(const CAChannelLayout& clientChannelLayout)
@@ -452,6 +471,26 @@ public:
 
 private:
 
+	/// Returns the interned copy of the channel layout property @c inPropertyID
+	/// @throw @c std::system_error
+	/// @throw @c std::bad_alloc
+	InternedChannelLayout InternedChannelLayoutProperty(ExtAudioFilePropertyID inPropertyID) const
+	{
+		// Layouts with up to eight channel descriptions are retrieved into a stack buffer
+		alignas(AudioChannelLayout) unsigned char buffer [offsetof(AudioChannelLayout, mChannelDescriptions) + 8 * sizeof(AudioChannelDescription)];
+		auto size = GetPropertyInfo(inPropertyID, nullptr);
+		if(size <= sizeof(buffer)) {
+			GetProperty(inPropertyID, size, buffer);
+			return InternedChannelLayout::Intern(reinterpret_cast<const AudioChannelLayout *>(buffer));
+		}
+
+		std::unique_ptr<AudioChannelLayout, free_deleter> layout{static_cast<AudioChannelLayout *>(std::malloc(size))};
+		if(!layout)
+			throw std::bad_alloc();
+		GetProperty(inPropertyID, size, layout.get());
+		return InternedChannelLayout::Intern(layout.get());
+	}
+
 	/// The underlying @c ExtAudioFile object
 	ExtAudioFileRef _Nullable mExtAudioFile = nullptr;
 
@@ -1,5 +1,5 @@
 //
-// Copyright © 2013-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2013-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
@@ -7,44 +7,54 @@
 #pragma once
 
 #import <atomic>
+#import <cstdlib>
+#import <type_traits>
+#import <utility>
 
 #import <CoreAudioTypes/CoreAudioTypes.h>
 
 #import "SFBCAStreamBasicDescription.hpp"
+#import "SFBRingBufferStatistics.hpp"
 
 namespace SFB {
 
 /// A ring buffer supporting timestamped non-interleaved audio based on Apple's @c CARingBuffer.
 ///
 /// This class is thread safe when used from one reader thread and one writer thread (single producer, single consumer model).
-class CARingBuffer
+///
+/// Statistics are collected by @c Counters, which must be either @c NullRingBufferCounters or @c RingBufferCounters.
+/// This template is not used directly; use @c CARingBuffer or @c InstrumentedCARingBuffer instead.
+template <typename Counters>
+class BasicCARingBuffer
 {
 
+	static_assert(std::is_same_v<Counters, NullRingBufferCounters> || std::is_same_v<Counters, RingBufferCounters>, "Unsupported counters type");
+
 public:
 
 #pragma mark Creation and Destruction
 
 	/// Creates a new @c CARingBuffer
 	/// @note @c Allocate() must be called before the object may be used.
-	constexpr CARingBuffer() noexcept = default;
+	constexpr BasicCARingBuffer() noexcept = default;
 
 	// This class is non-copyable
-	CARingBuffer(const CARingBuffer&) = delete;
+	BasicCARingBuffer(const BasicCARingBuffer&) = delete;
 
 	// This class is non-assignable
-	CARingBuffer& operator=(const CARingBuffer&) = delete;
+	BasicCARingBuffer& operator=(const BasicCARingBuffer&) = delete;
 
 	/// Destroys the @c CARingBuffer and release all associated resources.
-	~CARingBuffer()
+	~BasicCARingBuffer()
 	{
-		std::free(mBuffers);
+		Deallocate();
 	}
 
 	// This class is non-movable
-	CARingBuffer(CARingBuffer&&) = delete;
+	BasicCARingBuffer(BasicCARingBuffer&&) = delete;
 
 	// This class is non-move assignable
-	CARingBuffer& operator=(CARingBuffer&&) = delete;
+	BasicCARingBuffer& operator=(BasicCARingBuffer&&) = delete;
 
 #pragma mark Buffer management
 
@@ -57,6 +67,23 @@ public:
 	/// @return @c true on success, @c false on error
 	bool Allocate(const CAStreamBasicDescription& format, uint32_t capacityFrames) noexcept;
 
+	/// Allocates space for audio data with aligned channel buffers.
+	///
+	/// Each channel's buffer begins on an @c alignment boundary. When @c padChannelStride is @c true and the distance between
+	/// consecutive channel buffers would be a multiple of 4096 bytes, the distance is increased by one cache line so that
+	/// corresponding frames in different channels do not compete for the same L1 cache set. Padding takes precedence over
+	/// alignment: if @c alignment is larger than a cache line, such as @c vm_page_size, only the first channel's buffer is
+	/// then aligned to @c alignment and the others begin on a cache line boundary.
+	/// @note Only non-interleaved formats are supported.
+	/// @note This method is not thread safe.
+	/// @note Capacities from 2 to 2,147,483,648 (0x80000000) frames are supported
+	/// @param format The format of the audio that will be written to and read from this buffer.
+	/// @param capacityFrames The desired capacity, in frames
+	/// @param alignment The alignment of each channel's buffer in bytes, which must be a power of two multiple of @c sizeof(void *), such as 64 or @c vm_page_size
+	/// @param padChannelStride Whether the distance between channel buffers should be padded to avoid cache set aliasing, or @c false to align every channel's buffer to @c alignment
+	/// @return @c true on success, @c false on error
+	bool Allocate(const CAStreamBasicDescription& format, uint32_t capacityFrames, size_t alignment, bool padChannelStride = true) noexcept;
+
 	/// Frees the resources used by this @c CARingBuffer
 	/// @note This method is not thread safe.
 	void Deallocate() noexcept;
@@ -102,6 +129,112 @@ public:
 	/// @return @c true on success, @c false on error
 	bool Write(const AudioBufferList * const _Nonnull bufferList, uint32_t frameCount, int64_t timeStamp) noexcept;
 
+#pragma mark Advanced reading and writing
+
+	/// A read-only view of audio in the ring buffer
+	struct ReadBuffer {
+		/// An @c AudioBufferList whose buffers point directly into the ring buffer's storage
+		const AudioBufferList * const _Nullable mBufferList = nullptr;
+		/// The sample time of the first frame in @c mBufferList
+		const int64_t mStartTime = 0;
+		/// The number of frames of valid audio in @c mBufferList
+		const uint32_t mFrameCount = 0;
+
+	private:
+		friend class BasicCARingBuffer;
+
+		/// Construct an empty @c ReadBuffer
+		ReadBuffer() noexcept = default;
+
+		/// Construct a @c ReadBuffer for the specified buffer list, start time, and frame count
+		/// @param bufferList The buffer list
+		/// @param startTime The sample time of the first frame in @c bufferList
+		/// @param frameCount The number of frames of valid audio in @c bufferList
+		ReadBuffer(const AudioBufferList * const _Nullable bufferList, int64_t startTime, uint32_t frameCount) noexcept
+		: mBufferList{bufferList}, mStartTime{startTime}, mFrameCount{frameCount}
+		{}
+	};
+
+	/// A pair of @c ReadBuffer objects
+	using ReadBufferPair = std::pair<const ReadBuffer, const ReadBuffer>;
+
+	/// Returns the read vector containing the audio in the specified range that is present in the @c CARingBuffer
+	///
+	/// Unlike @c Read() no silence is supplied for the portions of the range outside the buffer's time bounds; the
+	/// caller may determine these from @c mStartTime and @c mFrameCount.
+	/// The buffer lists point directly at the ring buffer's storage and remain valid until the next call to
+	/// @c ReadVector(), @c Allocate(), or @c Deallocate().
+	/// @note The referenced audio may be overwritten if the writer advances more than the buffer's capacity past
+	/// @c timeStamp. If this is a concern @c GetTimeBounds() may be used after consuming the audio to verify it remained valid.
+	/// @note Negative time stamps are not supported
+	/// @note This method should only be called from the reader thread
+	/// @param timeStamp The starting sample time
+	/// @param frameCount The desired number of frames
+	/// @return The read vector
+	const ReadBufferPair ReadVector(int64_t timeStamp, uint32_t frameCount) const noexcept;
+
+
+	/// A write-only view of space in the ring buffer
+	struct WriteBuffer {
+		/// An @c AudioBufferList whose buffers point directly into the ring buffer's storage
+		AudioBufferList * const _Nullable mBufferList = nullptr;
+		/// The capacity of @c mBufferList in frames
+		const uint32_t mFrameCapacity = 0;
+
+	private:
+		friend class BasicCARingBuffer;
+
+		/// Construct an empty @c WriteBuffer
+		WriteBuffer() noexcept = default;
+
+		/// Construct a @c WriteBuffer for the specified buffer list and frame capacity
+		/// @param bufferList The buffer list
+		/// @param frameCapacity The capacity of @c bufferList in frames
+		WriteBuffer(AudioBufferList * const _Nullable bufferList, uint32_t frameCapacity) noexcept
+		: mBufferList{bufferList}, mFrameCapacity{frameCapacity}
+		{}
+	};
+
+	/// A pair of @c WriteBuffer objects
+	using WriteBufferPair = std::pair<const WriteBuffer, const WriteBuffer>;
+
+	/// Returns the write vector for audio beginning at the specified sample time
+	///
+	/// The buffer's time bounds are adjusted as for @c Write() and any gap is filled with silence. After storing audio
+	/// call @c AdvanceWritePosition() to make it available to the reader.
+	/// The buffer lists point directly at the ring buffer's storage and remain valid until the next call to
+	/// @c WriteVector(), @c Allocate(), or @c Deallocate(). The @c mDataByteSize of each buffer is set to its capacity
+	/// and may be modified by the caller.
+	/// @note Negative time stamps are not supported
+	/// @note This method should only be called from the writer thread
+	/// @param timeStamp The starting sample time
+	/// @param frameCount The desired number of frames to write
+	/// @return The write vector, which is empty on error
+	const WriteBufferPair WriteVector(int64_t timeStamp, uint32_t frameCount) noexcept;
+
+	/// Advances the buffer's end time by the specified number of frames.
+	/// @note @c frameCount must not exceed the number of frames requested in the preceding call to @c WriteVector()
+	/// @note This method should only be called from the writer thread
+	/// @param frameCount The number of frames stored in the write vector
+	void AdvanceWritePosition(uint32_t frameCount) noexcept;
+
+#pragma mark Statistics
+
+	/// Returns a snapshot of the statistics collected by this @c CARingBuffer
+	/// @note Statistics are only collected when @c Counters is @c RingBufferCounters
+	/// @note This method may be called from any thread
+	RingBufferStatistics Statistics() const noexcept
+	{
+		return mCounters.Snapshot();
+	}
+
+	/// Resets the statistics collected by this @c CARingBuffer
+	/// @note This method should not be called while the buffer is being read or written
+	void ResetStatistics() noexcept
+	{
+		mCounters.Reset();
+	}
+
 protected:
 
 	/// Returns the byte offset of @c frameNumber
@@ -131,6 +264,11 @@ protected:
 	/// @note This should only be called from @c Write()
 	void SetTimeBounds(int64_t startTime, int64_t endTime) noexcept;
 
+	/// Adjusts the buffer's time bounds for a write spanning @c startWrite to @c endWrite and zeroes any skipped samples
+	/// @note This should only be called from @c Write() or @c WriteVector()
+	/// @return The byte offset at which to begin writing
+	uint32_t PrepareWrite(int64_t startWrite, int64_t endWrite) noexcept;
+
 private:
 
 	/// The format of the audio
@@ -145,6 +283,10 @@ private:
 	/// @note Equal to @c mCapacityFrames-1
 	uint32_t mCapacityFramesMask = 0;
 
+	/// Four @c AudioBufferList structures allocated in one chunk of memory, used by @c ReadVector() and @c WriteVector()
+	/// @note The first two belong to the reader and the second two to the writer
+	void * _Nullable mBufferLists = nullptr;
+
 	/// A range of valid sample times in the buffer
 	struct TimeBounds {
 		/// The starting sample time
@@ -168,8 +310,20 @@ private:
 	/// Monotonically increasing counter incremented when the buffer's time bounds changes
 	std::atomic_uint64_t mTimeBoundsQueueCounter = 0;
 
+	/// Statistics counters
+	mutable Counters mCounters;
+
 	static_assert(std::atomic_uint64_t::is_always_lock_free, "Lock-free std::atomic_uint64_t required");
 
 };
 
+extern template class BasicCARingBuffer<NullRingBufferCounters>;
+extern template class BasicCARingBuffer<RingBufferCounters>;
+
+/// A ring buffer supporting timestamped non-interleaved audio that does not collect statistics
+using CARingBuffer = BasicCARingBuffer<NullRingBufferCounters>;
+
+/// A ring buffer supporting timestamped non-interleaved audio that collects statistics
+using InstrumentedCARingBuffer = BasicCARingBuffer<RingBufferCounters>;
+
 } /* namespace SFB */
@@ -0,0 +1,294 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <condition_variable>
+#import <cstdint>
+#import <deque>
+#import <functional>
+#import <list>
+#import <memory>
+#import <mutex>
+#import <optional>
+#import <thread>
+#import <unordered_map>
+#import <vector>
+
+#import <AudioToolbox/AudioFile.h>
+
+#import "SFBCAAudioFile.hpp"
+
+CF_ASSUME_NONNULL_BEGIN
+
+namespace SFB {
+
+/// A read-only source of audio file data for @c AudioFileOpenWithCallbacks
+///
+/// A data source is backed by one of:
+/// - A fetch function retrieving byte ranges from slow storage such as an object store. Fetched data is held in a
+///   cache of fixed-size blocks. Reads spanning several missing blocks fetch them in parallel on a pool of worker
+///   threads, and sequential reads prefetch the blocks that follow.
+/// - A buffer in memory owned by the caller.
+/// - A memory-mapped file.
+///
+/// The data source provides the @c AudioFile read and size callbacks, and may be used to open a @c CAAudioFile, which
+/// in turn may be wrapped by a @c CAExtAudioFile.
+/// @note The data source must outlive any @c AudioFileID opened with it
+///
+/// @code
+/// SFB::CachingAudioFileDataSource source(objectSize, [&](int64_t offset, void *buffer, size_t count) {
+///     return client.GetRange(key, offset, count, buffer);
+/// });
+/// SFB::CAAudioFile audioFile;
+/// source.OpenAudioFile(audioFile, kAudioFileMP3Type);
+/// SFB::CAExtAudioFile extAudioFile;
+/// extAudioFile.WrapAudioFileID(audioFile, false);
+/// @endcode
+class CachingAudioFileDataSource
+{
+
+public:
+
+	/// A function storing @c count bytes starting at @c offset in @c buffer
+	///
+	/// The requested range is always within the data source's size.
+	/// @note The function is called concurrently from the worker threads
+	/// @return @c true on success, @c false on error
+	using FetchFunction = std::function<bool(int64_t offset, void *buffer, size_t count)>;
+
+	/// Block cache options
+	struct Options {
+		/// The size of a cache block in bytes
+		size_t mBlockSize = 256 * 1024;
+		/// The maximum number of blocks in the cache
+		/// @note Reads needing more blocks than are available may exceed this; the excess is evicted when they complete
+		uint32_t mCacheBlocks = 64;
+		/// The number of blocks prefetched ahead of sequential reads
+		uint32_t mReadAheadBlocks = 4;
+		/// The number of worker threads fetching blocks
+		uint32_t mFetchThreads = 4;
+	};
+
+	/// Block cache usage statistics
+	struct Statistics {
+		/// The number of blocks read that were present in the cache, including blocks being prefetched
+		uint64_t mHits;
+		/// The number of blocks read that were not present in the cache
+		uint64_t mMisses;
+		/// The number of blocks fetched ahead of sequential reads
+		uint64_t mPrefetches;
+		/// The number of bytes fetched
+		uint64_t mBytesFetched;
+		/// The number of failed fetches
+		uint64_t mFetchErrors;
+	};
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c CachingAudioFileDataSource reading from @c fetch through a block cache with the default options
+	/// @param size The size of the data in bytes
+	/// @param fetch The function retrieving byte ranges
+	/// @throw @c std::invalid_argument If @c size is negative or @c fetch is empty
+	/// @throw @c std::system_error If the worker threads could not be created
+	CachingAudioFileDataSource(int64_t size, FetchFunction fetch);
+
+	/// Creates a new @c CachingAudioFileDataSource reading from @c fetch through a block cache
+	/// @param size The size of the data in bytes
+	/// @param fetch The function retrieving byte ranges
+	/// @param options The block cache options
+	/// @throw @c std::invalid_argument If @c size is negative, @c fetch is empty, or the options are invalid
+	/// @throw @c std::system_error If the worker threads could not be created
+	CachingAudioFileDataSource(int64_t size, FetchFunction fetch, const Options& options);
+
+	/// Creates a new @c CachingAudioFileDataSource reading from memory
+	/// @note The memory is not copied and must outlive the data source
+	/// @param bytes The data
+	/// @param size The size of the data in bytes
+	CachingAudioFileDataSource(const void *bytes, size_t size) noexcept;
+
+	/// Creates a new @c CachingAudioFileDataSource reading from the memory-mapped file at @c path
+	/// @param path The path of the file to map
+	/// @throw @c std::system_error If the file could not be opened or mapped
+	explicit CachingAudioFileDataSource(const char *path);
+
+	/// Creates a new @c CachingAudioFileDataSource reading from the memory-mapped file at @c url
+	/// @param url The URL of the file to map
+	/// @throw @c std::invalid_argument If @c url is not a file URL
+	/// @throw @c std::system_error If the file could not be opened or mapped
+	explicit CachingAudioFileDataSource(CFURLRef url);
+
+	// This class is non-copyable
+	CachingAudioFileDataSource(const CachingAudioFileDataSource&) = delete;
+
+	// This class is non-assignable
+	CachingAudioFileDataSource& operator=(const CachingAudioFileDataSource&) = delete;
+
+	/// Stops the worker threads, unmaps any mapped file, and destroys the @c CachingAudioFileDataSource
+	~CachingAudioFileDataSource();
+
+	// This class is non-movable
+	CachingAudioFileDataSource(CachingAudioFileDataSource&&) = delete;
+
+	// This class is non-move assignable
+	CachingAudioFileDataSource& operator=(CachingAudioFileDataSource&&) = delete;
+
+#pragma mark Audio Files
+
+	/// Opens @c audioFile for reading from this data source
+	/// @param audioFile The audio file to open
+	/// @param fileTypeHint A hint for the file type, or @c 0 for none
+	/// @throw @c std::system_error
+	void OpenAudioFile(CAAudioFile& audioFile, AudioFileTypeID fileTypeHint = 0)
+	{
+		audioFile.OpenWithCallbacks(this, ReadProc, nullptr, GetSizeProc, nullptr, fileTypeHint);
+	}
+
+	/// The @c AudioFile read callback
+	/// @note The client data must be a pointer to a @c CachingAudioFileDataSource
+	static OSStatus ReadProc(void *inClientData, SInt64 inPosition, UInt32 requestCount, void *buffer, UInt32 *actualCount) noexcept;
+
+	/// The @c AudioFile size callback
+	/// @note The client data must be a pointer to a @c CachingAudioFileDataSource
+	static SInt64 GetSizeProc(void *inClientData) noexcept;
+
+#pragma mark Reading
+
+	/// Returns the size of the data in bytes
+	int64_t Size() const noexcept
+	{
+		return mSize;
+	}
+
+	/// Reads data, waiting for any blocks not in the cache to be fetched
+	/// @param position The offset of the first byte to read
+	/// @param buffer A buffer to receive the data
+	/// @param count The desired number of bytes
+	/// @return The number of bytes read, which is less than @c count only at the end of the data, or @c std::nullopt on error
+	std::optional<size_t> Read(int64_t position, void *buffer, size_t count) noexcept;
+
+	/// Starts fetching the blocks containing the specified range without waiting for them
+	/// @note This method has no effect unless the data source is backed by a fetch function
+	/// @param position The offset of the first byte
+	/// @param count The number of bytes
+	void Prefetch(int64_t position, size_t count) noexcept;
+
+#pragma mark Cache Statistics
+
+	/// Returns the block cache usage statistics
+	Statistics UsageStatistics() const noexcept
+	{
+		return { mHits.load(std::memory_order_relaxed), mMisses.load(std::memory_order_relaxed), mPrefetches.load(std::memory_order_relaxed), mBytesFetched.load(std::memory_order_relaxed), mFetchErrors.load(std::memory_order_relaxed) };
+	}
+
+	/// Resets the block cache usage statistics
+	void ResetUsageStatistics() noexcept
+	{
+		mHits.store(0, std::memory_order_relaxed);
+		mMisses.store(0, std::memory_order_relaxed);
+		mPrefetches.store(0, std::memory_order_relaxed);
+		mBytesFetched.store(0, std::memory_order_relaxed);
+		mFetchErrors.store(0, std::memory_order_relaxed);
+	}
+
+private:
+
+	/// A cache block
+	struct Block {
+		/// Block states
+		enum class State {
+			/// The block is being fetched
+			pending,
+			/// The block contains valid data
+			ready,
+			/// The fetch failed
+			failed,
+		};
+
+		/// The block's index
+		uint64_t mIndex = 0;
+		/// The block's state
+		State mState = State::pending;
+		/// The number of readers copying from the block
+		uint32_t mPinCount = 0;
+		/// The block's data
+		std::unique_ptr<uint8_t[]> mData;
+	};
+
+	/// A list of blocks in order of most recent use
+	using BlockList = std::list<Block>;
+
+	/// Returns the cached block with index @c index, requesting it if necessary
+	/// @note @c mMutex must be held
+	/// @param index The block index
+	/// @param demand @c true if a reader is waiting for the block, @c false for prefetching
+	/// @return The block or @c nullptr if the block is not cached and the cache has no room for it
+	Block * _Nullable RequestBlock(uint64_t index, bool demand);
+
+	/// Moves unpinned blocks in excess of @c mCacheBlocks to @c evicted, least recently used first
+	/// @note @c mMutex must be held
+	/// @param evicted A list receiving the evicted blocks, which may be destroyed after @c mMutex is released
+	void TrimCache(BlockList& evicted) noexcept;
+
+	/// Returns the number of bytes in the block with index @c index
+	size_t BlockLength(uint64_t index) const noexcept;
+
+	/// Fetches requested blocks until @c mStopWorkers is set
+	void WorkerThreadEntry() noexcept;
+
+	/// The size of the data in bytes
+	int64_t mSize = 0;
+
+	/// The data if the source is in memory or mapped
+	const void * _Nullable mBytes = nullptr;
+	/// The mapped file or @c nullptr
+	void * _Nullable mMapping = nullptr;
+
+	/// The fetch function
+	FetchFunction mFetch;
+	/// The size of a block in bytes
+	const size_t mBlockSize = 0;
+	/// The maximum number of blocks in the cache
+	const uint32_t mCacheBlocks = 0;
+	/// The number of blocks prefetched ahead of sequential reads
+	const uint32_t mReadAheadBlocks = 0;
+
+	/// Protects the cache and the request queue
+	std::mutex mMutex;
+	/// Signaled when a block's fetch completes
+	std::condition_variable mBlockCondition;
+	/// Signaled when a block is requested or the workers should stop
+	std::condition_variable mWorkCondition;
+	/// The cached blocks, most recently used first
+	BlockList mBlocks;
+	/// The cached blocks by index
+	std::unordered_map<uint64_t, BlockList::iterator> mBlockIndex;
+	/// Blocks waiting to be fetched; demand requests precede prefetches
+	std::deque<Block *> mRequests;
+	/// The position following the most recent read, for detecting sequential access
+	int64_t mSequentialPosition = 0;
+	/// Flag set to stop the worker threads
+	bool mStopWorkers = false;
+	/// The worker threads
+	std::vector<std::thread> mWorkers;
+
+	/// The number of cache hits
+	std::atomic_uint64_t mHits = 0;
+	/// The number of cache misses
+	std::atomic_uint64_t mMisses = 0;
+	/// The number of prefetched blocks
+	std::atomic_uint64_t mPrefetches = 0;
+	/// The number of bytes fetched
+	std::atomic_uint64_t mBytesFetched = 0;
+	/// The number of failed fetches
+	std::atomic_uint64_t mFetchErrors = 0;
+
+};
+
+} /* namespace SFB */
+
+CF_ASSUME_NONNULL_END
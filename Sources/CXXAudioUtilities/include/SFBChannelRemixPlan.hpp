@@ -0,0 +1,204 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <list>
+#import <memory>
+#import <mutex>
+#import <vector>
+
+#import <CoreAudioTypes/CoreAudioTypes.h>
+
+#import "SFBCABufferList.hpp"
+#import "SFBCAChannelLayout.hpp"
+
+namespace SFB {
+
+/// A precomputed plan for remixing audio from one channel layout to another
+///
+/// The plan is compiled from the mixing matrix returned by @c kAudioFormatProperty_MatrixMixMap. Each output channel
+/// is the gain-weighted sum of the input channels with nonzero gain, computed using vDSP. When every output channel is
+/// a copy of at most one input channel the plan is a channel map and is applied by copying, or for non-interleaved
+/// audio by rebinding buffer pointers with @c RebindBuffers().
+///
+/// Plans are immutable and may be shared between threads.
+///
+/// @code
+/// auto plan = SFB::ChannelRemixPlan(SFB::CAChannelLayout(kAudioChannelLayoutTag_MPEG_5_1_A), SFB::CAChannelLayout::Stereo);
+/// plan.Apply(surroundBuffer, stereoBuffer);
+/// @endcode
+class ChannelRemixPlan
+{
+
+public:
+
+#pragma mark Creation and Destruction
+
+	/// Creates a plan for remixing audio from @c inputLayout to @c outputLayout
+	/// @param inputLayout The channel layout of the input audio
+	/// @param outputLayout The channel layout of the output audio
+	/// @throw @c std::invalid_argument If either layout is empty or has no channels
+	/// @throw @c std::system_error If the mixing matrix could not be determined
+	/// @throw @c std::bad_alloc
+	ChannelRemixPlan(const CAChannelLayout& inputLayout, const CAChannelLayout& outputLayout);
+
+	/// Creates a plan from a mixing matrix
+	/// @param inputChannelCount The number of input channels
+	/// @param outputChannelCount The number of output channels
+	/// @param matrix A matrix of @c inputChannelCount rows and @c outputChannelCount columns in row-major order, in
+	/// which @c matrix[i*outputChannelCount+j] is the gain applied to input channel @c i in output channel @c j
+	/// @throw @c std::invalid_argument If either channel count is zero or @c matrix is the wrong size
+	/// @throw @c std::bad_alloc
+	ChannelRemixPlan(UInt32 inputChannelCount, UInt32 outputChannelCount, const std::vector<Float32>& matrix);
+
+#pragma mark Properties
+
+	/// Returns the number of input channels
+	UInt32 InputChannelCount() const noexcept
+	{
+		return mInputChannelCount;
+	}
+
+	/// Returns the number of output channels
+	UInt32 OutputChannelCount() const noexcept
+	{
+		return mOutputChannelCount;
+	}
+
+	/// Returns the gain applied to @c inputChannel in @c outputChannel
+	Float32 Gain(UInt32 inputChannel, UInt32 outputChannel) const noexcept;
+
+	/// Returns @c true if each output channel is either silent or a copy of one input channel
+	bool IsChannelMap() const noexcept
+	{
+		return mIsChannelMap;
+	}
+
+	/// Returns the input channel copied to each output channel, or @c -1 for silence
+	/// @note The channel map is empty unless @c IsChannelMap() is @c true
+	const std::vector<SInt32>& ChannelMap() const noexcept
+	{
+		return mChannelMap;
+	}
+
+#pragma mark Remixing
+
+	/// Remixes the audio in @c input to @c output
+	///
+	/// Both buffers must contain native-endian 32-bit floating point audio with the planned channel counts. Either
+	/// buffer may be interleaved or non-interleaved.
+	/// @note This method does not allocate and is safe to call from a real-time thread
+	/// @param input The audio to remix
+	/// @param output A buffer receiving the remixed audio with a capacity of at least @c input.FrameLength() frames
+	/// @return @c true on success, @c false if the buffers' formats or capacity are unsuitable
+	bool Apply(const CABufferList& input, CABufferList& output) const noexcept;
+
+	/// Remixes @c frameCount frames of audio in @c input to @c output
+	/// @note This method does not allocate and is safe to call from a real-time thread
+	/// @param input The audio to remix
+	/// @param inputFormat The format of @c input
+	/// @param output A buffer list receiving the remixed audio
+	/// @param outputFormat The format of @c output
+	/// @param frameCount The number of frames to remix
+	/// @return @c true on success, @c false if the formats are unsuitable
+	bool Apply(const AudioBufferList& input, const CAStreamBasicDescription& inputFormat, AudioBufferList& output, const CAStreamBasicDescription& outputFormat, UInt32 frameCount) const noexcept;
+
+	/// Points the buffers in @c output to the buffers in @c input according to the channel map, without copying
+	/// @note The buffers in @c output then alias those in @c input, which must remain valid while @c output is used
+	/// @param input A non-interleaved buffer list with @c InputChannelCount() buffers
+	/// @param output A non-interleaved buffer list with @c OutputChannelCount() buffers
+	/// @return @c true on success, @c false if the plan is not a channel map with no silent channels or the buffer
+	/// counts differ from the plan
+	bool RebindBuffers(const AudioBufferList& input, AudioBufferList& output) const noexcept;
+
+private:
+
+	/// A term in the sum producing an output channel
+	struct Term {
+		/// The input channel
+		UInt32 mInputChannel;
+		/// The gain applied to the input channel
+		Float32 mGain;
+	};
+
+	/// Compiles the plan from @c matrix
+	void Compile(const std::vector<Float32>& matrix);
+
+	/// The number of input channels
+	UInt32 mInputChannelCount = 0;
+	/// The number of output channels
+	UInt32 mOutputChannelCount = 0;
+	/// The terms for all output channels
+	std::vector<Term> mTerms;
+	/// The offset of the first term for each output channel in @c mTerms, followed by the total term count
+	std::vector<UInt32> mTermOffsets;
+	/// Whether the plan is a channel map
+	bool mIsChannelMap = false;
+	/// The channel map
+	std::vector<SInt32> mChannelMap;
+
+};
+
+/// A thread-safe cache of recently used @c ChannelRemixPlan objects
+///
+/// Plans are keyed by their input and output channel layouts and evicted in least recently used order.
+class ChannelRemixPlanCache
+{
+
+public:
+
+	/// Creates a new @c ChannelRemixPlanCache holding at most @c capacity plans
+	explicit ChannelRemixPlanCache(size_t capacity = 8) noexcept
+	: mCapacity{capacity > 0 ? capacity : 1}
+	{}
+
+	// This class is non-copyable
+	ChannelRemixPlanCache(const ChannelRemixPlanCache&) = delete;
+
+	// This class is non-assignable
+	ChannelRemixPlanCache& operator=(const ChannelRemixPlanCache&) = delete;
+
+	/// Destroys the @c ChannelRemixPlanCache
+	~ChannelRemixPlanCache() = default;
+
+	// This class is non-movable
+	ChannelRemixPlanCache(ChannelRemixPlanCache&&) = delete;
+
+	// This class is non-move assignable
+	ChannelRemixPlanCache& operator=(ChannelRemixPlanCache&&) = delete;
+
+	/// Returns a plan for remixing audio from @c inputLayout to @c outputLayout, creating it if necessary
+	/// @throw @c std::invalid_argument If either layout is empty or has no channels
+	/// @throw @c std::system_error If the mixing matrix could not be determined
+	/// @throw @c std::bad_alloc
+	std::shared_ptr<const ChannelRemixPlan> Plan(const CAChannelLayout& inputLayout, const CAChannelLayout& outputLayout);
+
+	/// Removes all plans from the cache
+	void RemoveAll() noexcept;
+
+private:
+
+	/// A cached plan
+	struct Entry {
+		/// The input channel layout
+		CAChannelLayout mInputLayout;
+		/// The output channel layout
+		CAChannelLayout mOutputLayout;
+		/// The plan
+		std::shared_ptr<const ChannelRemixPlan> mPlan;
+	};
+
+	/// The maximum number of cached plans
+	const size_t mCapacity;
+	/// Cached plans ordered from most to least recently used
+	std::list<Entry> mEntries;
+	/// Protects @c mEntries
+	std::mutex mMutex;
+
+};
+
+} /* namespace SFB */
@@ -0,0 +1,209 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <vector>
+
+#import <CoreAudioTypes/CoreAudioTypes.h>
+
+#import "SFBCAStreamBasicDescription.hpp"
+
+namespace SFB {
+
+/// A ring buffer supporting timestamped non-interleaved audio divided into channel groups.
+///
+/// This class is thread safe when used from one reader thread and one writer thread (single producer, single consumer model).
+///
+/// A @c GroupedCARingBuffer behaves like a collection of @c CARingBuffer objects sharing a single time bounds queue.
+/// Audio for every group is written and read in one call, and each call observes one snapshot of the buffer's
+/// time bounds, so the groups can never drift apart.
+class GroupedCARingBuffer
+{
+
+public:
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c GroupedCARingBuffer
+	/// @note @c Allocate() must be called before the object may be used.
+	GroupedCARingBuffer() noexcept = default;
+
+	// This class is non-copyable
+	GroupedCARingBuffer(const GroupedCARingBuffer&) = delete;
+
+	// This class is non-assignable
+	GroupedCARingBuffer& operator=(const GroupedCARingBuffer&) = delete;
+
+	/// Destroys the @c GroupedCARingBuffer and release all associated resources.
+	~GroupedCARingBuffer()
+	{
+		Deallocate();
+	}
+
+	// This class is non-movable
+	GroupedCARingBuffer(GroupedCARingBuffer&&) = delete;
+
+	// This class is non-move assignable
+	GroupedCARingBuffer& operator=(GroupedCARingBuffer&&) = delete;
+
+#pragma mark Buffer management
+
+	/// Allocates space for audio data.
+	///
+	/// Each channel's buffer begins on a 64-byte boundary and the distance between channel buffers is padded to avoid
+	/// cache set aliasing.
+	/// @note Only non-interleaved formats are supported.
+	/// @note All formats must have the same sample rate.
+	/// @note This method is not thread safe.
+	/// @note Capacities from 2 to 2,147,483,648 (0x80000000) frames are supported
+	/// @param formats The formats of the audio in each group that will be written to and read from this buffer.
+	/// @param capacityFrames The desired capacity, in frames
+	/// @return @c true on success, @c false on error
+	bool Allocate(const std::vector<CAStreamBasicDescription>& formats, uint32_t capacityFrames) noexcept;
+
+	/// Allocates space for audio data in @c groupCount groups sharing a format.
+	/// @note This method is not thread safe.
+	/// @param format The format of the audio in each group that will be written to and read from this buffer.
+	/// @param groupCount The number of groups
+	/// @param capacityFrames The desired capacity, in frames
+	/// @return @c true on success, @c false on error
+	bool Allocate(const CAStreamBasicDescription& format, uint32_t groupCount, uint32_t capacityFrames) noexcept;
+
+	/// Frees the resources used by this @c GroupedCARingBuffer
+	/// @note This method is not thread safe.
+	void Deallocate() noexcept;
+
+
+	/// Returns the capacity in frames of this @c GroupedCARingBuffer
+	uint32_t CapacityFrames() const noexcept
+	{
+		return mCapacityFrames;
+	}
+
+	/// Returns the number of groups in this @c GroupedCARingBuffer
+	uint32_t GroupCount() const noexcept
+	{
+		return static_cast<uint32_t>(mGroups.size());
+	}
+
+	/// Returns the format of the specified group
+	/// @param group The group index, which must be less than @c GroupCount()
+	const CAStreamBasicDescription& Format(uint32_t group) const noexcept
+	{
+		return mGroups[group].mFormat;
+	}
+
+	/// Gets the time bounds of the audio contained in this @c GroupedCARingBuffer
+	/// @param startTime The starting sample time of audio contained in the buffer
+	/// @param endTime The end sample time of audio contained in the buffer
+	/// @return @c true on success, @c false on error
+	bool GetTimeBounds(int64_t& startTime, int64_t& endTime) const noexcept;
+
+#pragma mark Reading and writing audio
+
+	/// Reads audio for all groups from the @c GroupedCARingBuffer
+	///
+	/// Portions of the requested range outside the buffer's time bounds are filled with silence.
+	/// @note Negative time stamps are not supported
+	/// @param bufferLists An array of @c GroupCount() @c AudioBufferList pointers, in group order, to receive the audio
+	/// @param frameCount The desired number of frames to read
+	/// @param timeStamp The starting sample time
+	/// @return @c true on success, @c false on error
+	bool Read(AudioBufferList * const _Nonnull * const _Nonnull bufferLists, uint32_t frameCount, int64_t timeStamp) noexcept;
+
+	/// Writes audio for all groups to the @c GroupedCARingBuffer
+	///
+	/// The sample times should normally increase sequentially, although gaps are filled with silence. A sufficiently large
+	/// gap effectively empties the buffer before storing the new data.
+	/// @note Negative time stamps are not supported
+	/// @note If @c timeStamp is less than the previous sample time the buffer is emptied
+	/// @param bufferLists An array of @c GroupCount() @c AudioBufferList pointers, in group order, containing the audio to copy
+	/// @param frameCount The desired number of frames to write
+	/// @param timeStamp The starting sample time
+	/// @return @c true on success, @c false on error
+	bool Write(const AudioBufferList * const _Nonnull * const _Nonnull bufferLists, uint32_t frameCount, int64_t timeStamp) noexcept;
+
+protected:
+
+	/// Returns the index of @c frameNumber in the channel buffers
+	uint32_t FrameIndex(int64_t frameNumber) const noexcept
+	{
+		return static_cast<uint32_t>(static_cast<uint64_t>(frameNumber) & mCapacityFramesMask);
+	}
+
+	/// Constrains @c startRead and @c endRead to valid timestamps in the buffer
+	bool ClampTimesToBounds(int64_t& startRead, int64_t& endRead) const noexcept;
+
+	/// Returns the buffer's starting sample time
+	/// @note This should only be called from @c Write()
+	int64_t StartTime() const noexcept
+	{
+		return mTimeBoundsQueue[mTimeBoundsQueueCounter.load(std::memory_order_acquire) & sTimeBoundsQueueMask].mStartTime;
+	}
+
+	/// Returns the buffer's ending sample time
+	/// @note This should only be called from @c Write()
+	int64_t EndTime() const noexcept
+	{
+		return mTimeBoundsQueue[mTimeBoundsQueueCounter.load(std::memory_order_acquire) & sTimeBoundsQueueMask].mEndTime;
+	}
+
+	/// Sets the buffer's start and end sample times
+	/// @note This should only be called from @c Write()
+	void SetTimeBounds(int64_t startTime, int64_t endTime) noexcept;
+
+private:
+
+	/// A group of channels sharing a format
+	struct Group {
+		/// The format of the audio in the group
+		CAStreamBasicDescription mFormat;
+		/// The channel pointers for the group
+		void * _Nonnull * _Nonnull mBuffers;
+	};
+
+	/// The channel groups
+	std::vector<Group> mGroups;
+
+	/// The channel pointers and buffers for all groups allocated in one chunk of memory
+	void * _Nullable mAllocation = nullptr;
+
+	/// The frame capacity per channel
+	uint32_t mCapacityFrames = 0;
+	/// Mask used to wrap read and write locations
+	/// @note Equal to @c mCapacityFrames-1
+	uint32_t mCapacityFramesMask = 0;
+
+	/// A range of valid sample times in the buffer
+	struct TimeBounds {
+		/// The starting sample time
+		int64_t mStartTime = 0;
+		/// The ending sample time
+		int64_t mEndTime = 0;
+		/// The value of @c mTimeBoundsQueueCounter when the struct was modified
+		std::atomic_uint64_t mUpdateCounter = 0;
+
+		static_assert(std::atomic_uint64_t::is_always_lock_free, "Lock-free std::atomic_uint64_t required");
+	};
+
+	/// The number of elements in @c mTimeBoundsQueue
+	static const uint32_t sTimeBoundsQueueSize = 32;
+	/// Mask value used to wrap time bounds counters
+	/// @note Equal to @c sTimeBoundsQueueSize-1
+	static const uint32_t sTimeBoundsQueueMask = sTimeBoundsQueueSize - 1;
+
+	/// Array of @c TimeBounds structs
+	TimeBounds mTimeBoundsQueue[sTimeBoundsQueueSize];
+	/// Monotonically increasing counter incremented when the buffer's time bounds changes
+	std::atomic_uint64_t mTimeBoundsQueueCounter = 0;
+
+	static_assert(std::atomic_uint64_t::is_always_lock_free, "Lock-free std::atomic_uint64_t required");
+
+};
+
+} /* namespace SFB */
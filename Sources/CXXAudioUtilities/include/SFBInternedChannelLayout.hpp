@@ -0,0 +1,166 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <cstddef>
+#import <functional>
+
+#import <CoreAudioTypes/CoreAudioTypes.h>
+
+#import "SFBCAChannelLayout.hpp"
+
+namespace SFB {
+
+/// A handle to an immutable, process-wide shared copy of a channel layout
+///
+/// Interning a channel layout looks it up by a precomputed hash in a global table and adds it only if no identical
+/// layout is present. All handles to identical layouts then refer to the same allocation, so copying a handle is a
+/// pointer copy and equality is a pointer comparison. Interned layouts are never deallocated, which suits the small
+/// number of distinct layouts typically in use.
+///
+/// Layouts are identical if their @c AudioChannelLayout structures are bitwise equal. This is stricter than
+/// @c CAChannelLayout::operator==, which also considers layouts described differently but containing the same channels
+/// to be equal.
+///
+/// @code
+/// auto layout = SFB::InternedChannelLayout::Intern(file.FileChannelLayout());
+/// if(layout == SFB::InternedChannelLayout::Intern(SFB::CAChannelLayout::Stereo))
+///     // ...
+/// @endcode
+class InternedChannelLayout
+{
+
+public:
+
+#pragma mark Interning
+
+	/// Returns the interned copy of @c channelLayout
+	/// @param channelLayout The channel layout to intern or @c nullptr for an empty layout
+	/// @return An @c InternedChannelLayout
+	/// @throw @c std::bad_alloc
+	static InternedChannelLayout Intern(const AudioChannelLayout * _Nullable channelLayout);
+
+	/// Returns the interned copy of @c channelLayout
+	/// @param channelLayout The channel layout to intern
+	/// @return An @c InternedChannelLayout
+	/// @throw @c std::bad_alloc
+	static InternedChannelLayout Intern(const CAChannelLayout& channelLayout)
+	{
+		return Intern(channelLayout.ChannelLayout());
+	}
+
+	/// Returns the number of distinct interned layouts
+	static size_t InternedCount() noexcept;
+
+#pragma mark Creation and Destruction
+
+	/// Creates an empty @c InternedChannelLayout
+	constexpr InternedChannelLayout() noexcept = default;
+
+	/// Copy constructor
+	constexpr InternedChannelLayout(const InternedChannelLayout& rhs) noexcept = default;
+
+	/// Assignment operator
+	constexpr InternedChannelLayout& operator=(const InternedChannelLayout& rhs) noexcept = default;
+
+	/// Destructor
+	~InternedChannelLayout() = default;
+
+#pragma mark Comparison
+
+	/// Returns @c true if @c rhs is identical to @c this
+	bool operator==(const InternedChannelLayout& rhs) const noexcept
+	{
+		return mEntry == rhs.mEntry;
+	}
+
+	/// Returns @c true if @c rhs is not identical to @c this
+	bool operator!=(const InternedChannelLayout& rhs) const noexcept
+	{
+		return mEntry != rhs.mEntry;
+	}
+
+#pragma mark Properties
+
+	/// Returns @c true if the layout is not empty
+	explicit operator bool() const noexcept
+	{
+		return mEntry != nullptr;
+	}
+
+	/// Returns the layout's hash
+	size_t Hash() const noexcept
+	{
+		return mEntry ? mEntry->mHash : 0;
+	}
+
+	/// Returns the number of channels in the layout
+	UInt32 ChannelCount() const noexcept
+	{
+		return mEntry ? mEntry->mChannelCount : 0;
+	}
+
+	/// Returns the interned layout
+	const CAChannelLayout& Layout() const noexcept
+	{
+		return mEntry ? mEntry->mLayout : sEmptyLayout;
+	}
+
+	/// Returns the interned @c AudioChannelLayout or @c nullptr if empty
+	const AudioChannelLayout * _Nullable ChannelLayout() const noexcept
+	{
+		return mEntry ? mEntry->mLayout.ChannelLayout() : nullptr;
+	}
+
+	/// Returns the interned @c AudioChannelLayout or @c nullptr if empty
+	operator const AudioChannelLayout * _Nullable () const noexcept
+	{
+		return ChannelLayout();
+	}
+
+private:
+
+	/// An interned layout
+	struct Entry {
+		/// The layout
+		const CAChannelLayout mLayout;
+		/// The hash of @c mLayout
+		const size_t mHash;
+		/// The number of channels in @c mLayout
+		const UInt32 mChannelCount;
+	};
+
+	/// The global table of interned layouts
+	struct Table;
+
+	/// Creates an @c InternedChannelLayout referring to @c entry
+	explicit constexpr InternedChannelLayout(const Entry * _Nullable entry) noexcept
+	: mEntry{entry}
+	{}
+
+	/// The empty layout
+	static inline const CAChannelLayout sEmptyLayout;
+
+	/// The interned layout or @c nullptr if empty
+	const Entry * _Nullable mEntry = nullptr;
+
+};
+
+} /* namespace SFB */
+
+namespace std {
+
+/// Hash support for @c SFB::InternedChannelLayout
+template <> struct hash<SFB::InternedChannelLayout>
+{
+	size_t operator()(const SFB::InternedChannelLayout& layout) const noexcept
+	{
+		return layout.Hash();
+	}
+};
+
+} /* namespace std */
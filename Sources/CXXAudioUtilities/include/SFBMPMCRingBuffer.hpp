@@ -0,0 +1,266 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <cstddef>
+#import <cstring>
+#import <optional>
+#import <type_traits>
+
+namespace SFB {
+
+/// A lock-free bounded ring buffer of records.
+///
+/// This class is thread safe when used from any number of reader and writer threads (multiple producer, multiple consumer model).
+///
+/// Each write stores one record and each read removes one record. Records may be of differing sizes up to the
+/// maximum record size specified when the buffer is allocated.
+///
+/// Every slot carries a sequence number which indicates whether the slot is free for writing or contains a record
+/// ready for reading. Writers claim a slot by atomically advancing the write position, store their record, and publish
+/// it by updating the slot's sequence number; readers do the same with the read position. A thread never waits for
+/// another thread: if a slot cannot be claimed because the buffer is full or empty the operation fails immediately.
+class MPMCRingBuffer
+{
+
+public:
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c MPMCRingBuffer
+	/// @note @c Allocate() must be called before the object may be used.
+	constexpr MPMCRingBuffer() noexcept = default;
+
+	// This class is non-copyable
+	MPMCRingBuffer(const MPMCRingBuffer&) = delete;
+
+	// This class is non-assignable
+	MPMCRingBuffer& operator=(const MPMCRingBuffer&) = delete;
+
+	/// Destroys the @c MPMCRingBuffer and releases all associated resources.
+	~MPMCRingBuffer()
+	{
+		Deallocate();
+	}
+
+	// This class is non-movable
+	MPMCRingBuffer(MPMCRingBuffer&&) = delete;
+
+	// This class is non-move assignable
+	MPMCRingBuffer& operator=(MPMCRingBuffer&&) = delete;
+
+#pragma mark Buffer Management
+
+	/// Allocates space for records.
+	/// @attention This method is not thread safe.
+	/// @note Capacities from 2 to 2,147,483,648 (0x80000000) records are supported
+	/// @param maximumRecordSize The maximum size of a single record, in bytes
+	/// @param recordCount The desired capacity, in records
+	/// @return @c true on success, @c false on error
+	bool Allocate(uint32_t maximumRecordSize, uint32_t recordCount) noexcept;
+
+	/// Frees the resources used by this @c MPMCRingBuffer.
+	/// @attention This method is not thread safe.
+	void Deallocate() noexcept;
+
+
+	/// Resets this @c MPMCRingBuffer to its default state, discarding all records.
+	/// @attention This method is not thread safe.
+	void Reset() noexcept;
+
+#pragma mark Buffer Information
+
+	/// Returns the capacity of this @c MPMCRingBuffer in records.
+	constexpr uint32_t CapacityRecords() const noexcept
+	{
+		return mCapacityRecords;
+	}
+
+	/// Returns the maximum size of a single record in bytes.
+	constexpr uint32_t MaximumRecordSize() const noexcept
+	{
+		return mMaximumRecordSize;
+	}
+
+	/// Returns the approximate number of records available for reading.
+	/// @note The value may be out of date by the time it is returned if other threads are reading or writing
+	uint32_t RecordsAvailableToRead() const noexcept;
+
+	/// Returns the approximate number of records that may be written.
+	/// @note The value may be out of date by the time it is returned if other threads are reading or writing
+	uint32_t RecordsAvailableToWrite() const noexcept;
+
+#pragma mark Reading and Writing Data
+
+	/// Reads a record from the @c MPMCRingBuffer.
+	///
+	/// If the next record is larger than @c byteCount the record is not read.
+	/// @param destinationBuffer An address to receive the record
+	/// @param byteCount The capacity of @c destinationBuffer in bytes
+	/// @return The size of the record in bytes, or @c 0 if no record was read
+	uint32_t Read(void * const _Nonnull destinationBuffer, uint32_t byteCount) noexcept
+	{
+		return ReadRecord(destinationBuffer, byteCount, false);
+	}
+
+	/// Writes a record to the @c MPMCRingBuffer.
+	/// @param sourceBuffer An address containing the record to copy
+	/// @param byteCount The size of the record in bytes
+	/// @return @c true if the record was written, @c false if the buffer is full or @c byteCount exceeds the maximum record size
+	bool Write(const void * const _Nonnull sourceBuffer, uint32_t byteCount) noexcept;
+
+#pragma mark Reading and Writing Types
+
+	/// Reads a record containing a value from the @c MPMCRingBuffer.
+	/// @note The record is only read if its size is @c sizeof(T)
+	/// @tparam T The type to read
+	/// @param value The destination value
+	/// @return @c true on success, @c false otherwise
+	template <typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+	bool ReadValue(T& value) noexcept
+	{
+		const auto size = static_cast<uint32_t>(sizeof(T));
+		return ReadRecord(static_cast<void *>(&value), size, true) == size;
+	}
+
+	/// Reads a record containing values from the @c MPMCRingBuffer.
+	/// @note The record is only read if its size is the sum of the sizes of @c args
+	/// @tparam Args The types to read
+	/// @param args The destination values
+	/// @return @c true if the values were successfully read
+	template <typename... Args, typename = std::enable_if_t<std::conjunction_v<std::is_trivially_copyable<Args>...>>>
+	bool ReadValues(Args&... args) noexcept
+	{
+		constexpr auto totalSize = static_cast<uint32_t>((sizeof(args) + ...));
+
+		unsigned char record [totalSize];
+		if(ReadRecord(record, totalSize, true) != totalSize)
+			return false;
+
+		uint32_t bytesRead = 0;
+		([&]
+		 {
+			std::memcpy(static_cast<void *>(&args), record + bytesRead, sizeof(args));
+			bytesRead += static_cast<uint32_t>(sizeof(args));
+		}(), ...);
+
+		return true;
+	}
+
+	/// Reads a record containing a value from the @c MPMCRingBuffer.
+	/// @note The record is only read if its size is @c sizeof(T)
+	/// @tparam T The type to read
+	/// @return A @c std::optional containing an instance of @c T if a record of the correct size was available for reading
+	template <typename T, typename = std::enable_if_t<std::is_default_constructible_v<T>>>
+	std::optional<T> ReadValue() noexcept(std::is_nothrow_default_constructible_v<T>)
+	{
+		T value{};
+		if(!ReadValue(value))
+			return std::nullopt;
+		return value;
+	}
+
+	/// Writes a record containing a value to the @c MPMCRingBuffer.
+	/// @tparam T The type to write
+	/// @param value The value to write
+	/// @return @c true if @c value was successfully written
+	template <typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+	bool WriteValue(const T& value) noexcept
+	{
+		return Write(static_cast<const void *>(&value), static_cast<uint32_t>(sizeof(T)));
+	}
+
+	/// Writes a record containing values to the @c MPMCRingBuffer.
+	/// @tparam Args The types to write
+	/// @param args The values to write
+	/// @return @c true if the values were successfully written
+	template <typename... Args, typename = std::enable_if_t<std::conjunction_v<std::is_trivially_copyable<Args>...>>>
+	bool WriteValues(const Args&... args) noexcept
+	{
+		constexpr auto totalSize = static_cast<uint32_t>((sizeof(args) + ...));
+
+		unsigned char record [totalSize];
+
+		uint32_t bytesWritten = 0;
+		([&]
+		 {
+			std::memcpy(record + bytesWritten, static_cast<const void *>(&args), sizeof(args));
+			bytesWritten += static_cast<uint32_t>(sizeof(args));
+		}(), ...);
+
+		return Write(record, totalSize);
+	}
+
+private:
+
+	/// Reads a record from the @c MPMCRingBuffer.
+	/// @param destinationBuffer An address to receive the record
+	/// @param byteCount The capacity of @c destinationBuffer in bytes
+	/// @param exactSize Whether the record must be exactly @c byteCount bytes
+	/// @return The size of the record in bytes, or @c 0 if no record was read
+	uint32_t ReadRecord(void * const _Nonnull destinationBuffer, uint32_t byteCount, bool exactSize) noexcept;
+
+	/// The assumed size of a cache line in bytes
+#if defined(__arm64__) || defined(__aarch64__)
+	static constexpr size_t sCacheLineSize = 128;
+#else
+	static constexpr size_t sCacheLineSize = 64;
+#endif /* defined(__arm64__) || defined(__aarch64__) */
+
+	/// A slot in the buffer, immediately followed in memory by the record data
+	struct Slot {
+		/// The slot's sequence number
+		///
+		/// A slot at index @c i is free for writing at write position @c p when its sequence number is @c p,
+		/// and contains a record for reading at read position @c p when its sequence number is @c p+1
+		std::atomic_uint64_t mSequence = 0;
+		/// The size of the record in bytes
+		/// @note Readers examine the size before claiming the slot, possibly while it is being rewritten
+		std::atomic_uint32_t mRecordSize = 0;
+
+		static_assert(std::atomic_uint64_t::is_always_lock_free, "Lock-free std::atomic_uint64_t required");
+		static_assert(std::atomic_uint32_t::is_always_lock_free, "Lock-free std::atomic_uint32_t required");
+	};
+
+	/// Returns the slot at @c position
+	Slot * _Nonnull SlotAtPosition(uint64_t position) const noexcept
+	{
+		return reinterpret_cast<Slot *>(reinterpret_cast<uintptr_t>(mSlots) + ((position & mCapacityRecordsMask) * mSlotStride));
+	}
+
+	/// Returns the record data for @c slot
+	static void * _Nonnull RecordData(Slot * const _Nonnull slot) noexcept
+	{
+		return reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(slot) + sizeof(Slot));
+	}
+
+	/// The slots and their record data
+	void * _Nullable mSlots = nullptr;
+
+	/// The distance in bytes between consecutive slots
+	size_t mSlotStride = 0;
+
+	/// The capacity of @c mSlots in records
+	uint32_t mCapacityRecords = 0;
+	/// The capacity of @c mSlots in records minus one
+	uint32_t mCapacityRecordsMask = 0;
+
+	/// The maximum size of a single record in bytes
+	uint32_t mMaximumRecordSize = 0;
+
+	/// The position of the next slot to be claimed for writing
+	alignas(sCacheLineSize) std::atomic_uint64_t mWritePosition = 0;
+
+	/// The position of the next slot to be claimed for reading
+	alignas(sCacheLineSize) std::atomic_uint64_t mReadPosition = 0;
+
+	static_assert(std::atomic_uint64_t::is_always_lock_free, "Lock-free std::atomic_uint64_t required");
+
+};
+
+} /* namespace SFB */
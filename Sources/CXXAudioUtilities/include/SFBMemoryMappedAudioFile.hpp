@@ -0,0 +1,196 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <cstddef>
+#import <utility>
+
+#import <AudioToolbox/AudioFile.h>
+#import <CoreFoundation/CoreFoundation.h>
+
+#import "SFBCAStreamBasicDescription.hpp"
+
+CF_ASSUME_NONNULL_BEGIN
+
+namespace SFB {
+
+/// A class providing zero-copy access to the audio in an uncompressed WAVE, AIFF, AIFF-C, or CAF file
+///
+/// The file is mapped into memory read-only and its container header is parsed with @c ByteStream. Audio is exposed
+/// in the file's own interleaved PCM format, including its byte order, as pointers into the mapping. Access to any
+/// frame is a pointer calculation and no data is copied until it is touched.
+///
+/// @code
+/// SFB::MemoryMappedAudioFile file;
+/// file.OpenURL(url);
+/// file.SetAccessPattern(SFB::MemoryMappedAudioFile::AccessPattern::sequential);
+/// auto bufferList = file.BufferList(position, 4096);
+/// @endcode
+class MemoryMappedAudioFile
+{
+
+public:
+
+	/// The expected pattern of access to the audio
+	enum class AccessPattern {
+		/// No particular pattern (@c MADV_NORMAL)
+		normal,
+		/// Frames will be accessed in increasing order (@c MADV_SEQUENTIAL)
+		sequential,
+		/// Frames will be accessed in no particular order (@c MADV_RANDOM)
+		random,
+	};
+
+#pragma mark Creation and Destruction
+
+	/// Creates an empty @c MemoryMappedAudioFile
+	constexpr MemoryMappedAudioFile() noexcept = default;
+
+	// This class is non-copyable
+	MemoryMappedAudioFile(const MemoryMappedAudioFile&) = delete;
+
+	// This class is non-assignable
+	MemoryMappedAudioFile& operator=(const MemoryMappedAudioFile&) = delete;
+
+	/// Unmaps the file and destroys the @c MemoryMappedAudioFile
+	~MemoryMappedAudioFile()
+	{
+		Close();
+	}
+
+	/// Move constructor
+	MemoryMappedAudioFile(MemoryMappedAudioFile&& rhs) noexcept
+	: mMapping{std::exchange(rhs.mMapping, nullptr)}, mMappingLength{std::exchange(rhs.mMappingLength, 0)}, mAudioData{std::exchange(rhs.mAudioData, nullptr)}, mFrameLength{std::exchange(rhs.mFrameLength, 0)}, mFormat{rhs.mFormat}, mFileType{std::exchange(rhs.mFileType, 0)}
+	{}
+
+	/// Move assignment operator
+	MemoryMappedAudioFile& operator=(MemoryMappedAudioFile&& rhs) noexcept
+	{
+		if(this != &rhs) {
+			Close();
+			mMapping = std::exchange(rhs.mMapping, nullptr);
+			mMappingLength = std::exchange(rhs.mMappingLength, 0);
+			mAudioData = std::exchange(rhs.mAudioData, nullptr);
+			mFrameLength = std::exchange(rhs.mFrameLength, 0);
+			mFormat = rhs.mFormat;
+			mFileType = std::exchange(rhs.mFileType, 0);
+		}
+		return *this;
+	}
+
+#pragma mark Opening and Closing
+
+	/// Maps the file at @c url and parses its header
+	/// @param url The URL of the file to open
+	/// @throw @c std::invalid_argument If @c url is not a file URL
+	/// @throw @c std::system_error If the file could not be opened or mapped
+	/// @throw @c std::runtime_error If the file is not an uncompressed WAVE, AIFF, AIFF-C, or CAF file
+	void OpenURL(CFURLRef url);
+
+	/// Maps the file at @c path and parses its header
+	/// @param path The path of the file to open
+	/// @throw @c std::system_error If the file could not be opened or mapped
+	/// @throw @c std::runtime_error If the file is not an uncompressed WAVE, AIFF, AIFF-C, or CAF file
+	void Open(const char *path);
+
+	/// Unmaps the file
+	void Close() noexcept;
+
+	/// Returns @c true if a file is mapped
+	explicit operator bool() const noexcept
+	{
+		return mMapping != nullptr;
+	}
+
+	/// Returns @c true if a file is mapped
+	bool IsOpen() const noexcept
+	{
+		return mMapping != nullptr;
+	}
+
+#pragma mark Properties
+
+	/// Returns the file's type (@c kAudioFileWAVEType, @c kAudioFileAIFFType, @c kAudioFileAIFCType, or @c kAudioFileCAFType)
+	AudioFileTypeID FileType() const noexcept
+	{
+		return mFileType;
+	}
+
+	/// Returns the format of the audio in the file
+	/// @note The format is interleaved and may be non-native-endian
+	const CAStreamBasicDescription& Format() const noexcept
+	{
+		return mFormat;
+	}
+
+	/// Returns the number of frames in the file
+	SInt64 FrameLength() const noexcept
+	{
+		return mFrameLength;
+	}
+
+#pragma mark Audio Access
+
+	/// Returns a pointer to the audio for @c frame or @c nullptr if @c frame is out of range
+	const void * _Nullable FrameData(SInt64 frame) const noexcept
+	{
+		if(frame < 0 || frame >= mFrameLength)
+			return nullptr;
+		return reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(mAudioData) + static_cast<uintptr_t>(frame) * mFormat.mBytesPerFrame);
+	}
+
+	/// Returns a single-buffer @c AudioBufferList referencing audio in the mapping
+	///
+	/// The buffer list is empty if @c frame is out of range and is truncated at the end of the file otherwise.
+	/// @note The buffer list refers to read-only memory that is valid until the file is closed
+	/// @param frame The first frame
+	/// @param frameCount The desired number of frames
+	/// @return An @c AudioBufferList referencing the audio
+	AudioBufferList BufferList(SInt64 frame, UInt32 frameCount) const noexcept;
+
+	/// Returns the number of frames in an @c AudioBufferList returned by @c BufferList()
+	UInt32 FrameCount(const AudioBufferList& bufferList) const noexcept
+	{
+		return mFormat.mBytesPerFrame > 0 ? bufferList.mBuffers[0].mDataByteSize / mFormat.mBytesPerFrame : 0;
+	}
+
+#pragma mark Paging Hints
+
+	/// Advises the kernel of the expected pattern of access to the audio
+	/// @param pattern The expected access pattern
+	/// @return @c true on success, @c false otherwise
+	bool SetAccessPattern(AccessPattern pattern) noexcept;
+
+	/// Advises the kernel that frames will be accessed soon so they may be read ahead (@c MADV_WILLNEED)
+	/// @param frame The first frame
+	/// @param frameCount The number of frames
+	/// @return @c true on success, @c false otherwise
+	bool WillNeed(SInt64 frame, SInt64 frameCount) noexcept;
+
+private:
+
+	/// Advises the kernel about the pages containing a range of bytes in the mapping
+	bool Advise(size_t offset, size_t length, int advice) noexcept;
+
+	/// The mapped file
+	void * _Nullable mMapping = nullptr;
+	/// The length of the mapping in bytes
+	size_t mMappingLength = 0;
+	/// The first audio frame in the mapping
+	const void * _Nullable mAudioData = nullptr;
+	/// The number of audio frames
+	SInt64 mFrameLength = 0;
+	/// The format of the audio
+	CAStreamBasicDescription mFormat;
+	/// The file's type
+	AudioFileTypeID mFileType = 0;
+
+};
+
+} /* namespace SFB */
+
+CF_ASSUME_NONNULL_END
@@ -0,0 +1,188 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <functional>
+#import <vector>
+
+#import <CoreFoundation/CoreFoundation.h>
+
+#import "SFBCAAudioFile.hpp"
+#import "SFBCABufferList.hpp"
+#import "SFBCAStreamBasicDescription.hpp"
+#import "SFBCFWrapper.hpp"
+
+CF_ASSUME_NONNULL_BEGIN
+
+namespace SFB {
+
+/// A class that decodes one audio file on several threads
+///
+/// The file's packets are divided into independent ranges, each decoded on its own thread with its own
+/// @c CAAudioFile and @c CAAudioConverter. Each range is preceded by enough packets to prime the decoder at the range
+/// boundary; the audio decoded from these packets is discarded. Priming and remainder frames from the file's packet
+/// table are removed so the output is identical to a sequential decode of the file's valid frames.
+///
+/// The file's format must have a constant number of frames per packet.
+///
+/// @code
+/// SFB::ParallelAudioFileDecoder decoder(url);
+/// const SFB::CAStreamBasicDescription format{SFB::CommonPCMFormat::float32, decoder.FileDataFormat().mSampleRate, decoder.FileDataFormat().ChannelCount(), false};
+/// decoder.Decode(format, [](SInt64 framePosition, const SFB::CABufferList& buffer) {
+///     // Called concurrently from worker threads
+/// });
+/// @endcode
+class ParallelAudioFileDecoder
+{
+
+public:
+
+	/// A range of packets decoded independently
+	struct Range {
+		/// The first packet decoded, including packets decoded only to prime the decoder
+		SInt64 mStartPacket;
+		/// The number of packets decoded, including packets decoded only to prime the decoder
+		SInt64 mPacketCount;
+		/// The number of decoded frames to discard before the first frame of the range
+		SInt64 mDiscardFrames;
+		/// The position of the first frame of the range in the file's valid frames
+		SInt64 mFramePosition;
+		/// The number of frames in the range
+		SInt64 mFrameCount;
+	};
+
+	/// A function receiving decoded audio
+	/// @note This function is called concurrently from the worker threads. Within a range it is called with increasing
+	/// frame positions, but the order in which ranges are decoded is unspecified.
+	/// @param framePosition The position of the first frame of @c buffer in the file's valid frames
+	/// @param buffer The decoded audio
+	using OutputCallback = std::function<void(SInt64 framePosition, const CABufferList& buffer)>;
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c ParallelAudioFileDecoder for the file at @c url
+	/// @param url The URL of the file to decode
+	/// @throw @c std::system_error If the file could not be opened or its properties could not be determined
+	/// @throw @c std::invalid_argument If the file's format does not have a constant number of frames per packet
+	/// @throw @c std::bad_alloc
+	explicit ParallelAudioFileDecoder(CFURLRef url);
+
+	// This class is non-copyable
+	ParallelAudioFileDecoder(const ParallelAudioFileDecoder&) = delete;
+
+	// This class is non-assignable
+	ParallelAudioFileDecoder& operator=(const ParallelAudioFileDecoder&) = delete;
+
+	/// Destroys the @c ParallelAudioFileDecoder
+	~ParallelAudioFileDecoder() = default;
+
+	// This class is non-movable
+	ParallelAudioFileDecoder(ParallelAudioFileDecoder&&) = delete;
+
+	// This class is non-move assignable
+	ParallelAudioFileDecoder& operator=(ParallelAudioFileDecoder&&) = delete;
+
+#pragma mark Properties
+
+	/// Returns the file's data format
+	const CAStreamBasicDescription& FileDataFormat() const noexcept
+	{
+		return mFileDataFormat;
+	}
+
+	/// Returns the number of valid frames in the file
+	SInt64 FrameLength() const noexcept
+	{
+		return mValidFrames;
+	}
+
+	/// Returns the number of priming frames removed from the start of the decoded audio
+	SInt64 PrimingFrames() const noexcept
+	{
+		return mPrimingFrames;
+	}
+
+	/// Returns the number of remainder frames removed from the end of the decoded audio
+	SInt64 RemainderFrames() const noexcept
+	{
+		return mRemainderFrames;
+	}
+
+#pragma mark Decoding
+
+	/// Divides the file into at most @c rangeCount ranges of approximately equal length
+	/// @param rangeCount The desired number of ranges
+	/// @return Ranges in file order, whose frames are contiguous and together cover the file's valid frames
+	/// @throw @c std::system_error If the roll distance of a packet could not be determined
+	/// @throw @c std::bad_alloc
+	std::vector<Range> Ranges(size_t rangeCount) const;
+
+	/// Decodes one range
+	/// @note This method is thread safe
+	/// @param range The range to decode
+	/// @param outputFormat The desired PCM format, which must have the file's sample rate
+	/// @param callback A function receiving the decoded audio
+	/// @param bufferFrameCapacity The capacity in frames of the buffers passed to @c callback
+	/// @throw @c std::system_error If an error occurs while decoding
+	/// @throw @c std::runtime_error If the decoder produced fewer frames than expected
+	/// @throw @c std::bad_alloc
+	void Decode(const Range& range, const CAStreamBasicDescription& outputFormat, const OutputCallback& callback, UInt32 bufferFrameCapacity = 8192) const;
+
+	/// Decodes the file using multiple threads and blocks until complete
+	///
+	/// The calling thread is one of the worker threads. If decoding a range fails the remaining ranges are skipped.
+	/// @param outputFormat The desired PCM format, which must have the file's sample rate
+	/// @param callback A function receiving the decoded audio
+	/// @param threadCount The number of worker threads, or @c 0 to use one per processor
+	/// @param bufferFrameCapacity The capacity in frames of the buffers passed to @c callback
+	/// @throw @c std::invalid_argument If @c outputFormat is not PCM or the sample rates differ
+	/// @throw Any exception thrown while decoding a range
+	void Decode(const CAStreamBasicDescription& outputFormat, const OutputCallback& callback, unsigned int threadCount = 0, UInt32 bufferFrameCapacity = 8192) const;
+
+	/// Decodes the file into @c buffer using multiple threads and blocks until complete
+	/// @param buffer A buffer with the desired PCM format, which must have the file's sample rate, and a capacity of
+	/// at least @c FrameLength() frames
+	/// @param threadCount The number of worker threads, or @c 0 to use one per processor
+	/// @throw @c std::invalid_argument If @c buffer is too small, its format is not PCM, or the sample rates differ
+	/// @throw Any exception thrown while decoding a range
+	void Decode(CABufferList& buffer, unsigned int threadCount = 0) const;
+
+private:
+
+	/// The number of ranges per worker thread, for load balancing
+	static constexpr size_t sRangesPerThread = 4;
+
+	/// Returns the number of packets preceding @c packet decoded to prime the decoder
+	SInt64 PrerollPackets(SInt64 packet) const;
+
+	/// The URL of the file
+	CFURL mURL;
+	/// The file, used to determine packet roll distances
+	CAAudioFile mFile;
+	/// The file's data format
+	CAStreamBasicDescription mFileDataFormat;
+	/// The decoder magic cookie
+	std::vector<UInt8> mMagicCookie;
+	/// The number of packets in the file
+	SInt64 mPacketCount = 0;
+	/// The maximum size of a packet in bytes
+	UInt32 mPacketSizeUpperBound = 0;
+	/// Whether the file supports @c kAudioFilePropertyPacketToRollDistance
+	bool mHasRollDistance = false;
+
+	/// The number of valid frames
+	SInt64 mValidFrames = 0;
+	/// The number of priming frames
+	SInt64 mPrimingFrames = 0;
+	/// The number of remainder frames
+	SInt64 mRemainderFrames = 0;
+
+};
+
+} /* namespace SFB */
+
+CF_ASSUME_NONNULL_END
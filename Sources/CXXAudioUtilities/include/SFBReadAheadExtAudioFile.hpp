@@ -0,0 +1,217 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <thread>
+
+#import <CoreAudioTypes/CoreAudioTypes.h>
+
+#import "SFBAudioRingBuffer.hpp"
+#import "SFBCAExtAudioFile.hpp"
+#import "SFBDispatchSemaphore.hpp"
+
+CF_ASSUME_NONNULL_BEGIN
+
+namespace SFB {
+
+/// A class that decodes a @c CAExtAudioFile ahead of playback on a background thread
+///
+/// Audio is decoded in the file's client data format directly into an @c AudioRingBuffer by a worker thread owned by the
+/// object. @c Read() is wait-free and suitable for use on a realtime thread: it never blocks on disk or codec work and
+/// returns fewer frames than requested if the decoder has not kept up.
+///
+/// This class is thread safe when @c Read() is called from one thread and the remaining methods are called from one
+/// other thread.
+///
+/// @code
+/// SFB::CAExtAudioFile file;
+/// file.OpenURL(url);
+/// file.SetClientDataFormat(nonInterleavedFloatFormat);
+/// SFB::ReadAheadExtAudioFile readAhead(std::move(file), 32768);
+/// // On the render thread
+/// auto framesRead = readAhead.Read(bufferList, frameCount);
+/// @endcode
+class ReadAheadExtAudioFile
+{
+
+public:
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c ReadAheadExtAudioFile and starts decoding
+	/// @note The client data format of @c file must be non-interleaved
+	/// @param file The file to decode, which must be open for reading
+	/// @param readAheadFrames The maximum number of decoded frames to buffer ahead of the reader
+	/// @param decodeChunkFrames The number of frames decoded at a time by the worker thread
+	/// @throw @c std::invalid_argument If the client data format is interleaved or the frame counts are invalid
+	/// @throw @c std::bad_alloc If the ring buffer could not be allocated
+	/// @throw @c std::system_error If the worker thread could not be created or a file property could not be determined
+	ReadAheadExtAudioFile(CAExtAudioFile&& file, uint32_t readAheadFrames = 16384, uint32_t decodeChunkFrames = 2048);
+
+	// This class is non-copyable
+	ReadAheadExtAudioFile(const ReadAheadExtAudioFile&) = delete;
+
+	// This class is non-assignable
+	ReadAheadExtAudioFile& operator=(const ReadAheadExtAudioFile&) = delete;
+
+	/// Stops the worker thread and destroys the @c ReadAheadExtAudioFile
+	~ReadAheadExtAudioFile();
+
+	// This class is non-movable
+	ReadAheadExtAudioFile(ReadAheadExtAudioFile&&) = delete;
+
+	// This class is non-move assignable
+	ReadAheadExtAudioFile& operator=(ReadAheadExtAudioFile&&) = delete;
+
+#pragma mark Properties
+
+	/// Returns the format of the audio returned by @c Read()
+	const CAStreamBasicDescription& Format() const noexcept
+	{
+		return mRingBuffer.Format();
+	}
+
+	/// Returns the maximum number of decoded frames buffered ahead of the reader
+	uint32_t ReadAheadFrames() const noexcept
+	{
+		return mRingBuffer.CapacityFrames() - 1;
+	}
+
+	/// Returns the number of decoded frames available to @c Read() without waiting for the decoder
+	uint32_t FramesAvailableToRead() const noexcept
+	{
+		return mRingBuffer.FramesAvailableToRead();
+	}
+
+	/// Returns @c true if the decoder reached the end of the file and all decoded audio has been read
+	/// @note This method should only be called from the reader thread
+	bool IsAtEnd() const noexcept
+	{
+		return mDecoderIsFinished.load(std::memory_order_acquire) && mRingBuffer.FramesAvailableToRead() == 0 && !SeekIsPending();
+	}
+
+	/// Returns @c true if an error occurred while decoding
+	///
+	/// Decoding stops after an error and resumes after the next call to @c Seek().
+	bool DecoderErrorOccurred() const noexcept
+	{
+		return mDecoderErrorOccurred.load(std::memory_order_acquire);
+	}
+
+#pragma mark Reading
+
+	/// Reads decoded audio without blocking
+	/// @note This method should only be called from the reader thread
+	/// @param bufferList An @c AudioBufferList to receive the audio
+	/// @param frameCount The desired number of frames to read
+	/// @return The number of frames actually read, which may be less than @c frameCount if the decoder has not kept up
+	uint32_t Read(AudioBufferList * const _Nonnull bufferList, uint32_t frameCount) noexcept;
+
+	/// Returns the position of the next frame returned by @c Read() in client sample frames
+	/// @note This method should only be called from the reader thread
+	int64_t FramePosition() const noexcept
+	{
+		return mReaderFramePosition;
+	}
+
+#pragma mark Seeking
+
+	/// Requests that decoding continue from @c frame
+	///
+	/// The worker thread flushes the audio decoded for the previous position and refills the ring buffer from @c frame.
+	/// @c Read() returns zero frames from the time the seek is requested until the worker thread has performed it, and
+	/// then discards the flushed audio without copying it.
+	/// @param frame The desired position in sample frames of the file's data format
+	void Seek(int64_t frame) noexcept;
+
+private:
+
+	/// Decodes audio until @c mStopWorker is set
+	void DecoderThreadEntry() noexcept;
+
+	/// Returns @c true if a seek has been requested but not yet observed by the reader
+	bool SeekIsPending() const noexcept
+	{
+		return mSeekRequested.load(std::memory_order_acquire) || mSeekSequence.load(std::memory_order_acquire) != mReaderSeekSequence;
+	}
+
+	/// Returns @c true if the worker thread has a seek to perform, a chunk to decode, or has been asked to stop
+	bool WorkIsAvailable() const noexcept
+	{
+		if(mStopWorker.load(std::memory_order_acquire) || mSeekRequested.load(std::memory_order_acquire))
+			return true;
+		return !mDecoderIsFinished.load(std::memory_order_relaxed) && !mDecoderErrorOccurred.load(std::memory_order_relaxed) && mRingBuffer.FramesAvailableToWrite() >= mDecodeChunkFrames;
+	}
+
+	/// Signals @c mSemaphore if the worker thread is waiting on it
+	void WakeWorker() noexcept;
+
+	/// Discards audio flushed by a seek
+	/// @note This method should only be called from the reader thread
+	/// @return @c false if a seek is in progress, @c true otherwise
+	bool DiscardFlushedAudio() noexcept;
+
+	/// The file being decoded
+	CAExtAudioFile mFile;
+	/// The ratio of the client sample rate to the file sample rate
+	double mSampleRateRatio = 1;
+	/// The number of frames decoded at a time
+	const uint32_t mDecodeChunkFrames;
+
+	/// The decoded audio
+	AudioRingBuffer mRingBuffer;
+
+	/// Semaphore used to wake the worker thread
+	DispatchSemaphore mSemaphore;
+	/// Flag set by the worker thread immediately before waiting on @c mSemaphore and cleared by the thread that wakes it
+	std::atomic_bool mWorkerIsWaiting = false;
+	/// The worker thread
+	std::thread mWorker;
+	/// Flag set to stop the worker thread
+	std::atomic_bool mStopWorker = false;
+
+	/// Flag set when a seek is requested
+	std::atomic_bool mSeekRequested = false;
+	/// The requested seek position in file frames
+	std::atomic_int64_t mRequestedSeekFrame = 0;
+
+	/// Sequence number protecting @c mFlushBoundary and @c mFlushFramePosition
+	/// @note The sequence number is odd while the worker is modifying the protected values
+	std::atomic_uint64_t mSeekSequence = 0;
+	/// The total number of frames written to the ring buffer when the most recent seek was performed
+	std::atomic_uint64_t mFlushBoundary = 0;
+	/// The client frame position of the first frame written after the most recent seek
+	std::atomic_int64_t mFlushFramePosition = 0;
+
+	/// Flag set when the decoder reaches the end of the file
+	std::atomic_bool mDecoderIsFinished = false;
+	/// Flag set when the decoder encounters an error
+	std::atomic_bool mDecoderErrorOccurred = false;
+
+	/// The total number of frames written to the ring buffer
+	/// @note Only accessed from the worker thread
+	uint64_t mFramesWritten = 0;
+
+	/// The total number of frames consumed from the ring buffer, including discarded frames
+	/// @note Only accessed from the reader thread
+	uint64_t mFramesRead = 0;
+	/// The value of @c mSeekSequence most recently observed by the reader
+	/// @note Only accessed from the reader thread
+	uint64_t mReaderSeekSequence = 0;
+	/// The client frame position of the next frame returned by @c Read()
+	/// @note Only accessed from the reader thread
+	int64_t mReaderFramePosition = 0;
+
+	static_assert(std::atomic_int64_t::is_always_lock_free, "Lock-free std::atomic_int64_t required");
+	static_assert(std::atomic_uint64_t::is_always_lock_free, "Lock-free std::atomic_uint64_t required");
+
+};
+
+} /* namespace SFB */
+
+CF_ASSUME_NONNULL_END
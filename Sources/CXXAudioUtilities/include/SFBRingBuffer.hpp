@@ -1,5 +1,5 @@
 //
-// Copyright © 2014-2025 Stephen F. Booth <me@sbooth.org>
+// Copyright © 2014-2026 Stephen F. Booth <me@sbooth.org>
 // Part of https://github.com/sbooth/CXXAudioUtilities
 // MIT license
 //
@@ -8,43 +8,59 @@
 
 #import <algorithm>
 #import <atomic>
+#import <cstring>
 #import <optional>
 #import <type_traits>
 #import <utility>
 
+#import "SFBRingBufferStatistics.hpp"
+
 namespace SFB {
 
 /// A generic ring buffer.
 ///
 /// This class is thread safe when used from one reader thread and one writer thread (single producer, single consumer model).
-class RingBuffer
+///
+/// The read and write positions are kept on separate cache lines to avoid false sharing between the reader and writer.
+/// Additionally, the reader and writer each keep a cached copy of the other's position which is only refreshed
+/// when the cached value indicates insufficient data or space.
+///
+/// The buffer may optionally be allocated using virtual memory mirroring, in which the same physical pages are mapped
+/// twice at consecutive addresses. In a mirrored buffer all readable data and writable space are contiguous in memory.
+///
+/// Statistics are collected by @c Counters, which must be either @c NullRingBufferCounters or @c RingBufferCounters.
+/// This template is not used directly; use @c RingBuffer or @c InstrumentedRingBuffer instead.
+template <typename Counters>
+class BasicRingBuffer
 {
 
+	static_assert(std::is_same_v<Counters, NullRingBufferCounters> || std::is_same_v<Counters, RingBufferCounters>, "Unsupported counters type");
+
 public:
 
 #pragma mark Creation and Destruction
 
 	/// Creates a new @c RingBuffer
 	/// @note @c Allocate() must be called before the object may be used.
-	constexpr RingBuffer() noexcept = default;
+	constexpr BasicRingBuffer() noexcept = default;
 
 	// This class is non-copyable
-	RingBuffer(const RingBuffer&) = delete;
+	BasicRingBuffer(const BasicRingBuffer&) = delete;
 
 	// This class is non-assignable
-	RingBuffer& operator=(const RingBuffer&) = delete;
+	BasicRingBuffer& operator=(const BasicRingBuffer&) = delete;
 
 	/// Destroys the @c RingBuffer and releases all associated resources.
-	~RingBuffer()
+	~BasicRingBuffer()
 	{
-		std::free(mBuffer);
+		Deallocate();
 	}
 
 	// This class is non-movable
-	RingBuffer(RingBuffer&&) = delete;
+	BasicRingBuffer(BasicRingBuffer&&) = delete;
 
 	// This class is non-move assignable
-	RingBuffer& operator=(RingBuffer&&) = delete;
+	BasicRingBuffer& operator=(BasicRingBuffer&&) = delete;
 
 #pragma mark Buffer Management
 
@@ -55,6 +71,17 @@ public:
 	/// @return @c true on success, @c false on error
 	bool Allocate(uint32_t byteCount) noexcept;
 
+	/// Allocates space for data using virtual memory mirroring.
+	///
+	/// The buffer's pages are mapped twice, back to back, so that any read or write window is a single contiguous span
+	/// and @c ReadVector() and @c WriteVector() never return a second buffer.
+	/// @attention This method is not thread safe.
+	/// @note The capacity is rounded up to a power of two that is a multiple of the virtual memory page size
+	/// @note Capacities from 2 to 2,147,483,648 (0x80000000) bytes are supported
+	/// @param byteCount The desired capacity, in bytes
+	/// @return @c true on success, @c false on error
+	bool AllocateMirrored(uint32_t byteCount) noexcept;
+
 	/// Frees the resources used by this @c RingBuffer.
 	/// @attention This method is not thread safe.
 	void Deallocate() noexcept;
@@ -72,10 +99,18 @@ public:
 		return mCapacityBytes;
 	}
 
+	/// Returns @c true if this @c RingBuffer was allocated using virtual memory mirroring
+	constexpr bool IsMirrored() const noexcept
+	{
+		return mIsMirrored;
+	}
+
 	/// Returns the number of bytes available for reading.
+	/// @note This method may be called from any thread and always loads both the read and write positions
 	uint32_t BytesAvailableToRead() const noexcept;
 
 	/// Returns the free space available for writing in bytes.
+	/// @note This method may be called from any thread and always loads both the read and write positions
 	uint32_t BytesAvailableToWrite() const noexcept;
 
 #pragma mark Reading and Writing Data
@@ -125,13 +160,31 @@ public:
 		const auto totalSize = static_cast<uint32_t>((sizeof(args) + ...));
 
 		const auto rvec = ReadVector();
+		const auto bytesAvailable = rvec.first.mBufferSize + rvec.second.mBufferSize;
+
+		mCounters.RecordRead(totalSize, bytesAvailable, false);
 
 		// Don't read anything if there is insufficient data
-		if(rvec.first.mBufferSize + rvec.second.mBufferSize < totalSize)
+		if(bytesAvailable < totalSize)
 			return false;
 
 		uint32_t bytesRead = 0;
 
+		// Copy directly when the values are contiguous, which is always the case for a mirrored buffer
+		if(rvec.first.mBufferSize >= totalSize) {
+			([&]
+			 {
+				std::memcpy(static_cast<void *>(&args),
+							reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(rvec.first.mBuffer) + bytesRead),
+							sizeof(args));
+				bytesRead += static_cast<uint32_t>(sizeof(args));
+			}(), ...);
+
+			AdvanceReadPosition(bytesRead);
+
+			return true;
+		}
+
 		([&]
 		 {
 			auto bytesRemaining = static_cast<uint32_t>(sizeof(args));
@@ -148,7 +201,7 @@ public:
 			// Read from rvec.second
 			if(bytesRemaining > 0){
 				const auto n = bytesRemaining;
-				std::memcpy(static_cast<void *>(&args),
+				std::memcpy(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(&args) + (sizeof(args) - bytesRemaining)),
 							reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(rvec.second.mBuffer) + (bytesRead - rvec.first.mBufferSize)),
 							n);
 				bytesRead += n;
@@ -218,13 +271,31 @@ public:
 		const auto totalSize = static_cast<uint32_t>((sizeof(args) + ...));
 
 		auto wvec = WriteVector();
+		const auto bytesAvailable = wvec.first.mBufferCapacity + wvec.second.mBufferCapacity;
+
+		mCounters.RecordWrite(totalSize, bytesAvailable, false, mCapacityBytesMask - bytesAvailable + (bytesAvailable < totalSize ? 0 : totalSize));
 
 		// Don't write anything if there is insufficient space
-		if(wvec.first.mBufferCapacity + wvec.second.mBufferCapacity < totalSize)
+		if(bytesAvailable < totalSize)
 			return false;
 
 		uint32_t bytesWritten = 0;
 
+		// Copy directly when the space is contiguous, which is always the case for a mirrored buffer
+		if(wvec.first.mBufferCapacity >= totalSize) {
+			([&]
+			 {
+				std::memcpy(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(wvec.first.mBuffer) + bytesWritten),
+							static_cast<const void *>(&args),
+							sizeof(args));
+				bytesWritten += static_cast<uint32_t>(sizeof(args));
+			}(), ...);
+
+			AdvanceWritePosition(bytesWritten);
+
+			return true;
+		}
+
 		([&]
 		 {
 			auto bytesRemaining = static_cast<uint32_t>(sizeof(args));
@@ -242,7 +313,7 @@ public:
 			if(bytesRemaining > 0){
 				const auto n = bytesRemaining;
 				std::memcpy(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(wvec.second.mBuffer) + (bytesWritten - wvec.first.mBufferCapacity)),
-							static_cast<const void *>(&args),
+							reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(&args) + (sizeof(args) - bytesRemaining)),
 							n);
 				bytesWritten += n;
 			}
@@ -256,9 +327,11 @@ public:
 #pragma mark Advanced Reading and Writing
 
 	/// Advances the read position by the specified number of bytes.
+	/// @note This method should only be called from the reader thread
 	void AdvanceReadPosition(uint32_t byteCount) noexcept;
 
 	/// Advances the write position by the specified number of bytes.
+	/// @note This method should only be called from the writer thread
 	void AdvanceWritePosition(uint32_t byteCount) noexcept;
 
 
@@ -270,7 +343,7 @@ public:
 		const uint32_t mBufferSize = 0;
 
 	private:
-		friend class RingBuffer;
+		friend class BasicRingBuffer;
 
 		/// Construct an empty @c ReadBuffer
 		ReadBuffer() noexcept = default;
@@ -287,6 +360,8 @@ public:
 	using ReadBufferPair = std::pair<const ReadBuffer, const ReadBuffer>;
 
 	/// Returns the read vector containing the current readable data.
+	/// @note For a mirrored buffer the second @c ReadBuffer is always empty
+	/// @note This method should only be called from the reader thread
 	const ReadBufferPair ReadVector() const noexcept;
 
 
@@ -298,7 +373,7 @@ public:
 		const uint32_t mBufferCapacity = 0;
 
 	private:
-		friend class RingBuffer;
+		friend class BasicRingBuffer;
 
 		/// Construct an empty @c WriteBuffer
 		WriteBuffer() noexcept = default;
@@ -315,10 +390,36 @@ public:
 	using WriteBufferPair = std::pair<const WriteBuffer, const WriteBuffer>;
 
 	/// Returns the write vector containing the current writable space.
+	/// @note For a mirrored buffer the second @c WriteBuffer is always empty
+	/// @note This method should only be called from the writer thread
 	const WriteBufferPair WriteVector() const noexcept;
 
+#pragma mark Statistics
+
+	/// Returns a snapshot of the statistics collected by this @c RingBuffer
+	/// @note Statistics are only collected when @c Counters is @c RingBufferCounters
+	/// @note This method may be called from any thread
+	RingBufferStatistics Statistics() const noexcept
+	{
+		return mCounters.Snapshot();
+	}
+
+	/// Resets the statistics collected by this @c RingBuffer
+	/// @note This method should not be called while the buffer is being read or written
+	void ResetStatistics() noexcept
+	{
+		mCounters.Reset();
+	}
+
 private:
 
+	/// The assumed size of a cache line in bytes
+#if defined(__arm64__) || defined(__aarch64__)
+	static constexpr size_t sCacheLineSize = 128;
+#else
+	static constexpr size_t sCacheLineSize = 64;
+#endif /* defined(__arm64__) || defined(__aarch64__) */
+
 	/// The memory buffer holding the data
 	void * _Nullable mBuffer = nullptr;
 
@@ -326,14 +427,33 @@ private:
 	uint32_t mCapacityBytes = 0;
 	/// The capacity of @c mBuffer in bytes minus one
 	uint32_t mCapacityBytesMask = 0;
+	/// Whether @c mBuffer is mapped twice in consecutive virtual memory
+	bool mIsMirrored = false;
 
-	/// The offset into @c mBuffer of the read location
-	std::atomic_uint32_t mWritePosition = 0;
 	/// The offset into @c mBuffer of the write location
-	std::atomic_uint32_t mReadPosition = 0;
+	alignas(sCacheLineSize) std::atomic_uint32_t mWritePosition = 0;
+	/// The writer's cached copy of @c mReadPosition
+	mutable uint32_t mCachedReadPosition = 0;
+
+	/// The offset into @c mBuffer of the read location
+	alignas(sCacheLineSize) std::atomic_uint32_t mReadPosition = 0;
+	/// The reader's cached copy of @c mWritePosition
+	mutable uint32_t mCachedWritePosition = 0;
+
+	/// Statistics counters
+	mutable Counters mCounters;
 
 	static_assert(std::atomic_uint32_t::is_always_lock_free, "Lock-free std::atomic_uint32_t required");
 
 };
 
+extern template class BasicRingBuffer<NullRingBufferCounters>;
+extern template class BasicRingBuffer<RingBufferCounters>;
+
+/// A generic ring buffer that does not collect statistics
+using RingBuffer = BasicRingBuffer<NullRingBufferCounters>;
+
+/// A generic ring buffer that collects statistics
+using InstrumentedRingBuffer = BasicRingBuffer<RingBufferCounters>;
+
 } /* namespace SFB */
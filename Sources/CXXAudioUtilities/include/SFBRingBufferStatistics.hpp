@@ -0,0 +1,240 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <cstddef>
+#import <cstdint>
+#import <limits>
+
+namespace SFB {
+
+/// A snapshot of the statistics collected by a ring buffer
+///
+/// Quantities are in bytes for @c RingBuffer and in frames for the audio ring buffers.
+/// @note Ring buffers using @c NullRingBufferCounters collect no statistics and always return default values
+struct RingBufferStatistics {
+	/// The number of writes requesting more space than was available
+	uint64_t mOverruns = 0;
+	/// The number of reads requesting more data than was available
+	uint64_t mUnderruns = 0;
+	/// The number of writes that stored less than requested because @c allowPartial was @c true
+	uint64_t mPartialWrites = 0;
+	/// The number of reads that returned less than requested because @c allowPartial was @c true
+	uint64_t mPartialReads = 0;
+	/// The number of reads that were wholly or partially zero-filled because the requested range was outside the time bounds
+	uint64_t mZeroFilledReads = 0;
+	/// The number of times the time bounds could not be read consistently
+	uint64_t mTimeBoundsFailures = 0;
+	/// The largest amount of data observed in the buffer by the writer
+	uint32_t mHighWatermark = 0;
+	/// The smallest amount of data observed in the buffer by the reader, or @c UINT32_MAX if no reads occurred
+	uint32_t mLowWatermark = std::numeric_limits<uint32_t>::max();
+};
+
+/// Counters used by ring buffers to collect statistics
+///
+/// Counters modified by the writer and those modified by the reader occupy separate cache lines. Each counter is
+/// modified by only one thread using relaxed loads and stores, so updates never use read-modify-write operations
+/// on the realtime path. A monitoring thread may call @c Snapshot() at any time.
+///
+/// These counters are used by the instrumented ring buffers such as @c InstrumentedRingBuffer.
+class RingBufferCounters
+{
+
+public:
+
+	/// Statistics are collected
+	static constexpr bool sIsEnabled = true;
+
+	/// Creates a new @c RingBufferCounters with all counters zeroed
+	RingBufferCounters() noexcept = default;
+
+	// This class is non-copyable
+	RingBufferCounters(const RingBufferCounters&) = delete;
+
+	// This class is non-assignable
+	RingBufferCounters& operator=(const RingBufferCounters&) = delete;
+
+	// This class is non-movable
+	RingBufferCounters(RingBufferCounters&&) = delete;
+
+	// This class is non-move assignable
+	RingBufferCounters& operator=(RingBufferCounters&&) = delete;
+
+#pragma mark Writer
+
+	/// Records a write of @c count units with @c available units of space available
+	/// @note This method should only be called from the writer thread
+	/// @param count The number of units requested
+	/// @param available The number of units of space available
+	/// @param allowPartial Whether partial writes were allowed
+	/// @param fill The number of units in the buffer after the write
+	void RecordWrite(uint32_t count, uint32_t available, bool allowPartial, uint32_t fill) noexcept
+	{
+		if(count > available) {
+			Increment(mOverruns);
+			if(allowPartial && available > 0)
+				Increment(mPartialWrites);
+		}
+		if(fill > mHighWatermark.load(std::memory_order_relaxed))
+			mHighWatermark.store(fill, std::memory_order_relaxed);
+	}
+
+#pragma mark Reader
+
+	/// Records a read of @c count units with @c available units of data available
+	/// @note This method should only be called from the reader thread
+	/// @param count The number of units requested
+	/// @param available The number of units of data available
+	/// @param allowPartial Whether partial reads were allowed
+	void RecordRead(uint32_t count, uint32_t available, bool allowPartial) noexcept
+	{
+		if(count > available) {
+			Increment(mUnderruns);
+			if(allowPartial && available > 0)
+				Increment(mPartialReads);
+		}
+		if(available < mLowWatermark.load(std::memory_order_relaxed))
+			mLowWatermark.store(available, std::memory_order_relaxed);
+	}
+
+	/// Records a read that was zero-filled because the requested range was outside the time bounds
+	/// @note This method should only be called from the reader thread
+	void RecordZeroFilledRead() noexcept
+	{
+		Increment(mZeroFilledReads);
+	}
+
+	/// Records a failure to read the time bounds consistently
+	/// @note This method may be called from any thread
+	void RecordTimeBoundsFailure() noexcept
+	{
+		mTimeBoundsFailures.fetch_add(1, std::memory_order_relaxed);
+	}
+
+#pragma mark Monitoring
+
+	/// Returns a snapshot of the current counter values
+	/// @note The counters are read individually so the snapshot may reflect operations in progress
+	RingBufferStatistics Snapshot() const noexcept
+	{
+		RingBufferStatistics statistics;
+		statistics.mOverruns = mOverruns.load(std::memory_order_relaxed);
+		statistics.mUnderruns = mUnderruns.load(std::memory_order_relaxed);
+		statistics.mPartialWrites = mPartialWrites.load(std::memory_order_relaxed);
+		statistics.mPartialReads = mPartialReads.load(std::memory_order_relaxed);
+		statistics.mZeroFilledReads = mZeroFilledReads.load(std::memory_order_relaxed);
+		statistics.mTimeBoundsFailures = mTimeBoundsFailures.load(std::memory_order_relaxed);
+		statistics.mHighWatermark = mHighWatermark.load(std::memory_order_relaxed);
+		statistics.mLowWatermark = mLowWatermark.load(std::memory_order_relaxed);
+		return statistics;
+	}
+
+	/// Zeroes all counters
+	/// @note This method should not be called while the buffer is being read or written
+	void Reset() noexcept
+	{
+		mOverruns.store(0, std::memory_order_relaxed);
+		mPartialWrites.store(0, std::memory_order_relaxed);
+		mHighWatermark.store(0, std::memory_order_relaxed);
+		mUnderruns.store(0, std::memory_order_relaxed);
+		mPartialReads.store(0, std::memory_order_relaxed);
+		mLowWatermark.store(std::numeric_limits<uint32_t>::max(), std::memory_order_relaxed);
+		mZeroFilledReads.store(0, std::memory_order_relaxed);
+		mTimeBoundsFailures.store(0, std::memory_order_relaxed);
+	}
+
+private:
+
+	/// Increments a counter modified by a single thread
+	static void Increment(std::atomic_uint64_t& counter) noexcept
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	/// The assumed size of a cache line in bytes
+#if defined(__arm64__) || defined(__aarch64__)
+	static constexpr size_t sCacheLineSize = 128;
+#else
+	static constexpr size_t sCacheLineSize = 64;
+#endif /* defined(__arm64__) || defined(__aarch64__) */
+
+	/// The number of overruns
+	alignas(sCacheLineSize) std::atomic_uint64_t mOverruns = 0;
+	/// The number of partial writes
+	std::atomic_uint64_t mPartialWrites = 0;
+	/// The high fill watermark
+	std::atomic_uint32_t mHighWatermark = 0;
+
+	/// The number of underruns
+	alignas(sCacheLineSize) std::atomic_uint64_t mUnderruns = 0;
+	/// The number of partial reads
+	std::atomic_uint64_t mPartialReads = 0;
+	/// The low fill watermark
+	std::atomic_uint32_t mLowWatermark = std::numeric_limits<uint32_t>::max();
+	/// The number of zero-filled reads
+	std::atomic_uint64_t mZeroFilledReads = 0;
+
+	/// The number of time bounds failures
+	alignas(sCacheLineSize) std::atomic_uint64_t mTimeBoundsFailures = 0;
+
+	static_assert(std::atomic_uint64_t::is_always_lock_free, "Lock-free std::atomic_uint64_t required");
+	static_assert(std::atomic_uint32_t::is_always_lock_free, "Lock-free std::atomic_uint32_t required");
+
+};
+
+/// Counters that collect no statistics
+///
+/// This empty class is used by the uninstrumented ring buffers such as @c RingBuffer. Every method is an inline no-op
+/// and @c Snapshot() returns default statistics.
+class NullRingBufferCounters
+{
+
+public:
+
+	/// Statistics are not collected
+	static constexpr bool sIsEnabled = false;
+
+	/// Does nothing
+	void RecordWrite(uint32_t count, uint32_t available, bool allowPartial, uint32_t fill) noexcept
+	{
+#pragma unused(count)
+#pragma unused(available)
+#pragma unused(allowPartial)
+#pragma unused(fill)
+	}
+
+	/// Does nothing
+	void RecordRead(uint32_t count, uint32_t available, bool allowPartial) noexcept
+	{
+#pragma unused(count)
+#pragma unused(available)
+#pragma unused(allowPartial)
+	}
+
+	/// Does nothing
+	void RecordZeroFilledRead() noexcept
+	{}
+
+	/// Does nothing
+	void RecordTimeBoundsFailure() noexcept
+	{}
+
+	/// Returns default statistics
+	RingBufferStatistics Snapshot() const noexcept
+	{
+		return {};
+	}
+
+	/// Does nothing
+	void Reset() noexcept
+	{}
+
+};
+
+} /* namespace SFB */
@@ -0,0 +1,265 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+#import <type_traits>
+#import <utility>
+
+#import <AudioToolbox/AudioConverter.h>
+
+#import "SFBAudioRingBuffer.hpp"
+#import "SFBCAAudioConverter.hpp"
+#import "SFBCABufferList.hpp"
+#import "SFBCAStreamBasicDescription.hpp"
+
+CF_ASSUME_NONNULL_BEGIN
+
+namespace SFB {
+
+/// A PCM audio converter producing fixed-size blocks of output from streaming input
+///
+/// Input is either pushed into an internal FIFO using @c Push() or pulled during conversion from an @c AudioRingBuffer
+/// or a callable object. Input is staged in a buffer owned by the converter, so conversion does not allocate and is
+/// suitable for use on a realtime thread.
+///
+/// Each call to @c Convert() produces exactly the requested number of output frames. If the input is exhausted the
+/// remaining frames are filled with silence and the converter's state is preserved, so conversion resumes seamlessly
+/// when more input becomes available. After @c SetEndOfInput() is called the converter is flushed and any remaining
+/// frames are filled with silence.
+///
+/// @code
+/// SFB::StreamingAudioConverter converter(sourceFormat, destinationFormat, 512);
+/// // On the render thread
+/// auto framesConverted = converter.Convert(ringBuffer, *outputBufferList, 512);
+/// @endcode
+class StreamingAudioConverter
+{
+
+public:
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c StreamingAudioConverter
+	/// @param sourceFormat The format of the input audio, which must be PCM
+	/// @param destinationFormat The format of the output audio, which must be PCM
+	/// @param maximumFramesPerConversion The maximum number of output frames produced by each call to @c Convert()
+	/// @param inputBufferFrames The capacity of the internal FIFO used by @c Push() in frames, or @c 0 for none
+	/// @throw @c std::invalid_argument If either format is not PCM, @c maximumFramesPerConversion is zero, or
+	/// @c inputBufferFrames is nonzero and @c sourceFormat is interleaved
+	/// @throw @c std::system_error If the audio converter could not be created
+	/// @throw @c std::bad_alloc
+	StreamingAudioConverter(const CAStreamBasicDescription& sourceFormat, const CAStreamBasicDescription& destinationFormat, UInt32 maximumFramesPerConversion, UInt32 inputBufferFrames = 0);
+
+	// This class is non-copyable
+	StreamingAudioConverter(const StreamingAudioConverter&) = delete;
+
+	// This class is non-assignable
+	StreamingAudioConverter& operator=(const StreamingAudioConverter&) = delete;
+
+	/// Destroys the @c StreamingAudioConverter and releases all associated resources
+	~StreamingAudioConverter() = default;
+
+	// This class is non-movable
+	StreamingAudioConverter(StreamingAudioConverter&&) = delete;
+
+	// This class is non-move assignable
+	StreamingAudioConverter& operator=(StreamingAudioConverter&&) = delete;
+
+#pragma mark Properties
+
+	/// Returns the format of the input audio
+	const CAStreamBasicDescription& SourceFormat() const noexcept
+	{
+		return mSourceFormat;
+	}
+
+	/// Returns the format of the output audio
+	const CAStreamBasicDescription& DestinationFormat() const noexcept
+	{
+		return mDestinationFormat;
+	}
+
+	/// Returns the maximum number of output frames produced by each call to @c Convert()
+	UInt32 MaximumFramesPerConversion() const noexcept
+	{
+		return mMaximumFramesPerConversion;
+	}
+
+	/// Returns the underlying audio converter, which may be used to set additional properties before conversion
+	CAAudioConverter& Converter() noexcept
+	{
+		return mConverter;
+	}
+
+	/// Returns the converter's priming information (@c kAudioConverterPrimeInfo) in input frames
+	/// @throw @c std::system_error
+	AudioConverterPrimeInfo PrimeInfo();
+
+	/// Returns the number of output frames by which converted audio is delayed relative to the input
+	///
+	/// This is the converter's leading prime frames converted to the output sample rate, unless the prime method is
+	/// @c kConverterPrimeMethod_Pre, in which case the caller supplies the priming input and the latency is zero.
+	/// @throw @c std::system_error
+	UInt32 OutputLatencyFrames();
+
+	/// Returns the total number of input frames consumed since creation or the last call to @c Reset()
+	UInt64 InputFramesConsumed() const noexcept
+	{
+		return mInputFramesConsumed;
+	}
+
+	/// Returns the total number of output frames converted since creation or the last call to @c Reset()
+	/// @note This excludes silence inserted because the input was exhausted
+	UInt64 OutputFramesConverted() const noexcept
+	{
+		return mOutputFramesConverted;
+	}
+
+	/// Returns the total number of silent output frames inserted because the input was exhausted since creation or
+	/// the last call to @c Reset()
+	UInt64 UnderrunFrames() const noexcept
+	{
+		return mUnderrunFrames;
+	}
+
+#pragma mark Input
+
+	/// Copies audio to the internal FIFO for a subsequent call to @c Convert()
+	/// @note This method may be called concurrently with @c Convert() from a different thread
+	/// @param bufferList The audio to copy in @c SourceFormat()
+	/// @param frameCount The number of frames to copy
+	/// @return The number of frames copied, which is less than @c frameCount if the FIFO is full or was not allocated
+	UInt32 Push(const AudioBufferList& bufferList, UInt32 frameCount) noexcept
+	{
+		if(!mInputBuffer.CapacityFrames())
+			return 0;
+		return mInputBuffer.Write(&bufferList, frameCount, true);
+	}
+
+	/// Marks the end of the input so the converter is flushed once the available input is consumed
+	/// @note This method may be called concurrently with @c Convert() from a different thread
+	void SetEndOfInput() noexcept
+	{
+		mEndOfInput.store(true, std::memory_order_release);
+	}
+
+	/// Resets the converter, discarding any buffered input and clearing the end of input flag
+	/// @note This method is not safe to call concurrently with @c Push() or @c Convert()
+	/// @throw @c std::system_error
+	void Reset();
+
+#pragma mark Conversion
+
+	/// Converts input from the internal FIFO
+	/// @param output A buffer list in @c DestinationFormat() receiving @c frameCount frames
+	/// @param frameCount The number of frames to produce, which must not exceed @c MaximumFramesPerConversion()
+	/// @return The number of frames converted from input, with any remaining frames up to @c frameCount silent, or
+	/// @c 0 if @c output is unsuitable or an error occurred
+	UInt32 Convert(AudioBufferList& output, UInt32 frameCount) noexcept
+	{
+		return Convert(mInputBuffer, output, frameCount);
+	}
+
+	/// Converts input read from @c ringBuffer
+	/// @param ringBuffer An @c AudioRingBuffer containing audio in @c SourceFormat()
+	/// @param output A buffer list in @c DestinationFormat() receiving @c frameCount frames
+	/// @param frameCount The number of frames to produce, which must not exceed @c MaximumFramesPerConversion()
+	/// @return The number of frames converted from input, with any remaining frames up to @c frameCount silent, or
+	/// @c 0 if @c output is unsuitable or an error occurred
+	UInt32 Convert(AudioRingBuffer& ringBuffer, AudioBufferList& output, UInt32 frameCount) noexcept
+	{
+		if(!ringBuffer.CapacityFrames())
+			return Convert([](AudioBufferList&, UInt32) noexcept -> UInt32 { return 0; }, output, frameCount);
+		return Convert([&ringBuffer](AudioBufferList& bufferList, UInt32 count) noexcept {
+			return ringBuffer.Read(&bufferList, count, true);
+		}, output, frameCount);
+	}
+
+	/// Converts input read from @c ringBuffer to @c output, setting its frame length to @c frameCount
+	/// @see Convert(AudioRingBuffer&, AudioBufferList&, UInt32)
+	UInt32 Convert(AudioRingBuffer& ringBuffer, CABufferList& output, UInt32 frameCount) noexcept
+	{
+		if(!output || output.Format() != mDestinationFormat || !output.SetFrameLength(frameCount))
+			return 0;
+		return Convert(ringBuffer, *output.ABL(), frameCount);
+	}
+
+	/// Converts input supplied by @c source
+	///
+	/// @c source is called with a buffer list in @c SourceFormat() and the maximum number of frames to supply, and
+	/// returns the number of frames written to the buffer list. Returning @c 0 indicates no input is currently
+	/// available.
+	/// @note No allocation occurs unless @c source allocates
+	/// @param source A callable object with the signature @c UInt32(AudioBufferList&,UInt32)
+	/// @param output A buffer list in @c DestinationFormat() receiving @c frameCount frames
+	/// @param frameCount The number of frames to produce, which must not exceed @c MaximumFramesPerConversion()
+	/// @return The number of frames converted from input, with any remaining frames up to @c frameCount silent, or
+	/// @c 0 if @c output is unsuitable or an error occurred
+	template <typename Source, typename = std::enable_if_t<std::is_invocable_r_v<UInt32, Source&, AudioBufferList&, UInt32>>>
+	UInt32 Convert(Source&& source, AudioBufferList& output, UInt32 frameCount) noexcept
+	{
+		auto pull = [](void * _Nonnull context, AudioBufferList& bufferList, UInt32 count) noexcept -> UInt32 {
+			return (*static_cast<std::remove_reference_t<Source> *>(context))(bufferList, count);
+		};
+		return Convert(pull, static_cast<void *>(&source), output, frameCount);
+	}
+
+	/// Converts input supplied by @c source to @c output, setting its frame length to @c frameCount
+	/// @see Convert(Source&&, AudioBufferList&, UInt32)
+	template <typename Source, typename = std::enable_if_t<std::is_invocable_r_v<UInt32, Source&, AudioBufferList&, UInt32>>>
+	UInt32 Convert(Source&& source, CABufferList& output, UInt32 frameCount) noexcept
+	{
+		if(!output || output.Format() != mDestinationFormat || !output.SetFrameLength(frameCount))
+			return 0;
+		return Convert(std::forward<Source>(source), *output.ABL(), frameCount);
+	}
+
+private:
+
+	/// A function supplying input frames
+	using PullFunction = UInt32 (*)(void * _Nonnull context, AudioBufferList& bufferList, UInt32 frameCount) noexcept;
+
+	/// Converts input supplied by @c pull
+	UInt32 Convert(PullFunction _Nonnull pull, void * _Nonnull context, AudioBufferList& output, UInt32 frameCount) noexcept;
+
+	/// The converter's input data procedure
+	static OSStatus InputDataProc(AudioConverterRef inAudioConverter, UInt32 *ioNumberDataPackets, AudioBufferList *ioData, AudioStreamPacketDescription * _Nullable * _Nullable outDataPacketDescription, void * _Nullable inUserData) noexcept;
+
+	/// The format of the input audio
+	const CAStreamBasicDescription mSourceFormat;
+	/// The format of the output audio
+	const CAStreamBasicDescription mDestinationFormat;
+	/// The maximum number of output frames per conversion
+	const UInt32 mMaximumFramesPerConversion;
+
+	/// The underlying audio converter
+	CAAudioConverter mConverter;
+	/// The buffer holding input passed to the converter
+	CABufferList mStagingBuffer;
+	/// The FIFO holding pushed input
+	AudioRingBuffer mInputBuffer;
+
+	/// The input function for the conversion in progress
+	PullFunction _Nullable mPull = nullptr;
+	/// The context for @c mPull
+	void * _Nullable mPullContext = nullptr;
+
+	/// Whether the end of input was reached
+	std::atomic_bool mEndOfInput = false;
+	/// The number of input frames consumed
+	UInt64 mInputFramesConsumed = 0;
+	/// The number of output frames converted
+	UInt64 mOutputFramesConverted = 0;
+	/// The number of silent output frames inserted on underrun
+	UInt64 mUnderrunFrames = 0;
+
+};
+
+} /* namespace SFB */
+
+CF_ASSUME_NONNULL_END
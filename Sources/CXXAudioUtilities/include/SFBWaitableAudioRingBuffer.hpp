@@ -0,0 +1,221 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+#pragma once
+
+#import <atomic>
+
+#import <dispatch/dispatch.h>
+
+#import "SFBAudioRingBuffer.hpp"
+#import "SFBDispatchSemaphore.hpp"
+
+namespace SFB {
+
+/// An @c AudioRingBuffer supporting blocking waits for audio or free space.
+///
+/// This class is thread safe when used from one reader thread and one writer thread (single producer, single consumer model).
+///
+/// A non-realtime reader may block until a given number of frames are available for reading, and a non-realtime
+/// writer may block until a given amount of space is available for writing. The opposite side remains wait-free:
+/// it signals a semaphore only when a waiter is present and the waiter's threshold has been crossed.
+class WaitableAudioRingBuffer
+{
+
+public:
+
+#pragma mark Creation and Destruction
+
+	/// Creates a new @c WaitableAudioRingBuffer
+	/// @note @c Allocate() must be called before the object may be used.
+	/// @throw @c std::runtime_error If the semaphores could not be created
+	WaitableAudioRingBuffer()
+	: mFramesAvailableToReadSemaphore{0}, mFramesAvailableToWriteSemaphore{0}
+	{}
+
+	// This class is non-copyable
+	WaitableAudioRingBuffer(const WaitableAudioRingBuffer&) = delete;
+
+	// This class is non-assignable
+	WaitableAudioRingBuffer& operator=(const WaitableAudioRingBuffer&) = delete;
+
+	/// Destroys the @c WaitableAudioRingBuffer and releases all associated resources.
+	~WaitableAudioRingBuffer() = default;
+
+	// This class is non-movable
+	WaitableAudioRingBuffer(WaitableAudioRingBuffer&&) = delete;
+
+	// This class is non-move assignable
+	WaitableAudioRingBuffer& operator=(WaitableAudioRingBuffer&&) = delete;
+
+#pragma mark Buffer management
+
+	/// Allocates space for audio data.
+	/// @note This method is not thread safe.
+	/// @param format The format of the audio that will be written to and read from this buffer.
+	/// @param capacityFrames The desired capacity, in frames
+	/// @return @c true on success, @c false on error
+	/// @see AudioRingBuffer::Allocate()
+	bool Allocate(const CAStreamBasicDescription& format, uint32_t capacityFrames) noexcept
+	{
+		return mRingBuffer.Allocate(format, capacityFrames);
+	}
+
+	/// Allocates space for audio data using virtual memory mirroring.
+	/// @note This method is not thread safe.
+	/// @param format The format of the audio that will be written to and read from this buffer.
+	/// @param capacityFrames The desired capacity, in frames
+	/// @return @c true on success, @c false on error
+	/// @see AudioRingBuffer::AllocateMirrored()
+	bool AllocateMirrored(const CAStreamBasicDescription& format, uint32_t capacityFrames) noexcept
+	{
+		return mRingBuffer.AllocateMirrored(format, capacityFrames);
+	}
+
+	/// Frees the resources used by this @c WaitableAudioRingBuffer
+	/// @note This method is not thread safe.
+	void Deallocate() noexcept
+	{
+		mRingBuffer.Deallocate();
+	}
+
+
+	/// Resets this @c WaitableAudioRingBuffer to its default state.
+	/// @note This method is not thread safe.
+	void Reset() noexcept
+	{
+		mRingBuffer.Reset();
+	}
+
+
+	/// Returns the capacity in frames of this @c WaitableAudioRingBuffer
+	uint32_t CapacityFrames() const noexcept
+	{
+		return mRingBuffer.CapacityFrames();
+	}
+
+	/// Returns the format of this @c WaitableAudioRingBuffer
+	const CAStreamBasicDescription& Format() const noexcept
+	{
+		return mRingBuffer.Format();
+	}
+
+	/// Returns the number of frames available for reading
+	uint32_t FramesAvailableToRead() const noexcept
+	{
+		return mRingBuffer.FramesAvailableToRead();
+	}
+
+	/// Returns the free space available for writing in frames
+	uint32_t FramesAvailableToWrite() const noexcept
+	{
+		return mRingBuffer.FramesAvailableToWrite();
+	}
+
+#pragma mark Waiting
+
+	/// Blocks until at least @c frameCount frames are available for reading or @c timeout occurs.
+	/// @note This method should only be called from the reader thread
+	/// @param frameCount The desired number of frames, which must be less than @c CapacityFrames()
+	/// @param timeout The time at which to stop waiting, as returned by @c dispatch_time()
+	/// @return @c true if at least @c frameCount frames are available for reading, @c false otherwise
+	bool WaitForFramesToRead(uint32_t frameCount, dispatch_time_t timeout = DISPATCH_TIME_FOREVER) noexcept;
+
+	/// Blocks until free space for at least @c frameCount frames is available for writing or @c timeout occurs.
+	/// @note This method should only be called from the writer thread
+	/// @param frameCount The desired number of frames, which must be less than @c CapacityFrames()
+	/// @param timeout The time at which to stop waiting, as returned by @c dispatch_time()
+	/// @return @c true if space for at least @c frameCount frames is available for writing, @c false otherwise
+	bool WaitForSpaceToWrite(uint32_t frameCount, dispatch_time_t timeout = DISPATCH_TIME_FOREVER) noexcept;
+
+#pragma mark Reading and writing audio
+
+	/// Reads audio from the @c WaitableAudioRingBuffer and advances the read pointer.
+	/// @param bufferList An @c AudioBufferList to receive the audio
+	/// @param frameCount The desired number of frames to read
+	/// @param allowPartial Whether any frames should be read if the number of frames available for reading is less than @c frameCount
+	/// @return The number of frames actually read
+	uint32_t Read(AudioBufferList * const _Nonnull bufferList, uint32_t frameCount, bool allowPartial = true) noexcept
+	{
+		const auto framesRead = mRingBuffer.Read(bufferList, frameCount, allowPartial);
+		if(framesRead > 0)
+			SignalWriterIfNeeded();
+		return framesRead;
+	}
+
+	/// Writes audio to the @c WaitableAudioRingBuffer and advances the write pointer.
+	/// @param bufferList An @c AudioBufferList containing the audio to copy
+	/// @param frameCount The desired number of frames to write
+	/// @param allowPartial Whether any frames should be written if the free space available for writing is less than @c frameCount
+	/// @return The number of frames actually written
+	uint32_t Write(const AudioBufferList * const _Nonnull bufferList, uint32_t frameCount, bool allowPartial = true) noexcept
+	{
+		const auto framesWritten = mRingBuffer.Write(bufferList, frameCount, allowPartial);
+		if(framesWritten > 0)
+			SignalReaderIfNeeded();
+		return framesWritten;
+	}
+
+#pragma mark Advanced reading and writing
+
+	/// Advances the read position by the specified number of frames.
+	/// @note This method should only be called from the reader thread
+	void AdvanceReadPosition(uint32_t frameCount) noexcept
+	{
+		mRingBuffer.AdvanceReadPosition(frameCount);
+		SignalWriterIfNeeded();
+	}
+
+	/// Advances the write position by the specified number of frames.
+	/// @note This method should only be called from the writer thread
+	void AdvanceWritePosition(uint32_t frameCount) noexcept
+	{
+		mRingBuffer.AdvanceWritePosition(frameCount);
+		SignalReaderIfNeeded();
+	}
+
+	/// Returns the read vector containing the current readable audio.
+	/// @note This method should only be called from the reader thread
+	/// @see AudioRingBuffer::ReadVector()
+	const AudioRingBuffer::ReadBufferPair ReadVector() const noexcept
+	{
+		return mRingBuffer.ReadVector();
+	}
+
+	/// Returns the write vector containing the current writable space.
+	/// @note This method should only be called from the writer thread
+	/// @see AudioRingBuffer::WriteVector()
+	const AudioRingBuffer::WriteBufferPair WriteVector() const noexcept
+	{
+		return mRingBuffer.WriteVector();
+	}
+
+private:
+
+	/// Signals the reader if it is waiting and its threshold has been reached
+	void SignalReaderIfNeeded() noexcept;
+
+	/// Signals the writer if it is waiting and its threshold has been reached
+	void SignalWriterIfNeeded() noexcept;
+
+	/// The underlying ring buffer
+	AudioRingBuffer mRingBuffer;
+
+	/// The number of frames the reader is waiting for, or @c 0 if the reader is not waiting
+	std::atomic_uint32_t mReadThreshold = 0;
+	/// The number of frames the writer is waiting for, or @c 0 if the writer is not waiting
+	std::atomic_uint32_t mWriteThreshold = 0;
+
+	/// Semaphore signaled when the reader's threshold is reached
+	DispatchSemaphore mFramesAvailableToReadSemaphore;
+	/// Semaphore signaled when the writer's threshold is reached
+	DispatchSemaphore mFramesAvailableToWriteSemaphore;
+
+	static_assert(std::atomic_uint32_t::is_always_lock_free, "Lock-free std::atomic_uint32_t required");
+
+};
+
+} /* namespace SFB */
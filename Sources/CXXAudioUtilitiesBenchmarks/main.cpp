@@ -0,0 +1,879 @@
+//
+// Copyright © 2026 Stephen F. Booth <me@sbooth.org>
+// Part of https://github.com/sbooth/CXXAudioUtilities
+// MIT license
+//
+
+// Microbenchmarks for the ring buffers, buffer lists, audio converters, and locks
+//
+// Results are written to standard output as a single JSON document so runs from different builds may be compared.
+//
+// Usage: CXXAudioUtilitiesBenchmarks [--quick] [--filter <substring>]
+//   --quick               Perform one sixteenth of the default work
+//   --filter <substring>  Run only benchmarks whose name contains <substring>
+
+#import <algorithm>
+#import <atomic>
+#import <chrono>
+#import <cstdio>
+#import <cstring>
+#import <ctime>
+#import <stdexcept>
+#import <string>
+#import <thread>
+#import <vector>
+
+#import <sys/resource.h>
+#import <sys/sysctl.h>
+
+#import "SFBAdaptiveUnfairLock.hpp"
+#import "SFBAudioRingBuffer.hpp"
+#import "SFBCAAudioConverter.hpp"
+#import "SFBCABufferList.hpp"
+#import "SFBCARingBuffer.hpp"
+#import "SFBRingBuffer.hpp"
+#import "SFBUnfairLock.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Returns the nanoseconds elapsed between @c start and @c end
+double ElapsedNanoseconds(Clock::time_point start, Clock::time_point end) noexcept
+{
+	return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+#pragma mark Configuration
+
+/// Benchmark configuration
+struct Configuration {
+	/// The number of bytes transferred by each throughput measurement
+	uint64_t mThroughputBytes = 256 * 1024 * 1024;
+	/// The number of handoffs timed by each latency measurement
+	uint32_t mLatencySamples = 20000;
+	/// The number of operations timed by each single-threaded measurement
+	uint32_t mIterations = 200000;
+	/// The number of frames converted by each conversion measurement
+	uint64_t mConversionFrames = 16 * 1024 * 1024;
+	/// Only benchmarks whose names contain this string are run
+	std::string mFilter;
+};
+
+/// Channel counts to measure
+constexpr uint32_t kChannelCounts[] = { 1, 2, 8 };
+/// Block sizes in frames to measure
+constexpr uint32_t kBlockFrames[] = { 64, 512, 4096 };
+/// Block sizes in bytes to measure for byte-oriented buffers
+constexpr uint32_t kBlockBytes[] = { 64, 512, 4096, 32768 };
+/// Thread counts to measure for lock contention
+constexpr uint32_t kLockThreadCounts[] = { 2, 4 };
+/// Critical section lengths in iterations of dependent arithmetic to measure for lock contention
+constexpr uint32_t kCriticalSectionWork[] = { 0, 64, 512 };
+/// Sample formats to measure
+constexpr SFB::CommonPCMFormat kFormats[] = { SFB::CommonPCMFormat::float32, SFB::CommonPCMFormat::int16 };
+/// The ring buffer capacity as a multiple of the block size for SPSC measurements
+constexpr uint32_t kCapacityBlocks = 4;
+
+/// Returns the name of @c format
+const char * FormatName(SFB::CommonPCMFormat format) noexcept
+{
+	switch(format) {
+		case SFB::CommonPCMFormat::float32: 	return "float32";
+		case SFB::CommonPCMFormat::float64: 	return "float64";
+		case SFB::CommonPCMFormat::int16: 		return "int16";
+		case SFB::CommonPCMFormat::int32: 		return "int32";
+	}
+	return "unknown";
+}
+
+#pragma mark Results
+
+/// A named JSON value
+struct Field {
+	/// The field name
+	std::string mName;
+	/// The field value as JSON text
+	std::string mJSON;
+};
+
+/// Returns @c string as a JSON string
+std::string JSONString(const std::string& string)
+{
+	std::string json = "\"";
+	for(auto c : string) {
+		switch(c) {
+			case '"': 	json += "\\\""; 	break;
+			case '\\': 	json += "\\\\"; 	break;
+			case '\n': 	json += "\\n"; 		break;
+			case '\t': 	json += "\\t"; 		break;
+			default:
+				if(static_cast<unsigned char>(c) < 0x20) {
+					char escape[7];
+					std::snprintf(escape, sizeof escape, "\\u%04x", c);
+					json += escape;
+				}
+				else
+					json += c;
+		}
+	}
+	return json + "\"";
+}
+
+/// Returns @c value as a JSON number
+std::string JSONNumber(double value)
+{
+	char buffer[32];
+	std::snprintf(buffer, sizeof buffer, "%.9g", value);
+	return buffer;
+}
+
+/// Returns a field with a numeric value
+Field Number(std::string name, double value)
+{
+	return { std::move(name), JSONNumber(value) };
+}
+
+/// Returns a field with a Boolean value
+Field Boolean(std::string name, bool value)
+{
+	return { std::move(name), value ? "true" : "false" };
+}
+
+/// Returns a field with a string value
+Field String(std::string name, const std::string& value)
+{
+	return { std::move(name), JSONString(value) };
+}
+
+/// Returns @c fields as a JSON object
+std::string JSONObject(const std::vector<Field>& fields)
+{
+	std::string json = "{";
+	for(size_t i = 0; i < fields.size(); ++i) {
+		if(i > 0)
+			json += ", ";
+		json += JSONString(fields[i].mName) + ": " + fields[i].mJSON;
+	}
+	return json + "}";
+}
+
+/// The result of a benchmark
+struct Result {
+	/// The benchmark name
+	std::string mName;
+	/// The parameters of the measurement
+	std::vector<Field> mParameters;
+	/// The measured values
+	std::vector<Field> mMetrics;
+};
+
+/// Collects benchmark results
+class Results
+{
+
+public:
+
+	explicit Results(const Configuration& configuration)
+	: mConfiguration{configuration}
+	{}
+
+	/// Returns @c true if the benchmark named @c name should be run
+	bool ShouldRun(const std::string& name) const
+	{
+		return mConfiguration.mFilter.empty() || name.find(mConfiguration.mFilter) != std::string::npos;
+	}
+
+	/// Records a result
+	void Add(Result result)
+	{
+		std::fprintf(stderr, "%s %s\n", result.mName.c_str(), JSONObject(result.mParameters).c_str());
+		mResults.push_back(std::move(result));
+	}
+
+	/// Writes the results to @c file as JSON
+	void Write(FILE *file, const std::vector<Field>& context) const
+	{
+		std::fprintf(file, "{\n  \"version\": 1,\n  \"context\": %s,\n  \"benchmarks\": [\n", JSONObject(context).c_str());
+		for(size_t i = 0; i < mResults.size(); ++i) {
+			const auto& result = mResults[i];
+			std::fprintf(file, "    {\"name\": %s, \"parameters\": %s, \"metrics\": %s}%s\n", JSONString(result.mName).c_str(), JSONObject(result.mParameters).c_str(), JSONObject(result.mMetrics).c_str(), i + 1 < mResults.size() ? "," : "");
+		}
+		std::fprintf(file, "  ]\n}\n");
+	}
+
+private:
+
+	const Configuration& mConfiguration;
+	std::vector<Result> mResults;
+
+};
+
+/// Returns the value of the string sysctl @c name or an empty string
+std::string SysctlString(const char *name)
+{
+	size_t size = 0;
+	if(sysctlbyname(name, nullptr, &size, nullptr, 0) != 0 || size == 0)
+		return {};
+	std::string value(size, '\0');
+	if(sysctlbyname(name, value.data(), &size, nullptr, 0) != 0)
+		return {};
+	value.resize(std::strlen(value.c_str()));
+	return value;
+}
+
+/// Returns a description of the machine and build
+std::vector<Field> Context(const Configuration& configuration)
+{
+	char date[32];
+	const auto now = std::time(nullptr);
+	std::strftime(date, sizeof date, "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+	return {
+		String("date", date),
+		String("hardwareModel", SysctlString("hw.model")),
+		String("cpu", SysctlString("machdep.cpu.brand_string")),
+		Number("logicalCPUs", std::thread::hardware_concurrency()),
+#ifdef NDEBUG
+		String("build", "release"),
+#else
+		String("build", "debug"),
+#endif /* NDEBUG */
+		Number("throughputBytes", static_cast<double>(configuration.mThroughputBytes)),
+		Number("latencySamples", configuration.mLatencySamples),
+		Number("iterations", configuration.mIterations),
+		Number("conversionFrames", static_cast<double>(configuration.mConversionFrames)),
+	};
+}
+
+#pragma mark SPSC Harness
+
+/// Waits politely for another thread, spinning briefly before yielding
+class Backoff
+{
+
+public:
+
+	void Wait() noexcept
+	{
+		if(++mSpins < 1024) {
+#if defined(__arm64__) || defined(__aarch64__)
+			__asm__ __volatile__("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+#endif
+		}
+		else
+			std::this_thread::yield();
+	}
+
+	void Reset() noexcept
+	{
+		mSpins = 0;
+	}
+
+private:
+
+	uint32_t mSpins = 0;
+
+};
+
+/// Returns the value at @c percentile in the sorted @c values
+double Percentile(const std::vector<double>& values, double percentile) noexcept
+{
+	if(values.empty())
+		return 0;
+	const auto index = static_cast<size_t>(percentile / 100 * static_cast<double>(values.size() - 1) + 0.5);
+	return values[std::min(index, values.size() - 1)];
+}
+
+/// Measures SPSC throughput and handoff latency
+///
+/// For throughput the producer writes @c blockCount blocks as fast as possible while the consumer on the calling thread
+/// reads them. For latency the producer writes one block at a time into an empty buffer and the time from the start of
+/// the write to the completion of the read is recorded.
+/// @param tryWrite A function writing block @c k, returning @c false if there was insufficient space
+/// @param tryRead A function reading block @c k, returning @c false if there was insufficient data
+/// @param reset A function emptying the buffer
+template <typename W, typename R, typename Z>
+std::vector<Field> MeasureSPSC(uint64_t blockCount, uint64_t blockBytes, uint32_t latencySamples, W&& tryWrite, R&& tryRead, Z&& reset)
+{
+	reset();
+
+	std::atomic_bool go = false;
+	std::thread producer([&] {
+		while(!go.load(std::memory_order_acquire))
+			;
+		Backoff backoff;
+		for(uint64_t k = 0; k < blockCount; ++k) {
+			backoff.Reset();
+			while(!tryWrite(k))
+				backoff.Wait();
+		}
+	});
+
+	const auto start = Clock::now();
+	go.store(true, std::memory_order_release);
+	Backoff backoff;
+	for(uint64_t k = 0; k < blockCount; ++k) {
+		backoff.Reset();
+		while(!tryRead(k))
+			backoff.Wait();
+	}
+	const auto end = Clock::now();
+	producer.join();
+
+	const auto seconds = ElapsedNanoseconds(start, end) / 1e9;
+
+	reset();
+
+	std::vector<double> latencies(latencySamples);
+	std::atomic<Clock::rep> writeStart = 0;
+	std::atomic_uint32_t samplesRead = 0;
+
+	producer = std::thread([&] {
+		Backoff backoff;
+		for(uint32_t k = 0; k < latencySamples; ++k) {
+			backoff.Reset();
+			while(samplesRead.load(std::memory_order_acquire) < k)
+				backoff.Wait();
+			writeStart.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+			while(!tryWrite(k))
+				backoff.Wait();
+		}
+	});
+
+	for(uint32_t k = 0; k < latencySamples; ++k) {
+		backoff.Reset();
+		while(!tryRead(k))
+			backoff.Wait();
+		const auto readEnd = Clock::now();
+		latencies[k] = ElapsedNanoseconds(Clock::time_point(Clock::duration(writeStart.load(std::memory_order_relaxed))), readEnd);
+		samplesRead.store(k + 1, std::memory_order_release);
+	}
+	producer.join();
+
+	std::sort(latencies.begin(), latencies.end());
+
+	return {
+		Number("bytesPerSecond", static_cast<double>(blockCount * blockBytes) / seconds),
+		Number("blocksPerSecond", static_cast<double>(blockCount) / seconds),
+		Number("latencyP50Nanoseconds", Percentile(latencies, 50)),
+		Number("latencyP90Nanoseconds", Percentile(latencies, 90)),
+		Number("latencyP99Nanoseconds", Percentile(latencies, 99)),
+		Number("latencyP999Nanoseconds", Percentile(latencies, 99.9)),
+		Number("latencyMaxNanoseconds", latencies.empty() ? 0 : latencies.back()),
+	};
+}
+
+/// Returns the number of blocks of @c blockBytes to transfer for a throughput measurement
+uint64_t ThroughputBlockCount(const Configuration& configuration, uint64_t blockBytes) noexcept
+{
+	return std::max<uint64_t>(configuration.mThroughputBytes / blockBytes, 1024);
+}
+
+/// Allocates a buffer list of @c frameCapacity frames in @c format filled with a test signal
+SFB::CABufferList MakeBufferList(const SFB::CAStreamBasicDescription& format, UInt32 frameCapacity)
+{
+	SFB::CABufferList bufferList;
+	if(!bufferList.Allocate(format, frameCapacity))
+		throw std::bad_alloc();
+	bufferList.SetFrameLength(frameCapacity);
+	for(UInt32 i = 0; i < bufferList.ABL()->mNumberBuffers; ++i) {
+		auto& buffer = bufferList.ABL()->mBuffers[i];
+		auto bytes = static_cast<uint8_t *>(buffer.mData);
+		for(UInt32 j = 0; j < buffer.mDataByteSize; ++j)
+			bytes[j] = static_cast<uint8_t>(j * 31 + i);
+	}
+	return bufferList;
+}
+
+#pragma mark RingBuffer
+
+void BenchmarkRingBuffer(const Configuration& configuration, Results& results)
+{
+	if(results.ShouldRun("RingBuffer.SPSC")) {
+		for(auto blockBytes : kBlockBytes) {
+			SFB::RingBuffer ringBuffer;
+			if(!ringBuffer.Allocate(blockBytes * kCapacityBlocks))
+				throw std::bad_alloc();
+
+			std::vector<uint8_t> source(blockBytes, 0xa5), destination(blockBytes);
+			auto metrics = MeasureSPSC(ThroughputBlockCount(configuration, blockBytes), blockBytes, configuration.mLatencySamples,
+									   [&](uint64_t) { return ringBuffer.Write(source.data(), blockBytes, false) == blockBytes; },
+									   [&](uint64_t) { return ringBuffer.Read(destination.data(), blockBytes, false) == blockBytes; },
+									   [&] { ringBuffer.Reset(); });
+
+			results.Add({ "RingBuffer.SPSC", { Number("blockBytes", blockBytes) }, std::move(metrics) });
+		}
+	}
+
+	if(results.ShouldRun("RingBuffer.WrapAround")) {
+		for(auto blockBytes : kBlockBytes) {
+			for(auto mirrored : { false, true }) {
+				SFB::RingBuffer ringBuffer;
+				if(!(mirrored ? ringBuffer.AllocateMirrored(blockBytes * 2) : ringBuffer.Allocate(blockBytes * 2)))
+					throw std::bad_alloc();
+				const auto capacityBytes = ringBuffer.CapacityBytes();
+
+				std::vector<uint8_t> source(blockBytes, 0xa5), destination(blockBytes);
+
+				// Each iteration writes and reads one block starting at startPosition, then returns to startPosition
+				const auto measure = [&](uint32_t startPosition) {
+					ringBuffer.Reset();
+					ringBuffer.AdvanceWritePosition(startPosition);
+					ringBuffer.AdvanceReadPosition(startPosition);
+					const auto start = Clock::now();
+					for(uint32_t i = 0; i < configuration.mIterations; ++i) {
+						ringBuffer.Write(source.data(), blockBytes, false);
+						ringBuffer.Read(destination.data(), blockBytes, false);
+						ringBuffer.AdvanceWritePosition(capacityBytes - blockBytes);
+						ringBuffer.AdvanceReadPosition(capacityBytes - blockBytes);
+					}
+					return ElapsedNanoseconds(start, Clock::now()) / configuration.mIterations;
+				};
+
+				const auto contiguous = measure(0);
+				const auto wrapping = measure(capacityBytes - blockBytes / 2);
+
+				results.Add({ "RingBuffer.WrapAround", { Number("blockBytes", blockBytes), Boolean("mirrored", mirrored) }, {
+					Number("contiguousNanosecondsPerTransfer", contiguous),
+					Number("wrappingNanosecondsPerTransfer", wrapping),
+					Number("wrapOverheadNanoseconds", wrapping - contiguous),
+				} });
+			}
+		}
+	}
+}
+
+#pragma mark AudioRingBuffer
+
+void BenchmarkAudioRingBuffer(const Configuration& configuration, Results& results)
+{
+	if(results.ShouldRun("AudioRingBuffer.SPSC")) {
+		for(auto commonFormat : kFormats) {
+			for(auto channels : kChannelCounts) {
+				for(auto blockFrames : kBlockFrames) {
+					const SFB::CAStreamBasicDescription format(commonFormat, 48000, channels, false);
+					SFB::AudioRingBuffer ringBuffer;
+					if(!ringBuffer.Allocate(format, blockFrames * kCapacityBlocks))
+						throw std::bad_alloc();
+
+					auto source = MakeBufferList(format, blockFrames);
+					auto destination = MakeBufferList(format, blockFrames);
+					const auto blockBytes = static_cast<uint64_t>(format.FrameCountToByteSize(blockFrames)) * format.ChannelStreamCount();
+
+					auto metrics = MeasureSPSC(ThroughputBlockCount(configuration, blockBytes), blockBytes, configuration.mLatencySamples,
+											   [&](uint64_t) { return ringBuffer.Write(source, blockFrames, false) == blockFrames; },
+											   [&](uint64_t) { destination.SetFrameLength(blockFrames); return ringBuffer.Read(destination, blockFrames, false) == blockFrames; },
+											   [&] { ringBuffer.Reset(); });
+
+					results.Add({ "AudioRingBuffer.SPSC", { String("format", FormatName(commonFormat)), Number("channels", channels), Number("blockFrames", blockFrames) }, std::move(metrics) });
+				}
+			}
+		}
+	}
+
+	if(results.ShouldRun("AudioRingBuffer.WrapAround")) {
+		for(auto channels : kChannelCounts) {
+			for(auto blockFrames : kBlockFrames) {
+				for(auto mirrored : { false, true }) {
+					const SFB::CAStreamBasicDescription format(SFB::CommonPCMFormat::float32, 48000, channels, false);
+					SFB::AudioRingBuffer ringBuffer;
+					if(!(mirrored ? ringBuffer.AllocateMirrored(format, blockFrames * 2) : ringBuffer.Allocate(format, blockFrames * 2)))
+						throw std::bad_alloc();
+					const auto capacityFrames = ringBuffer.CapacityFrames();
+
+					auto source = MakeBufferList(format, blockFrames);
+					auto destination = MakeBufferList(format, blockFrames);
+
+					const auto measure = [&](uint32_t startPosition) {
+						ringBuffer.Reset();
+						ringBuffer.AdvanceWritePosition(startPosition);
+						ringBuffer.AdvanceReadPosition(startPosition);
+						const auto start = Clock::now();
+						for(uint32_t i = 0; i < configuration.mIterations; ++i) {
+							ringBuffer.Write(source, blockFrames, false);
+							destination.SetFrameLength(blockFrames);
+							ringBuffer.Read(destination, blockFrames, false);
+							ringBuffer.AdvanceWritePosition(capacityFrames - blockFrames);
+							ringBuffer.AdvanceReadPosition(capacityFrames - blockFrames);
+						}
+						return ElapsedNanoseconds(start, Clock::now()) / configuration.mIterations;
+					};
+
+					const auto contiguous = measure(0);
+					const auto wrapping = measure(capacityFrames - blockFrames / 2);
+
+					results.Add({ "AudioRingBuffer.WrapAround", { String("format", FormatName(SFB::CommonPCMFormat::float32)), Number("channels", channels), Number("blockFrames", blockFrames), Boolean("mirrored", mirrored) }, {
+						Number("contiguousNanosecondsPerTransfer", contiguous),
+						Number("wrappingNanosecondsPerTransfer", wrapping),
+						Number("wrapOverheadNanoseconds", wrapping - contiguous),
+					} });
+				}
+			}
+		}
+	}
+}
+
+#pragma mark CARingBuffer
+
+void BenchmarkCARingBuffer(const Configuration& configuration, Results& results)
+{
+	if(results.ShouldRun("CARingBuffer.SPSC")) {
+		for(auto commonFormat : kFormats) {
+			for(auto channels : kChannelCounts) {
+				for(auto blockFrames : kBlockFrames) {
+					const SFB::CAStreamBasicDescription format(commonFormat, 48000, channels, false);
+					SFB::CARingBuffer ringBuffer;
+					if(!ringBuffer.Allocate(format, blockFrames * kCapacityBlocks))
+						throw std::bad_alloc();
+
+					auto source = MakeBufferList(format, blockFrames);
+					auto destination = MakeBufferList(format, blockFrames);
+					const auto blockBytes = static_cast<uint64_t>(format.FrameCountToByteSize(blockFrames)) * format.ChannelStreamCount();
+					const auto capacityBlocks = ringBuffer.CapacityFrames() / blockFrames;
+
+					// The buffer is addressed by sample time, so the producer is throttled to avoid overwriting unread audio
+					std::atomic_uint64_t blocksRead = 0;
+					uint64_t timeOffset = 0;
+
+					auto metrics = MeasureSPSC(ThroughputBlockCount(configuration, blockBytes), blockBytes, configuration.mLatencySamples,
+											   [&](uint64_t k) {
+						if(k - blocksRead.load(std::memory_order_acquire) >= capacityBlocks)
+							return false;
+						return ringBuffer.Write(source, blockFrames, static_cast<int64_t>(timeOffset + k * blockFrames));
+					},
+											   [&](uint64_t k) {
+						int64_t startTime, endTime;
+						const auto blockEnd = static_cast<int64_t>(timeOffset + (k + 1) * blockFrames);
+						if(!ringBuffer.GetTimeBounds(startTime, endTime) || endTime < blockEnd)
+							return false;
+						destination.SetFrameLength(blockFrames);
+						const auto result = ringBuffer.Read(destination, blockFrames, blockEnd - blockFrames);
+						blocksRead.store(k + 1, std::memory_order_release);
+						return result;
+					},
+											   [&] {
+						// Sample times continue past the previous measurement since they may not move backward
+						int64_t startTime = 0, endTime = 0;
+						ringBuffer.GetTimeBounds(startTime, endTime);
+						timeOffset = static_cast<uint64_t>(endTime) + ringBuffer.CapacityFrames();
+						blocksRead.store(0, std::memory_order_relaxed);
+					});
+
+					results.Add({ "CARingBuffer.SPSC", { String("format", FormatName(commonFormat)), Number("channels", channels), Number("blockFrames", blockFrames) }, std::move(metrics) });
+				}
+			}
+		}
+	}
+
+	if(results.ShouldRun("CARingBuffer.WrapAround")) {
+		for(auto channels : kChannelCounts) {
+			for(auto blockFrames : kBlockFrames) {
+				const SFB::CAStreamBasicDescription format(SFB::CommonPCMFormat::float32, 48000, channels, false);
+				SFB::CARingBuffer ringBuffer;
+				if(!ringBuffer.Allocate(format, blockFrames * 2))
+					throw std::bad_alloc();
+
+				auto source = MakeBufferList(format, blockFrames);
+				auto destination = MakeBufferList(format, blockFrames);
+				int64_t sampleTime = 0;
+
+				// With a capacity of two blocks, blocks starting half a block into the buffer alternately wrap
+				const auto measure = [&](uint32_t startOffset) {
+					sampleTime += 2 * ringBuffer.CapacityFrames() + startOffset;
+					const auto start = Clock::now();
+					for(uint32_t i = 0; i < configuration.mIterations; ++i) {
+						ringBuffer.Write(source, blockFrames, sampleTime);
+						destination.SetFrameLength(blockFrames);
+						ringBuffer.Read(destination, blockFrames, sampleTime);
+						sampleTime += blockFrames;
+					}
+					const auto nanoseconds = ElapsedNanoseconds(start, Clock::now()) / configuration.mIterations;
+					sampleTime -= sampleTime % ringBuffer.CapacityFrames();
+					return nanoseconds;
+				};
+
+				const auto contiguous = measure(0);
+				const auto wrapping = measure(blockFrames / 2);
+
+				results.Add({ "CARingBuffer.WrapAround", { String("format", FormatName(SFB::CommonPCMFormat::float32)), Number("channels", channels), Number("blockFrames", blockFrames), Number("wrapFraction", 0.5) }, {
+					Number("contiguousNanosecondsPerTransfer", contiguous),
+					Number("wrappingNanosecondsPerTransfer", wrapping),
+					Number("wrapOverheadNanoseconds", wrapping - contiguous),
+				} });
+			}
+		}
+	}
+}
+
+#pragma mark CABufferList
+
+void BenchmarkCABufferList(const Configuration& configuration, Results& results)
+{
+	if(!results.ShouldRun("CABufferList.InsertFromBuffer"))
+		return;
+
+	for(auto channels : kChannelCounts) {
+		for(auto blockFrames : kBlockFrames) {
+			const SFB::CAStreamBasicDescription sourceFormat(SFB::CommonPCMFormat::float32, 48000, channels, false);
+			const SFB::CAStreamBasicDescription destinationFormats[] = {
+				sourceFormat,
+				SFB::CAStreamBasicDescription(SFB::CommonPCMFormat::float32, 48000, channels, true),
+				SFB::CAStreamBasicDescription(SFB::CommonPCMFormat::int16, 48000, channels, true),
+			};
+
+			for(const auto& destinationFormat : destinationFormats) {
+				auto source = MakeBufferList(sourceFormat, blockFrames);
+				auto destination = MakeBufferList(destinationFormat, blockFrames);
+				if(!destination.CanInsertFromFormat(sourceFormat))
+					continue;
+
+				const auto iterations = std::max<uint64_t>(configuration.mConversionFrames / blockFrames, 1);
+				const auto start = Clock::now();
+				for(uint64_t i = 0; i < iterations; ++i) {
+					destination.Reset();
+					destination.InsertFromBuffer(source, 0, blockFrames, 0);
+				}
+				const auto seconds = ElapsedNanoseconds(start, Clock::now()) / 1e9;
+
+				results.Add({ "CABufferList.InsertFromBuffer", {
+					String("sourceFormat", FormatName(SFB::CommonPCMFormat::float32)),
+					Boolean("sourceInterleaved", false),
+					String("destinationFormat", FormatName(*destinationFormat.CommonFormat())),
+					Boolean("destinationInterleaved", destinationFormat.IsInterleaved()),
+					Number("channels", channels),
+					Number("blockFrames", blockFrames),
+				}, {
+					Number("framesPerSecond", static_cast<double>(iterations * blockFrames) / seconds),
+				} });
+			}
+		}
+	}
+}
+
+#pragma mark CAAudioConverter
+
+/// Input for a sample rate conversion, supplying the same block repeatedly
+struct ConverterInput {
+	SFB::CABufferList& mBufferList;
+};
+
+/// Supplies input to @c AudioConverterFillComplexBuffer
+OSStatus ConverterInputProc(AudioConverterRef inAudioConverter, UInt32 *ioNumberDataPackets, AudioBufferList *ioData, AudioStreamPacketDescription * _Nullable * _Nullable outDataPacketDescription, void *inUserData)
+{
+#pragma unused(inAudioConverter)
+#pragma unused(outDataPacketDescription)
+
+	auto& bufferList = static_cast<ConverterInput *>(inUserData)->mBufferList;
+	bufferList.SetFrameLength(std::min(*ioNumberDataPackets, bufferList.FrameCapacity()));
+
+	const auto abl = bufferList.ABL();
+	ioData->mNumberBuffers = abl->mNumberBuffers;
+	for(UInt32 i = 0; i < abl->mNumberBuffers; ++i)
+		ioData->mBuffers[i] = abl->mBuffers[i];
+	*ioNumberDataPackets = bufferList.FrameLength();
+
+	return noErr;
+}
+
+void BenchmarkCAAudioConverter(const Configuration& configuration, Results& results)
+{
+	if(results.ShouldRun("CAAudioConverter.ConvertComplexBuffer")) {
+		for(auto channels : kChannelCounts) {
+			for(auto blockFrames : kBlockFrames) {
+				const SFB::CAStreamBasicDescription sourceFormat(SFB::CommonPCMFormat::float32, 48000, channels, false);
+				const SFB::CAStreamBasicDescription destinationFormat(SFB::CommonPCMFormat::int16, 48000, channels, true);
+
+				SFB::CAAudioConverter converter;
+				converter.New(sourceFormat, destinationFormat);
+
+				auto source = MakeBufferList(sourceFormat, blockFrames);
+				auto destination = MakeBufferList(destinationFormat, blockFrames);
+
+				const auto iterations = std::max<uint64_t>(configuration.mConversionFrames / blockFrames, 1);
+				const auto start = Clock::now();
+				for(uint64_t i = 0; i < iterations; ++i) {
+					destination.SetFrameLength(blockFrames);
+					converter.ConvertComplexBuffer(blockFrames, source, destination);
+				}
+				const auto seconds = ElapsedNanoseconds(start, Clock::now()) / 1e9;
+
+				results.Add({ "CAAudioConverter.ConvertComplexBuffer", {
+					String("sourceFormat", FormatName(SFB::CommonPCMFormat::float32)),
+					Boolean("sourceInterleaved", false),
+					String("destinationFormat", FormatName(SFB::CommonPCMFormat::int16)),
+					Boolean("destinationInterleaved", true),
+					Number("channels", channels),
+					Number("blockFrames", blockFrames),
+				}, {
+					Number("framesPerSecond", static_cast<double>(iterations * blockFrames) / seconds),
+				} });
+			}
+		}
+	}
+
+	if(results.ShouldRun("CAAudioConverter.SampleRateConversion")) {
+		constexpr Float64 kSampleRates[][2] = { { 44100, 48000 }, { 96000, 48000 } };
+		for(const auto& sampleRates : kSampleRates) {
+			for(auto channels : kChannelCounts) {
+				constexpr UInt32 kOutputFrames = 4096;
+				const SFB::CAStreamBasicDescription sourceFormat(SFB::CommonPCMFormat::float32, sampleRates[0], channels, false);
+				const SFB::CAStreamBasicDescription destinationFormat(SFB::CommonPCMFormat::float32, sampleRates[1], channels, false);
+
+				SFB::CAAudioConverter converter;
+				converter.New(sourceFormat, destinationFormat);
+
+				auto source = MakeBufferList(sourceFormat, kOutputFrames * 2 + 1);
+				auto destination = MakeBufferList(destinationFormat, kOutputFrames);
+				ConverterInput input{source};
+
+				const auto iterations = std::max<uint64_t>(configuration.mConversionFrames / kOutputFrames, 1);
+				uint64_t framesConverted = 0;
+				const auto start = Clock::now();
+				for(uint64_t i = 0; i < iterations; ++i) {
+					destination.SetFrameLength(kOutputFrames);
+					UInt32 frameCount = kOutputFrames;
+					converter.FillComplexBuffer(ConverterInputProc, &input, frameCount, destination, nullptr);
+					framesConverted += frameCount;
+				}
+				const auto seconds = ElapsedNanoseconds(start, Clock::now()) / 1e9;
+
+				results.Add({ "CAAudioConverter.SampleRateConversion", {
+					String("format", FormatName(SFB::CommonPCMFormat::float32)),
+					Number("sourceSampleRate", sampleRates[0]),
+					Number("destinationSampleRate", sampleRates[1]),
+					Number("channels", channels),
+					Number("blockFrames", kOutputFrames),
+				}, {
+					Number("framesPerSecond", static_cast<double>(framesConverted) / seconds),
+				} });
+			}
+		}
+	}
+}
+
+#pragma mark Locks
+
+/// Returns the number of voluntary context switches performed by the process
+long VoluntaryContextSwitches() noexcept
+{
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) == -1)
+		return 0;
+	return usage.ru_nvcsw;
+}
+
+/// Measures @c threadCount threads repeatedly locking @c lock and performing @c criticalSectionWork iterations of work
+template <typename L>
+std::vector<Field> MeasureContention(L& lock, uint32_t threadCount, uint64_t acquisitions, uint32_t criticalSectionWork)
+{
+	uint64_t shared = 0;
+	std::atomic_uint32_t ready = 0;
+	std::atomic_bool start = false;
+
+	const auto acquisitionsPerThread = std::max<uint64_t>(acquisitions / threadCount, 1);
+
+	std::vector<std::thread> threads;
+	for(uint32_t i = 0; i < threadCount; ++i) {
+		threads.emplace_back([&] {
+			ready.fetch_add(1);
+			while(!start.load())
+				std::this_thread::yield();
+			for(uint64_t j = 0; j < acquisitionsPerThread; ++j) {
+				std::lock_guard<L> guard(lock);
+				auto value = shared;
+				for(uint32_t k = 0; k < criticalSectionWork; ++k) {
+					value = value * 31 + k;
+					__asm__ __volatile__("" : "+r"(value));
+				}
+				shared = value + 1;
+			}
+		});
+	}
+
+	while(ready.load() < threadCount)
+		std::this_thread::yield();
+
+	const auto switches = VoluntaryContextSwitches();
+	const auto startTime = Clock::now();
+	start.store(true);
+	for(auto& thread : threads)
+		thread.join();
+	const auto seconds = ElapsedNanoseconds(startTime, Clock::now()) / 1e9;
+	const auto total = static_cast<double>(acquisitionsPerThread * threadCount);
+
+	return {
+		Number("acquisitionsPerSecond", total / seconds),
+		Number("contextSwitchesPerThousandAcquisitions", static_cast<double>(VoluntaryContextSwitches() - switches) * 1000 / total),
+	};
+}
+
+void BenchmarkLocks(const Configuration& configuration, Results& results)
+{
+	for(auto threadCount : kLockThreadCounts) {
+		for(auto work : kCriticalSectionWork) {
+			const std::vector<Field> parameters = {
+				Number("threads", threadCount),
+				Number("criticalSectionWork", work),
+			};
+
+			if(results.ShouldRun("UnfairLock.Contended")) {
+				SFB::UnfairLock lock;
+				results.Add({ "UnfairLock.Contended", parameters, MeasureContention(lock, threadCount, 10 * configuration.mIterations, work) });
+			}
+
+			if(results.ShouldRun("AdaptiveUnfairLock.Contended")) {
+				SFB::AdaptiveUnfairLock lock;
+				auto metrics = MeasureContention(lock, threadCount, 10 * configuration.mIterations, work);
+				const auto statistics = lock.UsageStatistics();
+				metrics.push_back(Number("contentions", statistics.mContentions));
+				metrics.push_back(Number("spinAcquisitions", statistics.mSpinAcquisitions));
+				metrics.push_back(Number("parks", statistics.mParks));
+				results.Add({ "AdaptiveUnfairLock.Contended", parameters, std::move(metrics) });
+			}
+		}
+	}
+}
+
+} /* namespace */
+
+int main(int argc, const char *argv[])
+{
+	Configuration configuration;
+
+	for(int i = 1; i < argc; ++i) {
+		if(!std::strcmp(argv[i], "--quick")) {
+			configuration.mThroughputBytes /= 16;
+			configuration.mLatencySamples /= 16;
+			configuration.mIterations /= 16;
+			configuration.mConversionFrames /= 16;
+		}
+		else if(!std::strcmp(argv[i], "--filter") && i + 1 < argc)
+			configuration.mFilter = argv[++i];
+		else {
+			std::fprintf(stderr, "Usage: %s [--quick] [--filter <substring>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	Results results(configuration);
+
+	try {
+		BenchmarkRingBuffer(configuration, results);
+		BenchmarkAudioRingBuffer(configuration, results);
+		BenchmarkCARingBuffer(configuration, results);
+		BenchmarkCABufferList(configuration, results);
+		BenchmarkCAAudioConverter(configuration, results);
+		BenchmarkLocks(configuration, results);
+	}
+	catch(const std::exception& e) {
+		std::fprintf(stderr, "Benchmark failed: %s\n", e.what());
+		return 1;
+	}
+
+	results.Write(stdout, Context(configuration));
+
+	return 0;
+}